@@ -0,0 +1,189 @@
+/*
+    Copyright (c) 2008-2020 Jan W. Krieger (<jan@jkrieger.de>)
+
+
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef JKQTPCACHINGTOOLS_H_INCLUDED
+#define JKQTPCACHINGTOOLS_H_INCLUDED
+#include "jkqtcommon/jkqtcommon_imexport.h"
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <list>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+
+/*! \brief a bounded, thread-safe key-value cache with least-recently-used eviction
+    \ingroup jkqtptools_codestructuring
+
+    \tparam TKey type of the keys, requires \c operator==() and a \c qHash() overload
+    \tparam TData type of the cached values
+    \tparam Shards number of independent shards (each with its own mutex)
+
+    The cache is split into \a Shards shards, selected by the hash of the key. Each shard is an LRU cache with its own lock and
+    at most maxEntries()/Shards entries, so concurrent users (e.g. several plotters, which are drawn in parallel threads) rarely
+    contend for the same lock and a lookup never has to wait for an insertion into another shard.
+
+    As \c qHash() is evaluated once per lookup for the shard and once by the QHash, keys with an expensive hash should store
+    a precomputed hash value.
+
+    Typical usage:
+    \code
+        static JKQTPShardedLRUCache<MyKey, MyData> cache(1024);
+
+        MyData d;
+        if (!cache.get(key, d)) {
+            d=calculate(key);
+            cache.put(key, d);
+        }
+    \endcode
+
+    hits() and misses() count the results of get().
+ */
+template <class TKey, class TData, size_t Shards=16>
+class JKQTPShardedLRUCache {
+    public:
+        /** \brief constructs an empty cache, which holds at most \a maxEntries entries */
+        explicit JKQTPShardedLRUCache(size_t maxEntries=4096):
+            m_maxEntriesPerShard(entriesPerShard(maxEntries)), m_hits(0), m_misses(0)
+        {
+        }
+
+        JKQTPShardedLRUCache(const JKQTPShardedLRUCache&)=delete;
+        JKQTPShardedLRUCache& operator=(const JKQTPShardedLRUCache&)=delete;
+
+        /** \brief looks up \a key and stores its value in \a data , returns \c false (and leaves \a data unchanged), if \a key is not in the cache */
+        bool get(const TKey& key, TData& data) {
+            Shard& s=shard(key);
+            QMutexLocker locker(&s.mutex);
+            auto it=s.index.constFind(key);
+            if (it==s.index.constEnd()) {
+                m_misses++;
+                return false;
+            }
+            // move the entry to the front of the usage list (most recently used)
+            s.usage.splice(s.usage.begin(), s.usage, it.value());
+            data=it.value()->second;
+            m_hits++;
+            return true;
+        }
+
+        /** \brief stores \a data for \a key (replaces an existing value) and evicts the least recently used entries, if the cache is full */
+        void put(const TKey& key, const TData& data) {
+            Shard& s=shard(key);
+            QMutexLocker locker(&s.mutex);
+            auto it=s.index.find(key);
+            if (it!=s.index.end()) {
+                it.value()->second=data;
+                s.usage.splice(s.usage.begin(), s.usage, it.value());
+                return;
+            }
+            s.usage.emplace_front(key, data);
+            s.index.insert(key, s.usage.begin());
+            shrink(s, m_maxEntriesPerShard.load());
+        }
+
+        /** \brief removes all entries (the hit/miss counters are not reset) */
+        void clear() {
+            for (Shard& s: m_shards) {
+                QMutexLocker locker(&s.mutex);
+                s.index.clear();
+                s.usage.clear();
+            }
+        }
+
+        /** \brief returns the number of entries in the cache */
+        size_t size() const {
+            size_t n=0;
+            for (const Shard& s: m_shards) {
+                QMutexLocker locker(&s.mutex);
+                n+=static_cast<size_t>(s.index.size());
+            }
+            return n;
+        }
+
+        /** \brief maximum number of entries in the cache */
+        size_t maxEntries() const {
+            return m_maxEntriesPerShard.load()*Shards;
+        }
+
+        /** \brief sets the maximum number of entries in the cache (rounded up to a multiple of the number of shards), evicts entries if necessary */
+        void setMaxEntries(size_t maxEntries) {
+            m_maxEntriesPerShard=entriesPerShard(maxEntries);
+            for (Shard& s: m_shards) {
+                QMutexLocker locker(&s.mutex);
+                shrink(s, m_maxEntriesPerShard.load());
+            }
+        }
+
+        /** \brief number of calls of get() that found the key */
+        uint64_t hits() const {
+            return m_hits.load();
+        }
+
+        /** \brief number of calls of get() that did not find the key */
+        uint64_t misses() const {
+            return m_misses.load();
+        }
+
+        /** \brief resets hits() and misses() to 0 */
+        void resetStatistics() {
+            m_hits=0;
+            m_misses=0;
+        }
+
+    private:
+        typedef std::list<std::pair<TKey, TData> > UsageList;
+        /** \brief one shard of the cache */
+        struct Shard {
+            /** \brief protects index and usage */
+            mutable QMutex mutex;
+            /** \brief entries, the most recently used entry is at the front */
+            UsageList usage;
+            /** \brief maps the keys to their entry in usage */
+            QHash<TKey, typename UsageList::iterator> index;
+        };
+
+        static size_t entriesPerShard(size_t maxEntries) {
+            return (maxEntries+Shards-1)/Shards>0?(maxEntries+Shards-1)/Shards:1;
+        }
+
+        Shard& shard(const TKey& key) {
+            return m_shards[static_cast<size_t>(qHash(key))%Shards];
+        }
+
+        /** \brief evicts the least recently used entries of \a s , until it contains at most \a maxEntries entries (\a s has to be locked) */
+        static void shrink(Shard& s, size_t maxEntries) {
+            while (static_cast<size_t>(s.index.size())>maxEntries) {
+                s.index.remove(s.usage.back().first);
+                s.usage.pop_back();
+            }
+        }
+
+        Shard m_shards[Shards];
+        std::atomic<size_t> m_maxEntriesPerShard;
+        std::atomic<uint64_t> m_hits;
+        std::atomic<uint64_t> m_misses;
+};
+
+
+#endif // JKQTPCACHINGTOOLS_H_INCLUDED
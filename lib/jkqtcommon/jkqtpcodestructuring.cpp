@@ -22,3 +22,67 @@ Copyright (c) 2008-2020 Jan W. Krieger (<jan@jkrieger.de>)
 
 
 #include "jkqtcommon/jkqtpcodestructuring.h"
+#include <QThreadPool>
+#include <QThread>
+#include <QRunnable>
+#include <QSemaphore>
+#include <atomic>
+#include <algorithm>
+
+
+namespace {
+    /** \internal
+     *  \brief QRunnable that executes tasks of a jkqtpParallelFor(), until none are left, and releases \a done afterwards */
+    class JKQTPParallelForRunnable: public QRunnable {
+        public:
+            JKQTPParallelForRunnable(const std::function<void()>& work, QSemaphore& done):
+                m_work(work), m_done(done)
+            {
+                setAutoDelete(true);
+            }
+            virtual void run() override {
+                m_work();
+                m_done.release();
+            }
+        private:
+            std::function<void()> m_work;
+            QSemaphore& m_done;
+    };
+}
+
+
+int jkqtpParallelThreadCount()
+{
+    return std::max(1, QThread::idealThreadCount());
+}
+
+void jkqtpParallelFor(size_t tasks, const std::function<void(size_t)>& func, int maxThreads)
+{
+    if (tasks==0) return;
+    const size_t threads=std::min<size_t>(tasks, static_cast<size_t>((maxThreads>0)?maxThreads:jkqtpParallelThreadCount()));
+    if (threads<=1) {
+        for (size_t i=0; i<tasks; i++) func(i);
+        return;
+    }
+    std::atomic<size_t> nextTask(0);
+    auto work=[&]() {
+        for (size_t i=nextTask++; i<tasks; i=nextTask++) {
+            func(i);
+        }
+    };
+    QSemaphore done;
+    int started=0;
+    QThreadPool* pool=QThreadPool::globalInstance();
+    for (size_t t=1; t<threads; t++) {
+        JKQTPParallelForRunnable* r=new JKQTPParallelForRunnable(work, done);
+        if (pool->tryStart(r)) {
+            started++;
+        } else {
+            // no idle thread: the remaining tasks are executed by the running threads
+            delete r;
+            break;
+        }
+    }
+    work();
+    done.acquire(started);
+}
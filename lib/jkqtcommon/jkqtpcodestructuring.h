@@ -21,7 +21,9 @@
 
 #ifndef JKQTPCODESTRUCTURING_H_INCLUDED
 #define JKQTPCODESTRUCTURING_H_INCLUDED
+#include "jkqtcommon/jkqtcommon_imexport.h"
 #include <functional>
+#include <cstddef>
 
 
 /** \brief C++11 finally construct (executes a callable-object when the edestructor is executed)
@@ -121,4 +123,31 @@ inline JKQTPFinalAct<F> JKQTPFinally(F&& f) noexcept
 }
 
 
+/** \brief returns the number of threads, used by jkqtpParallelFor() (i.e. QThread::idealThreadCount() )
+ * \ingroup jkqtptools_codestructuring
+ */
+JKQTCOMMON_LIB_EXPORT int jkqtpParallelThreadCount();
+
+/** \brief executes \c func(task) for every \c task in \c 0..tasks-1 in parallel, using idle threads of QThreadPool::globalInstance()
+ * \ingroup jkqtptools_codestructuring
+ *
+ * The calling thread also executes tasks and waits, until all tasks are finished. Only threads that are idle in the pool are used,
+ * so this function may also be called from a thread of the pool. If no threads are available, all tasks are executed in the calling thread.
+ *
+ * Typical usage:
+ * \code
+ *   std::vector<double> rowSums(rows);
+ *   jkqtpParallelFor(rows, [&](size_t r) {
+ *       // each task writes only to its own output, so no locking is required
+ *       rowSums[r]=std::accumulate(img.begin()+r*cols, img.begin()+(r+1)*cols, 0.0);
+ *   });
+ * \endcode
+ *
+ * \param tasks number of tasks to execute
+ * \param func the function to execute for every task, it has to be safe to call it for different tasks in parallel
+ * \param maxThreads maximum number of threads (including the calling thread) to use, \c <=0 uses jkqtpParallelThreadCount()
+ */
+JKQTCOMMON_LIB_EXPORT void jkqtpParallelFor(size_t tasks, const std::function<void(size_t)>& func, int maxThreads=-1);
+
+
 #endif // JKQTPCODESTRUCTURING_H_INCLUDED
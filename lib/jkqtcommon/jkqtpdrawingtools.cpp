@@ -24,6 +24,8 @@ Copyright (c) 2008-2020 Jan W. Krieger (<jan@jkrieger.de>)
 #include <QDebug>
 
 const double JKQTPlotterDrawingTools::ABS_MIN_LINEWIDTH= 0.02;
+const int JKQTPlotterDrawingTools::SYMBOL_SPRITE_MIN_COUNT= 64;
+const double JKQTPlotterDrawingTools::SYMBOL_SPRITE_MAX_SIZE= 256.0;
 
 
 
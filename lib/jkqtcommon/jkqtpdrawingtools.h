@@ -30,6 +30,8 @@
 #include <QLineF>
 #include <QLine>
 #include <QPainterPath>
+#include <QPaintEngine>
+#include <QImage>
 #include <QColor>
 #include <QVector>
 #include <vector>
@@ -51,6 +53,12 @@ struct JKQTPlotterDrawingTools {
     /** \brief smallest linewidth any line in JKQTPlotter/JKQTBasePlotter may have
      */
     static JKQTCOMMON_LIB_EXPORT const double ABS_MIN_LINEWIDTH;
+    /** \brief JKQTPPlotSymbols() renders the symbol once into a sprite and stamps it, if at least this many symbols are drawn onto a raster device
+     */
+    static JKQTCOMMON_LIB_EXPORT const int SYMBOL_SPRITE_MIN_COUNT;
+    /** \brief JKQTPPlotSymbols() does not use sprites for symbols with a size (in pixels) above this value
+     */
+    static JKQTCOMMON_LIB_EXPORT const double SYMBOL_SPRITE_MAX_SIZE;
 };
 
 
@@ -260,6 +268,45 @@ inline void JKQTPPlotSymbol(TPainter& painter, double x, double y, JKQTPGraphSym
  */
 JKQTCOMMON_LIB_EXPORT void JKQTPPlotSymbol(QPaintDevice& paintDevice, double x, double y, JKQTPGraphSymbols symbol, double size, double symbolLineWidth, QColor color, QColor fillColor);
 
+/*! \brief plot the specified symbol at all pixel positions in \a points, using the same size and colors for all of them
+   \ingroup jkqtptools_drawing
+
+    This is equivalent to calling JKQTPPlotSymbol() for every point in \a points, but the painter is set up only once.
+    When drawing many symbols (see JKQTPlotterDrawingTools::SYMBOL_SPRITE_MIN_COUNT) onto a raster device,
+    the symbol is rendered only once into a QImage-sprite, which is then stamped at every position. This only uses
+    QImage (not QPixmap), so it is also safe in non-GUI threads. In that case symbol positions are snapped to the
+    device pixel grid. The symbols are always drawn in the order of \a points.
+
+    \tparam TPainter Type of \a painter: A class like JKQTPEnhancedPainter or <a href="http://doc.qt.io/qt-5/qpainter.html">QPainter</a>
+    \param painter the <a href="http://doc.qt.io/qt-5/qpainter.html">QPainter</a> to draw to
+    \param points centers of the symbols
+    \param symbol type of the symbol to plot, see JKQTPGraphSymbols
+    \param size size (width/height) of the symbol around each point
+    \param symbolLineWidth width of the lines used to draw the symbol
+    \param color color of the symbol lines
+    \param fillColor color of the symbol filling
+ */
+template <class TPainter>
+inline void JKQTPPlotSymbols(TPainter& painter, const QVector<QPointF>& points, JKQTPGraphSymbols symbol, double size, double symbolLineWidth, QColor color, QColor fillColor);
+
+/*! \brief sets up the pen of \a painter for drawing symbols with JKQTPPlotSymbolShape() and returns the brush to use for filled symbols in \a fillBrush
+   \ingroup jkqtptools_drawing
+
+   \see JKQTPPlotSymbol(), JKQTPPlotSymbolShape()
+ */
+template <class TPainter>
+inline void JKQTPPrepareSymbolPainter(TPainter& painter, double symbolLineWidth, QColor color, QColor fillColor, QBrush& fillBrush);
+
+/*! \brief draws the shape of \a symbol at pixel position x,y with the current pen of \a painter, filled symbols use \a fillBrush
+   \ingroup jkqtptools_drawing
+
+   The painter has to be prepared with JKQTPPrepareSymbolPainter() first.
+
+   \see JKQTPPlotSymbol(), JKQTPPrepareSymbolPainter()
+ */
+template <class TPainter>
+inline void JKQTPPlotSymbolShape(TPainter& painter, double x, double y, JKQTPGraphSymbols symbol, double size, const QBrush& fillBrush);
+
 
 /*! \brief draw a tooltip, using the current brush and pen of the provided painter
     \ingroup jkqtptools_drawing
@@ -287,15 +334,64 @@ inline void JKQTPDrawTooltip(TPainter& painter, double x, double y, const QRectF
 template <class TPainter>
 inline void JKQTPPlotSymbol(TPainter& painter, double x, double y, JKQTPGraphSymbols symbol, double symbolSize, double symbolLineWidth, QColor color, QColor fillColor) {
     painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
+    QBrush b;
+    JKQTPPrepareSymbolPainter(painter, symbolLineWidth, color, fillColor, b);
+    JKQTPPlotSymbolShape(painter, x, y, symbol, symbolSize, b);
+}
+
+template <class TPainter>
+inline void JKQTPPrepareSymbolPainter(TPainter& painter, double symbolLineWidth, QColor color, QColor fillColor, QBrush& fillBrush) {
     QPen p=painter.pen();
     p.setColor(color);
     p.setWidthF(qMax(JKQTPlotterDrawingTools::ABS_MIN_LINEWIDTH,  symbolLineWidth));
     p.setStyle(Qt::SolidLine);
     p.setCapStyle(Qt::FlatCap);
     painter.setPen(p);
-    QBrush b=painter.brush();
-    b.setColor(fillColor);
-    b.setStyle(Qt::SolidPattern);
+    fillBrush=painter.brush();
+    fillBrush.setColor(fillColor);
+    fillBrush.setStyle(Qt::SolidPattern);
+}
+
+template <class TPainter>
+inline void JKQTPPlotSymbols(TPainter& painter, const QVector<QPointF>& points, JKQTPGraphSymbols symbol, double symbolSize, double symbolLineWidth, QColor color, QColor fillColor) {
+    if (points.size()<=0 || symbol==JKQTPNoSymbol) return;
+    painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
+    const QPaintEngine* engine=painter.paintEngine();
+    const bool useSprite=(points.size()>=JKQTPlotterDrawingTools::SYMBOL_SPRITE_MIN_COUNT)
+                         && (engine!=nullptr) && (engine->type()==QPaintEngine::Raster)
+                         && (painter.worldTransform().type()<=QTransform::TxTranslate)
+                         && (painter.device()!=nullptr) && (symbolSize>0.0) && (symbolSize<JKQTPlotterDrawingTools::SYMBOL_SPRITE_MAX_SIZE);
+    if (useSprite) {
+        // render the symbol once into a sprite and stamp it at every position
+        const double dpr=qMax(1.0, painter.device()->devicePixelRatioF());
+        const double ext=ceil(symbolSize+2.0*qMax(JKQTPlotterDrawingTools::ABS_MIN_LINEWIDTH,  symbolLineWidth)+2.0);
+        const int spriteSize=static_cast<int>(ceil(ext*dpr));
+        const double c=static_cast<double>(spriteSize)/dpr/2.0;
+        QImage sprite(spriteSize, spriteSize, QImage::Format_ARGB32_Premultiplied);
+        sprite.setDevicePixelRatio(dpr);
+        sprite.fill(Qt::transparent);
+        {
+            QPainter sp(&sprite);
+            sp.setRenderHints(painter.renderHints());
+            sp.setPen(painter.pen());
+            sp.setBrush(painter.brush());
+            JKQTPPlotSymbol(sp, c, c, symbol, symbolSize, symbolLineWidth, color, fillColor);
+        }
+        const QPointF offset(c,c);
+        for (const QPointF& pnt: points) {
+            painter.drawImage(pnt-offset, sprite);
+        }
+    } else {
+        QBrush b;
+        JKQTPPrepareSymbolPainter(painter, symbolLineWidth, color, fillColor, b);
+        for (const QPointF& pnt: points) {
+            JKQTPPlotSymbolShape(painter, pnt.x(), pnt.y(), symbol, symbolSize, b);
+        }
+    }
+}
+
+template <class TPainter>
+inline void JKQTPPlotSymbolShape(TPainter& painter, double x, double y, JKQTPGraphSymbols symbol, double symbolSize, const QBrush& b) {
     const double w=symbolSize;
     const double w2=w/2.0;
     const double w45=fabs(w*cos(45.0/180.0*JKQTPSTATISTICS_PI));
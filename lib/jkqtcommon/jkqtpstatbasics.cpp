@@ -44,3 +44,215 @@ double JKQTPStat5NumberStatistics::IQRSignificanceEstimate() const {
     return 2.0*(1.58*(IQR()))/sqrt(static_cast<double>(N));
 }
 
+
+
+JKQTPStatMomentsAccumulator::JKQTPStatMomentsAccumulator():
+    m_N(0),
+    m_processed(0),
+    m_mean(0),
+    m_M2(0),
+    m_M3(0),
+    m_M4(0),
+    m_min(JKQTP_DOUBLE_NAN),
+    m_max(JKQTP_DOUBLE_NAN)
+{
+
+}
+
+void JKQTPStatMomentsAccumulator::merge(const JKQTPStatMomentsAccumulator &other)
+{
+    if (other.m_N==0) {
+        m_processed+=other.m_processed;
+        return;
+    }
+    if (m_N==0) {
+        const size_t processed=m_processed;
+        *this=other;
+        m_processed+=processed;
+        return;
+    }
+    const double na=static_cast<double>(m_N);
+    const double nb=static_cast<double>(other.m_N);
+    const double n=na+nb;
+    const double delta=other.m_mean-m_mean;
+    const double delta2=delta*delta;
+    const double delta3=delta2*delta;
+    const double delta4=delta2*delta2;
+    const double M2=m_M2+other.m_M2+delta2*na*nb/n;
+    const double M3=m_M3+other.m_M3+delta3*na*nb*(na-nb)/(n*n)+3.0*delta*(na*other.m_M2-nb*m_M2)/n;
+    const double M4=m_M4+other.m_M4+delta4*na*nb*(na*na-na*nb+nb*nb)/(n*n*n)+6.0*delta2*(na*na*other.m_M2+nb*nb*m_M2)/(n*n)+4.0*delta*(na*other.m_M3-nb*m_M3)/n;
+    m_mean=m_mean+delta*nb/n;
+    m_M2=M2;
+    m_M3=M3;
+    m_M4=M4;
+    m_N+=other.m_N;
+    m_processed+=other.m_processed;
+    m_min=std::min(m_min, other.m_min);
+    m_max=std::max(m_max, other.m_max);
+}
+
+void JKQTPStatMomentsAccumulator::clear()
+{
+    *this=JKQTPStatMomentsAccumulator();
+}
+
+size_t JKQTPStatMomentsAccumulator::count() const
+{
+    return m_N;
+}
+
+size_t JKQTPStatMomentsAccumulator::processedItems() const
+{
+    return m_processed;
+}
+
+double JKQTPStatMomentsAccumulator::average() const
+{
+    if (m_N<=0) return JKQTP_DOUBLE_NAN;
+    return m_mean;
+}
+
+double JKQTPStatMomentsAccumulator::sum() const
+{
+    return m_mean*static_cast<double>(m_N);
+}
+
+double JKQTPStatMomentsAccumulator::minimum() const
+{
+    return m_min;
+}
+
+double JKQTPStatMomentsAccumulator::maximum() const
+{
+    return m_max;
+}
+
+double JKQTPStatMomentsAccumulator::variance() const
+{
+    if (m_N<=1) return 0;
+    return m_M2/static_cast<double>(m_N-1);
+}
+
+double JKQTPStatMomentsAccumulator::standardDeviation() const
+{
+    return sqrt(variance());
+}
+
+double JKQTPStatMomentsAccumulator::skewness() const
+{
+    if (m_N<=0) return 0;
+    const double n=static_cast<double>(m_N);
+    return (m_M3/n)/sqrt(jkqtp_cube(m_M2/n));
+}
+
+double JKQTPStatMomentsAccumulator::kurtosis() const
+{
+    if (m_N<=0) return 0;
+    const double n=static_cast<double>(m_N);
+    return (m_M4/n)/jkqtp_sqr(m_M2/n);
+}
+
+double JKQTPStatMomentsAccumulator::centralMoment(int order) const
+{
+    if (m_N<=0) return 0;
+    const double n=static_cast<double>(m_N);
+    switch(order) {
+        case 0: return 1;
+        case 1: return 0;
+        case 2: return m_M2/n;
+        case 3: return m_M3/n;
+        case 4: return m_M4/n;
+        default: return JKQTP_DOUBLE_NAN;
+    }
+}
+
+
+
+JKQTPStatCorrelationAccumulator::JKQTPStatCorrelationAccumulator():
+    m_N(0),
+    m_processed(0),
+    m_meanX(0),
+    m_meanY(0),
+    m_M2X(0),
+    m_M2Y(0),
+    m_C(0)
+{
+
+}
+
+void JKQTPStatCorrelationAccumulator::merge(const JKQTPStatCorrelationAccumulator &other)
+{
+    if (other.m_N==0) {
+        m_processed+=other.m_processed;
+        return;
+    }
+    if (m_N==0) {
+        const size_t processed=m_processed;
+        *this=other;
+        m_processed+=processed;
+        return;
+    }
+    const double na=static_cast<double>(m_N);
+    const double nb=static_cast<double>(other.m_N);
+    const double n=na+nb;
+    const double dx=other.m_meanX-m_meanX;
+    const double dy=other.m_meanY-m_meanY;
+    m_M2X=m_M2X+other.m_M2X+dx*dx*na*nb/n;
+    m_M2Y=m_M2Y+other.m_M2Y+dy*dy*na*nb/n;
+    m_C=m_C+other.m_C+dx*dy*na*nb/n;
+    m_meanX=m_meanX+dx*nb/n;
+    m_meanY=m_meanY+dy*nb/n;
+    m_N+=other.m_N;
+    m_processed+=other.m_processed;
+}
+
+void JKQTPStatCorrelationAccumulator::clear()
+{
+    *this=JKQTPStatCorrelationAccumulator();
+}
+
+size_t JKQTPStatCorrelationAccumulator::count() const
+{
+    return m_N;
+}
+
+size_t JKQTPStatCorrelationAccumulator::processedItems() const
+{
+    return m_processed;
+}
+
+double JKQTPStatCorrelationAccumulator::averageX() const
+{
+    if (m_N<=0) return JKQTP_DOUBLE_NAN;
+    return m_meanX;
+}
+
+double JKQTPStatCorrelationAccumulator::averageY() const
+{
+    if (m_N<=0) return JKQTP_DOUBLE_NAN;
+    return m_meanY;
+}
+
+double JKQTPStatCorrelationAccumulator::varianceX() const
+{
+    if (m_N<=1) return 0;
+    return m_M2X/static_cast<double>(m_N-1);
+}
+
+double JKQTPStatCorrelationAccumulator::varianceY() const
+{
+    if (m_N<=1) return 0;
+    return m_M2Y/static_cast<double>(m_N-1);
+}
+
+double JKQTPStatCorrelationAccumulator::covariance() const
+{
+    if (m_N<=1) return 0;
+    return m_C/static_cast<double>(m_N-1);
+}
+
+double JKQTPStatCorrelationAccumulator::correlationCoefficient() const
+{
+    if (m_N<=0) return JKQTP_DOUBLE_NAN;
+    return m_C/sqrt(m_M2X*m_M2Y);
+}
@@ -34,12 +34,24 @@
 #include <ostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
 #include "jkqtcommon/jkqtcommon_imexport.h"
 #include "jkqtcommon/jkqtplinalgtools.h"
 #include "jkqtcommon/jkqtparraytools.h"
 #include "jkqtcommon/jkqtpdebuggingtools.h"
 
 
+/*! \brief type trait that is \c true, if \c It supports \c it+(it2-it) , so a range of this iterator type can be split into chunks in constant time (e.g. pointers, random-access iterators and the JKQTPDatastore column iterators)
+    \ingroup jkqtptools_math_statistics_basic
+*/
+template <class It, class=void>
+struct JKQTPStatIsChunkableIterator: std::false_type {};
+template <class It>
+struct JKQTPStatIsChunkableIterator<It, decltype(void(std::declval<It>()+(std::declval<It>()-std::declval<It>())))>: std::true_type {};
+
+
 /*! \brief calculates the average of a given data range \a first ... \a last
     \ingroup jkqtptools_math_statistics_basic
 
@@ -442,6 +454,212 @@ inline size_t jkqtpstatFilterGoodFloat(InputIt first, InputIt last, OutputIt out
 
 
 
+/*! \brief single-pass, numerically stable and mergeable accumulator for the count, average, minimum, maximum and the central moments up to order 4 of a dataset
+    \ingroup jkqtptools_math_statistics_basic
+
+    The values are added one by one with add() (or addRange() ) and all statistics are updated with the
+    stable one-pass formulas of Welford and Pébay, i.e. each value is read only once, no matter how many of
+    the statistics are requested afterwards:
+      \f[ n\leftarrow n+1,\ \ \delta=x-\overline{x},\ \ \overline{x}\leftarrow\overline{x}+\frac{\delta}{n},\ \ M_2\leftarrow M_2+\delta^2\cdot\frac{n-1}{n},\ \ \ldots \f]
+    where \f$ M_p=\sum_i(x_i-\overline{x})^p \f$ .
+
+    Two accumulators can be combined with merge(), so a dataset can be split into chunks that are accumulated independently
+    (e.g. one accumulator per thread) and the results are merged at the end.
+
+    As the accumulator keeps its state, it can also be updated incrementally, when new values are appended to a dataset. processedItems()
+    counts all items that were passed to add() (including invalid ones), so e.g. new rows of a JKQTPDatastore column can be added with:
+    \code
+        JKQTPStatMomentsAccumulator acc;
+        // ... rows are appended to the column
+        acc.addRange(datastore->begin(column)+acc.processedItems(), datastore->end(column));
+        const double mean=acc.average();
+        const double std=acc.standardDeviation();
+        const double skew=acc.skewness();
+    \endcode
+
+    \note Values that are invalid double (using JKQTPIsOKFloat() ) are ignored.
+
+    \see jkqtpstatVariance(), jkqtpstatSkewness(), JKQTPStatCorrelationAccumulator,
+         P. Pébay: "Formulas for Robust, One-Pass Parallel Computation of Covariances and Arbitrary-Order Statistical Moments", Sandia Report SAND2008-6212 (2008)
+*/
+class JKQTCOMMON_LIB_EXPORT JKQTPStatMomentsAccumulator {
+    public:
+        JKQTPStatMomentsAccumulator();
+
+        /** \brief adds the value \a v to the accumulator */
+        inline void add(double v) {
+            m_processed++;
+            if (!JKQTPIsOKFloat(v)) return;
+            const double n1=static_cast<double>(m_N);
+            m_N++;
+            const double n=static_cast<double>(m_N);
+            const double delta=v-m_mean;
+            const double delta_n=delta/n;
+            const double delta_n2=delta_n*delta_n;
+            const double term1=delta*delta_n*n1;
+            m_mean+=delta_n;
+            m_M4+=term1*delta_n2*(n*n-3.0*n+3.0)+6.0*delta_n2*m_M2-4.0*delta_n*m_M3;
+            m_M3+=term1*delta_n*(n-2.0)-3.0*delta_n*m_M2;
+            m_M2+=term1;
+            if (m_N==1) {
+                m_min=m_max=v;
+            } else {
+                if (v<m_min) m_min=v;
+                if (v>m_max) m_max=v;
+            }
+        }
+        /*! \brief adds all values in the data range \a first ... \a last to the accumulator
+
+            \tparam InputIt standard iterator type of \a first and \a last.
+            \param first iterator pointing to the first item in the dataset to use \f$ X_1 \f$
+            \param last iterator pointing behind the last item in the dataset to use \f$ X_N \f$
+
+            \note Each value is the specified range is converted to a double using jkqtp_todouble().
+        */
+        template <class InputIt>
+        inline void addRange(InputIt first, InputIt last) {
+            for (auto it=first; it!=last; ++it) {
+                add(jkqtp_todouble(*it));
+            }
+        }
+        /** \brief merges the state of \a other into this accumulator, afterwards this object represents the union of both datasets */
+        void merge(const JKQTPStatMomentsAccumulator& other);
+        /** \brief resets the accumulator to the empty state */
+        void clear();
+
+        /** \brief number of valid values, accumulated so far */
+        size_t count() const;
+        /** \brief number of items that were passed to add() so far (including invalid values, which were ignored) */
+        size_t processedItems() const;
+        /** \brief average \f$ \overline{X}=\frac{1}{N}\cdot\sum\limits_{i=1}^{N}X_i \f$ of the accumulated values (NAN if empty) */
+        double average() const;
+        /** \brief sum \f$ \sum\limits_{i=1}^{N}X_i \f$ of the accumulated values */
+        double sum() const;
+        /** \brief minimum of the accumulated values (NAN if empty) */
+        double minimum() const;
+        /** \brief maximum of the accumulated values (NAN if empty) */
+        double maximum() const;
+        /** \brief variance \f$ \frac{1}{N-1}\cdot\sum\limits_{i=1}^{N}(X_i-\overline{X})^2 \f$ of the accumulated values (0 if less than 2 values were accumulated), see jkqtpstatVariance() */
+        double variance() const;
+        /** \brief standard deviation \f$ \sqrt{\mbox{variance()}} \f$ of the accumulated values, see jkqtpstatStdDev() */
+        double standardDeviation() const;
+        /** \brief skewness \f$ \gamma_1=\frac{m_3}{m_2^{3/2}} \f$ of the accumulated values (0 if empty), see jkqtpstatSkewness() */
+        double skewness() const;
+        /** \brief kurtosis \f$ \frac{m_4}{m_2^2} \f$ of the accumulated values (0 if empty), the excess kurtosis is \f$ \mbox{kurtosis()}-3 \f$ */
+        double kurtosis() const;
+        /** \brief central moment \f$ m_o=\frac{1}{N}\cdot\sum\limits_{i=1}^{N}(X_i-\overline{X})^o \f$ of order \a order (0<=order<=4, NAN for other orders, 0 if empty), see jkqtpstatCentralMoment() */
+        double centralMoment(int order) const;
+    private:
+        /** \brief number of valid values */
+        size_t m_N;
+        /** \brief number of processed items */
+        size_t m_processed;
+        /** \brief running average */
+        double m_mean;
+        /** \brief \f$ M_2=\sum_i(x_i-\overline{x})^2 \f$ */
+        double m_M2;
+        /** \brief \f$ M_3=\sum_i(x_i-\overline{x})^3 \f$ */
+        double m_M3;
+        /** \brief \f$ M_4=\sum_i(x_i-\overline{x})^4 \f$ */
+        double m_M4;
+        /** \brief minimum */
+        double m_min;
+        /** \brief maximum */
+        double m_max;
+};
+
+
+
+
+/*! \brief single-pass, numerically stable and mergeable accumulator for the averages, variances, the covariance and Pearson's correlation coefficient of two datasets \f$ X_i \f$ and \f$ Y_i \f$
+    \ingroup jkqtptools_math_statistics_basic
+
+    The value pairs are added one by one with add() (or addRange() ) and the co-moment
+    \f$ C=\sum_i(x_i-\overline{x})(y_i-\overline{y}) \f$ is updated with Welford's formula. Pairs, where
+    one value is an invalid double (using JKQTPIsOKFloat() ), are ignored.
+
+    Like JKQTPStatMomentsAccumulator, accumulators can be combined with merge() and updated incrementally
+    (see processedItems() ).
+
+    \see jkqtpstatCorrelationCoefficient(), JKQTPStatMomentsAccumulator
+*/
+class JKQTCOMMON_LIB_EXPORT JKQTPStatCorrelationAccumulator {
+    public:
+        JKQTPStatCorrelationAccumulator();
+
+        /** \brief adds the value pair (\a x , \a y ) to the accumulator */
+        inline void add(double x, double y) {
+            m_processed++;
+            if (!JKQTPIsOKFloat(x) || !JKQTPIsOKFloat(y)) return;
+            m_N++;
+            const double n=static_cast<double>(m_N);
+            const double dx=x-m_meanX;
+            const double dy=y-m_meanY;
+            m_meanX+=dx/n;
+            m_meanY+=dy/n;
+            const double dy2=y-m_meanY;
+            m_M2X+=dx*(x-m_meanX);
+            m_M2Y+=dy*dy2;
+            m_C+=dx*dy2;
+        }
+        /*! \brief adds all value pairs from the data ranges \a first1 ... \a last1 and \a first2 ... to the accumulator
+
+            \tparam InputIt1 standard iterator type of \a first1 and \a last1.
+            \tparam InputIt2 standard iterator type of \a first2
+            \param first1 iterator pointing to the first item in the first dataset to use \f$ X_1 \f$
+            \param last1 iterator pointing behind the last item in the first dataset to use \f$ X_N \f$
+            \param first2 iterator pointing to the first item in the second dataset to use \f$ Y_1 \f$
+
+            \note Each value is the specified range is converted to a double using jkqtp_todouble().
+        */
+        template <class InputIt1, class InputIt2>
+        inline void addRange(InputIt1 first1, InputIt1 last1, InputIt2 first2) {
+            auto it2=first2;
+            for (auto it=first1; it!=last1; ++it,++it2) {
+                add(jkqtp_todouble(*it), jkqtp_todouble(*it2));
+            }
+        }
+        /** \brief merges the state of \a other into this accumulator, afterwards this object represents the union of both datasets */
+        void merge(const JKQTPStatCorrelationAccumulator& other);
+        /** \brief resets the accumulator to the empty state */
+        void clear();
+
+        /** \brief number of valid value pairs, accumulated so far */
+        size_t count() const;
+        /** \brief number of value pairs that were passed to add() so far (including invalid pairs, which were ignored) */
+        size_t processedItems() const;
+        /** \brief average of the \f$ X_i \f$ (NAN if empty) */
+        double averageX() const;
+        /** \brief average of the \f$ Y_i \f$ (NAN if empty) */
+        double averageY() const;
+        /** \brief variance \f$ \frac{1}{N-1}\cdot\sum\limits_{i=1}^{N}(X_i-\overline{X})^2 \f$ (0 if less than 2 pairs were accumulated) */
+        double varianceX() const;
+        /** \brief variance \f$ \frac{1}{N-1}\cdot\sum\limits_{i=1}^{N}(Y_i-\overline{Y})^2 \f$ (0 if less than 2 pairs were accumulated) */
+        double varianceY() const;
+        /** \brief covariance \f$ \frac{1}{N-1}\cdot\sum\limits_{i=1}^{N}(X_i-\overline{X})(Y_i-\overline{Y}) \f$ (0 if less than 2 pairs were accumulated) */
+        double covariance() const;
+        /** \brief Pearson's correlation coefficient \f$ \rho_{x,y} \f$ (NAN if empty), see jkqtpstatCorrelationCoefficient() */
+        double correlationCoefficient() const;
+    private:
+        /** \brief number of valid value pairs */
+        size_t m_N;
+        /** \brief number of processed value pairs */
+        size_t m_processed;
+        /** \brief running average of \f$ X_i \f$ */
+        double m_meanX;
+        /** \brief running average of \f$ Y_i \f$ */
+        double m_meanY;
+        /** \brief \f$ \sum_i(x_i-\overline{x})^2 \f$ */
+        double m_M2X;
+        /** \brief \f$ \sum_i(y_i-\overline{y})^2 \f$ */
+        double m_M2Y;
+        /** \brief \f$ \sum_i(x_i-\overline{x})(y_i-\overline{y}) \f$ */
+        double m_C;
+};
+
+
+
+
 
 
 
@@ -461,7 +679,8 @@ inline size_t jkqtpstatFilterGoodFloat(InputIt first, InputIt last, OutputIt out
             If the given range \a first ... \a last is empty, 0 is returned
 
     This function implements:
-      \f[ \sigma_X^2=\text{Var}(X)=\frac{1}{N-1}\cdot\sum\limits_{i=1}^{N}(X_i-\overline{X})^2=\frac{1}{N-1}\cdot\left(\sum_{i=1}^NX_i^2-\frac{1}{N}\cdot\left(\sum_{i=1}^NX_i\right)^2\right) \f]
+      \f[ \sigma_X^2=\text{Var}(X)=\frac{1}{N-1}\cdot\sum\limits_{i=1}^{N}(X_i-\overline{X})^2 \f]
+    in a single pass over the data, using JKQTPStatMomentsAccumulator.
 
     \note Each value is the specified range is converted to a double using jkqtp_todouble().
           Entries in the range that are invalid double (using JKQTPIsOKFloat() )
@@ -469,24 +688,11 @@ inline size_t jkqtpstatFilterGoodFloat(InputIt first, InputIt last, OutputIt out
 */
 template <class InputIt>
 inline double jkqtpstatVariance(InputIt first, InputIt last, double* averageOut=nullptr, size_t* Noutput=nullptr) {
-    double sum=0;
-    double sum2=0;
-    size_t NN=0;
-    for (auto it=first; it!=last; ++it) {
-        const double v=jkqtp_todouble(*it);
-        if (JKQTPIsOKFloat(v)) {
-            sum=sum+v;
-            sum2=sum2+v*v;
-            NN++;
-        }
-    }
-    if (averageOut) {
-        if (NN<=0) *averageOut=JKQTP_DOUBLE_NAN;
-        else *averageOut=sum/static_cast<double>(NN);
-    }
-    if (Noutput) *Noutput=NN;
-    if (NN<=1) return 0;
-    else return ( sum2 - sum*sum/static_cast<double>(NN) ) / static_cast<double>(NN-1);
+    JKQTPStatMomentsAccumulator acc;
+    acc.addRange(first, last);
+    if (averageOut) *averageOut=acc.average();
+    if (Noutput) *Noutput=acc.count();
+    return acc.variance();
 }
 
 
@@ -602,8 +808,8 @@ inline double jkqtpstatWeightedStdDev(InputIt first, InputIt last, InputWeightIt
 
     This function implements:
       \f[ \gamma_1=\mathbb{E}\left[\left(\frac{X-\mu}{\sigma}\right)^3\right]= \frac{m_3}{m_2^{3/2}}  = \frac{\frac{1}{n} \sum_{i=1}^n (x_i-\overline{x})^3}{\left(\frac{1}{n} \sum_{i=1}^n (x_i-\overline{x})^2\right)^{3/2}} \f]
-    where \f$\mu\f$ is the mean and \f$\sigma\f$ the standard deviation of a random variable \f$X\f$ and \f$\overline{x}\f$ is the average (calculated using jkqtpstatAverage() ) of
-    the input dataset \f$ x_i\f$.
+    where \f$\mu\f$ is the mean and \f$\sigma\f$ the standard deviation of a random variable \f$X\f$ and \f$\overline{x}\f$ is the average of
+    the input dataset \f$ x_i\f$. The moments are calculated in a single pass over the data, using JKQTPStatMomentsAccumulator.
 
     \note Each value is the specified range is converted to a double using jkqtp_todouble().
           Entries in the range that are invalid double (using JKQTPIsOKFloat() )
@@ -611,23 +817,11 @@ inline double jkqtpstatWeightedStdDev(InputIt first, InputIt last, InputWeightIt
 */
 template <class InputIt>
 inline double jkqtpstatSkewness(InputIt first, InputIt last, double* averageOut=nullptr, size_t* Noutput=nullptr) {
-    double avg=jkqtpstatAverage(first, last);
-    double sum3=0;
-    double sum2=0;
-    size_t NN=0;
-    for (auto it=first; it!=last; ++it) {
-        const double v=jkqtp_todouble(*it)-avg;
-        if (JKQTPIsOKFloat(v)) {
-            sum3=sum3+jkqtp_cube(v);
-            sum2=sum2+jkqtp_sqr(v);
-            NN++;
-        }
-    }
-    if (averageOut) *averageOut=avg;
-    if (Noutput) *Noutput=NN;
-    if (NN<=0) return 0;
-    const double down=jkqtp_cube(sum2/double(NN));
-    return sum3/double(NN)/sqrt(down);
+    JKQTPStatMomentsAccumulator acc;
+    acc.addRange(first, last);
+    if (averageOut) *averageOut=acc.average();
+    if (Noutput) *Noutput=acc.count();
+    return acc.skewness();
 }
 
 
@@ -730,6 +924,7 @@ inline double jkqtpstatMoment(InputIt first, InputIt last, int order, size_t* No
 
     This function implements:
         \f[ \rho_{x,y}=\text{CorCoeff}_{\text{Pearson}}(x,y)=\frac{\sum\limits_{i=0}^{N-1}(x_i-\overline{x})(y_i-\overline{y})}{\sqrt{\sum\limits_{i=0}^{N-1}(x_i-\overline{x})^2\cdot\sum\limits_{i=0}^{N-1}(y_i-\overline{y})^2}} \f]
+    in a single pass over the data, using JKQTPStatCorrelationAccumulator.
 
     \note Each value is the specified range is converted to a double using jkqtp_todouble().
           Entries in the range that are invalid double (using JKQTPIsOKFloat() )
@@ -739,51 +934,56 @@ inline double jkqtpstatMoment(InputIt first, InputIt last, int order, size_t* No
 */
 template <class InputIt1,class InputIt2>
 inline double jkqtpstatCorrelationCoefficient(InputIt1 first1, InputIt1 last1, InputIt2 first2, double* averageOut1=nullptr, double* averageOut2=nullptr, size_t* Noutput=nullptr) {
-    double xbar=0;
-    double ybar=0;
-    size_t NN=0;
-    auto it2=first2;
-    for (auto it=first1; it!=last1; ++it,++it2) {
-        const double xm=jkqtp_todouble(*it);
-        const double ym=jkqtp_todouble(*it2);
-        if (JKQTPIsOKFloat(xm) && JKQTPIsOKFloat(ym)) {
-            xbar=xbar+xm;
-            ybar=ybar+ym;
-            NN++;
-        }
-    }
-    if (Noutput) *Noutput=NN;
-    if (averageOut1) {
-        if (NN<=0) *averageOut1=JKQTP_DOUBLE_NAN;
-        else *averageOut1=xbar/static_cast<double>(NN);
-    }
-    if (averageOut2) {
-        if (NN<=0) *averageOut2=JKQTP_DOUBLE_NAN;
-        else *averageOut2=ybar/static_cast<double>(NN);
-    }
-    if (NN<=0) return JKQTP_DOUBLE_NAN;
-
-    xbar=xbar/NN;
-    ybar=ybar/NN;
-    double sumxy=0;
-    double sumx=0;
-    double sumy=0;
-    it2=first2;
-    for (auto it=first1; it!=last1; ++it,++it2) {
-        const double xm=jkqtp_todouble(*it);
-        const double ym=jkqtp_todouble(*it2);
-        if (JKQTPIsOKFloat(xm) && JKQTPIsOKFloat(ym)) {
-            sumxy=sumxy+xm*ym;
-            sumx=sumx+xm*xm;
-            sumy=sumy+ym*ym;
-        }
-    }
-    return sumxy/sqrt(sumx*sumy);
+    JKQTPStatCorrelationAccumulator acc;
+    acc.addRange(first1, last1, first2);
+    if (Noutput) *Noutput=acc.count();
+    if (averageOut1) *averageOut1=acc.averageX();
+    if (averageOut2) *averageOut2=acc.averageY();
+    return acc.correlationCoefficient();
 }
 
 
 
 
+/*! \brief partially sorts the range \a first ... \a last , so that the elements at the (zero-based) positions \a ranks are the same as in the fully sorted range (multi-quantile selection)
+    \ingroup jkqtptools_math_statistics_basic
+
+    \tparam RandomIt random-access iterator type of \a first and \a last
+    \param first iterator pointing to the first item in the range
+    \param last iterator pointing behind the last item in the range
+    \param ranks positions in the sorted range that should be selected (may be unsorted and contain duplicates, positions outside the range are ignored)
+
+    After this call, for each selected position \c k all elements before \c first+k are \c <= \c first[k] and all elements after it are \c >= \c first[k] .
+    The range is split recursively at the median rank with std::nth_element(), which requires expected \f$ \mathcal{O}(N\log(\text{ranks.size()})) \f$
+    operations instead of \f$ \mathcal{O}(N\log N) \f$ for sorting the range.
+
+    \see jkqtpstat5NumberStatistics(), jkqtpstatMedian(), jkqtpstatQuantile()
+*/
+template <class RandomIt>
+inline void jkqtpstatSelectOrderStatistics(RandomIt first, RandomIt last, std::vector<size_t> ranks) {
+    const size_t N=static_cast<size_t>(std::distance(first, last));
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+    ranks.erase(std::lower_bound(ranks.begin(), ranks.end(), N), ranks.end());
+    // each entry selects the ranks [rFirst,rLast) within the positions [lo,hi)
+    struct Block {
+        size_t lo, hi, rFirst, rLast;
+    };
+    std::vector<Block> todo;
+    todo.push_back(Block{0, N, 0, ranks.size()});
+    while (todo.size()>0) {
+        const Block b=todo.back();
+        todo.pop_back();
+        if (b.rFirst>=b.rLast || b.hi-b.lo<=1) continue;
+        const size_t rMid=b.rFirst+(b.rLast-b.rFirst)/2;
+        const size_t k=ranks[rMid];
+        std::nth_element(first+static_cast<std::ptrdiff_t>(b.lo), first+static_cast<std::ptrdiff_t>(k), first+static_cast<std::ptrdiff_t>(b.hi));
+        todo.push_back(Block{b.lo, k, b.rFirst, rMid});
+        todo.push_back(Block{k+1, b.hi, rMid+1, b.rLast});
+    }
+}
+
+
 /*! \brief calculates the median of a given sorted (!) data vector
     \ingroup jkqtptools_math_statistics_basic
 
@@ -942,6 +1142,24 @@ inline void jkqtpstat5NumberStatisticsAndOutliersOfSortedVector(const TVector& d
 
 
 
+/*! \brief returns the positions in a sorted vector of size \a N , which are read by jkqtpstat5NumberStatisticsOfSortedVector() (for use with jkqtpstatSelectOrderStatistics() )
+    \ingroup jkqtptools_math_statistics_basic
+*/
+inline std::vector<size_t> jkqtpstat5NumberStatisticsRanks(size_t N, double minimumQuantile, double maximumQuantile, double quantile1Spec, double quantile2Spec) {
+    std::vector<size_t> ranks;
+    if (N>0) {
+        const auto quantileRank=[N](double q) { return jkqtp_bounded<size_t>(0, static_cast<size_t>(q*static_cast<double>(N-1)), N-1); };
+        ranks.push_back(quantileRank(minimumQuantile));
+        ranks.push_back(quantileRank(maximumQuantile));
+        ranks.push_back(quantileRank(quantile1Spec));
+        ranks.push_back(quantileRank(quantile2Spec));
+        ranks.push_back((N-1)/2);
+        if (N%2==0) ranks.push_back((N-1)/2+1);
+    }
+    return ranks;
+}
+
+
 /*! \brief calculates the Five-Number Statistical Summary (minimum, median, maximum and two user-defined quantiles (as well as derived from these the inter quartile range)) of a given data range \a first ... \a last (5-value statistics, e.g. used for boxplots)
     \ingroup jkqtptools_math_statistics_basic
 
@@ -961,7 +1179,7 @@ inline void jkqtpstat5NumberStatisticsAndOutliersOfSortedVector(const TVector& d
     \param[out] IQRSignificance significance range of the interquartile range, calculated as \f[ 2\cdot\frac{1.58\cdot \mbox{IQR}}{\sqrt{N}} \f] \see https://en.wikipedia.org/wiki/Box_plot
     \param[out] Noutput optionally returns the number of accumulated valid values in this variable
 
-    \note This operation implies an internal copy of the data, as well as sorting it!
+    \note This operation implies an internal copy of the data. The required order statistics are selected in expected \f$ \mathcal{O}(N) \f$ (see jkqtpstatSelectOrderStatistics() ), without sorting the data completely.
 
     \note Each value is the specified range is converted to a double using jkqtp_todouble().
           Entries in the range that are invalid double (using JKQTPIsOKFloat() )
@@ -973,7 +1191,8 @@ template <class InputIt>
 inline void jkqtpstat5NumberStatistics(InputIt first, InputIt last, double* minimum, double minimumQuantile=0, double* median=nullptr, double* maximum=nullptr, double maximumQuantile=1, double quantile1Spec=0.25, double* quantile1=nullptr, double quantile2Spec=0.75, double* quantile2=nullptr, double* IQR=nullptr, double* IQRSignificance=nullptr, size_t* Noutput=nullptr) {
     std::vector<double> dataFiltered;
     jkqtpstatFilterGoodFloat(first, last, std::back_inserter(dataFiltered));
-    std::sort(dataFiltered.begin(), dataFiltered.end());
+    // only the positions read by jkqtpstat5NumberStatisticsOfSortedVector() have to be sorted
+    jkqtpstatSelectOrderStatistics(dataFiltered.begin(), dataFiltered.end(), jkqtpstat5NumberStatisticsRanks(dataFiltered.size(), minimumQuantile, maximumQuantile, quantile1Spec, quantile2Spec));
     jkqtpstat5NumberStatisticsOfSortedVector(dataFiltered, minimum, minimumQuantile,  median,  maximum,  maximumQuantile, quantile1,  quantile1Spec,  quantile2,  quantile2Spec,  IQR,  IQRSignificance, Noutput);
 }
 
@@ -998,7 +1217,7 @@ inline void jkqtpstat5NumberStatistics(InputIt first, InputIt last, double* mini
     \param[out] IQRSignificance significance range of the interquartile range, calculated as \f[ 2\cdot\frac{1.58\cdot \mbox{IQR}}{\sqrt{N}} \f] \see https://en.wikipedia.org/wiki/Box_plot
     \param[out] Noutput optionally returns the number of accumulated valid values in this variable
 
-    \note This operation implies an internal copy of the data, as well as sorting it!
+    \note This operation implies an internal copy of the data. The required order statistics are selected in expected \f$ \mathcal{O}(N) \f$ (see jkqtpstatSelectOrderStatistics() ), only the outliers are sorted.
 
     \note Each value is the specified range is converted to a double using jkqtp_todouble().
           Entries in the range that are invalid double (using JKQTPIsOKFloat() )
@@ -1010,7 +1229,16 @@ template <class InputIt, class OutputIt>
 inline void jkqtpstat5NumberStatisticsAndOutliers(InputIt first, InputIt last, OutputIt outliersout, double* minimum=nullptr, double minimumQuantile=0, double* median=nullptr, double* maximum=nullptr, double maximumQuantile=1, double* quantile1=nullptr, double quantile1Spec=0.25, double* quantile2=nullptr, double quantile2Spec=0.75, double* IQR=nullptr, double* IQRSignificance=nullptr, size_t* Noutput=nullptr) {
     std::vector<double> dataFiltered;
     jkqtpstatFilterGoodFloat(first, last, std::back_inserter(dataFiltered));
-    std::sort(dataFiltered.begin(), dataFiltered.end());
+    const size_t N=dataFiltered.size();
+    if (N>0) {
+        // only the positions read by jkqtpstat5NumberStatisticsAndOutliersOfSortedVector() have to be sorted ...
+        jkqtpstatSelectOrderStatistics(dataFiltered.begin(), dataFiltered.end(), jkqtpstat5NumberStatisticsRanks(N, minimumQuantile, maximumQuantile, quantile1Spec, quantile2Spec));
+        // ... and the outliers (which are all below the minimum and above the maximum position), so they are output in ascending order
+        const size_t iMin=jkqtp_bounded<size_t>(0, static_cast<size_t>(minimumQuantile*static_cast<double>(N-1)), N-1);
+        const size_t iMax=jkqtp_bounded<size_t>(0, static_cast<size_t>(maximumQuantile*static_cast<double>(N-1)), N-1);
+        std::sort(dataFiltered.begin(), dataFiltered.begin()+static_cast<std::ptrdiff_t>(std::min(iMin, iMax)));
+        std::sort(dataFiltered.begin()+static_cast<std::ptrdiff_t>(std::max(iMin, iMax))+1, dataFiltered.end());
+    }
     jkqtpstat5NumberStatisticsAndOutliersOfSortedVector(dataFiltered, outliersout, minimum, minimumQuantile,  median,  maximum,  maximumQuantile, quantile1,  quantile1Spec,  quantile2,  quantile2Spec,  IQR,  IQRSignificance, Noutput);
 }
 
@@ -1061,7 +1289,7 @@ struct JKQTCOMMON_LIB_EXPORT JKQTPStat5NumberStatistics {
     \param maximumQuantile specifies a quantile for the return value maximum (default is 1 for the real maximum, but you could e.g. use 0.95 for the 95% quantile!)
     \return the Five-Number Statistical Summary in a JKQTPStat5NumberStatistics
 
-    \note This operation implies an internal copy of the data, as well as sorting it!
+    \note This operation implies an internal copy of the data. The required order statistics are selected in expected \f$ \mathcal{O}(N) \f$ (see jkqtpstatSelectOrderStatistics() ), only the outliers are sorted.
 
     \note Each value is the specified range is converted to a double using jkqtp_todouble().
           Entries in the range that are invalid double (using JKQTPIsOKFloat() )
@@ -1087,7 +1315,7 @@ inline JKQTPStat5NumberStatistics jkqtpstat5NumberStatistics(InputIt first, Inpu
     \return the median of the data returned between \a first and \a last (excluding invalid doubles).
             If the given range \a first ... \a last is empty, NAN is returned
 
-    \note This operation implies an internal copy of the data, as well as sorting it!
+    \note This operation implies an internal copy of the data. The required order statistics are selected in expected \f$ \mathcal{O}(N) \f$ (see jkqtpstatSelectOrderStatistics() ), without sorting the data completely.
 
     \note Each value is the specified range is converted to a double using jkqtp_todouble().
           Entries in the range that are invalid double (using JKQTPIsOKFloat() )
@@ -1097,7 +1325,10 @@ template <class InputIt>
 inline double jkqtpstatMedian(InputIt first, InputIt last, size_t* Noutput=nullptr) {
     std::vector<double> dataFiltered;
     jkqtpstatFilterGoodFloat(first, last, std::back_inserter(dataFiltered));
-    std::sort(dataFiltered.begin(), dataFiltered.end());
+    const size_t N=dataFiltered.size();
+    if (N>1) {
+        jkqtpstatSelectOrderStatistics(dataFiltered.begin(), dataFiltered.end(), (N%2==0)?std::vector<size_t>{(N-1)/2, (N-1)/2+1}:std::vector<size_t>{(N-1)/2});
+    }
     return jkqtpstatMedianOfSortedVector(dataFiltered, Noutput);
 }
 
@@ -1113,7 +1344,7 @@ inline double jkqtpstatMedian(InputIt first, InputIt last, size_t* Noutput=nullp
     \return the \a quantile -th quantile of the data returned between \a first and \a last (excluding invalid doubles).
             If the given range \a first ... \a last is empty, NAN is returned
 
-    \note This operation implies an internal copy of the data, as well as sorting it!
+    \note This operation implies an internal copy of the data. The required order statistics are selected in expected \f$ \mathcal{O}(N) \f$ (see jkqtpstatSelectOrderStatistics() ), without sorting the data completely.
 
     \note Each value is the specified range is converted to a double using jkqtp_todouble().
           Entries in the range that are invalid double (using JKQTPIsOKFloat() )
@@ -1123,13 +1354,14 @@ template <class InputIt>
 inline double jkqtpstatQuantile(InputIt first, InputIt last, double quantile, size_t* Noutput=nullptr) {
     std::vector<double> dataFiltered;
     jkqtpstatFilterGoodFloat(first, last, std::back_inserter(dataFiltered));
-    std::sort(dataFiltered.begin(), dataFiltered.end());
     if (dataFiltered.size()<=0) {
         if (Noutput) *Noutput=0;
         return JKQTP_DOUBLE_NAN;
     } else {
         if (Noutput) *Noutput=dataFiltered.size();
-        return dataFiltered[jkqtp_bounded<size_t>(0, static_cast<size_t>(quantile*static_cast<double>(dataFiltered.size()-1)), dataFiltered.size()-1)];
+        const auto it=dataFiltered.begin()+static_cast<std::ptrdiff_t>(jkqtp_bounded<size_t>(0, static_cast<size_t>(quantile*static_cast<double>(dataFiltered.size()-1)), dataFiltered.size()-1));
+        std::nth_element(dataFiltered.begin(), it, dataFiltered.end());
+        return *it;
     }
 }
 
@@ -1150,7 +1382,7 @@ inline double jkqtpstatQuantile(InputIt first, InputIt last, double quantile, si
       \f[ \mbox{MAD}(\vec{x})=\mbox{Med}\left\{|\vec{x}-\mbox{Med}(\vec{x})|\right\} \f]
 
 
-    \note This operation implies an internal copy of the data, as well as sorting it!
+    \note This operation implies an internal copy of the data. The required order statistics are selected in expected \f$ \mathcal{O}(N) \f$ (see jkqtpstatSelectOrderStatistics() ), without sorting the data completely.
 
     \note Each value is the specified range is converted to a double using jkqtp_todouble().
           Entries in the range that are invalid double (using JKQTPIsOKFloat() )
@@ -1162,19 +1394,21 @@ template <class InputIt>
 inline double jkqtpstatMAD(InputIt first, InputIt last, double* median=nullptr, size_t* Noutput=nullptr) {
     std::vector<double> dataFiltered;
     jkqtpstatFilterGoodFloat(first, last, std::back_inserter(dataFiltered));
-    std::sort(dataFiltered.begin(), dataFiltered.end());
     if (dataFiltered.size()<=0) {
         if (Noutput) *Noutput=0;
         if (median) *median=JKQTP_DOUBLE_NAN;
         return JKQTP_DOUBLE_NAN;
     } else {
-        if (Noutput) *Noutput=dataFiltered.size();
+        const size_t N=dataFiltered.size();
+        if (Noutput) *Noutput=N;
+        const std::vector<size_t> medianRanks=(N%2==0)?std::vector<size_t>{(N-1)/2, (N-1)/2+1}:std::vector<size_t>{(N-1)/2};
+        jkqtpstatSelectOrderStatistics(dataFiltered.begin(), dataFiltered.end(), medianRanks);
         double med=jkqtpstatMedianOfSortedVector(dataFiltered);
         if (median) *median=med;
         for(double& v: dataFiltered) {
             v=fabs(v-med);
         }
-        std::sort(dataFiltered.begin(), dataFiltered.end());
+        jkqtpstatSelectOrderStatistics(dataFiltered.begin(), dataFiltered.end(), medianRanks);
         return jkqtpstatMedianOfSortedVector(dataFiltered);
     }
 }
@@ -1196,7 +1430,7 @@ inline double jkqtpstatMAD(InputIt first, InputIt last, double* median=nullptr,
       \f[ \mbox{NMAD}(\vec{x})=\frac{\mbox{MAD}(\vec{x})}{0.6745}=\frac{\mbox{Med}\left\{|\vec{x}-\mbox{Med}(\vec{x})|\right\}}{0.6745} \f]
 
 
-    \note This operation implies an internal copy of the data, as well as sorting it!
+    \note This operation implies an internal copy of the data. The required order statistics are selected in expected \f$ \mathcal{O}(N) \f$ (see jkqtpstatSelectOrderStatistics() ), without sorting the data completely.
 
     \note Each value is the specified range is converted to a double using jkqtp_todouble().
           Entries in the range that are invalid double (using JKQTPIsOKFloat() )
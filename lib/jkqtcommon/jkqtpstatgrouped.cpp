@@ -38,3 +38,34 @@ JKQTPStatGroupDefinitionFunctor1D jkqtpstatMakeGroupingCustomRound1D(double firs
 {
     return std::bind(&jkqtpstatGroupingCustomRound1D, std::placeholders::_1, firstGroupCenter, groupWidth);
 }
+
+
+const size_t JKQTPStatGroupIndexHash::s_empty=std::numeric_limits<size_t>::max();
+
+JKQTPStatGroupIndexHash::JKQTPStatGroupIndexHash():
+    m_keys(64, 0.0),
+    m_indices(64, s_empty),
+    m_mask(63),
+    m_size(0)
+{
+
+}
+
+void JKQTPStatGroupIndexHash::rehash(size_t newCapacity)
+{
+    std::vector<double> oldKeys;
+    std::vector<size_t> oldIndices;
+    oldKeys.swap(m_keys);
+    oldIndices.swap(m_indices);
+    m_keys.assign(newCapacity, 0.0);
+    m_indices.assign(newCapacity, s_empty);
+    m_mask=newCapacity-1;
+    for (size_t i=0; i<oldKeys.size(); i++) {
+        if (oldIndices[i]!=s_empty) {
+            size_t pos=hashKey(oldKeys[i])&m_mask;
+            while (m_indices[pos]!=s_empty) pos=(pos+1)&m_mask;
+            m_keys[pos]=oldKeys[i];
+            m_indices[pos]=oldIndices[i];
+        }
+    }
+}
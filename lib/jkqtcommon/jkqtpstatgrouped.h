@@ -39,6 +39,10 @@
 #include "jkqtcommon/jkqtparraytools.h"
 #include "jkqtcommon/jkqtpdebuggingtools.h"
 #include "jkqtcommon/jkqtpstatbasics.h"
+#include <algorithm>
+#include <numeric>
+#include <map>
+#include <functional>
 
 /*! \brief a functor \f$ f(x): \mathbb{R}\rightarrow\mathbb{R} \f$ which assignes a value \f$ x \f$ to a group center \f$ f(x) \f$
     \ingroup jkqtptools_math_statistics_grouped
@@ -102,7 +106,7 @@ JKQTCOMMON_LIB_EXPORT JKQTPStatGroupDefinitionFunctor1D jkqtpstatMakeGroupingCus
 
     \note the contents of \a groupeddata is not cleared before usage, so you can also use this fucntion to append to a group!
 
-    \see JKQTPStatGroupDefinitionFunctor1D, \ref JKQTPlotterBasicJKQTPDatastoreStatisticsGroupedStat
+    \see jkqtpstatGroupDataCSR() for a faster variant for large datasets, JKQTPStatGroupDefinitionFunctor1D, \ref JKQTPlotterBasicJKQTPDatastoreStatisticsGroupedStat
 */
 template <class InputCatIt, class InputValueIt>
 inline void jkqtpstatGroupData(InputCatIt inFirstCat, InputCatIt inLastCat, InputValueIt inFirstValue, InputValueIt inLastValue, std::map<double, std::vector<double> >& groupeddata, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D) {
@@ -136,7 +140,7 @@ inline void jkqtpstatGroupData(InputCatIt inFirstCat, InputCatIt inLastCat, Inpu
 
     \note the contents of \a groupeddata is not cleared before usage, so you can also use this fucntion to append to a group!
 
-    \see JKQTPStatGroupDefinitionFunctor1D, \ref JKQTPlotterBasicJKQTPDatastoreStatisticsGroupedStat
+    \see jkqtpstatGroupDataCSR() for a faster variant for large datasets, JKQTPStatGroupDefinitionFunctor1D, \ref JKQTPlotterBasicJKQTPDatastoreStatisticsGroupedStat
 */
 template <class InputCatIt, class InputValueIt, class OutputGroupIt>
 inline void jkqtpstatGroupData(InputCatIt inFirstCat, InputCatIt inLastCat, InputValueIt inFirstValue, InputValueIt inLastValue, OutputGroupIt outFirstCategory, std::map<double, std::vector<double> >& groupeddata, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D) {
@@ -174,7 +178,7 @@ inline void jkqtpstatGroupData(InputCatIt inFirstCat, InputCatIt inLastCat, Inpu
 
     \note the contents of \a groupeddata is not cleared before usage, so you can also use this fucntion to append to a group!
 
-    \see JKQTPStatGroupDefinitionFunctor1D, \ref JKQTPlotterBasicJKQTPDatastoreStatisticsGroupedStat
+    \see jkqtpstatGroupDataCSR() for a faster variant for large datasets, JKQTPStatGroupDefinitionFunctor1D, \ref JKQTPlotterBasicJKQTPDatastoreStatisticsGroupedStat
 */
 template <class InputCatIt, class InputValueIt>
 inline void jkqtpstatGroupData(InputCatIt inFirstCat, InputCatIt inLastCat, InputValueIt inFirstValue, InputValueIt inLastValue, std::map<double, std::pair<std::vector<double>,std::vector<double> > >& groupeddata, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D) {
@@ -210,7 +214,7 @@ inline void jkqtpstatGroupData(InputCatIt inFirstCat, InputCatIt inLastCat, Inpu
 
     \note the contents of \a groupeddata is not cleared before usage, so you can also use this fucntion to append to a group!
 
-    \see JKQTPStatGroupDefinitionFunctor1D, \ref JKQTPlotterBasicJKQTPDatastoreStatisticsGroupedStat
+    \see jkqtpstatGroupDataCSR() for a faster variant for large datasets, JKQTPStatGroupDefinitionFunctor1D, \ref JKQTPlotterBasicJKQTPDatastoreStatisticsGroupedStat
 */
 template <class InputCatIt, class InputValueIt, class OutputGroupIt>
 inline void jkqtpstatGroupData(InputCatIt inFirstCat, InputCatIt inLastCat, InputValueIt inFirstValue, InputValueIt inLastValue, OutputGroupIt outFirstCategory, std::map<double, std::pair<std::vector<double>,std::vector<double> > >& groupeddata, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D) {
@@ -232,6 +236,169 @@ inline void jkqtpstatGroupData(InputCatIt inFirstCat, InputCatIt inLastCat, Inpu
     }
 }
 
+
+
+/*! \brief grouped data, as returned by jkqtpstatGroupDataCSR(): the values of all groups are stored in one contiguous buffer, the groups are defined by offsets into this buffer (compressed sparse row layout)
+    \ingroup jkqtptools_math_statistics_grouped
+
+    The values of group \c g (with ID \c groups[g] ) are \c values[offsets[g]] ... \c values[offsets[g+1]-1] , use valuesBegin() and valuesEnd()
+    to access them as a range. The groups are sorted by their ID (like the keys of the \c std::map in jkqtpstatGroupData() ) and the values
+    in each group are in the order of the input data.
+
+    \see jkqtpstatGroupDataCSR()
+*/
+struct JKQTCOMMON_LIB_EXPORT JKQTPStatGroupedData {
+        /** \brief sorted list of the group IDs \f$ c_{\text{out},j} \f$ */
+        std::vector<double> groups;
+        /** \brief for each group the index of its first value in values (and categories), contains one more entry than groups, the last one is \c values.size() */
+        std::vector<size_t> offsets;
+        /** \brief values \f$ v_i \f$ of all groups */
+        std::vector<double> values;
+        /** \brief category values \f$ c_i \f$ of all groups, in the same layout as values (only filled, if requested from jkqtpstatGroupDataCSR() ) */
+        std::vector<double> categories;
+
+        /** \brief number of groups */
+        inline size_t groupCount() const { return groups.size(); }
+        /** \brief number of values in group \a g */
+        inline size_t groupSize(size_t g) const { return offsets[g+1]-offsets[g]; }
+        /** \brief pointer to the first value in group \a g */
+        inline const double* valuesBegin(size_t g) const { return values.data()+offsets[g]; }
+        /** \brief pointer behind the last value in group \a g */
+        inline const double* valuesEnd(size_t g) const { return values.data()+offsets[g+1]; }
+        /** \brief pointer to the first category value in group \a g (only valid, if categories were stored) */
+        inline const double* categoriesBegin(size_t g) const { return categories.data()+offsets[g]; }
+        /** \brief pointer behind the last category value in group \a g (only valid, if categories were stored) */
+        inline const double* categoriesEnd(size_t g) const { return categories.data()+offsets[g+1]; }
+        /** \brief removes all groups */
+        inline void clear() { groups.clear(); offsets.clear(); values.clear(); categories.clear(); }
+};
+
+/*! \brief flat hash table (open addressing with linear probing) that maps group IDs to consecutive indices, used by jkqtpstatGroupDataCSR()
+    \ingroup jkqtptools_math_statistics_grouped
+    \internal
+
+    All keys are stored in one contiguous array, so a lookup typically touches a single cache line, in contrast to the
+    node-based \c std::map or \c std::unordered_map . \c -0.0 and \c +0.0 are treated as the same key (as in \c std::map ).
+*/
+class JKQTCOMMON_LIB_EXPORT JKQTPStatGroupIndexHash {
+    public:
+        JKQTPStatGroupIndexHash();
+        /** \brief returns the index stored for \a key , if \a key is not yet in the table, it is inserted with the index \a newIndex (which is then returned) */
+        inline size_t findOrInsert(double key, size_t newIndex) {
+            if (key==0.0) key=0.0;
+            size_t pos=hashKey(key)&m_mask;
+            while (m_indices[pos]!=s_empty) {
+                if (m_keys[pos]==key) return m_indices[pos];
+                pos=(pos+1)&m_mask;
+            }
+            m_keys[pos]=key;
+            m_indices[pos]=newIndex;
+            m_size++;
+            if (2*m_size>m_keys.size()) rehash(2*m_keys.size());
+            return newIndex;
+        }
+    private:
+        /** \brief marks an empty slot in m_indices */
+        static const size_t s_empty;
+        /** \brief hash function for the bit pattern of \a key */
+        static inline size_t hashKey(double key) {
+            uint64_t bits=0;
+            memcpy(&bits, &key, sizeof(bits));
+            bits^=bits>>33;
+            bits*=UINT64_C(0xff51afd7ed558ccd);
+            bits^=bits>>33;
+            return static_cast<size_t>(bits);
+        }
+        /** \brief resizes the table to \a newCapacity slots (a power of 2) */
+        void rehash(size_t newCapacity);
+        /** \brief keys in the table */
+        std::vector<double> m_keys;
+        /** \brief index stored for each slot, or s_empty */
+        std::vector<size_t> m_indices;
+        /** \brief m_keys.size()-1 */
+        size_t m_mask;
+        /** \brief number of used slots */
+        size_t m_size;
+};
+
+/*! \brief groups data from an input range \a inFirstCat / \a inFirstValue ...  \a inLastCat / \a outFirstCat representing pairs \f$ (c_i,v_i) \f$ of a
+           category value \f$ c_i \f$ and a group value \f$ v_i \f$ into groups \f$ V_j=\{v_{i}|c_i\equiv c_{\text{out},j}\} \f$ of data that were assigned
+           to the same group, i.e. \f$ c_i\equiv c_{\text{out},j} \f$ . A functor \a groupDefFunc assigns a group \f$ c_{\text{out},j} \f$ to each category value \f$ c_i \f$ .
+           The result is stored in a contiguous JKQTPStatGroupedData .
+    \ingroup jkqtptools_math_statistics_grouped
+
+    \tparam InputCatIt standard iterator type of \a inFirstCat and \a inLastCat
+    \tparam InputValueIt standard iterator type of \a inFirstValue and \a inLastValue
+    \param inFirstCat iterator pointing to the first item in the category dataset to use \f$ c_1 \f$
+    \param inLastCat iterator pointing behind the last item in the category dataset to use \f$ c_N \f$
+    \param inFirstValue iterator pointing to the first item in the category dataset to use \f$ v_1 \f$
+    \param inLastValue iterator pointing behind the last item in the category dataset to use \f$ v_N \f$
+    \param[out] groupeddata receives the grouped data (its previous contents is replaced)
+    \param groupDefFunc assigns a group \f$ c_{\text{out},j} \f$ to each category value \f$ c_i \f$ .
+    \param storeCategories if \c true, also the category values \f$ c_i \f$ are stored in JKQTPStatGroupedData::categories
+
+    In contrast to jkqtpstatGroupData(), which appends each value to a \c std::vector in a \c std::map , this function
+    looks up the group of each value in a flat hash table (JKQTPStatGroupIndexHash), counts the values per group and then scatters all values into
+    one buffer, which is allocated only once. This is considerably faster for large datasets with many groups.
+
+    \see JKQTPStatGroupedData, JKQTPStatGroupDefinitionFunctor1D, \ref JKQTPlotterBasicJKQTPDatastoreStatisticsGroupedStat
+*/
+template <class InputCatIt, class InputValueIt>
+inline void jkqtpstatGroupDataCSR(InputCatIt inFirstCat, InputCatIt inLastCat, InputValueIt inFirstValue, InputValueIt inLastValue, JKQTPStatGroupedData& groupeddata, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D, bool storeCategories=false) {
+    groupeddata.clear();
+    // 1. pass: assign each valid pair to a group (in order of appearance) and count the values per group
+    JKQTPStatGroupIndexHash groupIndex;
+    std::vector<double> groupIDs;
+    std::vector<size_t> groupCounts;
+    std::vector<size_t> rowGroup;
+    std::vector<double> rowValue;
+    std::vector<double> rowCat;
+    auto inCat=inFirstCat;
+    auto inVal=inFirstValue;
+    for (; inCat!=inLastCat && inVal!=inLastValue; ++inCat, ++inVal) {
+        const double c=jkqtp_todouble(*inCat);
+        const double v=jkqtp_todouble(*inVal);
+        if (JKQTPIsOKFloat(c) && JKQTPIsOKFloat(v)) {
+            const double g=groupDefFunc(c);
+            const size_t gi=groupIndex.findOrInsert(g, groupIDs.size());
+            if (gi==groupIDs.size()) {
+                groupIDs.push_back(g);
+                groupCounts.push_back(0);
+            }
+            groupCounts[gi]++;
+            rowGroup.push_back(gi);
+            rowValue.push_back(v);
+            if (storeCategories) rowCat.push_back(c);
+        }
+    }
+
+    // 2. sort the groups by their ID and calculate the offsets
+    const size_t G=groupIDs.size();
+    std::vector<size_t> order(G);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&groupIDs](size_t a, size_t b) { return groupIDs[a]<groupIDs[b]; });
+    groupeddata.groups.resize(G);
+    groupeddata.offsets.resize(G+1);
+    std::vector<size_t> cursor(G);
+    size_t offset=0;
+    for (size_t i=0; i<G; i++) {
+        groupeddata.groups[i]=groupIDs[order[i]];
+        groupeddata.offsets[i]=offset;
+        cursor[order[i]]=offset;
+        offset+=groupCounts[order[i]];
+    }
+    groupeddata.offsets[G]=offset;
+
+    // 3. scatter the values into the contiguous buffer
+    groupeddata.values.resize(rowValue.size());
+    if (storeCategories) groupeddata.categories.resize(rowValue.size());
+    for (size_t i=0; i<rowValue.size(); i++) {
+        const size_t pos=cursor[rowGroup[i]]++;
+        groupeddata.values[pos]=rowValue[i];
+        if (storeCategories) groupeddata.categories[pos]=rowCat[i];
+    }
+}
+
 #endif // JKQTPSTATGROUPED_H_INCLUDED
 
 
@@ -39,6 +39,10 @@
 #include "jkqtcommon/jkqtparraytools.h"
 #include "jkqtcommon/jkqtpdebuggingtools.h"
 #include "jkqtcommon/jkqtpstatbasics.h"
+#include "jkqtcommon/jkqtpcodestructuring.h"
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
 
 
 
@@ -53,6 +57,265 @@ enum class JKQTPStatHistogramBinXMode {
     XIsRight /*!< \brief x-location is the right edge of the bin */
 };
 
+
+/*! \brief minimum number of values per thread, before jkqtpstatHistogramCount1D(), jkqtpstatHistogramCount1DEdges() and jkqtpstatHistogramCount2D() split their input range and use several threads
+    \ingroup jkqtptools_math_statistics_1dhist
+*/
+#define JKQTPSTATISTICS_HISTOGRAM_PARALLEL_MINCHUNK (1<<17)
+
+/*! \brief number of values that the histogram engine converts to \c double and maps to bin indices in one block, before incrementing the bins
+    \ingroup jkqtptools_math_statistics_1dhist
+*/
+#define JKQTPSTATISTICS_HISTOGRAM_BLOCKSIZE 256
+
+/*! \brief bins the values in \a first ... \a last (and \a firstY ... ) into the integer bins \a counts , using \a binIndex to map each value to a bin (serial engine)
+    \ingroup jkqtptools_math_statistics_1dhist
+    \internal
+
+    The values are processed in blocks of JKQTPSTATISTICS_HISTOGRAM_BLOCKSIZE: first all values of a block are read and converted
+    to \c double , then all bin indices of the block are calculated in a tight (auto-vectorizable) loop and only then
+    the bins are incremented. \a binIndex returns an index \c 0..nbins-1 for valid values and \c nbins for invalid values
+    (so invalid values are counted in an overflow bin instead of requiring a branch).
+*/
+template <class InputIt, class BinIndexFunctor>
+inline void jkqtpstatHistogramCountSerial(InputIt first, InputIt last, BinIndexFunctor binIndex, size_t* counts) {
+    double v[JKQTPSTATISTICS_HISTOGRAM_BLOCKSIZE];
+    size_t b[JKQTPSTATISTICS_HISTOGRAM_BLOCKSIZE];
+    auto it=first;
+    while (it!=last) {
+        size_t n=0;
+        for (; n<JKQTPSTATISTICS_HISTOGRAM_BLOCKSIZE && it!=last; ++n, ++it) v[n]=jkqtp_todouble(*it);
+        for (size_t i=0; i<n; i++) b[i]=binIndex(v[i]);
+        for (size_t i=0; i<n; i++) counts[b[i]]++;
+    }
+}
+
+/*! \copydoc jkqtpstatHistogramCountSerial() */
+template <class InputItX, class InputItY, class BinIndexFunctor>
+inline void jkqtpstatHistogramCountSerial(InputItX firstX, InputItX lastX, InputItY firstY, InputItY lastY, BinIndexFunctor binIndex, size_t* counts) {
+    double vx[JKQTPSTATISTICS_HISTOGRAM_BLOCKSIZE];
+    double vy[JKQTPSTATISTICS_HISTOGRAM_BLOCKSIZE];
+    size_t b[JKQTPSTATISTICS_HISTOGRAM_BLOCKSIZE];
+    auto itX=firstX;
+    auto itY=firstY;
+    while (itX!=lastX && itY!=lastY) {
+        size_t n=0;
+        for (; n<JKQTPSTATISTICS_HISTOGRAM_BLOCKSIZE && itX!=lastX && itY!=lastY; ++n, ++itX, ++itY) {
+            vx[n]=jkqtp_todouble(*itX);
+            vy[n]=jkqtp_todouble(*itY);
+        }
+        for (size_t i=0; i<n; i++) b[i]=binIndex(vx[i], vy[i]);
+        for (size_t i=0; i<n; i++) counts[b[i]]++;
+    }
+}
+
+/*! \brief number of chunks (threads), the histogram engine uses for \a N values and \a nbins bins
+    \ingroup jkqtptools_math_statistics_1dhist
+    \internal
+
+    Each chunk requires its own private set of \a nbins bins, so small datasets, or datasets with less than
+    about 4 values per bin in each chunk are processed in a single chunk.
+*/
+inline size_t jkqtpstatHistogramChunks(size_t N, size_t nbins) {
+    const size_t threads=static_cast<size_t>(std::max(1, jkqtpParallelThreadCount()));
+    const size_t chunks=std::min(threads, std::min(N/JKQTPSTATISTICS_HISTOGRAM_PARALLEL_MINCHUNK, N/std::max<size_t>(1, 4*nbins)));
+    return std::max<size_t>(1, chunks);
+}
+
+/*! \brief bins the values in \a first ... \a last into \a counts (which has to contain \c nbins+1 entries, the last one counts invalid values),
+           splits the range into chunks with private bins that are processed in parallel
+    \ingroup jkqtptools_math_statistics_1dhist
+    \internal
+*/
+template <class InputIt, class BinIndexFunctor>
+inline void jkqtpstatHistogramCountParallel(InputIt first, InputIt last, BinIndexFunctor binIndex, std::vector<size_t>& counts, std::true_type /*chunkable*/) {
+    typedef decltype(last-first) DiffT;
+    const size_t N=static_cast<size_t>(std::max<ptrdiff_t>(0, static_cast<ptrdiff_t>(last-first)));
+    const size_t chunks=jkqtpstatHistogramChunks(N, counts.size());
+    if (chunks<=1) {
+        jkqtpstatHistogramCountSerial(first, last, binIndex, counts.data());
+        return;
+    }
+    std::vector<std::vector<size_t> > chunkCounts(chunks);
+    jkqtpParallelFor(chunks, [&](size_t c) {
+        chunkCounts[c].assign(counts.size(), 0);
+        const size_t b=N*c/chunks;
+        const size_t e=N*(c+1)/chunks;
+        jkqtpstatHistogramCountSerial(first+static_cast<DiffT>(b), first+static_cast<DiffT>(e), binIndex, chunkCounts[c].data());
+    });
+    for (const auto& cc: chunkCounts) {
+        for (size_t i=0; i<counts.size(); i++) counts[i]+=cc[i];
+    }
+}
+
+/*! \copydoc jkqtpstatHistogramCountParallel() */
+template <class InputIt, class BinIndexFunctor>
+inline void jkqtpstatHistogramCountParallel(InputIt first, InputIt last, BinIndexFunctor binIndex, std::vector<size_t>& counts, std::false_type /*chunkable*/) {
+    jkqtpstatHistogramCountSerial(first, last, binIndex, counts.data());
+}
+
+/*! \copydoc jkqtpstatHistogramCountParallel() */
+template <class InputItX, class InputItY, class BinIndexFunctor>
+inline void jkqtpstatHistogramCountParallel(InputItX firstX, InputItX lastX, InputItY firstY, InputItY lastY, BinIndexFunctor binIndex, std::vector<size_t>& counts, std::true_type /*chunkable*/) {
+    typedef decltype(lastX-firstX) DiffTX;
+    typedef decltype(lastY-firstY) DiffTY;
+    const size_t N=static_cast<size_t>(std::max<ptrdiff_t>(0, std::min(static_cast<ptrdiff_t>(lastX-firstX), static_cast<ptrdiff_t>(lastY-firstY))));
+    const size_t chunks=jkqtpstatHistogramChunks(N, counts.size());
+    if (chunks<=1) {
+        jkqtpstatHistogramCountSerial(firstX, lastX, firstY, lastY, binIndex, counts.data());
+        return;
+    }
+    std::vector<std::vector<size_t> > chunkCounts(chunks);
+    jkqtpParallelFor(chunks, [&](size_t c) {
+        chunkCounts[c].assign(counts.size(), 0);
+        const size_t b=N*c/chunks;
+        const size_t e=N*(c+1)/chunks;
+        jkqtpstatHistogramCountSerial(firstX+static_cast<DiffTX>(b), firstX+static_cast<DiffTX>(e), firstY+static_cast<DiffTY>(b), firstY+static_cast<DiffTY>(e), binIndex, chunkCounts[c].data());
+    });
+    for (const auto& cc: chunkCounts) {
+        for (size_t i=0; i<counts.size(); i++) counts[i]+=cc[i];
+    }
+}
+
+/*! \copydoc jkqtpstatHistogramCountParallel() */
+template <class InputItX, class InputItY, class BinIndexFunctor>
+inline void jkqtpstatHistogramCountParallel(InputItX firstX, InputItX lastX, InputItY firstY, InputItY lastY, BinIndexFunctor binIndex, std::vector<size_t>& counts, std::false_type /*chunkable*/) {
+    jkqtpstatHistogramCountSerial(firstX, lastX, firstY, lastY, binIndex, counts.data());
+}
+
+/*! \brief counts the values in \a first ... \a last in \a bins equally wide bins of width \a binw, starting at \a minV (histogram engine)
+    \ingroup jkqtptools_math_statistics_1dhist
+
+    \tparam InputIt standard iterator type of \a first and \a last.
+    \param first iterator pointing to the first item in the dataset to use \f$ X_1 \f$
+    \param last iterator pointing behind the last item in the dataset to use \f$ X_N \f$
+    \param minV left edge of the first bin
+    \param binw width of the bins
+    \param bins number of bins
+    \param[out] counts receives the number of values in each bin (is resized to \a bins )
+    \return number of valid values that were binned
+
+    Value \f$ v \f$ is counted in bin \f$ \lfloor(v-\mbox{minV})/\mbox{binw}\rfloor \f$ , values outside the bins are counted in the first/last bin.
+
+    The bin index is calculated branch-free in blocks of JKQTPSTATISTICS_HISTOGRAM_BLOCKSIZE values. If the iterators allow to split the range
+    in constant time (see JKQTPStatIsChunkableIterator, e.g. JKQTPDatastore column iterators) and the range is large enough
+    (see JKQTPSTATISTICS_HISTOGRAM_PARALLEL_MINCHUNK), it is split into chunks, that are binned in parallel (see jkqtpParallelFor() )
+    into private integer bins, which are summed up in the end.
+
+    \note Each value is the specified range is converted to a double using jkqtp_todouble().
+          Entries in the range that are invalid double (using JKQTPIsOKFloat() )
+          are ignored when calculating.
+*/
+template <class InputIt>
+inline size_t jkqtpstatHistogramCount1D(InputIt first, InputIt last, double minV, double binw, size_t bins, std::vector<size_t>& counts) {
+    counts.assign(bins+1, 0);
+    if (bins==0) {
+        counts.clear();
+        return 0;
+    }
+    const double maxBin=static_cast<double>(bins-1);
+    const double invalidBin=static_cast<double>(bins);
+    // divide (instead of multiplying with 1/binw), so values on a bin edge land in the same bin as with floor((v-minV)/binw)
+    auto binIndex=[minV, binw, maxBin, invalidBin](double v) -> size_t {
+        const double b=std::min(maxBin, std::max(0.0, (v-minV)/binw));
+        return static_cast<size_t>(JKQTPIsOKFloat(v)?b:invalidBin);
+    };
+    jkqtpstatHistogramCountParallel(first, last, binIndex, counts, JKQTPStatIsChunkableIterator<InputIt>());
+    const size_t N=std::accumulate(counts.begin(), counts.begin()+static_cast<ptrdiff_t>(bins), size_t(0));
+    counts.resize(bins);
+    return N;
+}
+
+/*! \brief counts the values in \a first ... \a last in the bins defined by the sorted edges \a sortedBins (histogram engine)
+    \ingroup jkqtptools_math_statistics_1dhist
+
+    \tparam InputIt standard iterator type of \a first and \a last.
+    \param first iterator pointing to the first item in the dataset to use \f$ X_1 \f$
+    \param last iterator pointing behind the last item in the dataset to use \f$ X_N \f$
+    \param sortedBins sorted bin positions \f$ b_0<b_1<... \f$
+    \param[out] counts receives the number of values in each bin (is resized to \c sortedBins.size() )
+    \return number of valid values that were binned
+
+    Value \f$ v \f$ is counted in the bin \f$ i \f$ with the smallest \f$ b_i\geq v \f$ (i.e. the bin given by std::lower_bound() ),
+    values larger than the last position are counted in the last bin.
+
+    The bin is found with a branch-free binary search (a fixed number of steps, without data-dependent branches),
+    see jkqtpstatHistogramCount1D() for the parallelization.
+
+    \note Each value is the specified range is converted to a double using jkqtp_todouble().
+          Entries in the range that are invalid double (using JKQTPIsOKFloat() )
+          are ignored when calculating.
+*/
+template <class InputIt>
+inline size_t jkqtpstatHistogramCount1DEdges(InputIt first, InputIt last, const std::vector<double>& sortedBins, std::vector<size_t>& counts) {
+    const size_t bins=sortedBins.size();
+    counts.assign(bins+1, 0);
+    if (bins==0) {
+        counts.clear();
+        return 0;
+    }
+    const double* edges=sortedBins.data();
+    auto binIndex=[edges, bins](double v) -> size_t {
+        // the comparison results are used arithmetically, so the compiler can not turn them into (unpredictable) branches
+        size_t lo=0;
+        size_t n=bins;
+        while (n>1) {
+            const size_t half=n/2;
+            lo+=static_cast<size_t>(edges[lo+half-1]<v)*half;
+            n-=half;
+        }
+        const size_t b=std::min(lo+static_cast<size_t>(edges[lo]<v), bins-1);
+        return JKQTPIsOKFloat(v)?b:bins;
+    };
+    jkqtpstatHistogramCountParallel(first, last, binIndex, counts, JKQTPStatIsChunkableIterator<InputIt>());
+    const size_t N=std::accumulate(counts.begin(), counts.begin()+static_cast<ptrdiff_t>(bins), size_t(0));
+    counts.resize(bins);
+    return N;
+}
+
+/*! \brief counts the value pairs in \a firstX / \a firstY ... \a lastX / \a lastY in \a xbins * \a ybins equally sized bins (histogram engine)
+    \ingroup jkqtptools_math_statistics_2dhist
+
+    \tparam InputItX standard iterator type of \a firstX and \a lastX.
+    \tparam InputItY standard iterator type of \a firstY and \a lastY.
+    \param firstX iterator pointing to the first x-position item in the dataset to use \f$ X_1 \f$
+    \param lastX iterator pointing behind the last x-position item in the dataset to use \f$ X_N \f$
+    \param firstY iterator pointing to the first y-position item in the dataset to use \f$ Y_1 \f$
+    \param lastY iterator pointing behind the last y-position item in the dataset to use \f$ Y_N \f$
+    \param xmin left edge of the first bin in x-direction
+    \param binwx width of the bins in x-direction
+    \param xbins number of bins in x-direction
+    \param ymin left edge of the first bin in y-direction
+    \param binwy width of the bins in y-direction
+    \param ybins number of bins in y-direction
+    \param[out] counts receives the number of values in each bin in row-major ordering (is resized to \a xbins * \a ybins )
+    \return number of valid value pairs that were binned
+
+    Values outside the bins are counted in the bins at the border, see jkqtpstatHistogramCount1D() for details on the implementation.
+*/
+template <class InputItX, class InputItY>
+inline size_t jkqtpstatHistogramCount2D(InputItX firstX, InputItX lastX, InputItY firstY, InputItY lastY, double xmin, double binwx, size_t xbins, double ymin, double binwy, size_t ybins, std::vector<size_t>& counts) {
+    const size_t bins=xbins*ybins;
+    counts.assign(bins+1, 0);
+    if (bins==0) {
+        counts.clear();
+        return 0;
+    }
+    const double maxBinX=static_cast<double>(xbins-1);
+    const double maxBinY=static_cast<double>(ybins-1);
+    // divide (instead of multiplying with 1/binw), so values on a bin edge land in the same bin as with floor((v-min)/binw)
+    auto binIndex=[xmin, ymin, binwx, binwy, maxBinX, maxBinY, xbins, bins](double vx, double vy) -> size_t {
+        const double bx=std::min(maxBinX, std::max(0.0, (vx-xmin)/binwx));
+        const double by=std::min(maxBinY, std::max(0.0, (vy-ymin)/binwy));
+        const bool ok=JKQTPIsOKFloat(vx) && JKQTPIsOKFloat(vy);
+        return ok?(static_cast<size_t>(by)*xbins+static_cast<size_t>(bx)):bins;
+    };
+    jkqtpstatHistogramCountParallel(firstX, lastX, firstY, lastY, binIndex, counts, std::integral_constant<bool, JKQTPStatIsChunkableIterator<InputItX>::value && JKQTPStatIsChunkableIterator<InputItY>::value>());
+    const size_t N=std::accumulate(counts.begin(), counts.begin()+static_cast<ptrdiff_t>(bins), size_t(0));
+    counts.resize(bins);
+    return N;
+}
+
 /*! \brief calculate an autoranged 1-dimensional histogram from the given data range \a first ... \a last, bins defined by their number
     \ingroup jkqtptools_math_statistics_1dhist
 
@@ -84,17 +347,12 @@ inline void jkqtpstatHistogram1DAutoranged(InputIt first, InputIt last, OutputIt
     // initialize the histogram
     for (int i=0; i<bins; i++)  {
         histX.push_back(minV+static_cast<double>(i)*binw);
-        histY.push_back(0);
     }
 
     // calculate the histogram
-    for (auto it=first; it!=last; ++it)  {
-        const double v=jkqtp_todouble(*it);
-        if (JKQTPIsOKFloat(v)) {
-            size_t b=jkqtp_bounded<size_t>(0, static_cast<size_t>(floor((v-minV)/binw)), bins-1);
-            histY[b]++;
-        }
-    }
+    std::vector<size_t> counts;
+    jkqtpstatHistogramCount1D(first, last, minV, binw, static_cast<size_t>(std::max(0, bins)), counts);
+    histY.assign(counts.begin(), counts.end());
 
 
     // output the histogram
@@ -149,17 +407,12 @@ inline void jkqtpstatHistogram1DAutoranged(InputIt first, InputIt last, OutputIt
     // initialize the histogram
     for (int i=0; i<bins; i++)  {
         histX.push_back(minV+static_cast<double>(i)*binw);
-        histY.push_back(0);
     }
 
     // calculate the histogram
-    for (auto it=first; it!=last; ++it)  {
-        const double v=jkqtp_todouble(*it);
-        if (JKQTPIsOKFloat(v)) {
-            size_t b=jkqtp_bounded<size_t>(0, static_cast<size_t>(floor((v-minV)/binw)), bins-1);
-            histY[b]++;
-        }
-    }
+    std::vector<size_t> counts;
+    jkqtpstatHistogramCount1D(first, last, minV, binw, static_cast<size_t>(std::max(0, bins)), counts);
+    histY.assign(counts.begin(), counts.end());
 
 
     // output the histogram
@@ -203,10 +456,6 @@ inline void jkqtpstatHistogram1DAutoranged(InputIt first, InputIt last, OutputIt
 */
 template <class InputIt, class BinsInputIt, class OutputIt>
 inline void jkqtpstatHistogram1D(InputIt first, InputIt last, BinsInputIt binsFirst, BinsInputIt binsLast, OutputIt histogramXOut, OutputIt histogramYOut, bool normalized=true, bool cummulative=false, JKQTPStatHistogramBinXMode binXMode=JKQTPStatHistogramBinXMode::XIsLeft) {
-    double minV=0, maxV=0;
-    size_t N=0;
-    jkqtpstatMinMax<InputIt>(first, last, minV, maxV, nullptr, nullptr, &N);
-
     std::vector<double> histX;
     std::vector<double> histY;
 
@@ -214,19 +463,13 @@ inline void jkqtpstatHistogram1D(InputIt first, InputIt last, BinsInputIt binsFi
     // initialize the histogram
     for (auto it=binsFirst; it!=binsLast; ++it)  {
         histX.push_back(jkqtp_todouble(*it));
-        histY.push_back(0);
     }
     std::sort(histX.begin(), histX.end());
 
     // calculate the histogram
-    for (auto it=first; it!=last; ++it)  {
-        const double v=jkqtp_todouble(*it);
-        if (JKQTPIsOKFloat(v)) {
-            auto itb=std::lower_bound(histX.begin(), histX.end(), v);
-            size_t bin=jkqtp_bounded<size_t>(0,static_cast<size_t>(std::abs(std::distance(histX.begin(), itb))), histY.size()-1);
-            histY[bin]++;
-        }
-    }
+    std::vector<size_t> counts;
+    const size_t N=jkqtpstatHistogramCount1DEdges(first, last, histX, counts);
+    histY.assign(counts.begin(), counts.end());
 
 
     // output the histogram
@@ -289,23 +532,9 @@ inline void jkqtpstatHistogram2D(InputItX firstX, InputItX lastX, InputItY first
     const double binwx=fabs(xmax-xmin)/static_cast<double>(xbins);
     const double binwy=fabs(ymax-ymin)/static_cast<double>(ybins);
 
-    std::vector<double> hist;
-    std::fill_n(std::back_inserter(hist), xbins*ybins, 0.0);
-
     // calculate the histogram
-    auto itX=firstX;
-    auto itY=firstY;
-    size_t N=0;
-    for (; (itX!=lastX) && (itY!=lastY); ++itX, ++itY)  {
-        const double vx=jkqtp_todouble(*itX);
-        const double vy=jkqtp_todouble(*itY);
-        if (JKQTPIsOKFloat(vx) && JKQTPIsOKFloat(vy)) {
-            const size_t bx=jkqtp_bounded<size_t>(0, static_cast<size_t>(floor((vx-xmin)/binwx)), xbins-1);
-            const size_t by=jkqtp_bounded<size_t>(0, static_cast<size_t>(floor((vy-ymin)/binwy)), ybins-1);
-            hist[by*xbins+bx]++;
-            N++;
-        }
-    }
+    std::vector<size_t> hist;
+    const size_t N=jkqtpstatHistogramCount2D(firstX, lastX, firstY, lastY, xmin, binwx, xbins, ymin, binwy, ybins, hist);
 
 
     // output the histogram
@@ -313,7 +542,7 @@ inline void jkqtpstatHistogram2D(InputItX firstX, InputItX lastX, InputItY first
     if (normalized) {
         NNorm=static_cast<double>(N);
     }
-    std::transform(hist.begin(), hist.end(), histogramImgOut, [NNorm](double v) { return v/NNorm; });
+    std::transform(hist.begin(), hist.end(), histogramImgOut, [NNorm](size_t v) { return static_cast<double>(v)/NNorm; });
 }
 
 
@@ -28,6 +28,7 @@
 #include "jkqtcommon/jkqtpstatpoly.h"
 #include "jkqtcommon/jkqtpstatregression.h"
 #include "jkqtcommon/jkqtpstatgrouped.h"
+#include "jkqtcommon/jkqtpstatquantilesketch.h"
 
 
 #endif // JKQTPSTATISTICSTOOLS_H_INCLUDED
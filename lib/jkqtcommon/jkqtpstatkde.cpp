@@ -20,6 +20,151 @@
 
 
 #include "jkqtpstatkde.h"
+#include <complex>
+
+
+namespace {
+    /** \internal
+     *  \brief in-place radix-2 FFT of \a data (size has to be a power of 2), \a twiddle contains \f$ \exp(-2\pi\mathrm{i}k/P),\ k=0..P/2-1 \f$ */
+    void jkqtpstatFFT(std::vector<std::complex<double> >& data, const std::vector<std::complex<double> >& twiddle, bool inverse) {
+        const size_t P=data.size();
+        // bit-reversal permutation
+        for (size_t i=1, j=0; i<P; i++) {
+            size_t bit=P>>1;
+            for (; j&bit; bit>>=1) j^=bit;
+            j^=bit;
+            if (i<j) std::swap(data[i], data[j]);
+        }
+        for (size_t len=2; len<=P; len<<=1) {
+            const size_t half=len/2;
+            const size_t tstep=P/len;
+            for (size_t i=0; i<P; i+=len) {
+                for (size_t k=0; k<half; k++) {
+                    // complex multiplication written out, as std::complex::operator* checks for NaN/inf
+                    const double wr=twiddle[k*tstep].real();
+                    const double wi=inverse?-twiddle[k*tstep].imag():twiddle[k*tstep].imag();
+                    const std::complex<double> u=data[i+k];
+                    const std::complex<double> x=data[i+k+half];
+                    const std::complex<double> v(x.real()*wr-x.imag()*wi, x.real()*wi+x.imag()*wr);
+                    data[i+k]=u+v;
+                    data[i+k+half]=u-v;
+                }
+            }
+        }
+    }
+
+    /** \internal
+     *  \brief convolves lines of \c G values with a sampled symmetric kernel, the sampled kernel (and its spectrum) are shared by all lines */
+    class JKQTPKernelConvolver1D {
+        public:
+            JKQTPKernelConvolver1D(size_t G_, double gridDeltaOverBandwidth, const std::function<double(double)>& kernel, double supportRadius):
+                G(G_), kr(0), P(1), useFFT(false)
+            {
+                // sample the kernel (symmetric, so only positive distances are required), every sample is the average over its grid cell,
+                // which keeps the area of discontinuous kernels (e.g. jkqtpstatKernel1DUniform() ) independent of the grid spacing
+                kr=G-1;
+                if (JKQTPIsOKFloat(supportRadius) && supportRadius/gridDeltaOverBandwidth+0.5<static_cast<double>(G-1)) {
+                    kr=static_cast<size_t>(ceil(supportRadius/gridDeltaOverBandwidth+0.5));
+                }
+                const int subsamples=8;
+                k.resize(kr+1);
+                for (size_t m=0; m<=kr; m++) {
+                    double ksum=0;
+                    for (int ss=0; ss<subsamples; ss++) {
+                        ksum+=kernel((static_cast<double>(m)-0.5+(static_cast<double>(ss)+0.5)/static_cast<double>(subsamples))*gridDeltaOverBandwidth);
+                    }
+                    k[m]=ksum/static_cast<double>(subsamples);
+                }
+
+                // P>=G+kr avoids wrap-around of the circular convolution into [0..G-1]
+                while (P<G+kr) P<<=1;
+                useFFT=(static_cast<double>(G)*static_cast<double>(2*kr+1) > 8.0*static_cast<double>(P)*log2(static_cast<double>(P)));
+                if (useFFT) {
+                    twiddle.resize(P/2);
+                    for (size_t i=0; i<P/2; i++) {
+                        const double phi=-2.0*JKQTPSTATISTICS_PI*static_cast<double>(i)/static_cast<double>(P);
+                        twiddle[i]=std::complex<double>(cos(phi), sin(phi));
+                    }
+                    std::vector<std::complex<double> > b(P, std::complex<double>(0.0,0.0));
+                    b[0]=k[0];
+                    for (size_t m=1; m<=kr; m++) {
+                        b[m]=k[m];
+                        b[P-m]=k[m];
+                    }
+                    jkqtpstatFFT(b, twiddle, false);
+                    // the kernel is real and symmetric, so its spectrum is real
+                    spectrum.resize(P);
+                    for (size_t i=0; i<P; i++) spectrum[i]=b[i].real()/static_cast<double>(P);
+                }
+            }
+
+            /** \brief convolves the \c G values \c data[0], \c data[stride], ... in-place */
+            void apply(double* data, size_t stride) const {
+                if (!useFFT) {
+                    // narrow kernel: direct convolution, skipping empty bins
+                    std::vector<double> res(G, 0.0);
+                    for (size_t j=0; j<G; j++) {
+                        const double g=data[j*stride];
+                        if (g!=0.0) {
+                            const size_t mmax=std::min(kr, G-1-j);
+                            for (size_t m=0; m<=mmax; m++) res[j+m]+=g*k[m];
+                            const size_t mmaxl=std::min(kr, j);
+                            for (size_t m=1; m<=mmaxl; m++) res[j-m]+=g*k[m];
+                        }
+                    }
+                    for (size_t j=0; j<G; j++) data[j*stride]=res[j];
+                } else {
+                    // wide kernel: circular convolution via FFT
+                    std::vector<std::complex<double> > a(P, std::complex<double>(0.0,0.0));
+                    for (size_t i=0; i<G; i++) a[i]=data[i*stride];
+                    jkqtpstatFFT(a, twiddle, false);
+                    for (size_t i=0; i<P; i++) a[i]*=spectrum[i];
+                    jkqtpstatFFT(a, twiddle, true);
+                    for (size_t i=0; i<G; i++) {
+                        // remove negative round-off errors, a density is never negative
+                        data[i*stride]=std::max(0.0, a[i].real());
+                    }
+                }
+            }
+        private:
+            size_t G;
+            size_t kr;
+            size_t P;
+            bool useFFT;
+            std::vector<double> k;
+            std::vector<std::complex<double> > twiddle;
+            std::vector<double> spectrum;
+    };
+
+    /** \internal
+     *  \brief x-factor of jkqtpstatKernel2DUniform() */
+    double jkqtpstatKernel2DUniformFactorX(double t) {
+        return (fabs(t)<1.0)?0.5:0.0;
+    }
+}
+
+
+bool jkqtpstatIsBuiltinKernel1D(const std::function<double(double)>& kernel, double* supportRadius) {
+    typedef double(*KernelFunc)(double);
+    const KernelFunc* f=kernel.target<KernelFunc>();
+    if (!f || !(*f)) return false;
+    double radius=0;
+    if (*f==&jkqtpstatKernel1DGaussian) radius=9.0; // exp(-t^2/2)<1e-17
+    else if (*f==&jkqtpstatKernel1DPicard) radius=80.0; // exp(-|t|/2)<1e-17
+    else if (*f==&jkqtpstatKernel1DCauchy) radius=std::numeric_limits<double>::infinity();
+    else if (*f==&jkqtpstatKernel1DEpanechnikov || *f==&jkqtpstatKernel1DUniform || *f==&jkqtpstatKernel1DTriangle || *f==&jkqtpstatKernel1DQuartic
+             || *f==&jkqtpstatKernel1DTriweight || *f==&jkqtpstatKernel1DTricube || *f==&jkqtpstatKernel1DCosine) radius=1.0;
+    else return false;
+    if (supportRadius) *supportRadius=radius;
+    return true;
+}
+
+
+void jkqtpstatConvolveKernel1DGrid(std::vector<double>& grid, double gridDeltaOverBandwidth, const std::function<double(double)>& kernel, double supportRadius) {
+    if (grid.size()==0 || !JKQTPIsOKFloat(gridDeltaOverBandwidth) || gridDeltaOverBandwidth<=0.0) return;
+    const JKQTPKernelConvolver1D conv(grid.size(), gridDeltaOverBandwidth, kernel, supportRadius);
+    conv.apply(grid.data(), 1);
+}
 
 
 double jkqtpstatKernel1DGaussian(double t) {
@@ -83,3 +228,45 @@ double jkqtpstatKernel2DGaussian(double tx, double ty)
 double jkqtpstatKernel2DUniform(double tx, double ty) {
     return (fabs(tx)<1.0 && fabs(ty)<=1.0)?0.25:0.0;
 }
+
+
+bool jkqtpstatIsBuiltinKernel2D(const std::function<double (double, double)> &kernel, std::function<double (double)> *kernelX, std::function<double (double)> *kernelY, double *supportRadius)
+{
+    typedef double(*KernelFunc)(double,double);
+    const KernelFunc* f=kernel.target<KernelFunc>();
+    if (!f || !(*f)) return false;
+    if (*f==&jkqtpstatKernel2DGaussian) {
+        if (kernelX) *kernelX=&jkqtpstatKernel1DGaussian;
+        if (kernelY) *kernelY=&jkqtpstatKernel1DGaussian;
+        if (supportRadius) *supportRadius=9.0;
+        return true;
+    } else if (*f==&jkqtpstatKernel2DUniform) {
+        if (kernelX) *kernelX=&jkqtpstatKernel2DUniformFactorX;
+        if (kernelY) *kernelY=&jkqtpstatKernel1DUniform;
+        if (supportRadius) *supportRadius=1.0;
+        return true;
+    }
+    return false;
+}
+
+
+void jkqtpstatConvolveKernel2DGridSeparable(std::vector<double> &grid, size_t gridWidth, double gridDeltaXOverBandwidth, double gridDeltaYOverBandwidth, const std::function<double (double)> &kernelX, const std::function<double (double)> &kernelY, double supportRadius, size_t firstColumn, size_t columnStep)
+{
+    if (gridWidth==0 || grid.size()==0 || firstColumn>=gridWidth) return;
+    if (columnStep==0) columnStep=1;
+    const size_t gridHeight=grid.size()/gridWidth;
+    // rows
+    {
+        const JKQTPKernelConvolver1D conv(gridWidth, gridDeltaXOverBandwidth, kernelX, supportRadius);
+        jkqtpParallelFor(gridHeight, [&](size_t r) {
+            conv.apply(grid.data()+r*gridWidth, 1);
+        });
+    }
+    // columns
+    {
+        const JKQTPKernelConvolver1D conv(gridHeight, gridDeltaYOverBandwidth, kernelY, supportRadius);
+        jkqtpParallelFor((gridWidth-firstColumn+columnStep-1)/columnStep, [&](size_t ci) {
+            conv.apply(grid.data()+firstColumn+ci*columnStep, gridWidth);
+        });
+    }
+}
@@ -39,6 +39,38 @@
 #include "jkqtcommon/jkqtparraytools.h"
 #include "jkqtcommon/jkqtpdebuggingtools.h"
 #include "jkqtcommon/jkqtpstatbasics.h"
+#include "jkqtcommon/jkqtpcodestructuring.h"
+#include <functional>
+#include <algorithm>
+
+
+/*! \brief number of gridpoints per bandwidth, used by the binned KDE (see jkqtpstatEvaluateKernelSumsBinned() )
+    \ingroup jkqtptools_math_statistics_1dkde
+*/
+#ifndef JKQTPSTATISTICS_KDE_BINNED_GRIDPOINTS_PER_BANDWIDTH
+#  define JKQTPSTATISTICS_KDE_BINNED_GRIDPOINTS_PER_BANDWIDTH 20
+#endif
+
+/*! \brief maximum number of gridpoints, used by the binned KDE (see jkqtpstatEvaluateKernelSumsBinned() ), for larger grids the KDE is evaluated exactly
+    \ingroup jkqtptools_math_statistics_1dkde
+*/
+#ifndef JKQTPSTATISTICS_KDE_BINNED_MAX_GRIDSIZE
+#  define JKQTPSTATISTICS_KDE_BINNED_MAX_GRIDSIZE (1<<23)
+#endif
+
+/*! \brief number of gridpoints per bandwidth (in each direction), used by the binned 2D KDE (see jkqtpstatKDE2DBinned() )
+    \ingroup jkqtptools_math_statistics_2dkde
+*/
+#ifndef JKQTPSTATISTICS_KDE2D_BINNED_GRIDPOINTS_PER_BANDWIDTH
+#  define JKQTPSTATISTICS_KDE2D_BINNED_GRIDPOINTS_PER_BANDWIDTH 8
+#endif
+
+/*! \brief maximum number of gridpoints (width*height), used by the binned 2D KDE (see jkqtpstatKDE2DBinned() ), for larger grids the KDE is evaluated exactly
+    \ingroup jkqtptools_math_statistics_2dkde
+*/
+#ifndef JKQTPSTATISTICS_KDE2D_BINNED_MAX_GRIDSIZE
+#  define JKQTPSTATISTICS_KDE2D_BINNED_MAX_GRIDSIZE (1<<24)
+#endif
 
 
 
@@ -204,6 +236,143 @@ inline double jkqtpstatEvaluateKernelSum(double t, InputIt first, InputIt last,
 
 
 
+/*! \brief checks whether \a kernel is one of the built-in 1D kernels (jkqtpstatKernel1DGaussian(), jkqtpstatKernel1DEpanechnikov(), ...), for which the binned KDE (see jkqtpstatEvaluateKernelSumsBinned() ) can be used
+    \ingroup jkqtptools_math_statistics_1dkde
+
+    \param kernel the kernel function to check
+    \param[out] supportRadius if not \c nullptr, this receives the radius (in units of the bandwidth) outside of which the kernel is zero (or below \f$ 10^{-16} \f$ ), this is \c +inf for the heavy-tailed jkqtpstatKernel1DCauchy()
+    \return \c true, if \a kernel wraps one of the built-in kernel functions
+*/
+JKQTCOMMON_LIB_EXPORT bool jkqtpstatIsBuiltinKernel1D(const std::function<double(double)>& kernel, double* supportRadius=nullptr);
+
+/*! \brief convolves the binned data \a grid with the symmetric \a kernel in-place
+    \ingroup jkqtptools_math_statistics_1dkde
+
+    evaluates \f[ g'_i:=\sum\limits_{j}g_j\cdot K\bigl((i-j)\cdot\delta\bigr) \f]
+    where \f$ \delta \f$ is the distance between two gridpoints in units of the bandwidth and the kernel is truncated outside \a supportRadius .
+    Narrow kernels are convolved directly, wider kernels via FFT in \f$ \mathcal{O}(G\log G) \f$ .
+
+    \param[in,out] grid the binned data
+    \param gridDeltaOverBandwidth the grid spacing in units of the bandwidth \f$ \delta \f$
+    \param kernel the kernel function to use (has to be symmetric, i.e. \f$ K(t)=K(-t) \f$ )
+    \param supportRadius radius (in units of the bandwidth) outside of which the kernel is zero (may be \c +inf )
+
+    \see jkqtpstatEvaluateKernelSumsBinned()
+*/
+JKQTCOMMON_LIB_EXPORT void jkqtpstatConvolveKernel1DGrid(std::vector<double>& grid, double gridDeltaOverBandwidth, const std::function<double(double)>& kernel, double supportRadius);
+
+
+/*! \brief evaluates the Kernel Density Estimator (KDE) at the sorted positions \a X, using linear binning and a (FFT) convolution
+    \ingroup jkqtptools_math_statistics_1dkde
+
+    The data is linearly binned onto a regular grid, which resolves the bandwidth with JKQTPSTATISTICS_KDE_BINNED_GRIDPOINTS_PER_BANDWIDTH points and spans \a X
+    (extended by the support of the kernel). Then the grid is convolved with the sampled kernel (see jkqtpstatConvolveKernel1DGrid() ) and the result is
+    read out at \a X . If \a X is equidistant, every output position coincides with a gridpoint, otherwise the grid is interpolated linearly.
+    The runtime is \f$ \mathcal{O}(N+G\log G) \f$ , instead of \f$ \mathcal{O}(N\cdot\text{X.size()}) \f$ for jkqtpstatEvaluateKernelSum().
+
+    \tparam InputIt standard iterator type of \a first and \a last.
+    \param first iterator pointing to the first item in the dataset to use \f$ X_1 \f$
+    \param last iterator pointing behind the last item in the dataset to use \f$ X_N \f$
+    \param X positions where to evaluate the KDE (sorted in ascending order)
+    \param[out] Y receives the KDE at the positions \a X
+    \param kernel the kernel function to use (has to be a built-in kernel, see jkqtpstatIsBuiltinKernel1D() )
+    \param bandwidth bandwidth used for the KDE
+    \return \c false (and leaves \a Y untouched), if the binned KDE cannot be used (custom kernel, too large grid) or if the exact evaluation is cheaper
+
+    \see jkqtpstatEvaluateKernelSums()
+*/
+template <class InputIt>
+inline bool jkqtpstatEvaluateKernelSumsBinned(InputIt first, InputIt last, const std::vector<double>& X, std::vector<double>& Y, const std::function<double(double)>& kernel, double bandwidth) {
+    double radius=0;
+    if (X.size()==0 || !JKQTPIsOKFloat(bandwidth) || bandwidth<=0.0 || !jkqtpstatIsBuiltinKernel1D(kernel, &radius)) return false;
+    const double xLeft=X.front();
+    const double xRight=X.back();
+    if (!JKQTPIsOKFloat(xLeft) || !JKQTPIsOKFloat(xRight) || xRight<xLeft) return false;
+
+    double minV=0, maxV=0;
+    size_t N=0;
+    jkqtpstatMinMax<InputIt>(first, last, minV, maxV, nullptr, nullptr, &N);
+    if (N==0) {
+        Y.assign(X.size(), 0.0);
+        return true;
+    }
+
+    // grid spacing: resolve the bandwidth and let equidistant X-positions coincide with gridpoints
+    const double dgMax=bandwidth/static_cast<double>(JKQTPSTATISTICS_KDE_BINNED_GRIDPOINTS_PER_BANDWIDTH);
+    double dg=dgMax;
+    if (X.size()>1 && xRight>xLeft) {
+        const double dX=(xRight-xLeft)/static_cast<double>(X.size()-1);
+        dg=dX/ceil(dX/dgMax);
+    }
+    // the grid spans X, extended by the kernel support, but not beyond the data
+    const double R=radius*bandwidth;
+    const double extLeft=std::max(0.0, std::min(R, xLeft-minV));
+    const double extRight=std::max(0.0, std::min(R, maxV-xRight));
+    const double padLeft=ceil(extLeft/dg)+1.0;
+    const double gridSize=padLeft+ceil((xRight-xLeft)/dg)+1.0+ceil(extRight/dg)+1.0;
+    if (!JKQTPIsOKFloat(gridSize) || gridSize>static_cast<double>(JKQTPSTATISTICS_KDE_BINNED_MAX_GRIDSIZE)) return false;
+    // for small datasets the exact evaluation is faster
+    if (static_cast<double>(N)*static_cast<double>(X.size())<=8.0*gridSize*log2(gridSize+1.0)) return false;
+
+    const size_t G=static_cast<size_t>(gridSize);
+    const double gridLeft=xLeft-padLeft*dg;
+
+    // linear binning of the data
+    std::vector<double> grid(G, 0.0);
+    for (auto it=first; it!=last; ++it) {
+        const double v=jkqtp_todouble(*it);
+        if (JKQTPIsOKFloat(v)) {
+            const double pos=(v-gridLeft)/dg;
+            if (pos>=0.0 && pos<=static_cast<double>(G-1)) {
+                const size_t j=static_cast<size_t>(pos);
+                const double w=pos-static_cast<double>(j);
+                grid[j]+=1.0-w;
+                if (j+1<G) grid[j+1]+=w;
+            }
+        }
+    }
+
+    jkqtpstatConvolveKernel1DGrid(grid, dg/bandwidth, kernel, radius);
+
+    // read out the KDE at X
+    const double norm=1.0/static_cast<double>(N)/bandwidth;
+    Y.resize(X.size());
+    for (size_t i=0; i<X.size(); i++) {
+        const double pos=std::max(0.0, std::min(static_cast<double>(G-1), (X[i]-gridLeft)/dg));
+        const size_t j=static_cast<size_t>(pos);
+        const double w=pos-static_cast<double>(j);
+        Y[i]=(grid[j]*(1.0-w)+((j+1<G)?(grid[j+1]*w):0.0))*norm;
+    }
+    return true;
+}
+
+
+/*! \brief evaluates the Kernel Density Estimator (KDE) at the sorted positions \a X
+    \ingroup jkqtptools_math_statistics_1dkde
+
+    For the built-in kernels (see jkqtpstatIsBuiltinKernel1D() ) and large datasets, this uses the binned KDE jkqtpstatEvaluateKernelSumsBinned(),
+    otherwise (e.g. for custom kernels) the KDE is evaluated exactly at every position with jkqtpstatEvaluateKernelSum().
+
+    \tparam InputIt standard iterator type of \a first and \a last.
+    \param first iterator pointing to the first item in the dataset to use \f$ X_1 \f$
+    \param last iterator pointing behind the last item in the dataset to use \f$ X_N \f$
+    \param X positions where to evaluate the KDE (sorted in ascending order)
+    \param[out] Y receives the KDE at the positions \a X
+    \param kernel the kernel function to use (e.g. jkqtpstatKernel1DGaussian() )
+    \param bandwidth bandwidth used for the KDE
+*/
+template <class InputIt>
+inline void jkqtpstatEvaluateKernelSums(InputIt first, InputIt last, const std::vector<double>& X, std::vector<double>& Y, const std::function<double(double)>& kernel, double bandwidth) {
+    if (!jkqtpstatEvaluateKernelSumsBinned(first, last, X, Y, kernel, bandwidth)) {
+        Y.resize(X.size());
+        for (size_t i=0; i<X.size(); i++) {
+            Y[i]=jkqtpstatEvaluateKernelSum(X[i], first, last, kernel, bandwidth);
+        }
+    }
+}
+
+
+
 
 /*! \brief calculate an autoranged 1-dimensional Kernel Density Estimation (KDE) from the given data range \a first ... \a last, bins defined by their number
     \ingroup jkqtptools_math_statistics_1dkde
@@ -222,7 +391,9 @@ inline double jkqtpstatEvaluateKernelSum(double t, InputIt first, InputIt last,
     This function performs <a href="https://en.wikipedia.org/wiki/Kernel_density_estimation">Kernel Density Estimation</a> for a given data array.
     Then the resulting density is evaluated on a regular grid spanning [min(X)...max(X)] with bins datapoints in between.
 
-    \warning this functions is getting very slow for large dataset, as for each point in the resulting histogram N kernel functions have to be evaluated.
+    \note For the built-in kernels (e.g. jkqtpstatKernel1DGaussian() ) and large datasets, the KDE is calculated by linear binning and an FFT convolution
+          (see jkqtpstatEvaluateKernelSums() ). For custom kernels the KDE is evaluated exactly, which gets very slow for large datasets,
+          as for each point in the resulting histogram N kernel functions have to be evaluated.
 
     \see https://en.wikipedia.org/wiki/Kernel_density_estimation, \ref JKQTPlotterBasicJKQTPDatastoreStatistics
 */
@@ -241,12 +412,11 @@ inline void jkqtpstatKDE1DAutoranged(InputIt first, InputIt last, OutputIt KDEXO
     // calculate the KDE
     for (double xi=minV; xi<=maxV; xi+=binw)  {
         histX.push_back(xi);
-        histY.push_back(jkqtpstatEvaluateKernelSum(xi, first, last, kernel, bandwidth));
     }
     if (histX.size()>0 && histX[histX.size()-1]<maxV) {
         histX.push_back(maxV);
-        histY.push_back(jkqtpstatEvaluateKernelSum(maxV, first, last, kernel, bandwidth));
     }
+    jkqtpstatEvaluateKernelSums(first, last, histX, histY, kernel, bandwidth);
 
 
 
@@ -280,7 +450,9 @@ inline void jkqtpstatKDE1DAutoranged(InputIt first, InputIt last, OutputIt KDEXO
     This function performs <a href="https://en.wikipedia.org/wiki/Kernel_density_estimation">Kernel Density Estimation</a> for a given data array.
     Then the resulting density is evaluated on a regular grid spanning [min(X)...max(X)] with bins datapoints in between.
 
-    \warning this functions is getting very slow for large dataset, as for each point in the resulting histogram N kernel functions have to be evaluated.
+    \note For the built-in kernels (e.g. jkqtpstatKernel1DGaussian() ) and large datasets, the KDE is calculated by linear binning and an FFT convolution
+          (see jkqtpstatEvaluateKernelSums() ). For custom kernels the KDE is evaluated exactly, which gets very slow for large datasets,
+          as for each point in the resulting histogram N kernel functions have to be evaluated.
 
     \see https://en.wikipedia.org/wiki/Kernel_density_estimation, \ref JKQTPlotterBasicJKQTPDatastoreStatistics
 */
@@ -298,12 +470,11 @@ inline void jkqtpstatKDE1DAutoranged(InputIt first, InputIt last, OutputIt KDEXO
     // calculate the KDE
     for (double xi=minV; xi<=maxV; xi+=binw)  {
         histX.push_back(xi);
-        histY.push_back(jkqtpstatEvaluateKernelSum(xi, first, last, kernel, bandwidth));
     }
     if (histX.size()>0 && histX[histX.size()-1]<maxV) {
         histX.push_back(maxV);
-        histY.push_back(jkqtpstatEvaluateKernelSum(maxV, first, last, kernel, bandwidth));
     }
+    jkqtpstatEvaluateKernelSums(first, last, histX, histY, kernel, bandwidth);
 
 
     // output the KDE
@@ -356,9 +527,7 @@ inline void jkqtpstatKDE1D(InputIt first, InputIt last, BinsInputIt binsFirst, B
     std::sort(histX.begin(), histX.end());
 
     // calculate the KDE
-    for (auto it=histX.begin(); it!=histX.end(); ++it) {
-        histY.push_back(jkqtpstatEvaluateKernelSum(*it, first, last, kernel, bandwidth));
-    }
+    jkqtpstatEvaluateKernelSums(first, last, histX, histY, kernel, bandwidth);
 
 
     // output the KDE
@@ -408,8 +577,8 @@ inline void jkqtpstatKDE1D(InputIt first, InputIt last, double binXLeft, double
     // calculate the KDE
     for (double x=binXLeft; x<=binXRight; x+=binXDelta)  {
         histX.push_back(x);
-        histY.push_back(jkqtpstatEvaluateKernelSum(x, first, last, kernel, bandwidth));
     }
+    jkqtpstatEvaluateKernelSums(first, last, histX, histY, kernel, bandwidth);
 
 
     // output the KDE
@@ -474,6 +643,182 @@ inline double jkqtpstatEvaluateKernelSum2D(double x, double y, InputItX firstX,
 
 
 
+/*! \brief checks whether \a kernel is one of the built-in separable 2D kernels (jkqtpstatKernel2DGaussian(), jkqtpstatKernel2DUniform() ), for which the binned 2D KDE (see jkqtpstatKDE2DBinned() ) can be used
+    \ingroup jkqtptools_math_statistics_2dkde
+
+    \param kernel the kernel function to check
+    \param[out] kernelX if not \c nullptr, this receives the x-factor \f$ k_x(t_x) \f$ of the kernel \f$ K(t_x,t_y)=k_x(t_x)\cdot k_y(t_y) \f$
+    \param[out] kernelY if not \c nullptr, this receives the y-factor \f$ k_y(t_y) \f$ of the kernel \f$ K(t_x,t_y)=k_x(t_x)\cdot k_y(t_y) \f$
+    \param[out] supportRadius if not \c nullptr, this receives the radius (in units of the bandwidth) outside of which the factors are zero (or below \f$ 10^{-16} \f$ )
+    \return \c true, if \a kernel wraps one of the built-in 2D kernel functions
+*/
+JKQTCOMMON_LIB_EXPORT bool jkqtpstatIsBuiltinKernel2D(const std::function<double(double,double)>& kernel, std::function<double(double)>* kernelX=nullptr, std::function<double(double)>* kernelY=nullptr, double* supportRadius=nullptr);
+
+/*! \brief convolves the binned 2D data \a grid (row-major, \a gridWidth columns) with the separable kernel \f$ k_x(t_x)\cdot k_y(t_y) \f$ in-place
+    \ingroup jkqtptools_math_statistics_2dkde
+
+    The rows are convolved with \a kernelX and then the columns with \a kernelY (see jkqtpstatConvolveKernel1DGrid() ), both passes run in parallel (see jkqtpParallelFor() ).
+    If only some columns are required, \a firstColumn and \a columnStep select them, all other columns are only convolved in x-direction.
+
+    \param[in,out] grid the binned data (row-major)
+    \param gridWidth number of columns in \a grid
+    \param gridDeltaXOverBandwidth the grid spacing in x-direction in units of the x-bandwidth
+    \param gridDeltaYOverBandwidth the grid spacing in y-direction in units of the y-bandwidth
+    \param kernelX the kernel factor in x-direction (has to be symmetric)
+    \param kernelY the kernel factor in y-direction (has to be symmetric)
+    \param supportRadius radius (in units of the bandwidth) outside of which the kernel factors are zero (may be \c +inf )
+    \param firstColumn first column, which is convolved in y-direction
+    \param columnStep only every \a columnStep -th column (starting with \a firstColumn ) is convolved in y-direction
+
+    \see jkqtpstatKDE2DBinned()
+*/
+JKQTCOMMON_LIB_EXPORT void jkqtpstatConvolveKernel2DGridSeparable(std::vector<double>& grid, size_t gridWidth, double gridDeltaXOverBandwidth, double gridDeltaYOverBandwidth, const std::function<double(double)>& kernelX, const std::function<double(double)>& kernelY, double supportRadius, size_t firstColumn=0, size_t columnStep=1);
+
+
+/*! \brief calculates a 2-dimensional Kernel Density Estimation (KDE) on the same grid as jkqtpstatKDE2D(), using linear binning and a separable (FFT) convolution
+    \ingroup jkqtptools_math_statistics_2dkde
+
+    The data is bilinearly binned onto a regular grid, which resolves the bandwidths with JKQTPSTATISTICS_KDE2D_BINNED_GRIDPOINTS_PER_BANDWIDTH points and contains
+    all output positions (extended by the support of the kernel). Then the grid is convolved with the separable kernel (see jkqtpstatConvolveKernel2DGridSeparable() ).
+    The runtime is \f$ \mathcal{O}(N+G\log G) \f$ , instead of \f$ \mathcal{O}(N\cdot\text{xbins}\cdot\text{ybins}) \f$ .
+
+    \tparam InputItX standard iterator type of \a firstX and \a lastX.
+    \tparam InputItY standard iterator type of \a firstY and \a lastY.
+    \param firstX iterator pointing to the first x-position item in the dataset to use \f$ X_1 \f$
+    \param lastX iterator pointing behind the last x-position item in the dataset to use \f$ X_N \f$
+    \param firstY iterator pointing to the first y-position item in the dataset to use \f$ Y_1 \f$
+    \param lastY iterator pointing behind the last y-position item in the dataset to use \f$ Y_N \f$
+    \param[out] histogramImg receives the KDE (\a xbins * \a ybins values in row-major ordering)
+    \param xmin position of the first histogram bin in x-direction
+    \param xmax position of the last histogram bin in x-direction
+    \param ymin position of the first histogram bin in y-direction
+    \param ymax position of the last histogram bin in y-direction
+    \param xbins number of bins in x-direction (i.e. width of the output histogram \a histogramImg )
+    \param ybins number of bins in y-direction (i.e. height of the output histogram \a histogramImg )
+    \param kernel the kernel function to use (has to be a built-in kernel, see jkqtpstatIsBuiltinKernel2D() )
+    \param bandwidthX x-bandwidth used for the KDE
+    \param bandwidthY y-bandwidth used for the KDE
+    \return \c false (and leaves \a histogramImg untouched), if the binned KDE cannot be used (custom kernel, too large grid) or if the exact evaluation is cheaper
+
+    \see jkqtpstatKDE2D()
+*/
+template <class InputItX, class InputItY>
+inline bool jkqtpstatKDE2DBinned(InputItX firstX, InputItX lastX, InputItY firstY, InputItY lastY, std::vector<double>& histogramImg, double xmin, double xmax, double ymin, double ymax, size_t xbins, size_t ybins, const std::function<double(double,double)>& kernel, double bandwidthX, double bandwidthY) {
+    std::function<double(double)> kernelX, kernelY;
+    double radius=0;
+    if (xbins==0 || ybins==0 || !JKQTPIsOKFloat(bandwidthX) || !JKQTPIsOKFloat(bandwidthY) || bandwidthX<=0.0 || bandwidthY<=0.0) return false;
+    if (!JKQTPIsOKFloat(xmin) || !JKQTPIsOKFloat(xmax) || !JKQTPIsOKFloat(ymin) || !JKQTPIsOKFloat(ymax)) return false;
+    if (!jkqtpstatIsBuiltinKernel2D(kernel, &kernelX, &kernelY, &radius)) return false;
+
+    const double binwx=fabs(xmax-xmin)/static_cast<double>(xbins);
+    const double binwy=fabs(ymax-ymin)/static_cast<double>(ybins);
+    if (binwx<=0.0 || binwy<=0.0) return false;
+
+    double dataXMin=0, dataXMax=0, dataYMin=0, dataYMax=0;
+    size_t N=0;
+    {
+        bool first=true;
+        auto itX=firstX;
+        auto itY=firstY;
+        for (; (itX!=lastX)&&(itY!=lastY); ++itX, ++itY)  {
+            const double vx=jkqtp_todouble(*itX);
+            const double vy=jkqtp_todouble(*itY);
+            if (JKQTPIsOKFloat(vx) && JKQTPIsOKFloat(vy)) {
+                if (first) {
+                    dataXMin=dataXMax=vx;
+                    dataYMin=dataYMax=vy;
+                    first=false;
+                } else {
+                    dataXMin=std::min(dataXMin, vx);
+                    dataXMax=std::max(dataXMax, vx);
+                    dataYMin=std::min(dataYMin, vy);
+                    dataYMax=std::max(dataYMax, vy);
+                }
+                N++;
+            }
+        }
+    }
+    if (N==0) {
+        histogramImg.assign(xbins*ybins, 0.0);
+        return true;
+    }
+
+    // one axis of the grid: output positions coincide with every sub-th gridpoint, the grid is extended by the kernel support (but not beyond the data)
+    struct GridAxis {
+        double delta;
+        size_t sub;
+        size_t pad;
+        size_t size;
+        double left;
+    };
+    auto makeAxis=[radius](double outLeft, double binw, size_t bins, double bandwidth, double dataMin, double dataMax, GridAxis& ax) {
+        const double dgMax=bandwidth/static_cast<double>(JKQTPSTATISTICS_KDE2D_BINNED_GRIDPOINTS_PER_BANDWIDTH);
+        const double sub=ceil(binw/dgMax);
+        ax.delta=binw/sub;
+        const double outRight=outLeft+binw*static_cast<double>(bins-1);
+        const double R=radius*bandwidth;
+        const double padLeft=ceil(std::max(0.0, std::min(R, outLeft-dataMin))/ax.delta)+1.0;
+        const double padRight=ceil(std::max(0.0, std::min(R, dataMax-outRight))/ax.delta)+1.0;
+        const double size=padLeft+sub*static_cast<double>(bins-1)+1.0+padRight;
+        if (!JKQTPIsOKFloat(size) || size>static_cast<double>(JKQTPSTATISTICS_KDE2D_BINNED_MAX_GRIDSIZE)) return false;
+        ax.sub=static_cast<size_t>(sub);
+        ax.pad=static_cast<size_t>(padLeft);
+        ax.size=static_cast<size_t>(size);
+        ax.left=outLeft-padLeft*ax.delta;
+        return true;
+    };
+    GridAxis ax, ay;
+    if (!makeAxis(xmin, binwx, xbins, bandwidthX, dataXMin, dataXMax, ax)) return false;
+    if (!makeAxis(ymin, binwy, ybins, bandwidthY, dataYMin, dataYMax, ay)) return false;
+    const double gridSize=static_cast<double>(ax.size)*static_cast<double>(ay.size);
+    if (gridSize>static_cast<double>(JKQTPSTATISTICS_KDE2D_BINNED_MAX_GRIDSIZE)) return false;
+    // for small datasets the exact evaluation is faster
+    if (static_cast<double>(N)*static_cast<double>(xbins)*static_cast<double>(ybins)<=8.0*gridSize*log2(gridSize+1.0)) return false;
+
+    // bilinear binning of the data
+    std::vector<double> grid(ax.size*ay.size, 0.0);
+    {
+        auto itX=firstX;
+        auto itY=firstY;
+        for (; (itX!=lastX)&&(itY!=lastY); ++itX, ++itY)  {
+            const double vx=jkqtp_todouble(*itX);
+            const double vy=jkqtp_todouble(*itY);
+            if (JKQTPIsOKFloat(vx) && JKQTPIsOKFloat(vy)) {
+                const double px=(vx-ax.left)/ax.delta;
+                const double py=(vy-ay.left)/ay.delta;
+                if (px>=0.0 && py>=0.0 && px<static_cast<double>(ax.size-1) && py<static_cast<double>(ay.size-1)) {
+                    const size_t jx=static_cast<size_t>(px);
+                    const size_t jy=static_cast<size_t>(py);
+                    const double wx=px-static_cast<double>(jx);
+                    const double wy=py-static_cast<double>(jy);
+                    double* g=grid.data()+jy*ax.size+jx;
+                    g[0]+=(1.0-wx)*(1.0-wy);
+                    g[1]+=wx*(1.0-wy);
+                    g[ax.size]+=(1.0-wx)*wy;
+                    g[ax.size+1]+=wx*wy;
+                }
+            }
+        }
+    }
+
+    // only the columns of the output positions are required after the convolution in x-direction
+    jkqtpstatConvolveKernel2DGridSeparable(grid, ax.size, ax.delta/bandwidthX, ay.delta/bandwidthY, kernelX, kernelY, radius, ax.pad, ax.sub);
+
+    // read out the KDE at the output positions
+    const double norm=1.0/static_cast<double>(N)/sqrt(bandwidthX*bandwidthY);
+    histogramImg.resize(xbins*ybins);
+    for (size_t by=0; by<ybins; by++) {
+        const double* g=grid.data()+(ay.pad+by*ay.sub)*ax.size+ax.pad;
+        double* o=histogramImg.data()+by*xbins;
+        for (size_t bx=0; bx<xbins; bx++) {
+            o[bx]=g[bx*ax.sub]*norm;
+        }
+    }
+    return true;
+}
+
+
+
 
 /*! \brief calculate an autoranged 2-dimensional Kernel Density Estimation (KDE) from the given data range \a firstX / \a firstY ... \a lastY / \a lastY
     \ingroup jkqtptools_math_statistics_2dkde
@@ -496,11 +841,25 @@ inline double jkqtpstatEvaluateKernelSum2D(double x, double y, InputItX firstX,
     \param bandwidthX x-bandwidth used for the KDE
     \param bandwidthY y-bandwidth used for the KDE
 
+    \note For the built-in kernels (jkqtpstatKernel2DGaussian(), jkqtpstatKernel2DUniform() ) and large datasets, the KDE is calculated by linear binning and
+          a separable (FFT) convolution (see jkqtpstatKDE2DBinned() ). For custom kernels the KDE is evaluated exactly, which gets very slow for large datasets.
+
     \see https://en.wikipedia.org/wiki/Multivariate_kernel_density_estimation, \ref JKQTPlotterBasicJKQTPDatastoreStatistics
 */
 
 template <class InputItX, class InputItY, class OutputIt>
 inline void jkqtpstatKDE2D(InputItX firstX, InputItX lastX, InputItY firstY, InputItY lastY, OutputIt histogramImgOut, double xmin, double xmax, double ymin, double ymax, size_t xbins, size_t ybins, const std::function<double(double,double)>& kernel=std::function<double(double,double)>(&jkqtpstatKernel2DGaussian), double bandwidthX=1.0, double bandwidthY=1.0) {
+    {
+        std::vector<double> img;
+        if (jkqtpstatKDE2DBinned(firstX, lastX, firstY, lastY, img, xmin, xmax, ymin, ymax, xbins, ybins, kernel, bandwidthX, bandwidthY)) {
+            auto itOut=histogramImgOut;
+            for (const double v: img) {
+                *itOut=v;
+                ++itOut;
+            }
+            return;
+        }
+    }
 
     const double binwx=fabs(xmax-xmin)/static_cast<double>(xbins);
     const double binwy=fabs(ymax-ymin)/static_cast<double>(ybins);
@@ -21,3 +21,101 @@
 
 #include "jkqtpstatpoly.h"
 
+
+
+JKQTPStatPolyFitAccumulator::JKQTPStatPolyFitAccumulator(size_t P, double xMin, double xMax):
+    m_P(P),
+    m_center((xMax+xMin)/2.0),
+    m_invScale(1.0),
+    m_N(0),
+    m_processed(0),
+    m_sumT(2*P+1, 0.0),
+    m_sumYT(P+1, 0.0)
+{
+    const double halfWidth=fabs(xMax-xMin)/2.0;
+    if (halfWidth>0 && JKQTPIsOKFloat(halfWidth)) m_invScale=1.0/halfWidth;
+}
+
+void JKQTPStatPolyFitAccumulator::merge(const JKQTPStatPolyFitAccumulator &other)
+{
+    JKQTPASSERT_M(m_P==other.m_P && m_center==other.m_center && m_invScale==other.m_invScale, "JKQTPStatPolyFitAccumulator::merge() requires accumulators with the same order and domain");
+    for (size_t m=0; m<m_sumT.size(); m++) m_sumT[m]+=other.m_sumT[m];
+    for (size_t k=0; k<m_sumYT.size(); k++) m_sumYT[k]+=other.m_sumYT[k];
+    m_N+=other.m_N;
+    m_processed+=other.m_processed;
+}
+
+void JKQTPStatPolyFitAccumulator::clear()
+{
+    std::fill(m_sumT.begin(), m_sumT.end(), 0.0);
+    std::fill(m_sumYT.begin(), m_sumYT.end(), 0.0);
+    m_N=0;
+    m_processed=0;
+}
+
+size_t JKQTPStatPolyFitAccumulator::degree() const
+{
+    return m_P;
+}
+
+size_t JKQTPStatPolyFitAccumulator::count() const
+{
+    return m_N;
+}
+
+size_t JKQTPStatPolyFitAccumulator::processedItems() const
+{
+    return m_processed;
+}
+
+std::vector<double> JKQTPStatPolyFitAccumulator::chebyshevCoefficients() const
+{
+    const size_t P1=m_P+1;
+    // Gram matrix G_jk=sum_i T_j(t_i)*T_k(t_i)=(S_{j+k}+S_{|j-k|})/2
+    std::vector<double> G(P1*P1, 0.0);
+    for (size_t j=0; j<P1; j++) {
+        for (size_t k=0; k<P1; k++) {
+            G[jkqtplinalgMatIndex(j,k,P1)]=(m_sumT[j+k]+m_sumT[(j>k)?(j-k):(k-j)])/2.0;
+        }
+    }
+    std::vector<double> c=m_sumYT;
+    if (m_N<P1 || !jkqtplinalgLinSolve(G.data(), c.data(), static_cast<long>(P1))) {
+        throw std::runtime_error("jkqtplinalgLinSolve() didn't return a result!");
+    }
+    return c;
+}
+
+std::vector<double> JKQTPStatPolyFitAccumulator::coefficients() const
+{
+    const std::vector<double> c=chebyshevCoefficients();
+    const size_t P1=m_P+1;
+
+    // convert to monomials in t: a_t=sum_k c_k*T_k(t), using T_{k+1}=2t*T_k-T_{k-1}
+    std::vector<double> at(P1, 0.0);
+    std::vector<double> Tkm1(P1, 0.0), Tk(P1, 0.0), Tkp1(P1, 0.0);
+    Tkm1[0]=1.0;
+    at[0]+=c[0];
+    if (m_P>0) {
+        Tk[1]=1.0;
+        at[1]+=c[1];
+    }
+    for (size_t k=2; k<P1; k++) {
+        Tkp1[0]=-Tkm1[0];
+        for (size_t i=1; i<=k; i++) Tkp1[i]=2.0*Tk[i-1]-Tkm1[i];
+        for (size_t i=0; i<=k; i++) at[i]+=c[k]*Tkp1[i];
+        std::swap(Tkm1, Tk);
+        std::swap(Tk, Tkp1);
+    }
+
+    // substitute t=alpha*x+beta, using Horner's scheme on the coefficient vectors
+    const double alpha=m_invScale;
+    const double beta=-m_center*m_invScale;
+    std::vector<double> p(P1, 0.0);
+    p[0]=at[m_P];
+    for (size_t k=m_P; k>0; k--) {
+        // p <- p*(alpha*x+beta)+at[k-1]
+        for (size_t i=m_P-k+1; i>0; i--) p[i]=p[i]*beta+p[i-1]*alpha;
+        p[0]=p[0]*beta+at[k-1];
+    }
+    return p;
+}
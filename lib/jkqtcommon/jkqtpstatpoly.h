@@ -38,19 +38,168 @@
 #include "jkqtcommon/jkqtplinalgtools.h"
 #include "jkqtcommon/jkqtparraytools.h"
 #include "jkqtcommon/jkqtpdebuggingtools.h"
+#include "jkqtcommon/jkqtpcodestructuring.h"
+#include "jkqtcommon/jkqtpstatbasics.h"
+#include <stdexcept>
 
 
 
 
 
 
+#ifndef JKQTPSTATISTICS_POLYFIT_PARALLEL_MINCHUNK
+/*! \brief minimum number of datapoints per thread, before jkqtpstatPolyFit() splits its input range and accumulates it with several threads
+    \ingroup jkqtptools_math_statistics_poly
+*/
+#define JKQTPSTATISTICS_POLYFIT_PARALLEL_MINCHUNK (1<<16)
+#endif
+
+
+/*! \brief single-pass, mergeable accumulator for a least-squares fit of a polynomial \f$ f(x)=\sum\limits_{i=0}^Pp_ix^i \f$ of order P
+    \ingroup jkqtptools_math_statistics_poly
+
+    Instead of building the \f$ N\times(P+1) \f$ Vandermonde matrix, this accumulator only keeps sums of size \f$ \mathcal{O}(P) \f$ .
+    To keep the problem well-conditioned, the x-values are mapped from the fit domain \f$ [x_\text{min}..x_\text{max}] \f$ (set in the constructor)
+    to \f$ t\in[-1..1] \f$ and the polynomial is expanded in Chebyshev polynomials \f$ T_k(t) \f$ :
+      \f[ f(x)=\sum\limits_{k=0}^Pc_kT_k(t),\ \ \ \ \ t=\frac{2x-x_\text{max}-x_\text{min}}{x_\text{max}-x_\text{min}} \f]
+    As \f$ T_jT_k=\frac{1}{2}(T_{j+k}+T_{|j-k|}) \f$ , the normal equations of this problem only need the sums
+      \f[ S_m=\sum\limits_iT_m(t_i)\ \ (m=0..2P),\ \ \ \ \ \ \ \ R_k=\sum\limits_iy_i\cdot T_k(t_i)\ \ (k=0..P) \f]
+    which are updated with the Chebyshev recurrence \f$ T_{m+1}=2tT_m-T_{m-1} \f$ in \f$ \mathcal{O}(P) \f$ operations per datapoint.
+    The resulting Gram matrix \f$ G_{jk}=\frac{1}{2}(S_{j+k}+S_{|j-k|}) \f$ is well-conditioned (in contrast to \f$ V^TV \f$ for the monomials \f$ x^i \f$ ),
+    so the Chebyshev coefficients \f$ c_k \f$ from chebyshevCoefficients() stay accurate also for high degrees.
+
+    \warning The conversion to the monomial coefficients \f$ p_i \f$ in coefficients() is ill-conditioned again for high degrees
+             or fit domains far away from 0 (the \f$ p_i \f$ become large and cancel each other). In these cases, evaluate the fit
+             from chebyshevCoefficients() and the domain mapping above (e.g. with the Clenshaw recurrence) instead.
+
+    As the sums are simply added, accumulators (with the same P and domain) can be combined with merge(), e.g. one accumulator per thread.
+
+    \note Datapoints, where one of the values is an invalid double (using JKQTPIsOKFloat() ), are ignored.
+
+    \see jkqtpstatPolyFit()
+*/
+class JKQTCOMMON_LIB_EXPORT JKQTPStatPolyFitAccumulator {
+    public:
+        /** \brief class constructor for a polynomial of order \a P , fitted on the domain \a xMin ... \a xMax (datapoints outside this range are allowed, but degrade the conditioning) */
+        explicit JKQTPStatPolyFitAccumulator(size_t P=1, double xMin=-1.0, double xMax=1.0);
+
+        /** \brief adds the datapoint (\a x , \a y ) to the accumulator */
+        inline void add(double x, double y) {
+            m_processed++;
+            if (!JKQTPIsOKFloat(x) || !JKQTPIsOKFloat(y)) return;
+            m_N++;
+            const double t=(x-m_center)*m_invScale;
+            const double t2=2.0*t;
+            double Tm1=1.0, Tm=t;
+            m_sumT[0]+=1.0;
+            m_sumYT[0]+=y;
+            if (m_P>0) {
+                m_sumT[1]+=t;
+                m_sumYT[1]+=y*t;
+            }
+            const size_t M=2*m_P;
+            for (size_t m=2; m<=M; m++) {
+                const double Tp1=t2*Tm-Tm1;
+                m_sumT[m]+=Tp1;
+                if (m<=m_P) m_sumYT[m]+=y*Tp1;
+                Tm1=Tm;
+                Tm=Tp1;
+            }
+        }
+        /*! \brief adds all datapoints from the data ranges \a firstX ... \a lastX and \a firstY ... to the accumulator
+
+            \tparam InputItX standard iterator type of \a firstX and \a lastX.
+            \tparam InputItY standard iterator type of \a firstY.
+            \param firstX iterator pointing to the first item in the x-dataset to use \f$ x_1 \f$
+            \param lastX iterator pointing behind the last item in the x-dataset to use \f$ x_N \f$
+            \param firstY iterator pointing to the first item in the y-dataset to use \f$ y_1 \f$ (this range has to contain at least as many items as \a firstX ... \a lastX )
+
+            \note Each value is the specified range is converted to a double using jkqtp_todouble().
+        */
+        template <class InputItX, class InputItY>
+        inline void addRange(InputItX firstX, InputItX lastX, InputItY firstY) {
+            auto itY=firstY;
+            for (auto itX=firstX; itX!=lastX; ++itX, ++itY) {
+                add(jkqtp_todouble(*itX), jkqtp_todouble(*itY));
+            }
+        }
+        /** \brief merges the state of \a other (which has to use the same order and domain) into this accumulator, afterwards this object represents the union of both datasets */
+        void merge(const JKQTPStatPolyFitAccumulator& other);
+        /** \brief resets the accumulator to the empty state (order and domain are kept) */
+        void clear();
+        /** \brief order P of the fitted polynomial */
+        size_t degree() const;
+        /** \brief number of valid datapoints, accumulated so far */
+        size_t count() const;
+        /** \brief number of datapoints that were passed to add() so far (including invalid datapoints, which were ignored) */
+        size_t processedItems() const;
+        /** \brief solves the (Chebyshev) normal equations and returns the P+1 coefficients \f$ c_k \f$ of \f$ f(x)=\sum_kc_kT_k(t) \f$ (see class description), throws a \c std::runtime_error if the system is singular (e.g. less than P+1 distinct x-values) */
+        std::vector<double> chebyshevCoefficients() const;
+        /** \brief solves the (Chebyshev) normal equations and returns the P+1 polynomial coefficients \f$ p_i \f$ of \f$ f(x)=\sum_ip_ix^i \f$ , throws a \c std::runtime_error if the system is singular (e.g. less than P+1 distinct x-values) */
+        std::vector<double> coefficients() const;
+    private:
+        /** \brief order of the polynomial */
+        size_t m_P;
+        /** \brief center \f$ (x_\text{max}+x_\text{min})/2 \f$ of the fit domain */
+        double m_center;
+        /** \brief inverse half-width \f$ 2/(x_\text{max}-x_\text{min}) \f$ of the fit domain */
+        double m_invScale;
+        /** \brief number of valid datapoints */
+        size_t m_N;
+        /** \brief number of processed datapoints */
+        size_t m_processed;
+        /** \brief \f$ S_m=\sum_iT_m(t_i) \f$ for \f$ m=0..2P \f$ */
+        std::vector<double> m_sumT;
+        /** \brief \f$ R_k=\sum_iy_iT_k(t_i) \f$ for \f$ k=0..P \f$ */
+        std::vector<double> m_sumYT;
+};
+
+
+/*! \brief adds the first \a N datapoints of \a firstX / \a firstY to \a acc (serial version for iterators that cannot be split into chunks)
+    \ingroup jkqtptools_math_statistics_poly
+    \internal
+*/
+template <class InputItX, class InputItY>
+inline void jkqtpstatPolyFitAccumulate(JKQTPStatPolyFitAccumulator& acc, InputItX firstX, InputItY firstY, size_t N, std::false_type /*chunkable*/) {
+    auto itX=firstX;
+    auto itY=firstY;
+    for (size_t i=0; i<N; i++, ++itX, ++itY) {
+        acc.add(jkqtp_todouble(*itX), jkqtp_todouble(*itY));
+    }
+}
+
+/*! \brief adds the first \a N datapoints of \a firstX / \a firstY to \a acc , large ranges are split into chunks that are accumulated in parallel
+    \ingroup jkqtptools_math_statistics_poly
+    \internal
+*/
+template <class InputItX, class InputItY>
+inline void jkqtpstatPolyFitAccumulate(JKQTPStatPolyFitAccumulator& acc, InputItX firstX, InputItY firstY, size_t N, std::true_type /*chunkable*/) {
+    typedef decltype(firstX-firstX) DiffTX;
+    typedef decltype(firstY-firstY) DiffTY;
+    const size_t threads=static_cast<size_t>(std::max(1, jkqtpParallelThreadCount()));
+    const size_t chunks=std::max<size_t>(1, std::min(threads, N/JKQTPSTATISTICS_POLYFIT_PARALLEL_MINCHUNK));
+    if (chunks<=1) {
+        jkqtpstatPolyFitAccumulate(acc, firstX, firstY, N, std::false_type());
+        return;
+    }
+    JKQTPStatPolyFitAccumulator empty=acc;
+    empty.clear();
+    std::vector<JKQTPStatPolyFitAccumulator> parts(chunks, empty);
+    jkqtpParallelFor(chunks, [&](size_t c) {
+        const size_t b=N*c/chunks;
+        const size_t e=N*(c+1)/chunks;
+        jkqtpstatPolyFitAccumulate(parts[c], firstX+static_cast<DiffTX>(b), firstY+static_cast<DiffTY>(b), e-b, std::false_type());
+    });
+    for (const auto& part: parts) acc.merge(part);
+}
+
+
 /*! \brief fits (in a least-squares sense) a polynomial \f$ f(x)=\sum\limits_{i=0}^Pp_ix^i \f$ of order P to a set of N data pairs \f$ (x_i,y_i) \f$
     \ingroup jkqtptools_math_statistics_poly
 
     \tparam InputItX standard iterator type of \a firstX and \a lastX.
     \tparam InputItY standard iterator type of \a firstY and \a lastY.
     \tparam OutputItP output iterator for the polynomial coefficients
-    \param type model to be fitted
     \param firstX iterator pointing to the first item in the x-dataset to use \f$ x_1 \f$
     \param lastX iterator pointing behind the last item in the x-dataset to use \f$ x_N \f$
     \param firstY iterator pointing to the first item in the y-dataset to use \f$ y_1 \f$
@@ -58,13 +207,24 @@
     \param P degree of the polynomial (P>=N !!!)
     \param[out] firstRes Iterator (of type \a OutputItP ), which receives the (P+1)-entry vector with the polynomial coefficients \f$ p_i \f$
 
-    This function uses jkqtpstatLinSolve() to solve the system of equations
+    \note The input ranges are read twice, so \a InputItX and \a InputItY have to be (at least) forward iterators, single-pass input iterators
+          (e.g. \c std::istream_iterator ) are not supported. Use JKQTPStatPolyFitAccumulator directly, if the data can only be read once
+          and its range is known beforehand.
+
+    This function solves the least-squares problem for the system of equations
       \f[ \begin{bmatrix} y_1\\ y_2\\ y_3 \\ \vdots \\ y_n \end{bmatrix}= \begin{bmatrix} 1 & x_1 & x_1^2 & \dots & x_1^P \\ 1 & x_2 & x_2^2 & \dots & x_2^P\\ 1 & x_3 & x_3^2 & \dots & x_3^P \\ \vdots & \vdots & \vdots & & \vdots \\ 1 & x_n & x_n^2 & \dots & x_n^P \end{bmatrix} \begin{bmatrix} p_0\\ p_1\\ p_2\\ \vdots \\ p_P \end{bmatrix}  \f]
       \f[ \vec{y}=V\vec{p}\ \ \ \ \ \Rightarrow\ \ \ \ \ \vec{p}=(V^TV)^{-1}V^T\vec{y} \f]
+    without building the matrix \f$ V \f$ : A first pass over the data determines the range of the x-values, a second pass
+    accumulates the sums of a JKQTPStatPolyFitAccumulator on that range, i.e. the normal equations are formed in the (well-conditioned)
+    basis of Chebyshev polynomials and the memory consumption is \f$ \mathcal{O}(P) \f$ instead of \f$ \mathcal{O}(N\cdot P) \f$ .
+    If the ranges can be split in constant time (see JKQTPStatIsChunkableIterator) and contain enough datapoints, the second pass
+    is split into chunks of at least JKQTPSTATISTICS_POLYFIT_PARALLEL_MINCHUNK datapoints, which are accumulated in parallel (see jkqtpParallelFor() ).
+    The returned monomial coefficients are obtained from the Chebyshev coefficients, so for high degrees they suffer from the ill-conditioning
+    described in JKQTPStatPolyFitAccumulator.
 
     \image html datastore_regression_polynom.png
 
-    \see https://en.wikipedia.org/wiki/Polynomial_regression
+    \see https://en.wikipedia.org/wiki/Polynomial_regression, JKQTPStatPolyFitAccumulator
 */
 template <class InputItX, class InputItY, class OutputItP>
 inline void jkqtpstatPolyFit(InputItX firstX, InputItX lastX, InputItY firstY, InputItY lastY, size_t P, OutputItP firstRes) {
@@ -74,96 +234,35 @@ inline void jkqtpstatPolyFit(InputItX firstX, InputItX lastX, InputItY firstY, I
         JKQTPASSERT(Nx>1 && Ny>1);
     }
 
+    // 1st pass: range of the x-values (of the valid datapoints)
     size_t N=0;
-
-    std::vector<double> X,Y;
+    double xmin=0, xmax=0;
     auto itX=firstX;
     auto itY=firstY;
     for (; itX!=lastX && itY!=lastY; ++itX, ++itY) {
         const double fit_x=jkqtp_todouble(*itX);
         const double fit_y=jkqtp_todouble(*itY);
         if (JKQTPIsOKFloat(fit_x) && JKQTPIsOKFloat(fit_y)) {
-            X.push_back(fit_x);
-            Y.push_back(fit_y);
+            if (N==0) {
+                xmin=xmax=fit_x;
+            } else {
+                if (fit_x<xmin) xmin=fit_x;
+                if (fit_x>xmax) xmax=fit_x;
+            }
             N++;
         }
     }
+    const size_t Nrange=static_cast<size_t>(std::distance(firstX, itX));
 
-    // build Vandermonde matrix V
-    std::vector<double> V;
-    V.resize(N*(P+1));
-    for (size_t l=0; l<N; l++) {
-        V[jkqtplinalgMatIndex(l,0,P+1)]=1.0;
-        double x=X[l];
-        const double xx=x;
-        for (size_t c=1; c<P+1; c++) {
-            V[jkqtplinalgMatIndex(l,c,P+1)]=x;
-            x=x*xx;
-        }
-    }
-#ifdef STATISTICS_TOOLS_DEBUG_statisticsPolyFit
-    std::cout<<"V = \n";
-    jkqtplinalgPrintMatrix(V.data(),N,P+1);
-    std::cout<<"\n";
-#endif
-
-    // calculate V^T
-   std::vector<double> VT=V;
-    jkqtplinalgTransposeMatrix(VT.data(), static_cast<long>(N), static_cast<long>(P+1));
-
-#ifdef STATISTICS_TOOLS_DEBUG_statisticsPolyFit
-    std::cout<<"V^T = \n";
-    jkqtplinalgPrintMatrix(VT.data(),P+1,N);
-    std::cout<<"\n";
-#endif
-
-    // calculate V^T*V
-    std::vector<double> VTV;
-    VTV.resize((P+1)*(P+1));
-    jkqtplinalgMatrixProduct(VT.data(), static_cast<long>(P+1), static_cast<long>(N), V.data(), static_cast<long>(N), static_cast<long>(P+1), VTV.data());
-
-#ifdef STATISTICS_TOOLS_DEBUG_statisticsPolyFit
-    std::cout<<"V^T*V = \n";
-    jkqtplinalgPrintMatrix(VTV.data(),P+1,P+1);
-    std::cout<<"\n";
-#endif
-
-    // calculate V^T*y
-    std::vector<double> VTY;
-    VTY.resize(P+1);
-    jkqtplinalgMatrixProduct(VT.data(), static_cast<long>(P+1), static_cast<long>(N), Y.data(), static_cast<long>(N), 1, VTY.data());
-
-#ifdef STATISTICS_TOOLS_DEBUG_statisticsPolyFit
-    std::cout<<"V^T*y = \n";
-    jkqtplinalgPrintMatrix(VTY.data(),P+1,1);
-    std::cout<<"\n";
-#endif
-
-    // solve V^T*y = V^T*V*p
-    const bool ok=jkqtplinalgLinSolve(VTV.data(), VTY.data(), static_cast<long>(P+1));
-
-    if (ok) {
-        auto itR=firstRes;
-        for (size_t p=0; p<P+1; p++) {
-            *itR=VTY[p];
-            ++itR;
-        }
-    } else {
-        throw std::runtime_error("jkqtplinalgLinSolve() didn't return a result!");
-    }
-
-#ifdef STATISTICS_TOOLS_DEBUG_statisticsPolyFit
-    std::cout<<"result_out = \n";
-    jkqtplinalgPrintMatrix(result_out,P+1,1);
-    std::cout<<"\n";
-#endif
+    // 2nd pass: accumulate the sums in the Chebyshev basis
+    JKQTPStatPolyFitAccumulator acc(P, xmin, xmax);
+    jkqtpstatPolyFitAccumulate(acc, firstX, firstY, Nrange, std::integral_constant<bool, JKQTPStatIsChunkableIterator<InputItX>::value && JKQTPStatIsChunkableIterator<InputItY>::value>());
 
+    const std::vector<double> coeffs=acc.coefficients();
+    std::copy(coeffs.begin(), coeffs.end(), firstRes);
 }
 
 
-
-
-
 #endif // JKQTPSTATPOLY_H_INCLUDED
 
 
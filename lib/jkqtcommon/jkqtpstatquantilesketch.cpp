@@ -0,0 +1,237 @@
+/*
+    Copyright (c) 2008-2020 Jan W. Krieger (<jan@jkrieger.de>)
+
+    last modification: $LastChangedDate$  (revision $Rev$)
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License (LGPL) as published by
+    the Free Software Foundation, either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License (LGPL) for more details.
+
+    You should have received a copy of the GNU Lesser General Public License (LGPL)
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "jkqtpstatquantilesketch.h"
+#include <algorithm>
+
+
+JKQTPStatQuantileSketch::JKQTPStatQuantileSketch(double compression):
+    m_compression(std::max(10.0, compression)),
+    m_bufferSize(0),
+    m_count(0),
+    m_weight(0),
+    m_sum(0),
+    m_min(JKQTP_DOUBLE_NAN),
+    m_max(JKQTP_DOUBLE_NAN)
+{
+    m_bufferSize=static_cast<size_t>(std::ceil(5.0*m_compression));
+    m_buffer.reserve(m_bufferSize);
+}
+
+void JKQTPStatQuantileSketch::add(double value, double weight)
+{
+    if (!JKQTPIsOKFloat(value) || !JKQTPIsOKFloat(weight) || weight<=0) return;
+    if (m_count==0) {
+        m_min=m_max=value;
+    } else {
+        if (value<m_min) m_min=value;
+        if (value>m_max) m_max=value;
+    }
+    m_count++;
+    m_weight+=weight;
+    m_sum+=weight*value;
+    m_buffer.push_back(Centroid(value, weight));
+    if (m_buffer.size()>=m_bufferSize) flush();
+}
+
+void JKQTPStatQuantileSketch::merge(const JKQTPStatQuantileSketch &other)
+{
+    if (&other==this || other.isEmpty()) return;
+    other.flush();
+    if (m_count==0) {
+        m_min=other.m_min;
+        m_max=other.m_max;
+    } else {
+        m_min=std::min(m_min, other.m_min);
+        m_max=std::max(m_max, other.m_max);
+    }
+    m_count+=other.m_count;
+    m_weight+=other.m_weight;
+    m_sum+=other.m_sum;
+    m_buffer.insert(m_buffer.end(), other.m_centroids.begin(), other.m_centroids.end());
+    flush();
+}
+
+void JKQTPStatQuantileSketch::clear()
+{
+    m_centroids.clear();
+    m_buffer.clear();
+    m_count=0;
+    m_weight=0;
+    m_sum=0;
+    m_min=JKQTP_DOUBLE_NAN;
+    m_max=JKQTP_DOUBLE_NAN;
+}
+
+double JKQTPStatQuantileSketch::compression() const
+{
+    return m_compression;
+}
+
+size_t JKQTPStatQuantileSketch::count() const
+{
+    return m_count;
+}
+
+double JKQTPStatQuantileSketch::totalWeight() const
+{
+    return m_weight;
+}
+
+bool JKQTPStatQuantileSketch::isEmpty() const
+{
+    return m_count==0;
+}
+
+size_t JKQTPStatQuantileSketch::centroidCount() const
+{
+    flush();
+    return m_centroids.size();
+}
+
+double JKQTPStatQuantileSketch::minimum() const
+{
+    return m_min;
+}
+
+double JKQTPStatQuantileSketch::maximum() const
+{
+    return m_max;
+}
+
+double JKQTPStatQuantileSketch::average() const
+{
+    if (m_count==0) return JKQTP_DOUBLE_NAN;
+    return m_sum/m_weight;
+}
+
+double JKQTPStatQuantileSketch::quantile(double quantile) const
+{
+    if (m_count==0) return JKQTP_DOUBLE_NAN;
+    flush();
+    if (quantile<=0) return m_min;
+    if (quantile>=1) return m_max;
+    const size_t n=m_centroids.size();
+    const double index=quantile*m_weight;
+    // the distribution is approximated piecewise linearly through the points (min,0), (mean_i, t_i), (max,W),
+    // where t_i is the cumulative weight up to the center of centroid i
+    double tLeft=0;
+    double xLeft=m_min;
+    double wSoFar=0;
+    for (size_t i=0; i<n; i++) {
+        const double t=wSoFar+m_centroids[i].weight/2.0;
+        if (index<t) {
+            if (t<=tLeft) return m_centroids[i].mean;
+            return xLeft+(m_centroids[i].mean-xLeft)*(index-tLeft)/(t-tLeft);
+        }
+        tLeft=t;
+        xLeft=m_centroids[i].mean;
+        wSoFar+=m_centroids[i].weight;
+    }
+    if (m_weight<=tLeft) return m_max;
+    return xLeft+(m_max-xLeft)*(index-tLeft)/(m_weight-tLeft);
+}
+
+double JKQTPStatQuantileSketch::median() const
+{
+    return quantile(0.5);
+}
+
+double JKQTPStatQuantileSketch::cdf(double x) const
+{
+    if (m_count==0 || !JKQTPIsOKFloat(x)) return JKQTP_DOUBLE_NAN;
+    if (x<m_min) return 0;
+    if (x>=m_max) return 1;
+    flush();
+    const size_t n=m_centroids.size();
+    double tLeft=0;
+    double xLeft=m_min;
+    double wSoFar=0;
+    for (size_t i=0; i<n; i++) {
+        const double t=wSoFar+m_centroids[i].weight/2.0;
+        if (x<m_centroids[i].mean) {
+            if (m_centroids[i].mean<=xLeft) return t/m_weight;
+            return (tLeft+(t-tLeft)*(x-xLeft)/(m_centroids[i].mean-xLeft))/m_weight;
+        }
+        tLeft=t;
+        xLeft=m_centroids[i].mean;
+        wSoFar+=m_centroids[i].weight;
+    }
+    if (m_max<=xLeft) return 1;
+    return (tLeft+(m_weight-tLeft)*(x-xLeft)/(m_max-xLeft))/m_weight;
+}
+
+JKQTPStat5NumberStatistics JKQTPStatQuantileSketch::fiveNumberStatistics(double quantile1Spec, double quantile2Spec, double minimumQuantile, double maximumQuantile) const
+{
+    JKQTPStat5NumberStatistics res;
+    res.minimumQuantile=minimumQuantile;
+    res.maximumQuantile=maximumQuantile;
+    res.quantile1Spec=quantile1Spec;
+    res.quantile2Spec=quantile2Spec;
+    res.N=m_count;
+    if (m_count>0) {
+        res.minimum=quantile(minimumQuantile);
+        res.quantile1=quantile(quantile1Spec);
+        res.median=quantile(0.5);
+        res.quantile2=quantile(quantile2Spec);
+        res.maximum=quantile(maximumQuantile);
+    }
+    return res;
+}
+
+void JKQTPStatQuantileSketch::flush() const
+{
+    if (m_buffer.empty()) return;
+    m_buffer.insert(m_buffer.end(), m_centroids.begin(), m_centroids.end());
+    std::sort(m_buffer.begin(), m_buffer.end());
+    m_centroids.clear();
+    const double W=m_weight;
+    double wSoFar=0;
+    double wLimit=W*scaleKInverse(scaleK(0)+1.0);
+    Centroid cur=m_buffer[0];
+    for (size_t i=1; i<m_buffer.size(); i++) {
+        const Centroid& c=m_buffer[i];
+        if (wSoFar+cur.weight+c.weight<=wLimit) {
+            // merge into the current centroid (incremental weighted mean)
+            cur.weight+=c.weight;
+            cur.mean+=(c.mean-cur.mean)*c.weight/cur.weight;
+        } else {
+            m_centroids.push_back(cur);
+            wSoFar+=cur.weight;
+            wLimit=W*scaleKInverse(scaleK(wSoFar/W)+1.0);
+            cur=c;
+        }
+    }
+    m_centroids.push_back(cur);
+    m_buffer.clear();
+}
+
+double JKQTPStatQuantileSketch::scaleK(double q) const
+{
+    return m_compression/(2.0*JKQTPSTATISTICS_PI)*asin(2.0*jkqtp_bounded(0.0, q, 1.0)-1.0);
+}
+
+double JKQTPStatQuantileSketch::scaleKInverse(double k) const
+{
+    const double kmax=m_compression/4.0;
+    if (k>=kmax) return 1.0;
+    return (sin(k*2.0*JKQTPSTATISTICS_PI/m_compression)+1.0)/2.0;
+}
@@ -0,0 +1,205 @@
+/*
+    Copyright (c) 2008-2020 Jan W. Krieger (<jan@jkrieger.de>)
+
+    last modification: $LastChangedDate$  (revision $Rev$)
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License (LGPL) as published by
+    the Free Software Foundation, either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License (LGPL) for more details.
+
+    You should have received a copy of the GNU Lesser General Public License (LGPL)
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef JKQTPSTATQUANTILESKETCH_H_INCLUDED
+#define JKQTPSTATQUANTILESKETCH_H_INCLUDED
+
+#include <stdint.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <iterator>
+#include "jkqtcommon/jkqtcommon_imexport.h"
+#include "jkqtcommon/jkqtpstatbasics.h"
+
+
+/*! \brief mergeable, memory-bounded sketch of a (possibly huge or streamed) distribution, which allows to estimate
+           arbitrary quantiles, the cumulative distribution function and the probability density (merging t-digest)
+    \ingroup jkqtptools_math_statistics_basic
+
+    The sketch summarizes all values added with add() or addRange() by a sorted list of weighted centroids.
+    The number of centroids is bounded by approximately \f$ 2\cdot\delta \f$ , where \f$ \delta \f$ is the
+    compression() parameter given in the constructor, independent of the number of values that were added.
+    Centroids close to the tails of the distribution are kept smaller than those around the median, so the
+    rank error of extreme quantiles (e.g. 1% or 99%) is considerably smaller than for the median.
+    Typically the rank error of a quantile estimate is well below \f$ 1/\delta \f$ .
+
+    New values are collected in a small buffer and only merged into the centroid list, when the buffer is full
+    (or when a quantile is requested), so adding a value costs amortized \f$ \mathcal{O}(\log\delta) \f$ .
+
+    Two sketches can be combined with merge(). This allows to build sketches for different chunks of a dataset
+    independently (e.g. on different threads, one sketch per thread) and combine them afterwards, or to keep a sketch
+    per block of a stream and combine blocks on demand.
+
+    Example:
+    \code
+        JKQTPStatQuantileSketch sketch;
+        sketch.addRange(datastore1->begin(randomdatacol1), datastore1->end(randomdatacol1));
+        // ... later: append new data incrementally
+        sketch.add(newValue);
+        const double median=sketch.median();
+        const double p99=sketch.quantile(0.99);
+    \endcode
+
+    \note The minimum, maximum, average and count of the added values are tracked exactly. The
+          quantiles returned by quantile(), median() and fiveNumberStatistics() are approximations.
+
+    \note All functions of this class (including the \c const ones, which may flush the internal buffer)
+          must not be called concurrently on the same object. Use one sketch per thread and merge() them.
+
+    \see jkqtpstatAddVBoxplot(), jkqtpstatAddHBoxplot(), jkqtpstatAddVViolinplotQuantileSketch(), jkqtpstatAddHViolinplotQuantileSketch(),
+         T. Dunning, O. Ertl: "Computing Extremely Accurate Quantiles Using t-Digests", arXiv:1902.04023 (2019)
+*/
+class JKQTCOMMON_LIB_EXPORT JKQTPStatQuantileSketch {
+    public:
+        /** \brief constructs an empty sketch with the given compression parameter \f$ \delta \f$ (larger values give better accuracy, but require more memory) */
+        explicit JKQTPStatQuantileSketch(double compression=100.0);
+
+        /** \brief adds the value \a value with the weight \a weight to the sketch, invalid values (see JKQTPIsOKFloat() ) and non-positive weights are ignored */
+        void add(double value, double weight=1.0);
+        /*! \brief adds all values in the data range \a first ... \a last to the sketch
+
+            \tparam InputIt standard iterator type of \a first and \a last.
+            \param first iterator pointing to the first item in the dataset to use \f$ X_1 \f$
+            \param last iterator pointing behind the last item in the dataset to use \f$ X_N \f$
+
+            \note Each value is the specified range is converted to a double using jkqtp_todouble().
+                  Entries in the range that are invalid double (using JKQTPIsOKFloat() )
+                  are ignored.
+        */
+        template <class InputIt>
+        inline void addRange(InputIt first, InputIt last) {
+            for (auto it=first; it!=last; ++it) {
+                add(jkqtp_todouble(*it));
+            }
+        }
+        /** \brief merges the contents of \a other into this sketch (the result approximates the distribution of the union of both datasets) */
+        void merge(const JKQTPStatQuantileSketch& other);
+        /** \brief removes all values from the sketch */
+        void clear();
+
+        /** \brief the compression parameter \f$ \delta \f$ of the sketch */
+        double compression() const;
+        /** \brief number of values that were added to the sketch */
+        size_t count() const;
+        /** \brief sum of the weights of all values that were added to the sketch */
+        double totalWeight() const;
+        /** \brief \c true, if no values were added to the sketch */
+        bool isEmpty() const;
+        /** \brief number of centroids, currently used to represent the distribution */
+        size_t centroidCount() const;
+        /** \brief exact minimum of the added values (NAN for an empty sketch) */
+        double minimum() const;
+        /** \brief exact maximum of the added values (NAN for an empty sketch) */
+        double maximum() const;
+        /** \brief exact (weighted) average of the added values (NAN for an empty sketch) */
+        double average() const;
+
+        /** \brief estimates the \a quantile -quantile (range: 0..1) of the added values (NAN for an empty sketch) */
+        double quantile(double quantile) const;
+        /** \brief estimates the median of the added values (NAN for an empty sketch) */
+        double median() const;
+        /** \brief estimates the value of the cumulative distribution function at \a x , i.e. the fraction of values \f$ \leq x \f$ (NAN for an empty sketch) */
+        double cdf(double x) const;
+
+        /*! \brief estimates the Five-Number Statistical Summary from the sketch
+
+            \param quantile1Spec specifies which quantile to calculate for \a qantile1 (range: 0..1)
+            \param quantile2Spec specifies which quantile to calculate for \a qantile2 (range: 0..1)
+            \param minimumQuantile specifies a quantile for the return value minimum (default is 0 for the real minimum, but you could e.g. use 0.05 for the 5% quantile!)
+            \param maximumQuantile specifies a quantile for the return value maximum (default is 1 for the real maximum, but you could e.g. use 0.95 for the 95% quantile!)
+            \return the Five-Number Statistical Summary in a JKQTPStat5NumberStatistics (JKQTPStat5NumberStatistics::outliers is always empty)
+
+            \see jkqtpstat5NumberStatistics()
+        */
+        JKQTPStat5NumberStatistics fiveNumberStatistics(double quantile1Spec=0.25, double quantile2Spec=0.75, double minimumQuantile=0, double maximumQuantile=1.0) const;
+
+        /*! \brief estimates the probability density of the added values at \a samples equally spaced positions between minimum() and maximum()
+
+            \tparam OutputIt output iterator for the density positions
+            \tparam OutputYIt output iterator for the density values
+            \param positionsOut receives the positions, at which the density is estimated
+            \param densityOut receives the estimated density at each position (normalized to an integral of 1)
+            \param samples number of positions
+
+            The density is estimated from the differences of cdf() over intervals of the sample spacing around
+            each position, which corresponds to a histogram with \a samples bins, centered on the positions.
+        */
+        template <class OutputIt, class OutputYIt>
+        inline void densityEstimate(OutputIt positionsOut, OutputYIt densityOut, int samples=100) const {
+            if (isEmpty() || samples<=0) return;
+            const double mi=minimum();
+            const double ma=maximum();
+            if (samples==1 || ma<=mi) {
+                *positionsOut=mi;
+                *densityOut=1.0;
+                ++positionsOut;
+                ++densityOut;
+                return;
+            }
+            const double delta=(ma-mi)/static_cast<double>(samples-1);
+            for (int i=0; i<samples; i++) {
+                const double x=mi+static_cast<double>(i)*delta;
+                const double c0=(i==0)?0.0:cdf(x-delta/2.0);
+                const double c1=(i==samples-1)?1.0:cdf(x+delta/2.0);
+                *positionsOut=x;
+                *densityOut=(c1-c0)/delta;
+                ++positionsOut;
+                ++densityOut;
+            }
+        }
+
+    private:
+        /** \brief a single centroid of the sketch */
+        struct Centroid {
+            inline Centroid(double mean_=0, double weight_=0): mean(mean_), weight(weight_) {}
+            double mean;
+            double weight;
+            inline bool operator<(const Centroid& other) const { return mean<other.mean; }
+        };
+        /** \brief merges the buffered values into the centroid list */
+        void flush() const;
+        /** \brief scale function \f$ k(q)=\frac{\delta}{2\pi}\cdot\arcsin(2q-1) \f$ , which limits the size of centroids */
+        double scaleK(double q) const;
+        /** \brief inverse of scaleK() */
+        double scaleKInverse(double k) const;
+
+        /** \brief compression parameter \f$ \delta \f$ */
+        double m_compression;
+        /** \brief sorted list of merged centroids */
+        mutable std::vector<Centroid> m_centroids;
+        /** \brief values that were added, but not yet merged into m_centroids */
+        mutable std::vector<Centroid> m_buffer;
+        /** \brief maximum size of m_buffer, before it is merged */
+        size_t m_bufferSize;
+        /** \brief number of added values */
+        size_t m_count;
+        /** \brief sum of weights of the added values */
+        double m_weight;
+        /** \brief weighted sum of the added values */
+        double m_sum;
+        /** \brief minimum added value */
+        double m_min;
+        /** \brief maximum added value */
+        double m_max;
+};
+
+
+#endif // JKQTPSTATQUANTILESKETCH_H_INCLUDED
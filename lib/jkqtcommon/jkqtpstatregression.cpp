@@ -85,3 +85,228 @@ std::pair<std::function<double (double)>, std::function<double (double)> > jkqtp
     }
     throw std::runtime_error("unknown JKQTPStatRegressionModelType in jkqtpStatGenerateParameterBTransformation()");
 }
+
+JKQTPStatLinearRegressionAccumulator::JKQTPStatLinearRegressionAccumulator():
+    m_N(0),
+    m_processed(0),
+    m_W(0),
+    m_meanX(0),
+    m_meanY(0),
+    m_Sxx(0),
+    m_Sxy(0)
+{
+
+}
+
+void JKQTPStatLinearRegressionAccumulator::merge(const JKQTPStatLinearRegressionAccumulator &other)
+{
+    if (other.m_N==0) {
+        m_processed+=other.m_processed;
+        return;
+    }
+    if (m_N==0) {
+        const size_t processed=m_processed;
+        *this=other;
+        m_processed+=processed;
+        return;
+    }
+    const double W=m_W+other.m_W;
+    const double dx=other.m_meanX-m_meanX;
+    const double dy=other.m_meanY-m_meanY;
+    const double f=m_W*other.m_W/W;
+    m_Sxx+=other.m_Sxx+dx*dx*f;
+    m_Sxy+=other.m_Sxy+dx*dy*f;
+    m_meanX+=dx*other.m_W/W;
+    m_meanY+=dy*other.m_W/W;
+    m_W=W;
+    m_N+=other.m_N;
+    m_processed+=other.m_processed;
+}
+
+void JKQTPStatLinearRegressionAccumulator::clear()
+{
+    *this=JKQTPStatLinearRegressionAccumulator();
+}
+
+size_t JKQTPStatLinearRegressionAccumulator::count() const
+{
+    return m_N;
+}
+
+size_t JKQTPStatLinearRegressionAccumulator::processedItems() const
+{
+    return m_processed;
+}
+
+double JKQTPStatLinearRegressionAccumulator::sumOfWeights() const
+{
+    return m_W;
+}
+
+double JKQTPStatLinearRegressionAccumulator::averageX() const
+{
+    if (m_N<=0) return JKQTP_DOUBLE_NAN;
+    return m_meanX;
+}
+
+double JKQTPStatLinearRegressionAccumulator::averageY() const
+{
+    if (m_N<=0) return JKQTP_DOUBLE_NAN;
+    return m_meanY;
+}
+
+double JKQTPStatLinearRegressionAccumulator::varianceX() const
+{
+    if (m_N<=0) return 0;
+    return m_Sxx/m_W;
+}
+
+double JKQTPStatLinearRegressionAccumulator::covariance() const
+{
+    if (m_N<=0) return 0;
+    return m_Sxy/m_W;
+}
+
+void JKQTPStatLinearRegressionAccumulator::coefficients(double &coeffA, double &coeffB, bool fixA, bool fixB) const
+{
+    if (!fixA && !fixB) {
+        coeffB=m_Sxy/m_Sxx;
+        coeffA=m_meanY-coeffB*m_meanX;
+    } else if (fixA && !fixB) {
+        coeffB=(m_meanY-coeffA)/m_meanX;
+    } else if (!fixA && fixB) {
+        coeffA=m_meanY-coeffB*m_meanX;
+    }
+}
+
+
+namespace {
+    /** \brief accumulates the datapoints \a x[b..e-1] , \a y[b..e-1] with the IRLS weights \f$ w_i^2=|a+b\cdot x_i-y_i|^{p-2} \f$ (or with unit weights if \a unweighted \c ==true ) */
+    void jkqtpstatIRLSReduceSpan(JKQTPStatLinearRegressionAccumulator& acc, const double* x, const double* y, size_t b, size_t e, double coeffA, double coeffB, double p, bool unweighted) {
+        if (unweighted) {
+            for (size_t i=b; i<e; i++) acc.add(x[i], y[i]);
+        } else {
+            const double pw=p-2.0;
+            for (size_t i=b; i<e; i++) {
+                const double err=coeffA+coeffB*x[i]-y[i];
+                acc.add(x[i], y[i], pow(std::max<double>(JKQTP_EPSILON*100.0, fabs(err)), pw));
+            }
+        }
+    }
+
+    /** \brief accumulates all \a N datapoints (see jkqtpstatIRLSReduceSpan() ), large datasets are split into spans that are reduced in parallel */
+    JKQTPStatLinearRegressionAccumulator jkqtpstatIRLSReduce(const double* x, const double* y, size_t N, double coeffA, double coeffB, double p, bool unweighted) {
+        const size_t threads=static_cast<size_t>(std::max(1, jkqtpParallelThreadCount()));
+        const size_t chunks=std::max<size_t>(1, std::min(threads, N/JKQTPSTATISTICS_REGRESSION_PARALLEL_MINCHUNK));
+        JKQTPStatLinearRegressionAccumulator acc;
+        if (chunks<=1) {
+            jkqtpstatIRLSReduceSpan(acc, x, y, 0, N, coeffA, coeffB, p, unweighted);
+            return acc;
+        }
+        std::vector<JKQTPStatLinearRegressionAccumulator> parts(chunks);
+        jkqtpParallelFor(chunks, [&](size_t c) {
+            jkqtpstatIRLSReduceSpan(parts[c], x, y, N*c/chunks, N*(c+1)/chunks, coeffA, coeffB, p, unweighted);
+        });
+        // merge in a fixed order, so the result does not depend on the thread scheduling
+        for (const auto& part: parts) acc.merge(part);
+        return acc;
+    }
+
+    bool jkqtpstatIRLSConverged(double oldV, double newV, double tolerance) {
+        return fabs(newV-oldV)<=tolerance*std::max(fabs(oldV), fabs(newV));
+    }
+}
+
+void jkqtpstatRobustIRLSLinearRegressionContiguous(const double *x, const double *y, size_t N, double &coeffA, double &coeffB, bool fixA, bool fixB, double p, int iterations, bool warmStart, double tolerance)
+{
+    if (fixA&&fixB) return;
+    JKQTPASSERT_M(N>1, "too few datapoints");
+
+    double alast=coeffA, blast=coeffB;
+    int it=0;
+    if (!warmStart) {
+        jkqtpstatIRLSReduce(x, y, N, alast, blast, p, true).coefficients(alast, blast, fixA, fixB);
+        it=1;
+    }
+    for (; it<iterations; it++) {
+        double a=alast, b=blast;
+        jkqtpstatIRLSReduce(x, y, N, alast, blast, p, false).coefficients(a, b, fixA, fixB);
+        const bool converged=jkqtpstatIRLSConverged(alast, a, tolerance) && jkqtpstatIRLSConverged(blast, b, tolerance);
+        alast=a;
+        blast=b;
+        if (converged) break;
+    }
+    coeffA=alast;
+    coeffB=blast;
+}
+
+
+JKQTPStatIncrementalRobustIRLSRegression::JKQTPStatIncrementalRobustIRLSRegression(JKQTPStatRegressionModelType type, double tolerance):
+    m_type(type),
+    m_trafo(jkqtpStatGenerateTransformation(type)),
+    m_tolerance(tolerance),
+    m_processed(0),
+    m_hasFit(false),
+    m_lastA(0),
+    m_lastB(0),
+    m_lastFixA(false),
+    m_lastFixB(false),
+    m_lastP(0)
+{
+
+}
+
+void JKQTPStatIncrementalRobustIRLSRegression::clear()
+{
+    m_processed=0;
+    m_x.clear();
+    m_y.clear();
+    m_hasFit=false;
+}
+
+size_t JKQTPStatIncrementalRobustIRLSRegression::count() const
+{
+    return m_x.size();
+}
+
+size_t JKQTPStatIncrementalRobustIRLSRegression::processedItems() const
+{
+    return m_processed;
+}
+
+JKQTPStatRegressionModelType JKQTPStatIncrementalRobustIRLSRegression::modelType() const
+{
+    return m_type;
+}
+
+double JKQTPStatIncrementalRobustIRLSRegression::tolerance() const
+{
+    return m_tolerance;
+}
+
+void JKQTPStatIncrementalRobustIRLSRegression::setTolerance(double tolerance)
+{
+    m_tolerance=tolerance;
+}
+
+void JKQTPStatIncrementalRobustIRLSRegression::fit(double &coeffA, double &coeffB, bool fixA, bool fixB, double p, int iterations)
+{
+    if (fixA&&fixB) return;
+    auto aTrafo =jkqtpStatGenerateParameterATransformation(m_type);
+    auto bTrafo =jkqtpStatGenerateParameterBTransformation(m_type);
+
+    const bool warmStart=m_hasFit && m_lastFixA==fixA && m_lastFixB==fixB && m_lastP==p;
+    double a=(warmStart && !fixA)?m_lastA:aTrafo.first(coeffA);
+    double b=(warmStart && !fixB)?m_lastB:bTrafo.first(coeffB);
+
+    jkqtpstatRobustIRLSLinearRegressionContiguous(m_x.data(), m_y.data(), m_x.size(), a, b, fixA, fixB, p, iterations, warmStart, m_tolerance);
+
+    m_hasFit=true;
+    m_lastA=a;
+    m_lastB=b;
+    m_lastFixA=fixA;
+    m_lastFixB=fixB;
+    m_lastP=p;
+    coeffA=aTrafo.second(a);
+    coeffB=bTrafo.second(b);
+}
@@ -38,10 +38,129 @@
 #include "jkqtcommon/jkqtplinalgtools.h"
 #include "jkqtcommon/jkqtparraytools.h"
 #include "jkqtcommon/jkqtpdebuggingtools.h"
+#include "jkqtcommon/jkqtpcodestructuring.h"
 #include "jkqtcommon/jkqtpstatbasics.h"
 #include "jkqtcommon/jkqtpstatpoly.h"
 
 
+#ifndef JKQTPSTATISTICS_REGRESSION_PARALLEL_MINCHUNK
+/*! \brief minimum number of datapoints per thread, before the weighted reductions of jkqtpstatRobustIRLSLinearRegressionContiguous() are split over several threads
+    \ingroup jkqtptools_math_statistics_regression
+ */
+#define JKQTPSTATISTICS_REGRESSION_PARALLEL_MINCHUNK (1<<15)
+#endif
+
+
+/*! \brief single-pass, numerically stable and mergeable accumulator for a (weighted) linear regression with the model \f$ f(x)=a+b\cdot x \f$
+    \ingroup jkqtptools_math_statistics_regression
+
+    The datapoints \f$ (x_i,y_i) \f$ with statistical weights \f$ \omega_i \f$ are added one by one with add() (or addRange() ). The accumulator
+    does not store the data, but only the sum of weights \f$ W=\sum_i\omega_i \f$ , the weighted averages \f$ \overline{x} \f$ , \f$ \overline{y} \f$
+    and the co-moments
+      \f[ S_{xx}=\sum_i\omega_i\cdot(x_i-\overline{x})^2,\ \ \ \ S_{xy}=\sum_i\omega_i\cdot(x_i-\overline{x})\cdot(y_i-\overline{y}) \f]
+    which are updated with West's weighted version of Welford's formula. The regression coefficients are then
+      \f[ b=\frac{S_{xy}}{S_{xx}},\ \ \ \ a=\overline{y}-b\cdot\overline{x} \f]
+    This avoids the cancellation in the textbook formula \f$ \sum x_iy_i-N\cdot\overline{x}\cdot\overline{y} \f$ , when the data is far from the origin.
+
+    Like JKQTPStatMomentsAccumulator, accumulators can be combined with merge() (e.g. one accumulator per thread) and
+    updated incrementally, when rows are appended to a dataset (see processedItems() ):
+    \code
+        JKQTPStatLinearRegressionAccumulator acc;
+        // ... rows are appended to the columns colX and colY
+        acc.addRange(datastore->begin(colX)+acc.processedItems(), datastore->end(colX), datastore->begin(colY)+acc.processedItems());
+        double a=0, b=0;
+        acc.coefficients(a, b);
+    \endcode
+
+    \note Datapoints, where one of the values or the weight is an invalid double (using JKQTPIsOKFloat() ), are ignored.
+
+    \see jkqtpstatLinearRegression(), jkqtpstatLinearWeightedRegression(), jkqtpstatRobustIRLSLinearRegression()
+*/
+class JKQTCOMMON_LIB_EXPORT JKQTPStatLinearRegressionAccumulator {
+    public:
+        JKQTPStatLinearRegressionAccumulator();
+
+        /** \brief adds the datapoint (\a x , \a y ) with the statistical weight \a w (i.e. \f$ w_i^2 \f$ in the notation of jkqtpstatLinearWeightedRegression() ) to the accumulator */
+        inline void add(double x, double y, double w=1.0) {
+            m_processed++;
+            if (!JKQTPIsOKFloat(x) || !JKQTPIsOKFloat(y) || !JKQTPIsOKFloat(w) || w<=0.0) return;
+            m_N++;
+            m_W+=w;
+            const double dx=x-m_meanX;
+            const double dy=y-m_meanY;
+            const double f=w/m_W;
+            m_meanX+=dx*f;
+            m_meanY+=dy*f;
+            const double wdx=w*dx;
+            m_Sxx+=wdx*(x-m_meanX);
+            m_Sxy+=wdx*(y-m_meanY);
+        }
+        /*! \brief adds all (unweighted) datapoints from the data ranges \a firstX ... \a lastX and \a firstY ... to the accumulator
+
+            \tparam InputItX standard iterator type of \a firstX and \a lastX.
+            \tparam InputItY standard iterator type of \a firstY.
+            \param firstX iterator pointing to the first item in the x-dataset to use \f$ x_1 \f$
+            \param lastX iterator pointing behind the last item in the x-dataset to use \f$ x_N \f$
+            \param firstY iterator pointing to the first item in the y-dataset to use \f$ y_1 \f$ (this range has to contain at least as many items as \a firstX ... \a lastX )
+
+            \note Each value is the specified range is converted to a double using jkqtp_todouble().
+        */
+        template <class InputItX, class InputItY>
+        inline void addRange(InputItX firstX, InputItX lastX, InputItY firstY) {
+            auto itY=firstY;
+            for (auto itX=firstX; itX!=lastX; ++itX, ++itY) {
+                add(jkqtp_todouble(*itX), jkqtp_todouble(*itY));
+            }
+        }
+        /** \brief merges the state of \a other into this accumulator, afterwards this object represents the union of both datasets */
+        void merge(const JKQTPStatLinearRegressionAccumulator& other);
+        /** \brief resets the accumulator to the empty state */
+        void clear();
+
+        /** \brief number of valid datapoints, accumulated so far */
+        size_t count() const;
+        /** \brief number of datapoints that were passed to add() so far (including invalid datapoints, which were ignored) */
+        size_t processedItems() const;
+        /** \brief sum of the weights \f$ W=\sum_i\omega_i \f$ of the accumulated datapoints */
+        double sumOfWeights() const;
+        /** \brief weighted average \f$ \overline{x}=\frac{1}{W}\sum_i\omega_i\cdot x_i \f$ of the x-values (NAN if empty) */
+        double averageX() const;
+        /** \brief weighted average \f$ \overline{y}=\frac{1}{W}\sum_i\omega_i\cdot y_i \f$ of the y-values (NAN if empty) */
+        double averageY() const;
+        /** \brief weighted (biased) variance \f$ S_{xx}/W \f$ of the x-values (0 if empty) */
+        double varianceX() const;
+        /** \brief weighted (biased) covariance \f$ S_{xy}/W \f$ of the x- and y-values (0 if empty) */
+        double covariance() const;
+        /*! \brief calculates the regression coefficients of the model \f$ f(x)=a+b\cdot x \f$ from the accumulated datapoints
+
+            \param[in,out] coeffA returns the offset of the linear model
+            \param[in,out] coeffB returns the slope of the linear model
+            \param fixA if \c true, the offset coefficient \f$ a \f$ is not determined by the fit, but the value provided in \a coeffA is used
+            \param fixB if \c true, the slope coefficient \f$ b \f$ is not determined by the fit, but the value provided in \a coeffB is used
+
+            If \a fixA \c ==true, the slope is calculated as \f$ b=(\overline{y}-a)/\overline{x} \f$ and if \a fixB \c ==true, the offset is
+            calculated as \f$ a=\overline{y}-b\cdot\overline{x} \f$ , as in jkqtpstatLinearRegression().
+         */
+        void coefficients(double& coeffA, double& coeffB, bool fixA=false, bool fixB=false) const;
+    private:
+        /** \brief number of valid datapoints */
+        size_t m_N;
+        /** \brief number of processed datapoints */
+        size_t m_processed;
+        /** \brief sum of weights */
+        double m_W;
+        /** \brief running weighted average of x */
+        double m_meanX;
+        /** \brief running weighted average of y */
+        double m_meanY;
+        /** \brief \f$ S_{xx}=\sum_i\omega_i(x_i-\overline{x})^2 \f$ */
+        double m_Sxx;
+        /** \brief \f$ S_{xy}=\sum_i\omega_i(x_i-\overline{x})(y_i-\overline{y}) \f$ */
+        double m_Sxy;
+};
+
+
+
 
 
 
@@ -64,6 +183,7 @@
     This function computes internally:
         \f[ a=\overline{y}-b\cdot\overline{x} \f]
         \f[ b=\frac{\sum x_iy_i-N\cdot\overline{x}\cdot\overline{y}}{\sum x_i^2-N\cdot(\overline{x})^2} \f]
+    The sums are accumulated in a single, numerically stable pass with JKQTPStatLinearRegressionAccumulator.
 
     \image html datastore_regression_lin.png
 */
@@ -75,31 +195,14 @@ inline void jkqtpstatLinearRegression(InputItX firstX, InputItX lastX, InputItY
 
     JKQTPASSERT(Nx>1 && Ny>1);
 
-    double sumx=0, sumy=0, sumxy=0, sumx2=0;
-    size_t N=0;
+    JKQTPStatLinearRegressionAccumulator acc;
     auto itX=firstX;
     auto itY=firstY;
     for (; itX!=lastX && itY!=lastY; ++itX, ++itY) {
-        const double fit_x=jkqtp_todouble(*itX);
-        const double fit_y=jkqtp_todouble(*itY);
-        if (JKQTPIsOKFloat(fit_x) && JKQTPIsOKFloat(fit_y)) {
-            sumx=sumx+fit_x;
-            sumy=sumy+fit_y;
-            sumxy=sumxy+fit_x*fit_y;
-            sumx2=sumx2+fit_x*fit_x;
-            N++;
-        }
-    }
-    const double NN=static_cast<double>(N);
-    JKQTPASSERT_M(NN>1, "too few datapoints");
-    if (!fixA && !fixB) {
-        coeffB=(double(sumxy)-double(sumx)*double(sumy)/NN)/(double(sumx2)-double(sumx)*double(sumx)/NN);;
-        coeffA=double(sumy)/NN-coeffB*double(sumx)/NN;
-    } else if (fixA && !fixB) {
-        coeffB=(double(sumy)/NN-coeffA)/(double(sumx)/NN);
-    } else if (!fixA && fixB) {
-        coeffA=double(sumy)/NN-coeffB*double(sumx)/NN;
+        acc.add(jkqtp_todouble(*itX), jkqtp_todouble(*itY));
     }
+    JKQTPASSERT_M(acc.count()>1, "too few datapoints");
+    acc.coefficients(coeffA, coeffB, fixA, fixB);
 }
 
 
@@ -136,6 +239,7 @@ inline void jkqtpstatLinearRegression(InputItX firstX, InputItX lastX, InputItY
         \f[ \overline{x\cdot y}=\sum\limits_iw_i^2\cdot x_i\cdot y_i \f]
         \f[ \overline{x^2}=\sum\limits_iw_i^2\cdot x_i^2 \f]
         \f[ \overline{w^2}=\sum\limits_iw_i^2 \f]
+    The sums are accumulated in a single, numerically stable pass with JKQTPStatLinearRegressionAccumulator.
 
     \image html datastore_regression_linweight.png
 
@@ -149,46 +253,53 @@ inline void jkqtpstatLinearWeightedRegression(InputItX firstX, InputItX lastX, I
 
     JKQTPASSERT(Nx>1 && Ny>1 && Nw>1);
 
-    double  sumx=0, sumy=0, sumxy=0, sumx2=0, sumw2=0;
-    size_t N=0;
+    JKQTPStatLinearRegressionAccumulator acc;
     auto itX=firstX;
     auto itY=firstY;
     auto itW=firstW;
     for (; itX!=lastX && itY!=lastY && itW!=lastW; ++itX, ++itY, ++itW) {
-        const double fit_x=jkqtp_todouble(*itX);
-        const double fit_y=jkqtp_todouble(*itY);
-        const double fit_w2=jkqtp_sqr(fWeightDataToWi(jkqtp_todouble(*itW)));
-        if (JKQTPIsOKFloat(fit_x)&&JKQTPIsOKFloat(fit_y)&&JKQTPIsOKFloat(fit_w2)) {
-            sumx=sumx+fit_w2*fit_x;
-            sumy=sumy+fit_w2*fit_y;
-            sumxy=sumxy+fit_w2*fit_x*fit_y;
-            sumx2=sumx2+fit_w2*fit_x*fit_x;
-            sumw2=sumw2+fit_w2;
-            N++;
-        }
-    }
-    const double NN=static_cast<double>(N);
-    JKQTPASSERT_M(NN>1, "too few datapoints");
-    if (!fixA && !fixB) {
-        coeffB=(double(sumxy)*double(sumw2)-double(sumx)*double(sumy))/(double(sumx2)*double(sumw2)-double(sumx)*double(sumx));
-        coeffA=(double(sumy)-coeffB*double(sumx))/double(sumw2);
-    } else if (fixA && !fixB) {
-        coeffB=(double(sumy)-coeffA*double(sumw2))/double(sumx);
-    } else if (!fixA && fixB) {
-        coeffA=(double(sumy)-coeffB*double(sumx))/double(sumw2);
+        acc.add(jkqtp_todouble(*itX), jkqtp_todouble(*itY), jkqtp_sqr(fWeightDataToWi(jkqtp_todouble(*itW))));
     }
+    JKQTPASSERT_M(acc.count()>1, "too few datapoints");
+    acc.coefficients(coeffA, coeffB, fixA, fixB);
 }
 
 
 
+/*! \brief calculate the (robust) iteratively reweighted least-squares (IRLS) estimate for the parameters of the model \f$ f(x)=a+b\cdot x \f$
+           for \a N datapoints, stored contiguously in \a x and \a y
+    \ingroup jkqtptools_math_statistics_regression
+
+    \param x pointer to the \a N x-values (all values have to be valid, i.e. JKQTPIsOKFloat() )
+    \param y pointer to the \a N y-values (all values have to be valid, i.e. JKQTPIsOKFloat() )
+    \param N number of datapoints
+    \param[in,out] coeffA returns the offset of the linear model
+    \param[in,out] coeffB returns the slope of the linear model
+    \param fixA if \c true, the offset coefficient \f$ a \f$ is not determined by the fit, but the value provided in \a coeffA is used
+    \param fixB if \c true, the slope coefficient \f$ b \f$ is not determined by the fit, but the value provided in \a coeffB is used
+    \param p regularization parameter, the optimization problem is formulated in the \f$ L_p \f$ norm
+    \param iterations the (maximum) number of iterations the IRLS algorithm performs
+    \param warmStart if \c true, the iterations start from the coefficients in \a coeffA and \a coeffB (e.g. the result of a previous fit,
+                     before some datapoints were appended), instead of the unweighted least-squares solution
+    \param tolerance the iterations stop early, if the relative change of both coefficients is \f$ \leq \f$ \a tolerance
+
+    This is the engine behind jkqtpstatRobustIRLSLinearRegression(): Each iteration is a single weighted reduction with
+    JKQTPStatLinearRegressionAccumulator over the data. For large \a N the data is split into spans of at least
+    JKQTPSTATISTICS_REGRESSION_PARALLEL_MINCHUNK datapoints, which are reduced in parallel with jkqtpParallelFor() and
+    then merged.
+
+    \see jkqtpstatRobustIRLSLinearRegression(), JKQTPStatIncrementalRobustIRLSRegression
+*/
+JKQTCOMMON_LIB_EXPORT void jkqtpstatRobustIRLSLinearRegressionContiguous(const double* x, const double* y, size_t N, double& coeffA, double& coeffB, bool fixA=false, bool fixB=false, double p=1.1, int iterations=100, bool warmStart=false, double tolerance=0.0);
+
+
+
 /*! \brief calculate the (robust) iteratively reweighted least-squares (IRLS) estimate for the parameters of the model \f$ f(x)=a+b\cdot x \f$
            for a given data range \a firstX / \a firstY ... \a lastX / \a lastY
            So this function finds an outlier-robust solution to the optimization problem:
            \f[ (a^\ast,b^\ast)=\mathop{\mathrm{arg\;min}}\limits_{a,b}\sum\limits_i|a+b\cdot x_i-y_i|^p \f]
     \ingroup jkqtptools_math_statistics_regression
 
-    \ingroup jkqtptools_math_statistics_regression
-
     \tparam InputItX standard iterator type of \a firstX and \a lastX.
     \tparam InputItY standard iterator type of \a firstY and \a lastY.
     \param firstX iterator pointing to the first item in the x-dataset to use \f$ x_1 \f$
@@ -219,6 +330,10 @@ inline void jkqtpstatLinearWeightedRegression(InputItX firstX, InputItX lastX, I
       - return the last estimates \f$ a_n\f$ and \f$ b_n\f$
     .
 
+    The valid datapoints are copied once into contiguous memory and the iterations are then performed by jkqtpstatRobustIRLSLinearRegressionContiguous(),
+    where each iteration is a single (parallel) weighted reduction. The iterations stop early, once the estimates do not change any more.
+    If the data grows incrementally, use JKQTPStatIncrementalRobustIRLSRegression, which keeps the data and warm-starts from the last fit.
+
     \image html irls.png
 
     \image html datastore_regression_linrobust_p.png
@@ -234,28 +349,21 @@ inline void jkqtpstatRobustIRLSLinearRegression(InputItX firstX, InputItX lastX,
 
     JKQTPASSERT(Nx>1 && Ny>1);
 
-    std::vector<double> weights;
-    std::fill_n(std::back_inserter(weights), N, 1.0);
-
-    double alast=coeffA, blast=coeffB;
-    jkqtpstatLinearWeightedRegression(firstX, lastX, firstY, lastY, weights.begin(), weights.end(), alast, blast, fixA, fixB, &jkqtp_identity<double>);
-    for (int it=0; it<iterations-1; it++) {
-        // calculate weights
-        auto itX=firstX;
-        auto itY=firstY;
-        for (double& w: weights) {
-            const double fit_x=*itX;
-            const double fit_y=*itY;
-            const double e=alast+blast*fit_x-fit_y;
-            w=pow(std::max<double>(JKQTP_EPSILON*100.0, fabs(e)), (p-2.0)/2.0);
-            ++itX;
-            ++itY;
+    std::vector<double> x, y;
+    x.reserve(static_cast<size_t>(N));
+    y.reserve(static_cast<size_t>(N));
+    auto itX=firstX;
+    auto itY=firstY;
+    for (; itX!=lastX && itY!=lastY; ++itX, ++itY) {
+        const double fit_x=jkqtp_todouble(*itX);
+        const double fit_y=jkqtp_todouble(*itY);
+        if (JKQTPIsOKFloat(fit_x) && JKQTPIsOKFloat(fit_y)) {
+            x.push_back(fit_x);
+            y.push_back(fit_y);
         }
-        // solve weighted linear least squares
-        jkqtpstatLinearWeightedRegression(firstX, lastX, firstY, lastY, weights.begin(), weights.end(), alast, blast, fixA, fixB, &jkqtp_identity<double>);
     }
-    coeffA=alast;
-    coeffB=blast;
+    JKQTPASSERT_M(x.size()>1, "too few datapoints");
+    jkqtpstatRobustIRLSLinearRegressionContiguous(x.data(), y.data(), x.size(), coeffA, coeffB, fixA, fixB, p, iterations);
 }
 
 
@@ -328,26 +436,32 @@ JKQTCOMMON_LIB_EXPORT std::pair<std::function<double(double)>,std::function<doub
     \param fixA if \c true, the offset coefficient \f$ a \f$ is not determined by the fit, but the value provided in \a coeffA is used
     \param fixB if \c true, the slope coefficient \f$ b \f$ is not determined by the fit, but the value provided in \a coeffB is used
 
-    This function computes internally first transforms the data, as appropriate to fit the model defined by \a type and then calls jkqtpstatLinearRegression()
-    to obtain the parameters. The output parameters are transformed, so they can be used with jkqtpStatGenerateRegressionModel() to generate a functor
+    This function transforms the data on the fly, as appropriate to fit the model defined by \a type and accumulates the linear regression
+    (see jkqtpstatLinearRegression() ) in a single pass with JKQTPStatLinearRegressionAccumulator, so no copy of the data is made.
+    The output parameters are transformed, so they can be used with jkqtpStatGenerateRegressionModel() to generate a functor
     that evaluates the model
 
     \see JKQTPStatRegressionModelType, jkqtpStatGenerateRegressionModel(), jkqtpstatLinearRegression(), jkqtpStatGenerateTransformation()
 */
 template <class InputItX, class InputItY>
 inline void jkqtpstatRegression(JKQTPStatRegressionModelType type, InputItX firstX, InputItX lastX, InputItY firstY, InputItY lastY, double& coeffA, double& coeffB, bool fixA=false, bool fixB=false) {
-    std::vector<double> x, y;
+    if (fixA&&fixB) return;
     auto trafo=jkqtpStatGenerateTransformation(type);
     auto aTrafo =jkqtpStatGenerateParameterATransformation(type);
     auto bTrafo =jkqtpStatGenerateParameterBTransformation(type);
 
-    std::transform(firstX, lastX, std::back_inserter(x), trafo.first);
-    std::transform(firstY, lastY, std::back_inserter(y), trafo.second);
+    JKQTPStatLinearRegressionAccumulator acc;
+    auto itX=firstX;
+    auto itY=firstY;
+    for (; itX!=lastX && itY!=lastY; ++itX, ++itY) {
+        acc.add(trafo.first(jkqtp_todouble(*itX)), trafo.second(jkqtp_todouble(*itY)));
+    }
+    JKQTPASSERT_M(acc.count()>1, "too few datapoints");
 
     double a=aTrafo.first(coeffA);
     double b=bTrafo.first(coeffB);
 
-    jkqtpstatLinearRegression(x.begin(), x.end(), y.begin(), y.end(), a, b, fixA, fixB);
+    acc.coefficients(a, b, fixA, fixB);
 
     coeffA=aTrafo.second(a);
     coeffB=bTrafo.second(b);
@@ -374,26 +488,37 @@ inline void jkqtpstatRegression(JKQTPStatRegressionModelType type, InputItX firs
     \param p regularization parameter, the optimization problem is formulated in the \f$ L_p \f$ norm, using this \a p (see image below for an example)
     \param iterations the number of iterations the IRLS algorithm performs
 
-    This function computes internally first transforms the data, as appropriate to fit the model defined by \a type and then calls jkqtpstatRobustIRLSLinearRegression()
-    to obtain the parameters. The output parameters are transformed, so they can be used with jkqtpStatGenerateRegressionModel() to generate a functor
+    This function transforms the data once into contiguous memory, as appropriate to fit the model defined by \a type and then calls
+    jkqtpstatRobustIRLSLinearRegressionContiguous() (see jkqtpstatRobustIRLSLinearRegression() ) to obtain the parameters.
+    The output parameters are transformed, so they can be used with jkqtpStatGenerateRegressionModel() to generate a functor
     that evaluates the model
 
     \see JKQTPStatRegressionModelType, jkqtpStatGenerateRegressionModel(), jkqtpstatRobustIRLSLinearRegression(), jkqtpStatGenerateTransformation()
 */
 template <class InputItX, class InputItY>
 inline void jkqtpstatRobustIRLSRegression(JKQTPStatRegressionModelType type, InputItX firstX, InputItX lastX, InputItY firstY, InputItY lastY, double& coeffA, double& coeffB, bool fixA=false, bool fixB=false, double p=1.1, int iterations=100) {
-    std::vector<double> x, y;
+    if (fixA&&fixB) return;
     auto trafo=jkqtpStatGenerateTransformation(type);
     auto aTrafo =jkqtpStatGenerateParameterATransformation(type);
     auto bTrafo =jkqtpStatGenerateParameterBTransformation(type);
 
-    std::transform(firstX, lastX, std::back_inserter(x), trafo.first);
-    std::transform(firstY, lastY, std::back_inserter(y), trafo.second);
+    std::vector<double> x, y;
+    auto itX=firstX;
+    auto itY=firstY;
+    for (; itX!=lastX && itY!=lastY; ++itX, ++itY) {
+        const double fit_x=trafo.first(jkqtp_todouble(*itX));
+        const double fit_y=trafo.second(jkqtp_todouble(*itY));
+        if (JKQTPIsOKFloat(fit_x) && JKQTPIsOKFloat(fit_y)) {
+            x.push_back(fit_x);
+            y.push_back(fit_y);
+        }
+    }
+    JKQTPASSERT_M(x.size()>1, "too few datapoints");
 
     double a=aTrafo.first(coeffA);
     double b=bTrafo.first(coeffB);
 
-    jkqtpstatRobustIRLSLinearRegression(x.begin(), x.end(), y.begin(), y.end(), a, b, fixA, fixB, p, iterations);
+    jkqtpstatRobustIRLSLinearRegressionContiguous(x.data(), y.data(), x.size(), a, b, fixA, fixB, p, iterations);
 
     coeffA=aTrafo.second(a);
     coeffB=bTrafo.second(b);
@@ -402,6 +527,115 @@ inline void jkqtpstatRobustIRLSRegression(JKQTPStatRegressionModelType type, Inp
 
 
 
+/*! \brief incremental, (robust) iteratively reweighted least-squares (IRLS) regression for a dataset that grows over time (e.g. live data in a JKQTPDatastore),
+           where the model is defined by a JKQTPStatRegressionModelType
+    \ingroup jkqtptools_math_statistics_regression
+
+    New datapoints are appended with add() or addRange(). They are transformed (see jkqtpStatGenerateTransformation() ) and stored
+    contiguously, so fit() can run the IRLS iterations of jkqtpstatRobustIRLSLinearRegressionContiguous() directly on that memory.
+    In addition, fit() warm-starts from the result of the previous call (if the fit-settings did not change) and stops iterating,
+    once the relative change of the coefficients is below tolerance(). As appending a few points to a large dataset changes the
+    solution only slightly, a refit usually converges after a few (parallel) passes over the data, instead of the full number of iterations.
+
+    Typical usage for a datastore, where rows are appended:
+    \code
+        JKQTPStatIncrementalRobustIRLSRegression irls(JKQTPStatRegressionModelType::Linear);
+        // ... rows are appended to the columns colX and colY
+        irls.addRange(datastore->begin(colX)+irls.processedItems(), datastore->end(colX), datastore->begin(colY)+irls.processedItems());
+        double a=0, b=0;
+        irls.fit(a, b);
+        graph->setPlotFunctionFunctor(jkqtpStatGenerateRegressionModel(JKQTPStatRegressionModelType::Linear, a, b));
+    \endcode
+
+    \note Datapoints, which are invalid (using JKQTPIsOKFloat() ) after the transformation, are ignored.
+
+    \see jkqtpstatRobustIRLSRegression(), jkqtpstatRobustIRLSLinearRegression(), JKQTPStatLinearRegressionAccumulator
+*/
+class JKQTCOMMON_LIB_EXPORT JKQTPStatIncrementalRobustIRLSRegression {
+    public:
+        /** \brief class constructor, \a type is the model to be fitted and \a tolerance the relative change of the coefficients, below which fit() stops iterating */
+        explicit JKQTPStatIncrementalRobustIRLSRegression(JKQTPStatRegressionModelType type=JKQTPStatRegressionModelType::Linear, double tolerance=1e-6);
+
+        /** \brief appends the datapoint (\a x , \a y ) */
+        inline void add(double x, double y) {
+            m_processed++;
+            const double tx=m_trafo.first(x);
+            const double ty=m_trafo.second(y);
+            if (JKQTPIsOKFloat(tx) && JKQTPIsOKFloat(ty)) {
+                m_x.push_back(tx);
+                m_y.push_back(ty);
+            }
+        }
+        /*! \brief appends all datapoints from the data ranges \a firstX ... \a lastX and \a firstY ...
+
+            \tparam InputItX standard iterator type of \a firstX and \a lastX.
+            \tparam InputItY standard iterator type of \a firstY.
+            \param firstX iterator pointing to the first item in the x-dataset to use \f$ x_1 \f$
+            \param lastX iterator pointing behind the last item in the x-dataset to use \f$ x_N \f$
+            \param firstY iterator pointing to the first item in the y-dataset to use \f$ y_1 \f$ (this range has to contain at least as many items as \a firstX ... \a lastX )
+
+            \note Each value is the specified range is converted to a double using jkqtp_todouble().
+        */
+        template <class InputItX, class InputItY>
+        inline void addRange(InputItX firstX, InputItX lastX, InputItY firstY) {
+            auto itY=firstY;
+            for (auto itX=firstX; itX!=lastX; ++itX, ++itY) {
+                add(jkqtp_todouble(*itX), jkqtp_todouble(*itY));
+            }
+        }
+        /** \brief removes all datapoints and forgets the last fit result */
+        void clear();
+        /** \brief number of valid datapoints */
+        size_t count() const;
+        /** \brief number of datapoints that were passed to add() so far (including invalid datapoints, which were ignored) */
+        size_t processedItems() const;
+        /** \brief the model to be fitted */
+        JKQTPStatRegressionModelType modelType() const;
+        /** \brief relative change of the coefficients, below which fit() stops iterating */
+        double tolerance() const;
+        /** \brief sets the relative change of the coefficients, below which fit() stops iterating */
+        void setTolerance(double tolerance);
+
+        /*! \brief fits the model to all datapoints, added so far
+
+            \param[in,out] coeffA returns the offset of the model
+            \param[in,out] coeffB returns the slope of the model
+            \param fixA if \c true, the offset coefficient \f$ a \f$ is not determined by the fit, but the value provided in \a coeffA is used
+            \param fixB if \c true, the slope coefficient \f$ b \f$ is not determined by the fit, but the value provided in \a coeffB is used
+            \param p regularization parameter, the optimization problem is formulated in the \f$ L_p \f$ norm
+            \param iterations the maximum number of iterations the IRLS algorithm performs
+
+            If fit() was called before with the same \a fixA , \a fixB , \a p (and fixed coefficients), the iterations start from the previous result.
+         */
+        void fit(double& coeffA, double& coeffB, bool fixA=false, bool fixB=false, double p=1.1, int iterations=100);
+    private:
+        /** \brief the model to be fitted */
+        JKQTPStatRegressionModelType m_type;
+        /** \brief transformations of the x- and y-data for m_type */
+        std::pair<std::function<double(double)>,std::function<double(double)> > m_trafo;
+        /** \brief relative change of the coefficients, below which fit() stops iterating */
+        double m_tolerance;
+        /** \brief number of processed datapoints */
+        size_t m_processed;
+        /** \brief transformed x-values of the valid datapoints */
+        std::vector<double> m_x;
+        /** \brief transformed y-values of the valid datapoints */
+        std::vector<double> m_y;
+        /** \brief indicates whether m_lastA and m_lastB contain the result of a previous fit() */
+        bool m_hasFit;
+        /** \brief result (offset, in the transformed/linear space) of the previous fit() */
+        double m_lastA;
+        /** \brief result (slope, in the transformed/linear space) of the previous fit() */
+        double m_lastB;
+        /** \brief settings of the previous fit() */
+        bool m_lastFixA, m_lastFixB;
+        /** \brief settings of the previous fit() */
+        double m_lastP;
+};
+
+
+
+
 /*! \brief calculate the robust linear regression coefficients for a given data range \a firstX / \a firstY ... \a lastX / \a lastY where the model is defined by \a type
            So this function solves the Lp-norm optimization problem: \f[ (a^\ast, b^\ast)=\mathop{\mathrm{arg\;min}}\limits_{a,b}\sum\limits_iw_i^2\left(y_i-f_{\text{type}}(x_i,a,b)\right)^2 \f]
            by reducing it to a linear fit by transforming x- and/or y-data
@@ -426,26 +660,33 @@ inline void jkqtpstatRobustIRLSRegression(JKQTPStatRegressionModelType type, Inp
                            In the case of jkqtp_inversePropSaveDefault(), a datapoint x,y, has a large weight, if it's error is small and in the case if jkqtp_identity() it's weight
                            is directly proportional to the given value.
 
-    This function computes internally first transforms the data, as appropriate to fit the model defined by \a type and then calls jkqtpstatLinearWeightedRegression()
-    to obtain the parameters. The output parameters are transformed, so they can be used with jkqtpStatGenerateRegressionModel() to generate a functor
+    This function transforms the data on the fly, as appropriate to fit the model defined by \a type and accumulates the weighted linear regression
+    (see jkqtpstatLinearWeightedRegression() ) in a single pass with JKQTPStatLinearRegressionAccumulator, so no copy of the data is made.
+    The output parameters are transformed, so they can be used with jkqtpStatGenerateRegressionModel() to generate a functor
     that evaluates the model
 
     \see JKQTPStatRegressionModelType, jkqtpStatGenerateRegressionModel(), jkqtpstatLinearWeightedRegression(), jkqtpStatGenerateTransformation()
 */
 template <class InputItX, class InputItY, class InputItW>
 inline void jkqtpstatWeightedRegression(JKQTPStatRegressionModelType type, InputItX firstX, InputItX lastX, InputItY firstY, InputItY lastY, InputItW firstW, InputItW lastW, double& coeffA, double& coeffB, bool fixA=false, bool fixB=false, std::function<double(double)> fWeightDataToWi=&jkqtp_identity<double>) {
-    std::vector<double> x, y;
+    if (fixA&&fixB) return;
     auto trafo=jkqtpStatGenerateTransformation(type);
     auto aTrafo =jkqtpStatGenerateParameterATransformation(type);
     auto bTrafo =jkqtpStatGenerateParameterBTransformation(type);
 
-    std::transform(firstX, lastX, std::back_inserter(x), trafo.first);
-    std::transform(firstY, lastY, std::back_inserter(y), trafo.second);
+    JKQTPStatLinearRegressionAccumulator acc;
+    auto itX=firstX;
+    auto itY=firstY;
+    auto itW=firstW;
+    for (; itX!=lastX && itY!=lastY && itW!=lastW; ++itX, ++itY, ++itW) {
+        acc.add(trafo.first(jkqtp_todouble(*itX)), trafo.second(jkqtp_todouble(*itY)), jkqtp_sqr(fWeightDataToWi(jkqtp_todouble(*itW))));
+    }
+    JKQTPASSERT_M(acc.count()>1, "too few datapoints");
 
     double a=aTrafo.first(coeffA);
     double b=bTrafo.first(coeffB);
 
-    jkqtpstatLinearWeightedRegression(x.begin(), x.end(), y.begin(), y.end(), firstW, lastW, a, b, fixA, fixB, fWeightDataToWi);
+    acc.coefficients(a, b, fixA, fixB);
 
     coeffA=aTrafo.second(a);
     coeffB=bTrafo.second(b);
@@ -29,6 +29,14 @@
 #include <typeinfo>
 #include <QApplication>
 #include <QPainterPath>
+#include <QTextLayout>
+#include <QMutex>
+#include <QMutexLocker>
+
+/** \brief protects the (static) font lookup in the constructor of JKQTMathText and in JKQTMathText::useSTIX(), JKQTMathText::useXITS(), ..., as JKQTMathText objects may be created in different threads
+ *  \internal
+ */
+static QMutex jkqtmathtext_fontinit_mutex;
 
 const double JKQTMathText::ABS_MIN_LINEWIDTH=0.02;
 
@@ -123,30 +131,43 @@ JKQTMathText::MTenvironment::MTenvironment() {
     insideMath=false;
 }
 
+bool JKQTMathText::MTenvironment::operator==(const MTenvironment &other) const
+{
+    return color==other.color && font==other.font && fontSize==other.fontSize && bold==other.bold && italic==other.italic
+            && smallCaps==other.smallCaps && underlined==other.underlined && overline==other.overline && strike==other.strike
+            && insideMath==other.insideMath;
+}
+
 QFont JKQTMathText::MTenvironment::getFont(JKQTMathText* parent) const {
-    QFont f;
+    QString family;
     switch (font) {
         case MTEsans: if (insideMath) {
-                f.setFamily(parent->getFontMathSans());
+                family=parent->getFontMathSans();
             } else {
-                f.setFamily(parent->getFontSans());
+                family=parent->getFontSans();
             }
             break;
-        case MTEmathSans: f.setFamily(parent->getFontMathSans()); break;
-        case MTEtypewriter: f.setFamily(parent->getFontTypewriter()); break;
-        case MTEscript: f.setFamily(parent->getFontScript()); break;
-        case MTEcaligraphic: f.setFamily(parent->getFontCaligraphic()); break;
-        case MTEblackboard: f.setFamily(parent->getFontBlackboard()); break;
-        case MTEfraktur: f.setFamily(parent->getFontFraktur()); break;
-        case MTEmathRoman: f.setFamily(parent->getFontMathRoman()); break;
+        case MTEmathSans: family=parent->getFontMathSans(); break;
+        case MTEtypewriter: family=parent->getFontTypewriter(); break;
+        case MTEscript: family=parent->getFontScript(); break;
+        case MTEcaligraphic: family=parent->getFontCaligraphic(); break;
+        case MTEblackboard: family=parent->getFontBlackboard(); break;
+        case MTEfraktur: family=parent->getFontFraktur(); break;
+        case MTEmathRoman: family=parent->getFontMathRoman(); break;
         default:
         case MTEroman: if (insideMath) {
-                f.setFamily(parent->getFontMathRoman());
+                family=parent->getFontMathRoman();
             } else {
-                f.setFamily(parent->getFontRoman());
+                family=parent->getFontRoman();
             }
             break;
     }
+    const FontCacheKey key(family, *this);
+    auto it=parent->fontCache.constFind(key);
+    if (it!=parent->fontCache.constEnd()) return it.value();
+
+    QFont f;
+    f.setFamily(family);
     f.setBold(bold);
     f.setItalic(italic);
     f.setUnderline(underlined);
@@ -156,6 +177,8 @@ QFont JKQTMathText::MTenvironment::getFont(JKQTMathText* parent) const {
     if (smallCaps) f.setCapitalization(QFont::SmallCaps);
     f.setPointSizeF(fontSize);
     f.setStyleStrategy(QFont::NoFontMerging);
+    if (parent->fontCache.size()>=1024) parent->fontCache.clear();
+    parent->fontCache.insert(key, f);
     return f;
 }
 
@@ -194,10 +217,37 @@ JKQTMathText::MTnode::MTnode(JKQTMathText* parent) {
 JKQTMathText::MTnode::~MTnode()
 = default;
 
+JKQTMathText::MTnode::LayoutCache::LayoutCache():
+    valid(false), generation(0), hasPrevNodeSize(false)
+{
+
+}
+
 void JKQTMathText::MTnode::getSize(QPainter &painter, JKQTMathText::MTenvironment currentEv, double &width, double &baselineHeight, double &overallHeight, double &strikeoutPos, const MTnodeSize* prevNodeSize)
 {
-    double w=width, b=baselineHeight, o=overallHeight, s=strikeoutPos;
-    getSizeInternal(painter, currentEv, w, b, o, s, prevNodeSize);
+    double w, b, o, s;
+    const bool samePrevNodeSize=(prevNodeSize==nullptr && !layoutCache.hasPrevNodeSize)
+                                 || (prevNodeSize!=nullptr && layoutCache.hasPrevNodeSize
+                                     && prevNodeSize->width==layoutCache.prevNodeSize.width && prevNodeSize->baselineHeight==layoutCache.prevNodeSize.baselineHeight
+                                     && prevNodeSize->overallHeight==layoutCache.prevNodeSize.overallHeight && prevNodeSize->strikeoutPos==layoutCache.prevNodeSize.strikeoutPos);
+    if (layoutCache.valid && layoutCache.generation==parent->layoutGeneration && samePrevNodeSize && layoutCache.ev==currentEv) {
+        w=layoutCache.size.width;
+        b=layoutCache.size.baselineHeight;
+        o=layoutCache.size.overallHeight;
+        s=layoutCache.size.strikeoutPos;
+    } else {
+        w=width; b=baselineHeight; o=overallHeight; s=strikeoutPos;
+        getSizeInternal(painter, currentEv, w, b, o, s, prevNodeSize);
+        layoutCache.valid=true;
+        layoutCache.generation=parent->layoutGeneration;
+        layoutCache.ev=currentEv;
+        layoutCache.hasPrevNodeSize=(prevNodeSize!=nullptr);
+        if (prevNodeSize) layoutCache.prevNodeSize=*prevNodeSize;
+        layoutCache.size.width=w;
+        layoutCache.size.baselineHeight=b;
+        layoutCache.size.overallHeight=o;
+        layoutCache.size.strikeoutPos=s;
+    }
 
     if (w<1e5) width=w;
     if (b<1e5) baselineHeight=b;
@@ -272,7 +322,7 @@ void JKQTMathText::MTtextNode::getSizeInternal(QPainter& painter, JKQTMathText::
             //f.setFamily(parent->getFontData(currentEv.font, currentEv.insideMath, FontSubclass::Text).first);
         }
     QString txt=textTransform(text, currentEv, true);
-    QFontMetricsF fm(f, painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(f, painter.device());
     QRectF br=fm.boundingRect(txt);
     QRectF tbr=parent->getTightBoundingRect(f, txt, painter.device()); //fm.tightBoundingRect(txt);
     if (txt=="|") {
@@ -337,7 +387,7 @@ double JKQTMathText::MTtextNode::draw(QPainter& painter, double x, double y, JKQ
     p.setColor(currentEv.color);
     painter.setPen(p);
     double dx=0;
-    QFontMetricsF fm(f, painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(f, painter.device());
     /*if (txt.size()>1 && txt[txt.size()-1].isSpace()) {
         QFontMetricsF fm(f, painter.device());
         //if ((fm.width("a ")==fm.width("a"))) dx=fm.boundingRect("I").width();
@@ -348,14 +398,21 @@ double JKQTMathText::MTtextNode::draw(QPainter& painter, double x, double y, JKQ
             QPainterPath path;
             path.addText(QPointF(x+dx, y), f, txt);
             painter.drawPath(path);
-        } else {
-            painter.drawText(QPointF(x+dx, y), txt);//.simplified());
+        } else if (!parent->drawGlyphRuns(painter, QPointF(x+dx, y), f, txt, glyphRuns)) {
+            // reuse the glyph layout of the last draw() (drawStaticText() expects the top-left corner, not the baseline)
+            if (staticTextFont!=f || staticText.text()!=txt) {
+                staticText.setText(txt);
+                staticText.setTextFormat(Qt::PlainText);
+                staticText.prepare(painter.transform(), f);
+                staticTextFont=f;
+            }
+            painter.drawStaticText(QPointF(x+dx, y-fm.ascent()), staticText);
         }
     } else {
         int i=0;
         double xx=x+dx;
         QFont ff=f;
-        QFontMetricsF fmff(ff, painter.device());
+        QFontMetricsF fmff=parent->getFontMetrics(ff, painter.device());
         ff.setItalic(false);
         while (i<txt.size()) {
             if (txt[i].isDigit()) {
@@ -464,7 +521,7 @@ void JKQTMathText::MTinstruction1Node::getSizeInternal(QPainter& painter, JKQTMa
 
     child->getSize(painter, ev, width, baselineHeight, overallHeight, strikeoutPos);
     if (name=="colorbox" || name=="fbox" || name=="boxed") {
-        QFontMetricsF fm(ev.getFont(parent));
+        QFontMetricsF fm=parent->getFontMetrics(ev.getFont(parent), nullptr);
         double xw=fm.width("x");
         width+=xw;
         overallHeight+=xw;
@@ -487,7 +544,7 @@ double JKQTMathText::MTinstruction1Node::draw(QPainter& painter, double x, doubl
         double width, baselineHeight, overallHeight, strikeoutPos;
         child->getSize(painter, currentEv, width, baselineHeight, overallHeight, strikeoutPos);
         QPen p=painter.pen();
-        QFontMetricsF fm(currentEv.getFont(parent));
+        QFontMetricsF fm=parent->getFontMetrics(currentEv.getFont(parent), nullptr);
         double xw=fm.width("x");
         p.setColor(fcol);
         painter.setPen(p);
@@ -581,7 +638,7 @@ void JKQTMathText::MTsubscriptNode::getSizeInternal(QPainter& painter, JKQTMathT
 
     child->getSize(painter, ev, width, baselineHeight, overallHeight, strikeoutPos);
 
-    QFontMetricsF fm(ev.getFont(parent), painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(ev.getFont(parent), painter.device());
     QRectF tbr=parent->getTightBoundingRect(currentEv.getFont(parent), "M", painter.device());
     double shift=parent->getSubShiftFactor()*tbr.height();
 
@@ -599,7 +656,7 @@ double JKQTMathText::MTsubscriptNode::draw(QPainter& painter, double x, double y
     doDrawBoxes(painter, x, y, currentEv);
     JKQTMathText::MTenvironment ev=currentEv;
     ev.fontSize=ev.fontSize*parent->getSubsuperSizeFactor();
-    QFontMetricsF fm(ev.getFont(parent), painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(ev.getFont(parent), painter.device());
     QRectF tbr=parent->getTightBoundingRect(currentEv.getFont(parent), "M", painter.device());
 
     double width=0, baselineHeight=0, overallHeight=0, strikeoutPos=0;
@@ -660,7 +717,7 @@ JKQTMathText::MTsqrtNode::~MTsqrtNode() {
 }
 
 void JKQTMathText::MTsqrtNode::getSizeInternal(QPainter& painter, JKQTMathText::MTenvironment currentEv, double& width, double& baselineHeight, double& overallHeight, double& strikeoutPos, const MTnodeSize* /*prevNodeSize*/) {
-    QFontMetricsF fm(currentEv.getFont(parent), painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(currentEv.getFont(parent), painter.device());
 
     child->getSize(painter, currentEv, width, baselineHeight, overallHeight, strikeoutPos);
 
@@ -675,7 +732,7 @@ double JKQTMathText::MTsqrtNode::draw(QPainter& painter, double x, double y, JKQ
     child->getSize(painter, currentEv, width, baselineHeight, overallHeight, sp);
     QFont f=currentEv.getFont(parent);
     QFont fsmall=f;
-    QFontMetricsF fm(f, painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(f, painter.device());
     double w=fm.boundingRect("A").width();
     double a=baselineHeight*1.15;
     double d=overallHeight-baselineHeight;
@@ -761,7 +818,7 @@ QString JKQTMathText::MTfracNode::getTypeName() const
 }
 
 void JKQTMathText::MTfracNode::getSizeInternal(QPainter& painter, JKQTMathText::MTenvironment currentEv, double& width, double& baselineHeight, double& overallHeight, double& strikeoutPos, const MTnodeSize* /*prevNodeSize*/) {
-    QFontMetricsF fm(currentEv.getFont(parent), painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(currentEv.getFont(parent), painter.device());
     JKQTMathText::MTenvironment ev1=currentEv;
     JKQTMathText::MTenvironment ev2=currentEv;
 
@@ -840,7 +897,7 @@ void JKQTMathText::MTfracNode::getSizeInternal(QPainter& painter, JKQTMathText::
 double JKQTMathText::MTfracNode::draw(QPainter& painter, double x, double y, JKQTMathText::MTenvironment currentEv, const MTnodeSize* /*prevNodeSize*/) {
     doDrawBoxes(painter, x, y, currentEv);
     QFont f=currentEv.getFont(parent);
-    QFontMetricsF fm(f, painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(f, painter.device());
     JKQTMathText::MTenvironment ev1=currentEv;
     JKQTMathText::MTenvironment ev2=currentEv;
 
@@ -996,7 +1053,7 @@ QString JKQTMathText::MTmatrixNode::getTypeName() const
 }
 
 void JKQTMathText::MTmatrixNode::getSizeInternal(QPainter& painter, JKQTMathText::MTenvironment currentEv, double& width, double& baselineHeight, double& overallHeight, double& strikeoutPos, const MTnodeSize* /*prevNodeSize*/) {
-    QFontMetricsF fm(currentEv.getFont(parent), painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(currentEv.getFont(parent), painter.device());
     JKQTMathText::MTenvironment ev1=currentEv;
 
     double xh=fm.strikeOutPos();//fm.xHeight();
@@ -1040,7 +1097,7 @@ void JKQTMathText::MTmatrixNode::getSizeInternal(QPainter& painter, JKQTMathText
 double JKQTMathText::MTmatrixNode::draw(QPainter& painter, double x, double y, JKQTMathText::MTenvironment currentEv, const MTnodeSize* /*prevNodeSize*/) {
     doDrawBoxes(painter, x, y, currentEv);
 
-    QFontMetricsF fm(currentEv.getFont(parent), painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(currentEv.getFont(parent), painter.device());
     JKQTMathText::MTenvironment ev1=currentEv;
 
     double xh=fm.strikeOutPos();//fm.xHeight();
@@ -1145,7 +1202,7 @@ JKQTMathText::MTdecoratedNode::~MTdecoratedNode() {
 }
 
 void JKQTMathText::MTdecoratedNode::getSizeInternal(QPainter& painter, JKQTMathText::MTenvironment currentEv, double& width, double& baselineHeight, double& overallHeight, double& strikeoutPos, const MTnodeSize* /*prevNodeSize*/) {
-    QFontMetricsF fm(currentEv.getFont(parent), painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(currentEv.getFont(parent), painter.device());
     double wc=fm.boundingRect("A").width();
     double dheightfactor=1.0+parent->getDecorationHeightFactor()*2.0;
 
@@ -1161,7 +1218,7 @@ double JKQTMathText::MTdecoratedNode::draw(QPainter& painter, double x, double y
     MTenvironment ev=currentEv;
     double width=0, baselineHeight=0, overallHeight=0, strikeoutPos=0;
     child->getSize(painter, ev, width, baselineHeight, overallHeight, strikeoutPos);
-    QFontMetricsF fm(ev.getFont(parent), painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(ev.getFont(parent), painter.device());
     double w=width;
     double wc=fm.boundingRect("A").width();
     //double ll=wc*0.8;
@@ -1315,7 +1372,7 @@ JKQTMathText::MTsuperscriptNode::~MTsuperscriptNode() {
 void JKQTMathText::MTsuperscriptNode::getSizeInternal(QPainter& painter, JKQTMathText::MTenvironment currentEv, double& width, double& baselineHeight, double& overallHeight, double& strikeoutPos, const MTnodeSize* prevNodeSize) {
     JKQTMathText::MTenvironment ev=currentEv;
     ev.fontSize=ev.fontSize*parent->getSubsuperSizeFactor();
-    QFontMetricsF fm(currentEv.getFont(parent), painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(currentEv.getFont(parent), painter.device());
     QRectF tbr=parent->getTightBoundingRect(currentEv.getFont(parent), "M", painter.device());
     child->getSize(painter, ev, width, baselineHeight, overallHeight, strikeoutPos);
     double shift=parent->getSuperShiftFactor()*tbr.height();
@@ -1338,7 +1395,7 @@ double JKQTMathText::MTsuperscriptNode::draw(QPainter& painter, double x, double
     double cWidth, cBaselineHeight, cOverallHeight, cStrikeoutPos;
     child->getSize(painter, ev, cWidth, cBaselineHeight, cOverallHeight, cStrikeoutPos);
 
-    QFontMetricsF fm(currentEv.getFont(parent), painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(currentEv.getFont(parent), painter.device());
     QRectF tbr=parent->getTightBoundingRect(currentEv.getFont(parent), "M", painter.device());
     double shift=parent->getSuperShiftFactor()*tbr.height();
 
@@ -1676,7 +1733,7 @@ void JKQTMathText::MTlistNode::getSizeInternal(QPainter& painter, JKQTMathText::
     overallHeight=0;
     baselineHeight=0;
     strikeoutPos=0;
-    QFontMetricsF fm(currentEv.getFont(parent));
+    QFontMetricsF fm=parent->getFontMetrics(currentEv.getFont(parent), nullptr);
     //QRectF tbr=parent->getTightBoundingRect(currentEv.getFont(parent), "M", painter.device());
 
 
@@ -1889,7 +1946,7 @@ double JKQTMathText::MTlistNode::draw(QPainter& painter, double x, double y, JKQ
     double ynew=y;
     double xnew=x;
     //qDebug()<<"listNode: "<<currentEv.fontSize;
-    QFontMetricsF fm(currentEv.getFont(parent));
+    QFontMetricsF fm=parent->getFontMetrics(currentEv.getFont(parent), nullptr);
     bool wasBrace=false;
     for (int i=0; i<nodes.size(); i++) {
         bool doDraw=true;
@@ -2069,8 +2126,8 @@ bool JKQTMathText::MTsymbolNode::getWinSymbolProp(JKQTMathText::MTsymbolNode::Sy
 
     //qDebug()<<"  +--- getWinSymbolProp("<<n<<"): fnt: "<<fnt.first<<", "<<fnt.second<<" / sym: "<<fntSym.first<<", "<<fntSym.second;
 
-    static QHash<QString, QString> winSymbolSymbol;
-    if (winSymbolSymbol.isEmpty()) {
+    static QHash<QString, QString> winSymbolSymbol=[]() {
+      QHash<QString, QString> winSymbolSymbol;
       winSymbolSymbol.insert("leftrightarrow", QChar(0xAB));
       winSymbolSymbol.insert("leftarrow", QChar(0xAC));
       winSymbolSymbol.insert("rightarrow", QChar(0xAE));
@@ -2151,7 +2208,8 @@ bool JKQTMathText::MTsymbolNode::getWinSymbolProp(JKQTMathText::MTsymbolNode::Sy
       winSymbolSymbol.insert("cent", "c");
       winSymbolSymbol.insert("sim", QChar(0x7E));
       winSymbolSymbol.insert("infty", QChar(0xA5));
-    }
+      return winSymbolSymbol;
+    }();
 
     QHash<QString, QString>::iterator itsymbol = winSymbolSymbol.find(n);
     if (itsymbol!=winSymbolSymbol.end()) {
@@ -2212,8 +2270,8 @@ bool JKQTMathText::MTsymbolNode::getGreekSymbolProp(JKQTMathText::MTsymbolNode::
 
     //qDebug()<<"  +--- getGreekSymbolProp("<<n<<"): fnt: "<<fnt.first<<", "<<fnt.second<<" / greek: "<<fntGreek.first<<", "<<fntGreek.second;
 
-    static QHash<QString, QString> winSymbolGreek;
-    if (winSymbolGreek.isEmpty()) {
+    static QHash<QString, QString> winSymbolGreek=[]() {
+      QHash<QString, QString> winSymbolGreek;
       winSymbolGreek.insert("alpha", "a");
       winSymbolGreek.insert("beta", "b");
       winSymbolGreek.insert("gamma", "g");
@@ -2253,10 +2311,11 @@ bool JKQTMathText::MTsymbolNode::getGreekSymbolProp(JKQTMathText::MTsymbolNode::
       winSymbolGreek.insert("Upsilon", "");
       winSymbolGreek.insert("Phi", "F");
       winSymbolGreek.insert("Psi", "Y");
-    }
+      return winSymbolGreek;
+    }();
 
-    static QHash<QString, QString> unicodeGreek;
-    if (unicodeGreek.isEmpty()) {
+    static QHash<QString, QString> unicodeGreek=[]() {
+      QHash<QString, QString> unicodeGreek;
       unicodeGreek.insert("alpha", QChar(0x3B1));
       unicodeGreek.insert("beta", QChar(0x3B2));
       unicodeGreek.insert("gamma", QChar(0x3B3));
@@ -2299,7 +2358,8 @@ bool JKQTMathText::MTsymbolNode::getGreekSymbolProp(JKQTMathText::MTsymbolNode::
       unicodeGreek.insert("Upsilon", QChar(0x3A5));
       unicodeGreek.insert("Phi", QChar(0x3A6));
       unicodeGreek.insert("Psi", QChar(0x3A8));
-    }
+      return unicodeGreek;
+    }();
 
     //qDebug()<<"##SEARCHING "<<n;
     props.italic = -1;
@@ -2373,8 +2433,8 @@ bool JKQTMathText::MTsymbolNode::getUnicodeBaseSymbolProp(JKQTMathText::MTsymbol
 {
 
     //qDebug()<<"--- getUnicodeBaseSymbolProp("<<n<<"): ";
-    static QHash<QString, QString> unicodeBaseSymbol;
-    if (unicodeBaseSymbol.isEmpty()) {
+    static QHash<QString, QString> unicodeBaseSymbol=[]() {
+        QHash<QString, QString> unicodeBaseSymbol;
 
         unicodeBaseSymbol.insert("diamond", QChar(0xE0));
         unicodeBaseSymbol.insert("infty", QChar(0x221E));
@@ -2412,7 +2472,8 @@ bool JKQTMathText::MTsymbolNode::getUnicodeBaseSymbolProp(JKQTMathText::MTsymbol
         unicodeBaseSymbol.insert("cdots", QString(QChar(0x00B7)) + QString(QChar(0x00B7)) + QString(QChar(0x00B7)));
         unicodeBaseSymbol.insert("approx", QChar(0x2248));
         unicodeBaseSymbol.insert("Angstroem", QChar(0x212B));
-    }
+        return unicodeBaseSymbol;
+    }();
 
     QHash<QString, QString>::iterator itbasesymbol = unicodeBaseSymbol.find(n);
     if (itbasesymbol!=unicodeBaseSymbol.end()) {
@@ -2442,8 +2503,8 @@ bool JKQTMathText::MTsymbolNode::getUnicodeFullSymbolProp(JKQTMathText::MTsymbol
 
     //qDebug()<<"  +--- getUnicodeFullSymbolProp("<<n<<")";
 
-    static QHash<QString, QString> unicodeSymbol;
-    if (unicodeSymbol.isEmpty()) {
+    static QHash<QString, QString> unicodeSymbol=[]() {
+      QHash<QString, QString> unicodeSymbol;
       unicodeSymbol.insert("leftrightarrow", QChar(0x2194));
       unicodeSymbol.insert("leftarrow", QChar(0x2190));
       unicodeSymbol.insert("rightarrow", QChar(0x2192));
@@ -2584,7 +2645,8 @@ bool JKQTMathText::MTsymbolNode::getUnicodeFullSymbolProp(JKQTMathText::MTsymbol
       unicodeSymbol.insert("male", QChar(0x2642));
 
       unicodeSymbol.insert("accurrent", QChar(0x23E6));
-    }
+      return unicodeSymbol;
+    }();
 
     QHash<QString, QString>::iterator itsymbol = unicodeSymbol.find(n);
 
@@ -2730,23 +2792,24 @@ JKQTMathText::MTsymbolNode::SymbolProps JKQTMathText::MTsymbolNode::getSymbolPro
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // statische Lookup-Tabellen vorbereiten
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    static QStringList extendWInMM;
-    if (extendWInMM.isEmpty()) {
+    static QStringList extendWInMM=[]() {
+        QStringList extendWInMM;
         extendWInMM <<"ll"<<"gg"<<"leq"<<"geq"<<"leftrightarrow"<<"leftarrow"<<"rightarrow"<<"to"<<"uparrow"<<"downarrow"<<"updownarrow"<<"Leftrightarrow"
                     <<"iff"<<"Leftarrow"<<"Rightarrow"<<"Uparrow"<<"Downarrow"<<"Updownarrow"<<"pm"<<"mp"<<"nexists"<<"ni"<<"notni"<<"circ"<<"sim"<<"emptyset"<<"odot"<<"ominus"
                     <<"subsetnot"<<"bot"<<"leftharpoonup"<<"rightharpoonup"<<"upharpoonleft"<<"downharpoonleft"<<"leftrightharpoon"<<"rightleftharpoon"<<"coprod"<<"leftharpoondown"
                     <<"rightharpoondown"<<"upharpoonright"<<"downharpoonright"<<"nwarrow"<<"nearrow"<<"searrow"<<"swarrow"<<"mapsto"<<"div"<<"multimap"<<"maporiginal"<<"mapimage"
                     <<"times"<<"propto"<<"bullet"<<"neq"<<"ne"<<"equiv"<<"approx"<<"otimes"<<"oplus"<<"oslash"<<"cap"<<"land"<<"cup"<<"lor"<<"supset"<<"supseteq"<<"supsetnot"
                     <<"subset"<<"subseteq"<<"in"<<"notin"<<"cdot"<<"wedge"<<"vee"<<"cong"<<"bot"<<"mid";
-    }
+        return extendWInMM;
+    }();
 
     if (extendWInMM.contains(n)) {
         props.extendWidthInMathmode=true;
     }
 
 
-    static QHash<QString, QString> simpleTranslations;
-    if (simpleTranslations.isEmpty()) {
+    static QHash<QString, QString> simpleTranslations=[]() {
+      QHash<QString, QString> simpleTranslations;
       simpleTranslations.insert("", " ");
       simpleTranslations.insert("sin", "sin");
       simpleTranslations.insert("cos", "cos");
@@ -2788,11 +2851,12 @@ JKQTMathText::MTsymbolNode::SymbolProps JKQTMathText::MTsymbolNode::getSymbolPro
       simpleTranslations.insert("deg", "deg");
       simpleTranslations.insert("Pr", "Pr");
       simpleTranslations.insert("coth", "coth");
-    }
+      return simpleTranslations;
+    }();
 
 
-    static QHash<QString, QString> simpleTranslations_heightIsAscent;
-    if (simpleTranslations_heightIsAscent.isEmpty()) {
+    static QHash<QString, QString> simpleTranslations_heightIsAscent=[]() {
+      QHash<QString, QString> simpleTranslations_heightIsAscent;
       simpleTranslations_heightIsAscent.insert("erf", "erf");
       simpleTranslations_heightIsAscent.insert("median", "median");
       simpleTranslations_heightIsAscent.insert("min", "min");
@@ -2802,7 +2866,8 @@ JKQTMathText::MTsymbolNode::SymbolProps JKQTMathText::MTsymbolNode::getSymbolPro
       simpleTranslations_heightIsAscent.insert("liminf", "liminf");
       simpleTranslations_heightIsAscent.insert("limsup", "limsup");
       simpleTranslations_heightIsAscent.insert("lim", "lim");
-    }
+      return simpleTranslations_heightIsAscent;
+    }();
 
 
 
@@ -2854,7 +2919,7 @@ void JKQTMathText::MTsymbolNode::getSizeInternal(QPainter& painter, JKQTMathText
     if (props.italic>0) f.setItalic(true);
     if (props.bold<0) f.setBold(false);
     if (props.bold>0) f.setBold(true);
-    QFontMetricsF fm(f, painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(f, painter.device());
     QString symb=props.symbol;
     width=0;
     if (currentEv.insideMath) width=qMax(parent->getTightBoundingRect(f, symb, painter.device()).width(),parent->getTightBoundingRect(f, "i", painter.device()).width());//fm.width(symbol);
@@ -2915,8 +2980,8 @@ double JKQTMathText::MTsymbolNode::draw(QPainter& painter, double x, double y, J
     if (props.italic>0) f.setItalic(true);
     if (props.bold<0) f.setBold(false);
     if (props.bold>0) f.setBold(true);
-    QFontMetricsF fm(f, painter.device());
-    QFontMetricsF fm1(f1, painter.device());
+    QFontMetricsF fm=parent->getFontMetrics(f, painter.device());
+    QFontMetricsF fm1=parent->getFontMetrics(f1, painter.device());
     painter.setFont(f);
 
     double shift=0;
@@ -2936,7 +3001,8 @@ double JKQTMathText::MTsymbolNode::draw(QPainter& painter, double x, double y, J
     double xwi=fm.width("x");
     if (!props.symbol.isEmpty()) {
         // if the symbol has been recognized in the constructor: draw the symbol
-        painter.drawText(QPointF(x+shift, y+props.yfactor*overallHeight), props.symbol);
+        const QPointF pos(x+shift, y+props.yfactor*overallHeight);
+        if (!parent->drawGlyphRuns(painter, pos, f, props.symbol, glyphRuns)) painter.drawText(pos, props.symbol);
         double xx=x+shift;
         double yy=y-fm.xHeight()-(parent->getTightBoundingRect(f, "M", painter.device()).height()-fm.xHeight())/3.0;
         QLineF l(xx, yy, xx+xwi/3.0+((currentEv.italic)?(xwi/3.0):0), yy);
@@ -3024,8 +3090,8 @@ bool JKQTMathText::MTsymbolNode::toHtml(QString &html, JKQTMathText::MTenvironme
     QString s;
     JKQTMathText::MTenvironment ev=currentEv;
 
-    static QMap<QString, QString> entitylut;
-    if (entitylut.isEmpty()) {
+    static QMap<QString, QString> entitylut=[]() {
+      QMap<QString, QString> entitylut;
       entitylut.insert("sin", "sin");
       entitylut.insert("cos", "cos");
       entitylut.insert("tan", "tan");
@@ -3218,7 +3284,8 @@ bool JKQTMathText::MTsymbolNode::toHtml(QString &html, JKQTMathText::MTenvironme
       entitylut.insert("frq", "&gt;");
       entitylut.insert("flqq", "");
       entitylut.insert("frqq", "");
-    }
+      return entitylut;
+    }();
 
 
     QMap<QString, QString>::iterator itS = entitylut.find(symbolName);
@@ -3263,6 +3330,9 @@ JKQTMathText::JKQTMathText(QObject* parent):
     QFontDatabase fontdb;
     //qDebug()<<"init_fontDB: "<<std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()-t0).count()/1000.0<<"ms"; t0=std::chrono::high_resolution_clock::now();
 
+    layoutGeneration=0;
+    layoutDpiX=0;
+    layoutDpiY=0;
     fontSize=10;
     brace_factor=1.04;
     subsuper_size_factor=0.7;
@@ -3283,6 +3353,7 @@ JKQTMathText::JKQTMathText(QObject* parent):
 
     expensiveRendering=true;
     blackboardSimulated=true;
+    layoutSettingsKey=getLayoutSettingsKey();
 
 
     static QString serifFont="serif";
@@ -3293,6 +3364,7 @@ JKQTMathText::JKQTMathText(QObject* parent):
     static QString decorativeFont="decorative";
     static QString blackboardFont="blackboard";
     static QString fracturFont="fraktur";
+    QMutexLocker fontInitLocker(&jkqtmathtext_fontinit_mutex);
     static bool firstStart=true;
 
     if (firstStart) {
@@ -3348,6 +3420,8 @@ JKQTMathText::JKQTMathText(QObject* parent):
         //qDebug()<<"check all font: "<<std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()-t0).count()/1000.0<<"ms";
     }
 
+    fontInitLocker.unlock();
+
     //t0=std::chrono::high_resolution_clock::now();
     if (serifFont!="serif") addReplacementFont("serif", serifFont);
     if (sansFont!="sans") addReplacementFont("sans", sansFont);
@@ -3377,6 +3451,10 @@ JKQTMathText::JKQTMathText(QObject* parent):
 
     parsedNode=nullptr;
     unparsedNode=nullptr;
+    parseCacheSize=128;
+    renderCacheEnabled=false;
+    glyphRunsEnabled=false;
+    renderCache.setMaxCost(32*1024*1024);
 
     currentToken=MTTnone;
     currentTokenName="";
@@ -3386,9 +3464,13 @@ JKQTMathText::JKQTMathText(QObject* parent):
 }
 
 JKQTMathText::~JKQTMathText() {
-    if (parsedNode!=nullptr) delete parsedNode;
+    for (auto it=parseCache.begin(); it!=parseCache.end(); ++it) {
+        if (it->parsedNode!=nullptr) delete it->parsedNode;
+        if (it->unparsedNode!=nullptr) delete it->unparsedNode;
+    }
+    parseCache.clear();
+    parseCacheUsage.clear();
     parsedNode=nullptr;
-    if (unparsedNode!=nullptr) delete unparsedNode;
     unparsedNode=nullptr;
 }
 
@@ -3409,6 +3491,7 @@ void JKQTMathText::loadSettings(const QSettings& settings, const QString& group)
     decoration_height_factor=settings.value(group+"decoration_height_factor", decoration_height_factor).toDouble();
     operatorsubsuper_size_factor=settings.value(group+"operatorsubsuper_size_factor", operatorsubsuper_size_factor).toDouble();
     mathoperator_width_factor=settings.value(group+"mathoperator_width_factor", mathoperator_width_factor).toDouble();
+    invalidateLayout();
 
 
     if (settings.value(group+"use_stix_fonts", false).toBool()) useSTIX();
@@ -3437,6 +3520,7 @@ void JKQTMathText::saveSettings(QSettings& settings, const QString& group) const
 }
 
 bool JKQTMathText::useSTIX(bool mathModeOnly) {
+    QMutexLocker fontInitLocker(&jkqtmathtext_fontinit_mutex);
 
     static QStringList mathNames{"STIX Two Math", "STIX Math", "STIX Two Math Standard", "STIX Math Standard"};
     static QStringList textNames{"STIX", "STIXGeneral", "STIX General"};
@@ -3489,12 +3573,13 @@ bool JKQTMathText::useSTIX(bool mathModeOnly) {
         res=true;
     }
 
-    brace_shrink_factor=0.6;
+    setBraceShrinkFactor(0.6);
     return res;
 }
 
 bool JKQTMathText::useXITS(bool mathModeOnly)
 {
+    QMutexLocker fontInitLocker(&jkqtmathtext_fontinit_mutex);
     QFontDatabase fdb;
     if (!fdb.families().contains("XITS")) {
         if (QFile::exists(":/JKQTMathText/fonts/xits-bold.otf")) { QFontDatabase::addApplicationFont(":/JKQTMathText/fonts/xits-bold.otf"); }
@@ -3532,14 +3617,14 @@ bool JKQTMathText::useXITS(bool mathModeOnly)
         setFontRoman(textFamily, MTFEunicode);
         setSymbolfontSymbol(textFamily, MTFEunicode);
         setSymbolfontGreek(textFamily, MTFEunicode);
-        brace_shrink_factor=0.6;
+        setBraceShrinkFactor(0.6);
         res=true;
     }
     if (!mathFamily.isEmpty()) {
         setFontMathRoman(mathFamily, MTFEunicode);
         setSymbolfontSymbol(textFamily, MTFEunicode);
         setSymbolfontGreek(textFamily, MTFEunicode);
-        brace_shrink_factor=0.6;
+        setBraceShrinkFactor(0.6);
         res=true;
     }
 
@@ -3549,6 +3634,7 @@ bool JKQTMathText::useXITS(bool mathModeOnly)
 
 bool JKQTMathText::useASANA(bool mathModeOnly)
 {
+    QMutexLocker fontInitLocker(&jkqtmathtext_fontinit_mutex);
     QFontDatabase fdb;
     if (!fdb.families().contains("Asana") && !fdb.families().contains("Asana Math")) {
         if (QFile::exists(":/JKQTMathText/fonts/asana-math.otf")) { /*i=*/QFontDatabase::addApplicationFont(":/JKQTMathText/fonts/asana-math.otf"); }
@@ -3586,7 +3672,7 @@ bool JKQTMathText::useASANA(bool mathModeOnly)
         res=true;
     }
 
-    brace_shrink_factor=0.6;
+    setBraceShrinkFactor(0.6);
     return res;
 }
 
@@ -3594,7 +3680,7 @@ void JKQTMathText::useAnyUnicode(QString timesFont, const QString &sansFont, JKQ
 {
     if (!timesFont.isEmpty()) { setFontRoman(timesFont, encodingTimes); }
     if (!sansFont.isEmpty()) { setFontSans(sansFont, encodingSans); }
-    brace_shrink_factor=0.6;
+    setBraceShrinkFactor(0.6);
 }
 
 
@@ -3707,8 +3793,7 @@ void JKQTMathText::setFontRomanOrSpecial(const QString &__value)
 void JKQTMathText::setFontRoman(const QString &__value, MTfontEncoding encoding)
 {
     auto f=getReplacementFont(__value, __value, encoding);
-    fontDefinitions[MTEroman].fontName = f.first;
-    fontDefinitions[MTEroman].fontEncoding = f.second;
+    setFontDefinition(MTEroman, FontSubclass::Text, f);
 }
 
 QString JKQTMathText::getFontRoman() const
@@ -3724,8 +3809,7 @@ JKQTMathText::MTfontEncoding JKQTMathText::getFontEncodingRoman() const
 void JKQTMathText::setFontSans(const QString &__value, MTfontEncoding encoding)
 {
     auto f=getReplacementFont(__value, __value, encoding);
-    fontDefinitions[MTEsans].fontName = f.first;
-    fontDefinitions[MTEsans].fontEncoding = f.second;
+    setFontDefinition(MTEsans, FontSubclass::Text, f);
 }
 
 QString JKQTMathText::getFontSans() const
@@ -3741,8 +3825,7 @@ JKQTMathText::MTfontEncoding JKQTMathText::getFontEncodingSans() const
 void JKQTMathText::setFontTypewriter(const QString &__value, MTfontEncoding encoding)
 {
     auto f=getReplacementFont(__value, __value, encoding);
-    fontDefinitions[MTEtypewriter].fontName = f.first;
-    fontDefinitions[MTEtypewriter].fontEncoding = f.second;
+    setFontDefinition(MTEtypewriter, FontSubclass::Text, f);
 }
 
 QString JKQTMathText::getFontTypewriter() const
@@ -3758,8 +3841,7 @@ JKQTMathText::MTfontEncoding JKQTMathText::getFontEncodingTypewriter() const
 void JKQTMathText::setFontScript(const QString &__value, MTfontEncoding encoding)
 {
     auto f=getReplacementFont(__value, __value, encoding);
-    fontDefinitions[MTEscript].fontName = f.first;
-    fontDefinitions[MTEscript].fontEncoding = f.second;
+    setFontDefinition(MTEscript, FontSubclass::Text, f);
 }
 
 QString JKQTMathText::getFontScript() const
@@ -3775,8 +3857,7 @@ JKQTMathText::MTfontEncoding JKQTMathText::getFontEncodingScript() const
 void JKQTMathText::setFontFraktur(const QString &__value, MTfontEncoding encoding)
 {
     auto f=getReplacementFont(__value, __value, encoding);
-    fontDefinitions[MTEfraktur].fontName = f.first;
-    fontDefinitions[MTEfraktur].fontEncoding = f.second;
+    setFontDefinition(MTEfraktur, FontSubclass::Text, f);
 }
 
 QString JKQTMathText::getFontFraktur() const
@@ -3791,8 +3872,7 @@ JKQTMathText::MTfontEncoding JKQTMathText::getFontEncodingFraktur() const
 void JKQTMathText::setSymbolfontGreek(MTenvironmentFont font, const QString &__value, MTfontEncoding encoding)
 {
     auto f=getReplacementFont(__value, __value, encoding);
-    fontDefinitions[font].symbolfontGreek = f.first;
-    fontDefinitions[font].symbolfontGreekEncoding = f.second;
+    setFontDefinition(font, FontSubclass::Greek, f);
 }
 
 void JKQTMathText::setSymbolfontGreek(const QString &fontName, JKQTMathText::MTfontEncoding encoding)
@@ -3815,8 +3895,7 @@ JKQTMathText::MTfontEncoding JKQTMathText::getSymbolfontEncodingGreek(MTenvironm
 void JKQTMathText::setSymbolfontSymbol(MTenvironmentFont font, const QString &__value, MTfontEncoding encoding)
 {
     auto f=getReplacementFont(__value, __value, encoding);
-    fontDefinitions[font].symbolfontSymbol = f.first;
-    fontDefinitions[font].symbolfontSymbolEncoding = f.second;
+    setFontDefinition(font, FontSubclass::Symbols, f);
 }
 
 void JKQTMathText::setSymbolfontSymbol(const QString &fontName, JKQTMathText::MTfontEncoding encoding)
@@ -3839,8 +3918,7 @@ JKQTMathText::MTfontEncoding JKQTMathText::getSymbolfontEncodingSymbol(MTenviron
 void JKQTMathText::setFontCaligraphic(const QString &__value, MTfontEncoding encoding)
 {
     auto f=getReplacementFont(__value, __value, encoding);
-    fontDefinitions[MTEcaligraphic].fontName = f.first;
-    fontDefinitions[MTEcaligraphic].fontEncoding = f.second;
+    setFontDefinition(MTEcaligraphic, FontSubclass::Text, f);
 }
 
 QString JKQTMathText::getFontCaligraphic() const
@@ -3856,8 +3934,7 @@ JKQTMathText::MTfontEncoding JKQTMathText::getFontEncodingCaligraphic() const
 void JKQTMathText::setFontMathRoman(const QString &fontName, JKQTMathText::MTfontEncoding encoding)
 {
     auto f=getReplacementFont(fontName, fontName, encoding);
-    fontDefinitions[MTEmathRoman].fontName = f.first;
-    fontDefinitions[MTEmathRoman].fontEncoding = f.second;
+    setFontDefinition(MTEmathRoman, FontSubclass::Text, f);
 }
 
 QString JKQTMathText::getFontMathRoman() const
@@ -3868,8 +3945,7 @@ QString JKQTMathText::getFontMathRoman() const
 void JKQTMathText::setFontMathSans(const QString &fontName, JKQTMathText::MTfontEncoding encoding)
 {
     auto f=getReplacementFont(fontName, fontName, encoding);
-    fontDefinitions[MTEmathSans].fontName = f.first;
-    fontDefinitions[MTEmathSans].fontEncoding = f.second;
+    setFontDefinition(MTEmathSans, FontSubclass::Text, f);
 }
 
 QString JKQTMathText::getFontMathSans() const
@@ -3889,15 +3965,17 @@ JKQTMathText::MTfontEncoding JKQTMathText::getFontEncodingMathRoman() const
 
 void JKQTMathText::setFontBlackboard(const QString &__value, MTfontEncoding encoding)
 {
-    blackboardSimulated=false;
+    setFontBlackboardSimulated(false);
     auto f=getReplacementFont(__value, __value, encoding);
-    fontDefinitions[MTEblackboard].fontName = f.first;
-    fontDefinitions[MTEblackboard].fontEncoding = f.second;
+    setFontDefinition(MTEblackboard, FontSubclass::Text, f);
 }
 
 void JKQTMathText::setFontBlackboardSimulated(bool doSimulate)
 {
-    blackboardSimulated=doSimulate;
+    if (blackboardSimulated!=doSimulate) {
+        blackboardSimulated=doSimulate;
+        invalidateLayout();
+    }
 }
 
 bool JKQTMathText::isFontBlackboardSimulated() const
@@ -3918,7 +3996,10 @@ JKQTMathText::MTfontEncoding JKQTMathText::getFontEncodingBlackboard() const
 
 void JKQTMathText::setBraceFactor(double __value)
 {
-    this->brace_factor = __value;
+    if (this->brace_factor != __value) {
+        this->brace_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getBraceFactor() const
@@ -3928,7 +4009,10 @@ double JKQTMathText::getBraceFactor() const
 
 void JKQTMathText::setSubsuperSizeFactor(double __value)
 {
-    this->subsuper_size_factor = __value;
+    if (this->subsuper_size_factor != __value) {
+        this->subsuper_size_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getSubsuperSizeFactor() const
@@ -3938,7 +4022,10 @@ double JKQTMathText::getSubsuperSizeFactor() const
 
 void JKQTMathText::setItalicCorrectionFactor(double __value)
 {
-    this->italic_correction_factor = __value;
+    if (this->italic_correction_factor != __value) {
+        this->italic_correction_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getItalicCorrectionFactor() const
@@ -3948,7 +4035,10 @@ double JKQTMathText::getItalicCorrectionFactor() const
 
 void JKQTMathText::setOperatorsubsuperSizeFactor(double __value)
 {
-    this->operatorsubsuper_size_factor = __value;
+    if (this->operatorsubsuper_size_factor != __value) {
+        this->operatorsubsuper_size_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getOperatorsubsuperSizeFactor() const
@@ -3958,7 +4048,10 @@ double JKQTMathText::getOperatorsubsuperSizeFactor() const
 
 void JKQTMathText::setMathoperatorWidthFactor(double __value)
 {
-    this->mathoperator_width_factor = __value;
+    if (this->mathoperator_width_factor != __value) {
+        this->mathoperator_width_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getMathoperatorWidthFactor() const
@@ -3968,7 +4061,10 @@ double JKQTMathText::getMathoperatorWidthFactor() const
 
 void JKQTMathText::setSuperShiftFactor(double __value)
 {
-    this->super_shift_factor = __value;
+    if (this->super_shift_factor != __value) {
+        this->super_shift_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getSuperShiftFactor() const
@@ -3978,7 +4074,10 @@ double JKQTMathText::getSuperShiftFactor() const
 
 void JKQTMathText::setSubShiftFactor(double __value)
 {
-    this->sub_shift_factor = __value;
+    if (this->sub_shift_factor != __value) {
+        this->sub_shift_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getSubShiftFactor() const
@@ -3988,7 +4087,10 @@ double JKQTMathText::getSubShiftFactor() const
 
 void JKQTMathText::setBraceShrinkFactor(double __value)
 {
-    this->brace_shrink_factor = __value;
+    if (this->brace_shrink_factor != __value) {
+        this->brace_shrink_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getBraceShrinkFactor() const
@@ -3998,7 +4100,10 @@ double JKQTMathText::getBraceShrinkFactor() const
 
 void JKQTMathText::setUnderbraceFactor(double __value)
 {
-    this->underbrace_factor = __value;
+    if (this->underbrace_factor != __value) {
+        this->underbrace_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getUnderbraceFactor() const
@@ -4008,7 +4113,10 @@ double JKQTMathText::getUnderbraceFactor() const
 
 void JKQTMathText::setUndersetFactor(double __value)
 {
-    this->undersetFactor = __value;
+    if (this->undersetFactor != __value) {
+        this->undersetFactor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getUndersetFactor() const
@@ -4018,7 +4126,10 @@ double JKQTMathText::getUndersetFactor() const
 
 void JKQTMathText::setFracFactor(double __value)
 {
-    this->frac_factor = __value;
+    if (this->frac_factor != __value) {
+        this->frac_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getFracFactor() const
@@ -4028,7 +4139,10 @@ double JKQTMathText::getFracFactor() const
 
 void JKQTMathText::setFracShiftFactor(double __value)
 {
-    this->frac_shift_factor = __value;
+    if (this->frac_shift_factor != __value) {
+        this->frac_shift_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getFracShiftFactor() const
@@ -4038,7 +4152,10 @@ double JKQTMathText::getFracShiftFactor() const
 
 void JKQTMathText::setBraceYShiftFactor(double __value)
 {
-    this->brace_y_shift_factor = __value;
+    if (this->brace_y_shift_factor != __value) {
+        this->brace_y_shift_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getBraceYShiftFactor() const
@@ -4048,7 +4165,10 @@ double JKQTMathText::getBraceYShiftFactor() const
 
 void JKQTMathText::setDecorationHeightFactor(double __value)
 {
-    this->decoration_height_factor = __value;
+    if (this->decoration_height_factor != __value) {
+        this->decoration_height_factor = __value;
+        invalidateLayout();
+    }
 }
 
 double JKQTMathText::getDecorationHeightFactor() const
@@ -4058,7 +4178,10 @@ double JKQTMathText::getDecorationHeightFactor() const
 
 void JKQTMathText::setExpensiveRendering(bool __value)
 {
-    this->expensiveRendering = __value;
+    if (this->expensiveRendering != __value) {
+        this->expensiveRendering = __value;
+        invalidateLayout();
+    }
 }
 
 bool JKQTMathText::getExpensiveRendering() const
@@ -4590,33 +4713,53 @@ JKQTMathText::MTnode* JKQTMathText::parseLatexString(bool get, const QString& qu
     return nl;
 }
 
+bool JKQTMathText::isPlainText(const QString &text)
+{
+    for (const QChar& c: text) {
+        const ushort u=c.unicode();
+        if (u=='\\' || u=='$' || u=='&' || u=='{' || u=='}' || u=='_' || u=='^') return false;
+    }
+    return true;
+}
+
+JKQTMathText::MTnode *JKQTMathText::parsePlainText(const QString &text)
+{
+    // parse() prepends "\\;" (a symbol node), the tokenizer splits the text into words at whitespace, a word followed by
+    // whitespace gets a trailing space and leading whitespace yields a whitespace node. The appended "\\;" is dropped by
+    // the tokenizer, as it ends the string.
+    MTlistNode* nl=new MTlistNode(this);
+    nl->addNode(new MTsymbolNode(this, ";", false));
+    const int N=text.size();
+    int i=0;
+    if (i<N && text[i].isSpace()) {
+        nl->addNode(new MTwhitespaceNode(this));
+        while (i<N && text[i].isSpace()) i++;
+    }
+    while (i<N) {
+        const int start=i;
+        while (i<N && !text[i].isSpace()) i++;
+        const QString word=text.mid(start, i-start);
+        const bool addWhite=(i<N);
+        while (i<N && text[i].isSpace()) i++;
+        nl->addNode(new MTtextNode(this, word, addWhite, false));
+    }
+    return nl;
+}
+
 JKQTMathText::MTnode *JKQTMathText::getParsedNode() const {
     return this->parsedNode;
 }
 
 
-QList<JKQTMathText::tbrData> JKQTMathText::tbrs=QList<JKQTMathText::tbrData>();
-QHash<JKQTMathText::tbrDataH, QRectF> JKQTMathText::tbrh=QHash<JKQTMathText::tbrDataH, QRectF>();
+JKQTPShardedLRUCache<JKQTMathText::tbrDataH, QRectF> JKQTMathText::s_tightBoundingRectCache(8192);
 
 QRectF JKQTMathText::getTightBoundingRect(const QFont &fm, const QString &text, QPaintDevice *pd)
 {
-    JKQTMathText::tbrDataH  dh(fm, text, pd);
-    if (pd) {        
-        if (tbrh.contains(dh)) return tbrh[dh];
-        /*for (int i=0; i<tbrs.size(); i++) {
-            if (tbrs[i].f==fm && tbrs[i].text==text && (tbrs[i].ldpiX==pd->logicalDpiX() && tbrs[i].ldpiY==pd->logicalDpiY() && tbrs[i].pdpiX==pd->physicalDpiX() && tbrs[i].pdpiY==pd->physicalDpiY())) {
-                //qDebug()<<"   ### "<<fm<<pd<<tbrs[i].text<<tbrs[i].tbr;
-                return tbrs[i].tbr;
-            }
-        }*/
-    } else {
-        //qDebug()<<"warning no pd";
-    }
-    tbrData d(fm, text, pd);
-    tbrs.append(d);
-    tbrh[dh]=d.tbr;
-    //qDebug()<<"TBRs lits: "<<tbrs.size();
-    //qDebug()<<"+++ "<<fm<<pd<<d.text<<d.tbr;
+    const JKQTMathText::tbrDataH dh(fm, text, pd);
+    QRectF tbr;
+    if (s_tightBoundingRectCache.get(dh, tbr)) return tbr;
+    const tbrData d(fm, text, pd);
+    s_tightBoundingRectCache.put(dh, d.tbr);
     return d.tbr;
 }
 
@@ -4629,9 +4772,17 @@ bool JKQTMathText::parse(QString text){
     ntext=ntext.remove("\\limits");
     if (parsedNode && parseString==ntext) return true;
 
+    auto it=parseCache.find(ntext);
+    if (it!=parseCache.end()) {
+        // cache hit: mark the entry as most recently used and reuse its tree
+        parseCacheUsage.splice(parseCacheUsage.begin(), parseCacheUsage, it->usage);
+        parseString=ntext;
+        parsedNode=it->parsedNode;
+        unparsedNode=it->unparsedNode;
+        error_list=it->errors;
+        return (parsedNode!=nullptr);
+    }
 
-    if (parsedNode!=nullptr) delete parsedNode;
-    if (unparsedNode!=nullptr) delete unparsedNode;
     parseString=ntext;
 
     currentTokenID=-1;
@@ -4639,11 +4790,52 @@ bool JKQTMathText::parse(QString text){
     currentTokenName="";
     parsingMathEnvironment=false;
     error_list.clear();
-    parsedNode=parseLatexString(true);
+    if (isPlainText(text)) parsedNode=parsePlainText(text);
+    else parsedNode=parseLatexString(true);
     unparsedNode=new MTplainTextNode(this, text, false);
+
+    parseCacheUsage.push_front(ntext);
+    ParseCacheEntry entry;
+    entry.parsedNode=parsedNode;
+    entry.unparsedNode=unparsedNode;
+    entry.errors=error_list;
+    entry.usage=parseCacheUsage.begin();
+    parseCache.insert(ntext, entry);
+    shrinkParseCache(parseCacheSize);
     return (parsedNode!=nullptr);
 }
 
+int JKQTMathText::getParseCacheSize() const
+{
+    return parseCacheSize;
+}
+
+void JKQTMathText::setParseCacheSize(int size)
+{
+    parseCacheSize=size;
+    shrinkParseCache(parseCacheSize);
+}
+
+void JKQTMathText::clearParseCache()
+{
+    shrinkParseCache(1);
+}
+
+void JKQTMathText::shrinkParseCache(int maxEntries)
+{
+    // the front entry is the tree of the last parsed string, which is still referenced by parsedNode and unparsedNode
+    const size_t keep=static_cast<size_t>(qMax(1, maxEntries));
+    while (parseCacheUsage.size()>keep) {
+        auto it=parseCache.find(parseCacheUsage.back());
+        if (it!=parseCache.end()) {
+            if (it->parsedNode!=nullptr) delete it->parsedNode;
+            if (it->unparsedNode!=nullptr) delete it->unparsedNode;
+            parseCache.erase(it);
+        }
+        parseCacheUsage.pop_back();
+    }
+}
+
 
 QSizeF JKQTMathText::getSize(QPainter& painter){
     if (getTree()!=nullptr) {
@@ -4672,12 +4864,8 @@ void JKQTMathText::getSizeDetail(QPainter& painter, double& width, double& ascen
     descent=0;
     strikeoutPos=0;
     if (getTree()!=nullptr) {
-        MTenvironment ev;
-        ev.color=fontColor;
-        ev.fontSize=fontSize;
-
         double overallHeight=0;        
-        getTree()->getSize(painter, ev, width, ascent, overallHeight, strikeoutPos);
+        getTreeSize(painter, width, ascent, overallHeight, strikeoutPos);
         descent=overallHeight-ascent;
         ascent=ascent*1.1;
         descent=qMax(ascent*0.1, descent*1.1);
@@ -4687,6 +4875,8 @@ void JKQTMathText::getSizeDetail(QPainter& painter, double& width, double& ascen
 
 void JKQTMathText::draw(QPainter& painter, double x, double y, bool drawBoxes){
     if (getTree()!=nullptr) {
+        updateLayoutGeneration(painter.device());
+        if (!drawBoxes && drawFromRenderCache(painter, x, y)) return;
         MTenvironment ev;
         ev.color=fontColor;
         ev.fontSize=fontSize;
@@ -4716,7 +4906,7 @@ void JKQTMathText::draw(QPainter& painter, unsigned int flags, QRectF rect, bool
         double width=0;
         double baselineHeight=0;
         double overallHeight=0, strikeoutPos=0;
-        getTree()->getSize(painter, ev, width, baselineHeight, overallHeight, strikeoutPos);
+        getTreeSize(painter, width, baselineHeight, overallHeight, strikeoutPos);
 
         // align left top
         double x=rect.left();
@@ -4731,11 +4921,257 @@ void JKQTMathText::draw(QPainter& painter, unsigned int flags, QRectF rect, bool
         else if ((flags & Qt::AlignVCenter) != 0) y=y+(rect.height()-overallHeight)/2.0;
 
         // finally draw
-        getTree()->draw(painter, x, y, ev);
+        if (drawBoxes || !drawFromRenderCache(painter, x, y)) getTree()->draw(painter, x, y, ev);
         painter.setPen(pp);
     }
 }
 
+void JKQTMathText::setRenderCacheEnabled(bool enabled)
+{
+    renderCacheEnabled=enabled;
+    if (!renderCacheEnabled) renderCache.clear();
+}
+
+bool JKQTMathText::isRenderCacheEnabled() const
+{
+    return renderCacheEnabled;
+}
+
+void JKQTMathText::clearRenderCache()
+{
+    renderCache.clear();
+}
+
+void JKQTMathText::setGlyphRunsEnabled(bool enabled)
+{
+    if (glyphRunsEnabled!=enabled) {
+        glyphRunsEnabled=enabled;
+        // cached images were drawn with the other text backend
+        renderCache.clear();
+    }
+}
+
+bool JKQTMathText::isGlyphRunsEnabled() const
+{
+    return glyphRunsEnabled;
+}
+
+JKQTMathText::GlyphRunCache::GlyphRunCache():
+    dpiX(0), dpiY(0), ascent(0)
+{
+
+}
+
+bool JKQTMathText::drawGlyphRuns(QPainter &painter, const QPointF &pos, const QFont &f, const QString &text, GlyphRunCache &cache) const
+{
+    if (!glyphRunsEnabled || !painter.paintEngine() || painter.paintEngine()->type()!=QPaintEngine::Raster || !painter.device()) return false;
+    const int dpiX=painter.device()->logicalDpiX();
+    const int dpiY=painter.device()->logicalDpiY();
+    if (cache.dpiX!=dpiX || cache.dpiY!=dpiY || cache.text!=text || cache.font!=f) {
+        QTextLayout layout(text, f, painter.device());
+        QTextOption opt;
+        opt.setWrapMode(QTextOption::NoWrap);
+        layout.setTextOption(opt);
+        layout.beginLayout();
+        QTextLine line=layout.createLine();
+        if (line.isValid()) {
+            line.setNumColumns(text.size());
+            line.setPosition(QPointF(0,0));
+        }
+        layout.endLayout();
+        cache.text=text;
+        cache.font=f;
+        cache.dpiX=dpiX;
+        cache.dpiY=dpiY;
+        cache.ascent=line.isValid()?line.ascent():0;
+        cache.runs=layout.glyphRuns();
+    }
+    const QPointF topLeft(pos.x(), pos.y()-cache.ascent);
+    for (const QGlyphRun& run: cache.runs) {
+        painter.drawGlyphRun(topLeft, run);
+    }
+    return true;
+}
+
+JKQTMathText::RenderCacheEntry::RenderCacheEntry():
+    width(0), baselineHeight(0), overallHeight(0), strikeoutPos(0), imageScale(0)
+{
+
+}
+
+QByteArray JKQTMathText::getRenderCacheKey() const
+{
+    QByteArray key;
+    key.reserve(layoutSettingsKey.size()+parseString.size()*2+48);
+    key.append(parseString.toUtf8());
+    key.append('\0');
+    key.append(useUnparsed?'U':'P');
+    const double v[4]={fontSize, static_cast<double>(fontColor.rgba()), static_cast<double>(layoutDpiX), static_cast<double>(layoutDpiY)};
+    key.append(reinterpret_cast<const char*>(v), sizeof(v));
+    key.append(layoutSettingsKey);
+    return key;
+}
+
+QByteArray JKQTMathText::getRenderCacheImageKey(const QByteArray &key, const QPainter &painter, double scale) const
+{
+    QByteArray imageKey=key;
+    const QPen pen=painter.pen();
+    const double v[5]={scale, pen.widthF(), static_cast<double>(pen.color().rgba()), static_cast<double>(painter.brush().color().rgba()), static_cast<double>(painter.brush().style())};
+    imageKey.append('\0');
+    imageKey.append('I');
+    imageKey.append(reinterpret_cast<const char*>(v), sizeof(v));
+    const int hints=static_cast<int>(painter.renderHints());
+    imageKey.append(reinterpret_cast<const char*>(&hints), sizeof(hints));
+    return imageKey;
+}
+
+QByteArray JKQTMathText::getLayoutSettingsKey() const
+{
+    QByteArray key;
+    key.reserve(512);
+    auto addString=[&key](const QString& s) { key.append(s.toUtf8()); key.append('\0'); };
+    auto addValue=[&key](double v) { key.append(reinterpret_cast<const char*>(&v), sizeof(v)); };
+    for (int f=0; f<MTenvironmentFontCount; f++) {
+        const FontDefinition fd=fontDefinitions.value(static_cast<MTenvironmentFont>(f));
+        addString(fd.fontName);
+        addString(fd.symbolfontGreek);
+        addString(fd.symbolfontSymbol);
+        key.append(static_cast<char>(fd.fontEncoding));
+        key.append(static_cast<char>(fd.symbolfontGreekEncoding));
+        key.append(static_cast<char>(fd.symbolfontSymbolEncoding));
+    }
+    key.append(blackboardSimulated?'1':'0');
+    key.append(expensiveRendering?'1':'0');
+    for (double v: {brace_factor, brace_shrink_factor, subsuper_size_factor, italic_correction_factor, operatorsubsuper_size_factor,
+                    mathoperator_width_factor, super_shift_factor, sub_shift_factor, frac_factor, frac_shift_factor,
+                    underbrace_factor, undersetFactor, brace_y_shift_factor, decoration_height_factor}) {
+        addValue(v);
+    }
+    return key;
+}
+
+void JKQTMathText::invalidateLayout()
+{
+    layoutSettingsKey=getLayoutSettingsKey();
+    layoutGeneration++;
+}
+
+void JKQTMathText::updateLayoutGeneration(const QPaintDevice *pd)
+{
+    const int dpiX=pd?pd->logicalDpiX():0;
+    const int dpiY=pd?pd->logicalDpiY():0;
+    if (dpiX!=layoutDpiX || dpiY!=layoutDpiY) {
+        layoutDpiX=dpiX;
+        layoutDpiY=dpiY;
+        layoutGeneration++;
+    }
+}
+
+void JKQTMathText::setFontDefinition(MTenvironmentFont font, FontSubclass subclass, const QPair<QString, MTfontEncoding> &f)
+{
+    FontDefinition& fd=fontDefinitions[font];
+    QString& name=(subclass==FontSubclass::Greek)?fd.symbolfontGreek:((subclass==FontSubclass::Symbols)?fd.symbolfontSymbol:fd.fontName);
+    MTfontEncoding& encoding=(subclass==FontSubclass::Greek)?fd.symbolfontGreekEncoding:((subclass==FontSubclass::Symbols)?fd.symbolfontSymbolEncoding:fd.fontEncoding);
+    if (name!=f.first || encoding!=f.second) {
+        name=f.first;
+        encoding=f.second;
+        invalidateLayout();
+    }
+}
+
+JKQTMathText::RenderCacheEntry *JKQTMathText::getRenderCacheEntry(QPainter &painter, const QByteArray &key)
+{
+    RenderCacheEntry* e=renderCache.object(key);
+    if (e==nullptr && getTree()!=nullptr) {
+        MTenvironment ev;
+        ev.color=fontColor;
+        ev.fontSize=fontSize;
+        e=new RenderCacheEntry();
+        getTree()->getSize(painter, ev, e->width, e->baselineHeight, e->overallHeight, e->strikeoutPos);
+        // insert() deletes e, if it cannot be stored
+        if (!renderCache.insert(key, e, key.size()+static_cast<int>(sizeof(RenderCacheEntry)))) return nullptr;
+    }
+    return e;
+}
+
+void JKQTMathText::getTreeSize(QPainter &painter, double &width, double &baselineHeight, double &overallHeight, double &strikeoutPos)
+{
+    width=0;
+    baselineHeight=0;
+    overallHeight=0;
+    strikeoutPos=0;
+    if (getTree()==nullptr) return;
+    updateLayoutGeneration(painter.device());
+    if (renderCacheEnabled) {
+        const RenderCacheEntry* e=getRenderCacheEntry(painter, getRenderCacheKey());
+        if (e!=nullptr) {
+            width=e->width;
+            baselineHeight=e->baselineHeight;
+            overallHeight=e->overallHeight;
+            strikeoutPos=e->strikeoutPos;
+            return;
+        }
+    }
+    MTenvironment ev;
+    ev.color=fontColor;
+    ev.fontSize=fontSize;
+    getTree()->getSize(painter, ev, width, baselineHeight, overallHeight, strikeoutPos);
+}
+
+bool JKQTMathText::drawFromRenderCache(QPainter &painter, double x, double y)
+{
+    if (!renderCacheEnabled || getTree()==nullptr || !painter.paintEngine() || painter.paintEngine()->type()!=QPaintEngine::Raster || !painter.device()) return false;
+    // only blit for transformations that map image pixels 1:1 onto device pixels (scaling, rotation by multiples of 90 degrees)
+    const QTransform trans=painter.combinedTransform();
+    const bool axisAligned=(trans.type()<=QTransform::TxScale && qFuzzyCompare(fabs(trans.m11()), fabs(trans.m22())))
+                           || (trans.type()==QTransform::TxRotate && qFuzzyIsNull(trans.m11()) && qFuzzyIsNull(trans.m22()) && qFuzzyCompare(fabs(trans.m12()), fabs(trans.m21())));
+    if (!axisAligned) return false;
+    const double scale=sqrt(fabs(trans.determinant()))*painter.device()->devicePixelRatioF();
+    if (!(scale>0)) return false;
+
+    const QByteArray key=getRenderCacheKey();
+    const QByteArray imageKey=getRenderCacheImageKey(key, painter, scale);
+    RenderCacheEntry* e=renderCache.object(imageKey);
+    if (e==nullptr) {
+        // the size of the tree is stored in the entry without image
+        const RenderCacheEntry* se=getRenderCacheEntry(painter, key);
+        if (se==nullptr) return false;
+        // leave room for glyphs that overhang the size of the tree (e.g. italic letters)
+        const double pad=ceil(fontSize*0.5)+2.0;
+        const QSize imageSize(static_cast<int>(ceil((se->width+2.0*pad)*scale)), static_cast<int>(ceil((se->overallHeight+2.0*pad)*scale)));
+        if (imageSize.isEmpty()) return false;
+        const int cost=imageKey.size()+static_cast<int>(sizeof(RenderCacheEntry))+imageSize.width()*imageSize.height()*4;
+        if (cost>renderCache.maxCost()) return false;
+
+        RenderCacheEntry* ne=new RenderCacheEntry(*se);
+        ne->image=QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+        ne->image.setDevicePixelRatio(scale);
+        ne->image.setDotsPerMeterX(qRound(painter.device()->logicalDpiX()/0.0254));
+        ne->image.setDotsPerMeterY(qRound(painter.device()->logicalDpiY()/0.0254));
+        ne->image.fill(Qt::transparent);
+        ne->imageOrigin=QPointF(pad, pad+se->baselineHeight);
+        ne->imageScale=scale;
+        {
+            QPainter ip(&ne->image);
+            ip.setRenderHints(painter.renderHints());
+            QPen p=painter.pen();
+            p.setStyle(Qt::SolidLine);
+            ip.setPen(p);
+            ip.setBrush(painter.brush());
+            MTenvironment ev;
+            ev.color=fontColor;
+            ev.fontSize=fontSize;
+            getTree()->setDrawBoxes(false);
+            getTree()->draw(ip, ne->imageOrigin.x(), ne->imageOrigin.y(), ev);
+        }
+        // insert() deletes ne, if it cannot be stored
+        if (!renderCache.insert(imageKey, ne, cost)) return false;
+        e=ne;
+    }
+    painter.drawImage(QPointF(x, y)-e->imageOrigin, e->image);
+    return true;
+}
+
 JKQTMathText::MTwhitespaceNode::MTwhitespaceNode(JKQTMathText *_parent):
     MTtextNode(_parent, " ", false, false)
 {
@@ -4964,6 +5400,44 @@ bool JKQTMathText::tbrDataH::operator==(const JKQTMathText::tbrDataH &other) con
 
 }
 
+JKQTMathText::FontCacheKey::FontCacheKey(const QString &family, const JKQTMathText::MTenvironment &ev):
+    family(family), fontSize(ev.fontSize), style(0)
+{
+    if (ev.bold) style|=1;
+    if (ev.italic) style|=2;
+    if (ev.underlined) style|=4;
+    if (ev.overline) style|=8;
+    if (ev.strike) style|=16;
+    if (ev.smallCaps) style|=32;
+}
+
+bool JKQTMathText::FontCacheKey::operator==(const JKQTMathText::FontCacheKey &other) const
+{
+    return fontSize==other.fontSize && style==other.style && family==other.family;
+}
+
+JKQTMathText::FontMetricsCacheKey::FontMetricsCacheKey(const QFont &f, const QPaintDevice *pd):
+    f(f), dpiX(pd?pd->logicalDpiX():0), dpiY(pd?pd->logicalDpiY():0)
+{
+}
+
+bool JKQTMathText::FontMetricsCacheKey::operator==(const JKQTMathText::FontMetricsCacheKey &other) const
+{
+    return dpiX==other.dpiX && dpiY==other.dpiY && f==other.f;
+}
+
+QFontMetricsF JKQTMathText::getFontMetrics(const QFont &f, const QPaintDevice *pd)
+{
+    const FontMetricsCacheKey key(f, pd);
+    auto it=fontMetricsCache.constFind(key);
+    if (it!=fontMetricsCache.constEnd()) return it.value();
+    // QFontMetricsF only takes a non-const QPaintDevice, but does not modify it
+    const QFontMetricsF fm=pd?QFontMetricsF(f, const_cast<QPaintDevice*>(pd)):QFontMetricsF(f);
+    if (fontMetricsCache.size()>=1024) fontMetricsCache.clear();
+    fontMetricsCache.insert(key, fm);
+    return fm;
+}
+
 
 JKQTMathText::MTplainTextNode::MTplainTextNode(JKQTMathText *_parent, const QString& _text, bool addWhitespace, bool stripInnerWhitepace):
     JKQTMathText::MTtextNode(_parent, _text, addWhitespace, stripInnerWhitepace)
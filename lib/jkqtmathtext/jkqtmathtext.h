@@ -37,9 +37,16 @@
 #include <QSet>
 #include <QFile>
 #include "jkqtmathtext/jkqtmathtext_imexport.h"
+#include "jkqtcommon/jkqtpcachingtools.h"
 #include <QWidget>
 #include <QLabel>
 #include <QHash>
+#include <QCache>
+#include <QImage>
+#include <QStaticText>
+#include <QGlyphRun>
+#include <QFontMetricsF>
+#include <list>
 
 
 
@@ -231,8 +238,31 @@ class JKQTMATHTEXT_LIB_EXPORT JKQTMathText : public QObject {
         void loadSettings(const QSettings& settings, const QString& group=QString("mathtext/"));
         /** \brief store the object settings to the given QSettings object with the given name prefix */
         void saveSettings(QSettings& settings, const QString& group=QString("mathtext/")) const;
-        /** \brief parse the given enhanced string. Returns \c true on success. */
+        /** \brief parse the given enhanced string. Returns \c true on success.
+         *
+         *  The parse trees of the last getParseCacheSize() strings are kept in a least-recently-used cache,
+         *  so parsing a string again (e.g. the tick labels of a plot on every redraw) does not re-tokenize
+         *  it and rebuild its tree. The error list of a cached string is restored together with its tree.
+         *
+         *  \see setParseCacheSize(), clearParseCache()
+         */
         bool parse(QString text);
+        /** \brief returns the maximum number of parse trees kept in the parse cache (see parse() ) */
+        int getParseCacheSize() const;
+        /** \brief sets the maximum number of parse trees kept in the parse cache (see parse() ), at least the tree of the last parsed string is always kept */
+        void setParseCacheSize(int size);
+        /** \brief removes all parse trees from the parse cache (see parse() ), except the tree of the last parsed string */
+        void clearParseCache();
+        /** \copydoc renderCacheEnabled */
+        void setRenderCacheEnabled(bool enabled);
+        /** \copydoc renderCacheEnabled */
+        bool isRenderCacheEnabled() const;
+        /** \brief removes all sizes and images from the render cache (see renderCacheEnabled ) */
+        void clearRenderCache();
+        /** \copydoc glyphRunsEnabled */
+        void setGlyphRunsEnabled(bool enabled);
+        /** \copydoc glyphRunsEnabled */
+        bool isGlyphRunsEnabled() const;
         /** \brief get the size of the drawn representation. returns an invalid size if no text has been parsed. */
         QSizeF getSize(QPainter& painter);
         /** \brief return the descent, i.e. the distance from the baseline to the lowest part of the representation */
@@ -545,6 +575,9 @@ class JKQTMATHTEXT_LIB_EXPORT JKQTMathText : public QObject {
             /** \brief is the text currently are we inside a math environment? */
             bool insideMath;
 
+            /** \brief returns \c true, if both environments are equal in all properties */
+            bool operator==(const MTenvironment& other) const;
+
 
             /** \brief build a QFont object from the settings in this object */
             QFont getFont(JKQTMathText* parent) const;
@@ -562,6 +595,21 @@ class JKQTMATHTEXT_LIB_EXPORT JKQTMathText : public QObject {
             QString toHtmlAfter(MTenvironment defaultEv) const;
         };
 
+        /** \brief glyph runs of a text, as created by drawGlyphRuns() \internal */
+        struct GlyphRunCache {
+            GlyphRunCache();
+            /** \brief the text, for which runs was created */
+            QString text;
+            /** \brief the font, for which runs was created */
+            QFont font;
+            /** \brief the resolution of the paint device, for which runs was created */
+            int dpiX, dpiY;
+            /** \brief distance from the top of the glyph positions in runs to the baseline */
+            double ascent;
+            /** \brief the shaped text */
+            QList<QGlyphRun> runs;
+        };
+
         /** \brief beschreibt die Größe eines Knotens */
         struct JKQTMATHTEXT_LIB_EXPORT MTnodeSize {
             MTnodeSize();
@@ -638,6 +686,29 @@ class JKQTMATHTEXT_LIB_EXPORT JKQTMathText : public QObject {
                 JKQTMathText* parent;
                 /** \brief enables the drawing of colored boxes (for DEBUGGING) around the actual output of the node */
                 bool drawBoxes;
+                /** \brief result of the last call of getSizeInternal() and the parameters it was called with
+                 *
+                 * getSize() returns these values without calling getSizeInternal() again, as long as it is called with the same environment and
+                 * previous node size and JKQTMathText::layoutGeneration did not change. So the nodes, which measure their children in draw(),
+                 * do not walk the tree below them again.
+                 */
+                struct LayoutCache {
+                    LayoutCache();
+                    /** \brief \c true, if the fields below contain a result */
+                    bool valid;
+                    /** \brief JKQTMathText::layoutGeneration at the time of the calculation */
+                    quint64 generation;
+                    /** \brief environment, for which the size was calculated */
+                    MTenvironment ev;
+                    /** \brief \c true, if a prevNodeSize was given */
+                    bool hasPrevNodeSize;
+                    /** \brief the prevNodeSize that was given (if hasPrevNodeSize) */
+                    MTnodeSize prevNodeSize;
+                    /** \brief the size as calculated by getSizeInternal() */
+                    MTnodeSize size;
+                };
+                /** \brief the last layout of this node \see LayoutCache */
+                LayoutCache layoutCache;
                 /** \brief draws colored boxes (for DEBUGGING) around the actual output of the node
                  *
                  * \param painter QPainter to use
@@ -668,6 +739,12 @@ class JKQTMATHTEXT_LIB_EXPORT JKQTMathText : public QObject {
                 QString text;
                 /** \brief transforms the text before sizing/drawing (may e.g. exchange special letters for other unicode symbols etc.) */
                 virtual QString textTransform(const QString& text, JKQTMathText::MTenvironment currentEv, bool forSize=false);
+                /** \brief glyph layout of the text, as drawn by the last call of draw(), it is reused as long as the (transformed) text and the font do not change */
+                QStaticText staticText;
+                /** \brief font, for which staticText was prepared */
+                QFont staticTextFont;
+                /** \brief shaped text for drawGlyphRuns() (see glyphRunsEnabled ) */
+                GlyphRunCache glyphRuns;
         };
 
         /** \brief subclass representing one text node in the syntax tree
@@ -721,6 +798,8 @@ class JKQTMATHTEXT_LIB_EXPORT JKQTMathText : public QObject {
                 QString symbolName;
                 /** \brief add a whitespace to the symbol? */
                 bool addWhitespace;
+                /** \brief shaped symbol for drawGlyphRuns() (see glyphRunsEnabled ) */
+                GlyphRunCache glyphRuns;
                 struct SymbolProps {
                     /** \brief the symbol name supplied to the constructor */
                     QString symbol;
@@ -1122,13 +1201,103 @@ class JKQTMATHTEXT_LIB_EXPORT JKQTMathText : public QObject {
         /** \brief used by the parser. This is used to implement brace pairs with \\right. */
         bool showRightBrace;
 
-        /** \brief the result of parsing the last string supplied to the object via parse() */
+        /** \brief the result of parsing the last string supplied to the object via parse() (owned by parseCache) */
         MTnode* parsedNode;
-        /** \brief a tree containing the unparsed text as a single node */
+        /** \brief a tree containing the unparsed text as a single node (owned by parseCache) */
         MTnode* unparsedNode;
+
+        /** \brief an entry in the parse cache parseCache */
+        struct ParseCacheEntry {
+            /** \brief the result of parseLatexString() for the string */
+            MTnode* parsedNode;
+            /** \brief a tree containing the unparsed text as a single node */
+            MTnode* unparsedNode;
+            /** \brief the errors that occured while parsing the string */
+            QStringList errors;
+            /** \brief position of the string in parseCacheUsage */
+            std::list<QString>::iterator usage;
+        };
+        /** \brief cache of parse trees, the key is the string as prepared by parse() */
+        QHash<QString, ParseCacheEntry> parseCache;
+        /** \brief keys of parseCache, the most recently used key is at the front */
+        std::list<QString> parseCacheUsage;
+        /** \brief maximum number of entries in parseCache */
+        int parseCacheSize;
+        /** \brief removes the least recently used entries from parseCache, until it contains at most \a maxEntries entries (the most recently used entry is kept) */
+        void shrinkParseCache(int maxEntries);
+
+        /*! \brief if enabled, the sizes of the last drawn strings and their rendered images are kept in a cache, so drawing the same
+                   string (e.g. a tick label) again is a single image blit (default: \c false )
+
+            The cache is keyed by the parsed string, the font size and color, all font definitions and layout factors and the resolution of
+            the paint device, so changing any property of the object simply leads to a new entry. The images are premultiplied ARGB images
+            at the device resolution (incl. the device pixel ratio and the scaling of the painter). They are additionally keyed by this scaling,
+            the pen and brush and the render hints of the painter, so e.g. drawing a string alternately on screen and in a print preview keeps
+            one image for each. They are only used for painters with a raster paint engine, whose transformation is a uniform scaling,
+            optionally rotated by a multiple of 90 degrees (e.g. rotated axis labels).
+            Other painters (e.g. SVG, PDF or printers) always draw the parse tree, so vector output stays vector output.
+
+            \note The output differs slightly from drawing the parse tree: the images are rendered at the origin of a pixel and then blitted,
+                  so a string is not antialiased to fractional pixel positions as drawing it directly would do.
+         */
+        bool renderCacheEnabled;
+        /** \brief an entry in renderCache */
+        struct RenderCacheEntry {
+            RenderCacheEntry();
+            /** \brief size of the tree as returned by MTnode::getSize() */
+            double width, baselineHeight, overallHeight, strikeoutPos;
+            /** \brief the rendered tree (may be null, if only the size was requested so far) */
+            QImage image;
+            /** \brief offset of the baseline start (x,y) in image (in logical coordinates) */
+            QPointF imageOrigin;
+            /** \brief scaling from logical coordinates to image pixels, for which image was rendered */
+            double imageScale;
+        };
+        /** \brief cache of sizes and rendered images of the parse tree (see renderCacheEnabled ), the cost of an entry is its size in bytes */
+        QCache<QByteArray, RenderCacheEntry> renderCache;
+        /** \brief returns the key of the current tree and settings in renderCache (layoutDpiX and layoutDpiY have to be up to date, see updateLayoutGeneration()) */
+        QByteArray getRenderCacheKey() const;
+        /** \brief returns the key of the image of the current tree (with the key \a key , see getRenderCacheKey() ) in renderCache, when drawn with \a painter at the scaling \a scale */
+        QByteArray getRenderCacheImageKey(const QByteArray& key, const QPainter& painter, double scale) const;
+        /** \brief returns the entry of the current tree with the key \a key in renderCache (the entry is created with the size of the tree, if necessary), or \c nullptr if it could not be stored */
+        RenderCacheEntry* getRenderCacheEntry(QPainter& painter, const QByteArray& key);
+        /** \brief returns the size of the current tree, uses renderCache if enabled */
+        void getTreeSize(QPainter& painter, double& width, double& baselineHeight, double& overallHeight, double& strikeoutPos);
+        /** \brief draws the current tree from a cached image with the baseline starting at (\a x , \a y ), returns \c false if \a painter is not suited to use renderCache */
+        bool drawFromRenderCache(QPainter& painter, double x, double y);
         /** \brief if true, the unparsedNode is drawn */
         bool useUnparsed;
 
+        /*! \brief if enabled, text and symbol nodes draw their text from QGlyphRun objects, which they create once and keep, instead of calling
+                   QPainter::drawText() (default: \c false )
+
+            Qt shapes a string anew on every QPainter::drawText(), while the glyph runs are shaped only when the text, font or device resolution
+            of a node changes. As the nodes are kept in the parse cache (see parse() ), drawing the same label again skips text shaping completely.
+            This is only used for painters with a raster paint engine, other painters (e.g. SVG, PDF or printers) still call QPainter::drawText().
+         */
+        bool glyphRunsEnabled;
+        /** \brief draws \a text with the font \a f and its baseline starting at \a pos from the glyph runs in \a cache (they are created, if
+         *         \a cache does not contain the runs for this text, font and device), returns \c false (without drawing), if glyphRunsEnabled is \c false or
+         *         \a painter does not use a raster paint engine */
+        bool drawGlyphRuns(QPainter& painter, const QPointF& pos, const QFont& f, const QString& text, GlyphRunCache& cache) const;
+
+        /** \brief generation of the layout settings, the sizes stored in the nodes (see MTnode::LayoutCache) are only valid for the generation they were calculated in
+         *
+         *  The setters of all settings that influence the layout call invalidateLayout(), a change of the device resolution is detected by updateLayoutGeneration(). */
+        quint64 layoutGeneration;
+        /** \brief key of the current layout settings (see getLayoutSettingsKey()), updated by invalidateLayout() */
+        QByteArray layoutSettingsKey;
+        /** \brief logical resolution of the paint device, for which layoutGeneration is valid */
+        int layoutDpiX, layoutDpiY;
+        /** \brief returns a key of all settings that influence the layout of the nodes, except the font size and color (which are part of the environment) and the device resolution */
+        QByteArray getLayoutSettingsKey() const;
+        /** \brief increments layoutGeneration and updates layoutSettingsKey, has to be called, whenever a setting that influences the layout changed */
+        void invalidateLayout();
+        /** \brief increments layoutGeneration, if the resolution of the paint device \a pd differs from the last call, has to be called before the tree is measured or drawn */
+        void updateLayoutGeneration(const QPaintDevice* pd);
+        /** \brief sets the font name and encoding of \a font (or of its greek/symbol font, depending on \a subclass ) to \a f and calls invalidateLayout(), if this changes the font */
+        void setFontDefinition(MTenvironmentFont font, FontSubclass subclass, const QPair<QString, MTfontEncoding>& f);
+
         MTnode* getTree() const;
 
         /** \brief the token types that may arrise in the string */
@@ -1151,6 +1320,13 @@ class JKQTMATHTEXT_LIB_EXPORT JKQTMathText : public QObject {
         MTnode* parseLatexString(bool get, const QString& quitOnClosingBrace=QString(""), const QString& quitOnEnvironmentEnd=QString(""));
         /** \brief parse a LaTeX math environment */
         MTnode* parseMath(bool get);
+        /** \brief returns \c true, if \a text does not contain any LaTeX markup, i.e. none of the characters \c \\ \c $ \c & \c { \c } \c _ \c ^ */
+        static bool isPlainText(const QString& text);
+        /** \brief builds the parse tree of the markup-free string \a text (see isPlainText() ) directly, without the tokenizer.
+         *
+         *  The result is the same tree that parseLatexString() returns for the string prepared by parse().
+         */
+        MTnode* parsePlainText(const QString& text);
 
         /** \brief used by the tokenizer. type of the current token */
         tokenType currentToken;
@@ -1187,10 +1363,43 @@ class JKQTMATHTEXT_LIB_EXPORT JKQTMathText : public QObject {
 
             bool operator==(const tbrDataH& other) const;
         };
-        static QList<JKQTMathText::tbrData> tbrs;
-        static QHash<JKQTMathText::tbrDataH, QRectF> tbrh;
+        /** \brief cache for the results of getTightBoundingRect()
+         *
+         *  The cache is bounded (least recently used entries are evicted) and thread-safe, as several JKQTMathText objects
+         *  may be used in parallel threads (e.g. by plotters that are drawn in parallel, see JKQTBasePlotter::gridPrintingParallel).
+         */
+        static JKQTPShardedLRUCache<JKQTMathText::tbrDataH, QRectF> s_tightBoundingRectCache;
+        /** \brief returns the tight bounding rectangle of \a text in the font \a fm on the paint device \a pd (results are cached in s_tightBoundingRectCache) */
         static QRectF getTightBoundingRect(const QFont &fm, const QString& text,  QPaintDevice *pd);
 
+        /** \brief key of fontCache: the font family and the style and size of a MTenvironment
+         *  \internal */
+        struct JKQTMATHTEXT_LIB_EXPORT FontCacheKey {
+            explicit FontCacheKey(const QString& family, const MTenvironment& ev);
+            QString family;
+            double fontSize;
+            /** \brief bold, italic, underlined, overline, strike and smallCaps of the MTenvironment as bit flags */
+            int style;
+
+            bool operator==(const FontCacheKey& other) const;
+        };
+        /** \brief key of fontMetricsCache: a font and the resolution of the paint device
+         *  \internal */
+        struct JKQTMATHTEXT_LIB_EXPORT FontMetricsCacheKey {
+            explicit FontMetricsCacheKey(const QFont& f, const QPaintDevice* pd);
+            QFont f;
+            int dpiX, dpiY;
+
+            bool operator==(const FontMetricsCacheKey& other) const;
+        };
+    protected:
+        /** \brief cache of the fonts built by MTenvironment::getFont() */
+        QHash<FontCacheKey, QFont> fontCache;
+        /** \brief cache of the font metrics returned by getFontMetrics() */
+        QHash<FontMetricsCacheKey, QFontMetricsF> fontMetricsCache;
+        /** \brief returns the metrics of the font \a f on the paint device \a pd (or the screen, if \c nullptr ), the metrics are cached, so the size and draw passes share them */
+        QFontMetricsF getFontMetrics(const QFont& f, const QPaintDevice* pd);
+
 };
 
 
@@ -1199,6 +1408,14 @@ inline uint qHash(const JKQTMathText::tbrDataH& data) {
     return qHash(data.f.family())+qHash(data.text);
 }
 
+inline uint qHash(const JKQTMathText::FontCacheKey& data) {
+    return qHash(data.family)^(qHash(data.fontSize)+static_cast<uint>(data.style));
+}
+
+inline uint qHash(const JKQTMathText::FontMetricsCacheKey& data) {
+    return qHash(data.f)^(static_cast<uint>(data.dpiX)<<16)^static_cast<uint>(data.dpiY);
+}
+
 
 
 
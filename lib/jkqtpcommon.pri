@@ -23,6 +23,7 @@ isEmpty(JKQTP_COMMON_PRI_INCLUDED) {
                $$PWD/jkqtcommon/jkqtpstringtools.h  \
                $$PWD/jkqtcommon/jkqtplinalgtools.h \
                $$PWD/jkqtcommon/jkqtpcodestructuring.h \
+               $$PWD/jkqtcommon/jkqtpcachingtools.h \
                $$PWD/jkqtcommon/jkqtpbasicimagetools.h \
                $$PWD/jkqtcommon/jkqtpgeometrytools.h \
                $$PWD/jkqtcommon/jkqtpdrawingtools.h \
@@ -37,7 +38,8 @@ isEmpty(JKQTP_COMMON_PRI_INCLUDED) {
                $$PWD/jkqtcommon/jkqtpstatkde.h \
                $$PWD/jkqtcommon/jkqtpstatregression.h \
                $$PWD/jkqtcommon/jkqtpstatpoly.h \
-               $$PWD/jkqtcommon/jkqtpstatgrouped.h
+               $$PWD/jkqtcommon/jkqtpstatgrouped.h \
+               $$PWD/jkqtcommon/jkqtpstatquantilesketch.h
 
 
 
@@ -60,7 +62,8 @@ isEmpty(JKQTP_COMMON_PRI_INCLUDED) {
                $$PWD/jkqtcommon/jkqtpstatkde.cpp \
                $$PWD/jkqtcommon/jkqtpstatregression.cpp \
                $$PWD/jkqtcommon/jkqtpstatpoly.cpp \
-               $$PWD/jkqtcommon/jkqtpstatgrouped.cpp
+               $$PWD/jkqtcommon/jkqtpstatgrouped.cpp \
+               $$PWD/jkqtcommon/jkqtpstatquantilesketch.cpp
 
 
     INCLUDEPATH += $$PWD
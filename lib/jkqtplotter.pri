@@ -47,6 +47,7 @@ isEmpty(JKQTP_PLOTTER_PRI_INCLUDED) {
                $$PWD/jkqtplotter/graphs/jkqtpviolinplot.h \
                $$PWD/jkqtplotter/graphs/jkqtpviolinplotstylingmixins.h \
                $$PWD/jkqtplotter/graphs/jkqtpstatisticsadaptors.h \
+               $$PWD/jkqtplotter/graphs/jkqtplivestatistics.h \
                $$PWD/jkqtplotter/graphs/jkqtpscatter.h \
                $$PWD/jkqtplotter/graphs/jkqtprange.h \
                $$PWD/jkqtplotter/graphs/jkqtpspecialline.h \
@@ -99,6 +100,7 @@ isEmpty(JKQTP_PLOTTER_PRI_INCLUDED) {
                $$PWD/jkqtplotter/graphs/jkqtpviolinplot.cpp \
                $$PWD/jkqtplotter/graphs/jkqtpviolinplotstylingmixins.cpp \
                $$PWD/jkqtplotter/graphs/jkqtpstatisticsadaptors.cpp  \
+               $$PWD/jkqtplotter/graphs/jkqtplivestatistics.cpp \
                $$PWD/jkqtplotter/graphs/jkqtpscatter.cpp \
                $$PWD/jkqtplotter/graphs/jkqtprange.cpp \
                $$PWD/jkqtplotter/graphs/jkqtpspecialline.cpp \
@@ -75,48 +75,51 @@ void JKQTPBarVerticalGraph::draw(JKQTPEnhancedPainter& painter) {
         double deltam=0;
         intSortData();
         const bool hasStackPar=hasStackParent();
-        for (int iii=imin; iii<imax; iii++) {
-            int i=qBound(imin, getDataIndex(iii), imax);
-            const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
-            const int sr=datastore->getNextLowerIndex(xColumn, i);
-            const int lr=datastore->getNextHigherIndex(xColumn, i);
-            double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
-            double yv0=y0;
-            if (!qFuzzyIsNull(getBaseline())) yv0=transformY(getBaseline());
-            if (hasStackPar) {
-                double stackLastY=getParentStackedMax(i);
-                const double yvold=yv;
-                yv0=transformY(stackLastY)-(getLineWidth());
-                yv=stackLastY+yvold;
-            }
-            if (sr<0 && lr<0) { // only one x-value
-                deltam=0.5;
-                deltap=0.5;
-            } else if (lr<0) { // the right-most x-value
-                deltap=deltam=fabs(xv-datastore->get(xColumn,sr))/2.0;
-            } else if (sr<0) { // the left-most x-value
-                deltam=deltap=fabs(datastore->get(xColumn,lr)-xv)/2.0;
-            } else {
-                deltam=fabs(xv-datastore->get(xColumn,sr))/2.0;
-                deltap=fabs(datastore->get(xColumn,lr)-xv)/2.0;
-            }
-            //std::cout<<iii<<", \t"<<i<<", \t"<<sr<<", \t"<<lr<<", \t"<<deltam<<", \t"<<deltap<<"\n\n";
-            delta=deltap+deltam;
-
-            if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv)) {
-                const double x=transformX(xv+shift*delta-width*deltam);
-                double y=transformY(yv);
-                const double xx=transformX(xv+shift*delta+width*deltap);
-                double yy=yv0;
-
-                //std::cout<<"delta="<<delta<<"   x="<<x<<" y="<<y<<"   xx="<<xx<<" yy="<<yy<<std::endl;
-                if (yy<y) { qSwap(y,yy); }
-                if (JKQTPIsOKFloat(x) && JKQTPIsOKFloat(xx) && JKQTPIsOKFloat(y) && JKQTPIsOKFloat(yy)) {
-                    painter.setBrush(b);
-                    painter.setPen(p);
-                    QRectF r(QPointF(x, y), QPointF(xx, yy));
-                    painter.drawRect(r);
+        // bars extend from the baseline and their width depends on the neighboring bars, so only bars beyond the nearest datapoints outside the visible x-range are skipped
+        for (const auto& range: getVisibleIndexRanges(imin, imax, false, parent->pt2px(painter, getLineWidth()*parent->getLineWidthMultiplier()), true, false, true)) {
+            for (int iii=range.first; iii<range.second; iii++) {
+                int i=qBound(imin, getDataIndex(iii), imax);
+                const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
+                const int sr=datastore->getNextLowerIndex(xColumn, i);
+                const int lr=datastore->getNextHigherIndex(xColumn, i);
+                double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
+                double yv0=y0;
+                if (!qFuzzyIsNull(getBaseline())) yv0=transformY(getBaseline());
+                if (hasStackPar) {
+                    double stackLastY=getParentStackedMax(i);
+                    const double yvold=yv;
+                    yv0=transformY(stackLastY)-(getLineWidth());
+                    yv=stackLastY+yvold;
+                }
+                if (sr<0 && lr<0) { // only one x-value
+                    deltam=0.5;
+                    deltap=0.5;
+                } else if (lr<0) { // the right-most x-value
+                    deltap=deltam=fabs(xv-datastore->get(xColumn,sr))/2.0;
+                } else if (sr<0) { // the left-most x-value
+                    deltam=deltap=fabs(datastore->get(xColumn,lr)-xv)/2.0;
+                } else {
+                    deltam=fabs(xv-datastore->get(xColumn,sr))/2.0;
+                    deltap=fabs(datastore->get(xColumn,lr)-xv)/2.0;
+                }
+                //std::cout<<iii<<", \t"<<i<<", \t"<<sr<<", \t"<<lr<<", \t"<<deltam<<", \t"<<deltap<<"\n\n";
+                delta=deltap+deltam;
+
+                if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv)) {
+                    const double x=transformX(xv+shift*delta-width*deltam);
+                    double y=transformY(yv);
+                    const double xx=transformX(xv+shift*delta+width*deltap);
+                    double yy=yv0;
+
+                    //std::cout<<"delta="<<delta<<"   x="<<x<<" y="<<y<<"   xx="<<xx<<" yy="<<yy<<std::endl;
+                    if (yy<y) { qSwap(y,yy); }
+                    if (JKQTPIsOKFloat(x) && JKQTPIsOKFloat(xx) && JKQTPIsOKFloat(y) && JKQTPIsOKFloat(yy)) {
+                        painter.setBrush(b);
+                        painter.setPen(p);
+                        QRectF r(QPointF(x, y), QPointF(xx, yy));
+                        painter.drawRect(r);
 
+                    }
                 }
             }
         }
@@ -252,49 +255,52 @@ void JKQTPBarHorizontalGraph::draw(JKQTPEnhancedPainter& painter) {
             double delta=1;
             double deltap=0;
             double deltam=0;
-            for (int iii=imin; iii<imax; iii++) {
-                int i=qBound(imin, getDataIndex(iii), imax);
-                double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
-                double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
-                int sr=datastore->getNextLowerIndex(yColumn, i);
-                int lr=datastore->getNextHigherIndex(yColumn, i);
-                double xv0=x0;
-                if (!qFuzzyIsNull(getBaseline())) xv0=transformX(getBaseline());
-                if (hasStackPar) {
-                    double stackLastX=getParentStackedMax(i);
-                    const double xvold=xv;
-                    xv0=transformX(stackLastX)+(getLineWidth());
-                    xv=stackLastX+xvold;
-                }
+            // bars extend from the baseline and their width depends on the neighboring bars, so only bars beyond the nearest datapoints outside the visible y-range are skipped
+            for (const auto& range: getVisibleIndexRanges(imin, imax, false, parent->pt2px(painter, getLineWidth()*parent->getLineWidthMultiplier()), false, true, true)) {
+                for (int iii=range.first; iii<range.second; iii++) {
+                    int i=qBound(imin, getDataIndex(iii), imax);
+                    double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
+                    double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
+                    int sr=datastore->getNextLowerIndex(yColumn, i);
+                    int lr=datastore->getNextHigherIndex(yColumn, i);
+                    double xv0=x0;
+                    if (!qFuzzyIsNull(getBaseline())) xv0=transformX(getBaseline());
+                    if (hasStackPar) {
+                        double stackLastX=getParentStackedMax(i);
+                        const double xvold=xv;
+                        xv0=transformX(stackLastX)+(getLineWidth());
+                        xv=stackLastX+xvold;
+                    }
 
 
-                if (sr<0 && lr<0) { // only one y-value
-                    deltam=0.5;
-                    deltap=0.5;
-                } else if (lr<0) { // the right-most y-value
-                    deltap=deltam=fabs(yv-datastore->get(yColumn,sr))/2.0;
-                } else if (sr<0) { // the left-most y-value
-                    deltam=deltap=fabs(datastore->get(yColumn,lr)-yv)/2.0;
-                } else {
-                    deltam=fabs(yv-datastore->get(yColumn,sr))/2.0;
-                    deltap=fabs(datastore->get(yColumn,lr)-yv)/2.0;
-                }
-                delta=deltap+deltam;
-
-                if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv)) {
-                    double x=xv0;
-                    if (!qFuzzyIsNull(getBaseline())) x=transformX(getBaseline());
-                    double y=transformY(yv+shift*delta+width*deltap);
-                    double xx=transformX(xv);
-                    double yy=transformY(yv+shift*delta-width*deltam);
-                    if (x>xx) { qSwap(x,xx); }
-                    //qDebug()<<"delta="<<delta<<"   x="<<x<<" y="<<y<<"   xx="<<xx<<" yy="<<yy;
-                    //qDebug()<<"xv="<<xv<<"   x0="<<x0<<"   x="<<x<<"..."<<xx;
-                    if (JKQTPIsOKFloat(x) && JKQTPIsOKFloat(xx) && JKQTPIsOKFloat(y) && JKQTPIsOKFloat(yy)) {
-                        painter.setBrush(b);
-                        painter.setPen(p);
-                        QRectF r(QPointF(x, y), QPointF(xx, yy));
-                        painter.drawRect(r);
+                    if (sr<0 && lr<0) { // only one y-value
+                        deltam=0.5;
+                        deltap=0.5;
+                    } else if (lr<0) { // the right-most y-value
+                        deltap=deltam=fabs(yv-datastore->get(yColumn,sr))/2.0;
+                    } else if (sr<0) { // the left-most y-value
+                        deltam=deltap=fabs(datastore->get(yColumn,lr)-yv)/2.0;
+                    } else {
+                        deltam=fabs(yv-datastore->get(yColumn,sr))/2.0;
+                        deltap=fabs(datastore->get(yColumn,lr)-yv)/2.0;
+                    }
+                    delta=deltap+deltam;
+
+                    if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv)) {
+                        double x=xv0;
+                        if (!qFuzzyIsNull(getBaseline())) x=transformX(getBaseline());
+                        double y=transformY(yv+shift*delta+width*deltap);
+                        double xx=transformX(xv);
+                        double yy=transformY(yv+shift*delta-width*deltam);
+                        if (x>xx) { qSwap(x,xx); }
+                        //qDebug()<<"delta="<<delta<<"   x="<<x<<" y="<<y<<"   xx="<<xx<<" yy="<<yy;
+                        //qDebug()<<"xv="<<xv<<"   x0="<<x0<<"   x="<<x<<"..."<<xx;
+                        if (JKQTPIsOKFloat(x) && JKQTPIsOKFloat(xx) && JKQTPIsOKFloat(y) && JKQTPIsOKFloat(yy)) {
+                            painter.setBrush(b);
+                            painter.setPen(p);
+                            QRectF r(QPointF(x, y), QPointF(xx, yy));
+                            painter.drawRect(r);
+                        }
                     }
                 }
             }
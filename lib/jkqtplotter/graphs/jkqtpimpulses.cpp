@@ -105,17 +105,21 @@ void JKQTPImpulsesHorizontalGraph::draw(JKQTPEnhancedPainter& painter) {
             QVector<QLineF> lines;
             QVector<QPointF> points;
             intSortData();
-            for (int iii=imin; iii<imax; iii++) {
-                const int i=qBound(imin, getDataIndex(iii), imax);
-                const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
-                const double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
-                if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv)) {
-                    const double x=transformX(xv);
-                    const double y=transformY(yv);
-
-                    lines.append(QLineF(x0, y, x, y));
-                    points.append(QPointF(x,y));
-
+            // impulses extend from the baseline, so only datapoints outside the visible y-range are skipped
+            const double marginPx=parent->pt2px(painter, getSymbolSize()/2.0+getLineWidth()*parent->getLineWidthMultiplier());
+            for (const auto& range: getVisibleIndexRanges(imin, imax, false, marginPx, false, true)) {
+                for (int iii=range.first; iii<range.second; iii++) {
+                    const int i=qBound(imin, getDataIndex(iii), imax);
+                    const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
+                    const double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
+                    if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv)) {
+                        const double x=transformX(xv);
+                        const double y=transformY(yv);
+
+                        lines.append(QLineF(x0, y, x, y));
+                        points.append(QPointF(x,y));
+
+                    }
                 }
             }
             painter.setPen(p);
@@ -208,18 +212,22 @@ void JKQTPImpulsesVerticalGraph::draw(JKQTPEnhancedPainter& painter) {
             QVector<QLineF> lines;
             QVector<QPointF> points;
             intSortData();
-            for (int iii=imin; iii<imax; iii++) {
-                const int i=qBound(imin, getDataIndex(iii), imax);
-                const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
-                const double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
-                if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv) ) {
-                    const double x=transformX(xv);
-                    const double y=transformY(yv);
-
-
-                    lines.append(QLineF(x, y0, x, y));
-                    points.append(QPointF(x,y));
-
+            // impulses extend from the baseline, so only datapoints outside the visible x-range are skipped
+            const double marginPx=parent->pt2px(painter, getSymbolSize()/2.0+getLineWidth()*parent->getLineWidthMultiplier());
+            for (const auto& range: getVisibleIndexRanges(imin, imax, false, marginPx, true, false)) {
+                for (int iii=range.first; iii<range.second; iii++) {
+                    const int i=qBound(imin, getDataIndex(iii), imax);
+                    const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
+                    const double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
+                    if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv) ) {
+                        const double x=transformX(xv);
+                        const double y=transformY(yv);
+
+
+                        lines.append(QLineF(x, y0, x, y));
+                        points.append(QPointF(x,y));
+
+                    }
                 }
             }
             painter.setPen(p);
@@ -0,0 +1,614 @@
+/*
+    Copyright (c) 2008-2020 Jan W. Krieger (<jan@jkrieger.de>)
+
+
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License (LGPL) as published by
+    the Free Software Foundation, either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License (LGPL) for more details.
+
+    You should have received a copy of the GNU Lesser General Public License (LGPL)
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "jkqtplotter/graphs/jkqtplivestatistics.h"
+#include "jkqtplotter/graphs/jkqtpstatisticsadaptors.h"
+#include "jkqtplotter/jkqtpbaseplotter.h"
+#include "jkqtplotter/jkqtplotter.h"
+#include "jkqtcommon/jkqtpstathistogram.h"
+#include "jkqtcommon/jkqtpdebuggingtools.h"
+#include <algorithm>
+#include <limits>
+
+
+namespace {
+    /** \brief returns an iterator to the row \a row of \a column (\a row is converted to the difference type of the column iterators with a range check) */
+    JKQTPColumnConstIterator jkqtpLiveColumnRow(const JKQTPDatastore* ds, int column, size_t row) {
+        typedef JKQTPColumnConstIterator::difference_type DiffType;
+        JKQTPASSERT(row<=static_cast<size_t>(std::numeric_limits<DiffType>::max()));
+        return ds->begin(column)+static_cast<DiffType>(row);
+    }
+}
+
+
+
+
+JKQTPLiveHistogramGraph::JKQTPLiveHistogramGraph(JKQTBasePlotter* parent):
+    JKQTPBarVerticalGraph(parent),
+    dataColumn(-1),
+    binMin(0),
+    binWidth(1),
+    binCount(10),
+    windowSize(0),
+    normalized(false),
+    cummulative(false),
+    m_valueCount(0),
+    m_firstRow(0),
+    m_endRow(0),
+    m_countsValid(false),
+    m_outputDatastore(nullptr)
+{
+    // the base class constructor can not call the setParent() of this class
+    if (parent!=nullptr) allocateOutputColumns();
+}
+
+JKQTPLiveHistogramGraph::JKQTPLiveHistogramGraph(JKQTPlotter* parent):
+    JKQTPLiveHistogramGraph(parent->getPlotter())
+{
+}
+
+JKQTPLiveHistogramGraph::~JKQTPLiveHistogramGraph()
+{
+    freeOutputColumns();
+}
+
+void JKQTPLiveHistogramGraph::setParent(JKQTBasePlotter *parent)
+{
+    JKQTPBarVerticalGraph::setParent(parent);
+    allocateOutputColumns();
+}
+
+bool JKQTPLiveHistogramGraph::usesColumn(int c) const
+{
+    return (c==dataColumn) || JKQTPBarVerticalGraph::usesColumn(c);
+}
+
+int JKQTPLiveHistogramGraph::getDataColumn() const
+{
+    return dataColumn;
+}
+
+double JKQTPLiveHistogramGraph::getBinMin() const
+{
+    return binMin;
+}
+
+double JKQTPLiveHistogramGraph::getBinWidth() const
+{
+    return binWidth;
+}
+
+size_t JKQTPLiveHistogramGraph::getBinCount() const
+{
+    return binCount;
+}
+
+size_t JKQTPLiveHistogramGraph::getWindowSize() const
+{
+    return windowSize;
+}
+
+bool JKQTPLiveHistogramGraph::getNormalized() const
+{
+    return normalized;
+}
+
+bool JKQTPLiveHistogramGraph::getCummulative() const
+{
+    return cummulative;
+}
+
+size_t JKQTPLiveHistogramGraph::getValueCount() const
+{
+    return m_valueCount;
+}
+
+const std::vector<size_t> &JKQTPLiveHistogramGraph::getBinCounts() const
+{
+    return m_counts;
+}
+
+void JKQTPLiveHistogramGraph::updateStatistics()
+{
+    if (parent==nullptr) return;
+    if (parent->getDatastore()!=m_outputDatastore) allocateOutputColumns();
+    if (dataColumn<0 || binCount==0 || !(binWidth>0)) return;
+    const JKQTPDatastore* ds=parent->getDatastore();
+    const size_t rows=ds->getRows(static_cast<size_t>(dataColumn));
+    const size_t first=(windowSize>0 && rows>windowSize)?(rows-windowSize):0;
+
+    bool changed=false;
+    if (!m_countsValid || rows<m_endRow || first<m_firstRow || first>=m_endRow) {
+        // no overlap with the last update: count the complete window
+        m_valueCount=jkqtpstatHistogramCount1D(jkqtpLiveColumnRow(ds, dataColumn, first), jkqtpLiveColumnRow(ds, dataColumn, rows), binMin, binWidth, binCount, m_counts);
+        m_countsValid=true;
+        changed=true;
+    } else if (first!=m_firstRow || rows!=m_endRow) {
+        std::vector<size_t> delta;
+        if (first>m_firstRow) {
+            // rows that left the window
+            const size_t N=jkqtpstatHistogramCount1D(jkqtpLiveColumnRow(ds, dataColumn, m_firstRow), jkqtpLiveColumnRow(ds, dataColumn, first), binMin, binWidth, binCount, delta);
+            for (size_t i=0; i<binCount; i++) m_counts[i]-=delta[i];
+            m_valueCount-=N;
+        }
+        if (rows>m_endRow) {
+            // rows that were appended
+            const size_t N=jkqtpstatHistogramCount1D(jkqtpLiveColumnRow(ds, dataColumn, m_endRow), jkqtpLiveColumnRow(ds, dataColumn, rows), binMin, binWidth, binCount, delta);
+            for (size_t i=0; i<binCount; i++) m_counts[i]+=delta[i];
+            m_valueCount+=N;
+        }
+        changed=true;
+    }
+    m_firstRow=first;
+    m_endRow=rows;
+    if (changed) writeOutputColumns();
+}
+
+void JKQTPLiveHistogramGraph::resetStatistics()
+{
+    m_countsValid=false;
+}
+
+void JKQTPLiveHistogramGraph::setDataColumn(int __value)
+{
+    dataColumn=__value;
+    resetStatistics();
+}
+
+void JKQTPLiveHistogramGraph::setDataColumn(size_t __value)
+{
+    setDataColumn(static_cast<int>(__value));
+}
+
+void JKQTPLiveHistogramGraph::setBins(double binMin, double binWidth, size_t binCount)
+{
+    this->binMin=binMin;
+    this->binWidth=binWidth;
+    this->binCount=binCount;
+    resetStatistics();
+    m_counts.clear();
+    m_valueCount=0;
+    allocateOutputColumns();
+}
+
+void JKQTPLiveHistogramGraph::setWindowSize(size_t __value)
+{
+    windowSize=__value;
+    resetStatistics();
+}
+
+void JKQTPLiveHistogramGraph::setNormalized(bool __value)
+{
+    normalized=__value;
+    writeOutputColumns();
+}
+
+void JKQTPLiveHistogramGraph::setCummulative(bool __value)
+{
+    cummulative=__value;
+    writeOutputColumns();
+}
+
+void JKQTPLiveHistogramGraph::allocateOutputColumns()
+{
+    JKQTPDatastore* ds=(parent!=nullptr)?parent->getDatastore():nullptr;
+    if (ds!=m_outputDatastore) freeOutputColumns();
+    if (ds==nullptr) return;
+    if (m_outputDatastore==nullptr) {
+        m_outputDatastore=ds;
+        m_outputPlotter=parent;
+        setXColumn(ds->addColumn(binCount, QString("%1, bins").arg(getTitle())));
+        setYColumn(ds->addColumn(binCount, QString("%1, values").arg(getTitle())));
+    } else {
+        if (ds->getRows(static_cast<size_t>(xColumn))!=binCount) ds->resizeColumn(static_cast<size_t>(xColumn), binCount);
+        if (ds->getRows(static_cast<size_t>(yColumn))!=binCount) ds->resizeColumn(static_cast<size_t>(yColumn), binCount);
+    }
+    writeOutputColumns();
+}
+
+void JKQTPLiveHistogramGraph::freeOutputColumns()
+{
+    // the datastore of a plotter is deleted before the graphs, so the columns are only deleted, if it is still alive
+    if (m_outputDatastore!=nullptr && !m_outputPlotter.isNull() && m_outputPlotter->getDatastore()==m_outputDatastore) {
+        if (xColumn>=0) m_outputDatastore->deleteColumn(static_cast<size_t>(xColumn));
+        if (yColumn>=0) m_outputDatastore->deleteColumn(static_cast<size_t>(yColumn));
+    }
+    m_outputDatastore=nullptr;
+    m_outputPlotter.clear();
+    xColumn=-1;
+    yColumn=-1;
+}
+
+void JKQTPLiveHistogramGraph::writeOutputColumns()
+{
+    if (m_outputDatastore==nullptr || xColumn<0 || yColumn<0) return;
+    const bool hasCounts=(m_countsValid && m_counts.size()==binCount);
+    const double norm=(normalized && m_valueCount>0)?(1.0/static_cast<double>(m_valueCount)):1.0;
+    double sum=0;
+    for (size_t i=0; i<binCount; i++) {
+        const double h=hasCounts?(static_cast<double>(m_counts[i])*norm):0.0;
+        sum+=h;
+        m_outputDatastore->set(static_cast<size_t>(xColumn), i, binMin+(static_cast<double>(i)+0.5)*binWidth);
+        m_outputDatastore->set(static_cast<size_t>(yColumn), i, cummulative?sum:h);
+    }
+}
+
+
+
+
+JKQTPLiveBoxplotStatistics::JKQTPLiveBoxplotStatistics():
+    dataColumn(-1),
+    quantile1Spec(0.25),
+    quantile2Spec(0.75),
+    minimumQuantile(0),
+    maximumQuantile(1)
+{
+
+}
+
+void JKQTPLiveBoxplotStatistics::reset()
+{
+    sketch.clear();
+    moments.clear();
+}
+
+void JKQTPLiveBoxplotStatistics::update(JKQTPBoxplotElementBase *boxplot, const JKQTPDatastore *ds)
+{
+    if (ds==nullptr || dataColumn<0) return;
+    const size_t rows=ds->getRows(static_cast<size_t>(dataColumn));
+    if (rows<moments.processedItems()) reset();
+    const size_t first=moments.processedItems();
+    if (rows>first) {
+        const auto itEnd=jkqtpLiveColumnRow(ds, dataColumn, rows);
+        for (auto it=jkqtpLiveColumnRow(ds, dataColumn, first); it!=itEnd; ++it) {
+            const double v=*it;
+            moments.add(v);
+            if (JKQTPIsOKFloat(v)) sketch.add(v);
+        }
+        apply(boxplot);
+    }
+}
+
+void JKQTPLiveBoxplotStatistics::apply(JKQTPBoxplotElementBase *boxplot) const
+{
+    if (!sketch.isEmpty()) jkqtpstatUpdateBoxplot(boxplot, sketch, quantile1Spec, quantile2Spec, minimumQuantile, maximumQuantile);
+}
+
+
+
+
+JKQTPLiveBoxplotVerticalElement::JKQTPLiveBoxplotVerticalElement(JKQTBasePlotter* parent):
+    JKQTPBoxplotVerticalElement(parent)
+{
+    setDrawMean(true);
+    setDrawMedian(true);
+}
+
+JKQTPLiveBoxplotVerticalElement::JKQTPLiveBoxplotVerticalElement(JKQTPlotter* parent):
+    JKQTPLiveBoxplotVerticalElement(parent->getPlotter())
+{
+}
+
+void JKQTPLiveBoxplotVerticalElement::draw(JKQTPEnhancedPainter &painter)
+{
+    if (!m_statistics.sketch.isEmpty()) JKQTPBoxplotVerticalElement::draw(painter);
+}
+
+bool JKQTPLiveBoxplotVerticalElement::getYMinMax(double &miny, double &maxy, double &smallestGreaterZero)
+{
+    if (m_statistics.sketch.isEmpty()) return false;
+    return JKQTPBoxplotVerticalElement::getYMinMax(miny, maxy, smallestGreaterZero);
+}
+
+int JKQTPLiveBoxplotVerticalElement::getDataColumn() const
+{
+    return m_statistics.dataColumn;
+}
+
+const JKQTPStatMomentsAccumulator &JKQTPLiveBoxplotVerticalElement::getMoments() const
+{
+    return m_statistics.moments;
+}
+
+const JKQTPStatQuantileSketch &JKQTPLiveBoxplotVerticalElement::getQuantileSketch() const
+{
+    return m_statistics.sketch;
+}
+
+void JKQTPLiveBoxplotVerticalElement::updateStatistics()
+{
+    if (parent!=nullptr) m_statistics.update(this, parent->getDatastore());
+}
+
+void JKQTPLiveBoxplotVerticalElement::resetStatistics()
+{
+    m_statistics.reset();
+}
+
+void JKQTPLiveBoxplotVerticalElement::setDataColumn(int __value)
+{
+    m_statistics.dataColumn=__value;
+    resetStatistics();
+}
+
+void JKQTPLiveBoxplotVerticalElement::setDataColumn(size_t __value)
+{
+    setDataColumn(static_cast<int>(__value));
+}
+
+void JKQTPLiveBoxplotVerticalElement::setBoxQuantiles(double quantile1Spec, double quantile2Spec)
+{
+    m_statistics.quantile1Spec=quantile1Spec;
+    m_statistics.quantile2Spec=quantile2Spec;
+    m_statistics.apply(this);
+}
+
+void JKQTPLiveBoxplotVerticalElement::setWhiskerQuantiles(double minimumQuantile, double maximumQuantile)
+{
+    m_statistics.minimumQuantile=minimumQuantile;
+    m_statistics.maximumQuantile=maximumQuantile;
+    m_statistics.apply(this);
+}
+
+
+
+
+JKQTPLiveBoxplotHorizontalElement::JKQTPLiveBoxplotHorizontalElement(JKQTBasePlotter* parent):
+    JKQTPBoxplotHorizontalElement(parent)
+{
+    setDrawMean(true);
+    setDrawMedian(true);
+}
+
+JKQTPLiveBoxplotHorizontalElement::JKQTPLiveBoxplotHorizontalElement(JKQTPlotter* parent):
+    JKQTPLiveBoxplotHorizontalElement(parent->getPlotter())
+{
+}
+
+void JKQTPLiveBoxplotHorizontalElement::draw(JKQTPEnhancedPainter &painter)
+{
+    if (!m_statistics.sketch.isEmpty()) JKQTPBoxplotHorizontalElement::draw(painter);
+}
+
+bool JKQTPLiveBoxplotHorizontalElement::getXMinMax(double &minx, double &maxx, double &smallestGreaterZero)
+{
+    if (m_statistics.sketch.isEmpty()) return false;
+    return JKQTPBoxplotHorizontalElement::getXMinMax(minx, maxx, smallestGreaterZero);
+}
+
+int JKQTPLiveBoxplotHorizontalElement::getDataColumn() const
+{
+    return m_statistics.dataColumn;
+}
+
+const JKQTPStatMomentsAccumulator &JKQTPLiveBoxplotHorizontalElement::getMoments() const
+{
+    return m_statistics.moments;
+}
+
+const JKQTPStatQuantileSketch &JKQTPLiveBoxplotHorizontalElement::getQuantileSketch() const
+{
+    return m_statistics.sketch;
+}
+
+void JKQTPLiveBoxplotHorizontalElement::updateStatistics()
+{
+    if (parent!=nullptr) m_statistics.update(this, parent->getDatastore());
+}
+
+void JKQTPLiveBoxplotHorizontalElement::resetStatistics()
+{
+    m_statistics.reset();
+}
+
+void JKQTPLiveBoxplotHorizontalElement::setDataColumn(int __value)
+{
+    m_statistics.dataColumn=__value;
+    resetStatistics();
+}
+
+void JKQTPLiveBoxplotHorizontalElement::setDataColumn(size_t __value)
+{
+    setDataColumn(static_cast<int>(__value));
+}
+
+void JKQTPLiveBoxplotHorizontalElement::setBoxQuantiles(double quantile1Spec, double quantile2Spec)
+{
+    m_statistics.quantile1Spec=quantile1Spec;
+    m_statistics.quantile2Spec=quantile2Spec;
+    m_statistics.apply(this);
+}
+
+void JKQTPLiveBoxplotHorizontalElement::setWhiskerQuantiles(double minimumQuantile, double maximumQuantile)
+{
+    m_statistics.minimumQuantile=minimumQuantile;
+    m_statistics.maximumQuantile=maximumQuantile;
+    m_statistics.apply(this);
+}
+
+
+
+
+JKQTPLiveRegressionGraph::JKQTPLiveRegressionGraph(JKQTBasePlotter* parent):
+    JKQTPXFunctionLineGraph(parent),
+    xColumn(-1),
+    yColumn(-1),
+    modelType(JKQTPStatRegressionModelType::Linear),
+    robust(false),
+    irlsP(1.1),
+    irlsIterations(100),
+    m_irls(JKQTPStatRegressionModelType::Linear),
+    m_processedRows(0),
+    m_fitDirty(true),
+    m_coeffA(JKQTP_NAN),
+    m_coeffB(JKQTP_NAN)
+{
+
+}
+
+JKQTPLiveRegressionGraph::JKQTPLiveRegressionGraph(JKQTPlotter* parent):
+    JKQTPLiveRegressionGraph(parent->getPlotter())
+{
+}
+
+void JKQTPLiveRegressionGraph::draw(JKQTPEnhancedPainter &painter)
+{
+    if (JKQTPIsOKFloat(m_coeffA) && JKQTPIsOKFloat(m_coeffB)) {
+        JKQTPXFunctionLineGraph::draw(painter);
+    }
+}
+
+bool JKQTPLiveRegressionGraph::usesColumn(int c) const
+{
+    return (c==xColumn) || (c==yColumn) || JKQTPXFunctionLineGraph::usesColumn(c);
+}
+
+int JKQTPLiveRegressionGraph::getXColumn() const
+{
+    return xColumn;
+}
+
+int JKQTPLiveRegressionGraph::getYColumn() const
+{
+    return yColumn;
+}
+
+JKQTPStatRegressionModelType JKQTPLiveRegressionGraph::getModelType() const
+{
+    return modelType;
+}
+
+bool JKQTPLiveRegressionGraph::isRobust() const
+{
+    return robust;
+}
+
+double JKQTPLiveRegressionGraph::getIRLSParameter() const
+{
+    return irlsP;
+}
+
+int JKQTPLiveRegressionGraph::getIRLSIterations() const
+{
+    return irlsIterations;
+}
+
+double JKQTPLiveRegressionGraph::getCoeffA() const
+{
+    return m_coeffA;
+}
+
+double JKQTPLiveRegressionGraph::getCoeffB() const
+{
+    return m_coeffB;
+}
+
+void JKQTPLiveRegressionGraph::updateStatistics()
+{
+    if (parent==nullptr || xColumn<0 || yColumn<0) return;
+    JKQTPDatastore* ds=parent->getDatastore();
+    const size_t rows=std::min(ds->getRows(static_cast<size_t>(xColumn)), ds->getRows(static_cast<size_t>(yColumn)));
+    if (rows<m_processedRows) resetStatistics();
+    if (rows>m_processedRows) {
+        if (robust) {
+            m_irls.addRange(jkqtpLiveColumnRow(ds, xColumn, m_processedRows), jkqtpLiveColumnRow(ds, xColumn, rows), jkqtpLiveColumnRow(ds, yColumn, m_processedRows));
+        } else {
+            const auto trafo=jkqtpStatGenerateTransformation(modelType);
+            for (size_t i=m_processedRows; i<rows; i++) {
+                m_leastSquares.add(trafo.first(ds->get(static_cast<size_t>(xColumn), i)), trafo.second(ds->get(static_cast<size_t>(yColumn), i)));
+            }
+        }
+        m_processedRows=rows;
+        m_fitDirty=true;
+    }
+    if (!m_fitDirty) return;
+    m_fitDirty=false;
+
+    double a=JKQTP_NAN, b=JKQTP_NAN;
+    if (robust && m_irls.count()>1) {
+        a=0;
+        b=0;
+        m_irls.fit(a, b, false, false, irlsP, irlsIterations);
+    } else if (!robust && m_leastSquares.count()>1) {
+        m_leastSquares.coefficients(a, b);
+        a=jkqtpStatGenerateParameterATransformation(modelType).second(a);
+        b=jkqtpStatGenerateParameterBTransformation(modelType).second(b);
+    }
+    if (a!=m_coeffA || b!=m_coeffB) {
+        m_coeffA=a;
+        m_coeffB=b;
+        if (JKQTPIsOKFloat(a) && JKQTPIsOKFloat(b)) setPlotFunctionFunctor(jkqtpStatGenerateRegressionModel(modelType, a, b));
+    }
+}
+
+void JKQTPLiveRegressionGraph::resetStatistics()
+{
+    m_leastSquares.clear();
+    m_irls=JKQTPStatIncrementalRobustIRLSRegression(modelType, m_irls.tolerance());
+    m_processedRows=0;
+    m_fitDirty=true;
+}
+
+void JKQTPLiveRegressionGraph::setXColumn(int __value)
+{
+    xColumn=__value;
+    resetStatistics();
+}
+
+void JKQTPLiveRegressionGraph::setXColumn(size_t __value)
+{
+    setXColumn(static_cast<int>(__value));
+}
+
+void JKQTPLiveRegressionGraph::setYColumn(int __value)
+{
+    yColumn=__value;
+    resetStatistics();
+}
+
+void JKQTPLiveRegressionGraph::setYColumn(size_t __value)
+{
+    setYColumn(static_cast<int>(__value));
+}
+
+void JKQTPLiveRegressionGraph::setModelType(JKQTPStatRegressionModelType __value)
+{
+    modelType=__value;
+    resetStatistics();
+}
+
+void JKQTPLiveRegressionGraph::setRobust(bool __value)
+{
+    robust=__value;
+    resetStatistics();
+}
+
+void JKQTPLiveRegressionGraph::setIRLSParameter(double __value)
+{
+    irlsP=__value;
+    m_fitDirty=true;
+}
+
+void JKQTPLiveRegressionGraph::setIRLSIterations(int __value)
+{
+    irlsIterations=__value;
+    m_fitDirty=true;
+}
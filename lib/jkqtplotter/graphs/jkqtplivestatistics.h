@@ -0,0 +1,416 @@
+/*
+    Copyright (c) 2008-2020 Jan W. Krieger (<jan@jkrieger.de>)
+
+
+
+    This software is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License (LGPL) as published by
+    the Free Software Foundation, either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License (LGPL) for more details.
+
+    You should have received a copy of the GNU Lesser General Public License (LGPL)
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <QString>
+#include <QPainter>
+#include <QPointer>
+#include <vector>
+#include "jkqtplotter/jkqtptools.h"
+#include "jkqtplotter/jkqtplotter_imexport.h"
+#include "jkqtplotter/jkqtpgraphsbase.h"
+#include "jkqtplotter/graphs/jkqtpbarchart.h"
+#include "jkqtplotter/graphs/jkqtpboxplot.h"
+#include "jkqtplotter/graphs/jkqtpevaluatedfunction.h"
+#include "jkqtcommon/jkqtpstatbasics.h"
+#include "jkqtcommon/jkqtpstatregression.h"
+#include "jkqtcommon/jkqtpstatquantilesketch.h"
+
+#ifndef jkqtpgraphslivestatistics_H
+#define jkqtpgraphslivestatistics_H
+
+
+
+/*! \brief a histogram (drawn as vertical bars) of a data column, which is updated incrementally, when rows are appended to the column
+    \ingroup jkqtplotter_statgraphs
+
+    In contrast to jkqtpstatAddHHistogram1D(), which calculates a histogram once, this graph keeps the integer bin counts
+    of the data column getDataColumn() and, whenever updateStatistics() is called, only bins the rows that were appended to the column since the last update
+    (using jkqtpstatHistogramCount1D() ). The bins are fixed (see setBins() ), as an automatic bin range would require a recount of all data.
+
+    If a window size is set with setWindowSize(), only the last rows of the column are used (rolling histogram). Rows that leave the
+    window are subtracted from the bins, so also this mode costs only \f$ \mathcal{O}(\mbox{new rows}) \f$ per update.
+
+    The bin positions and heights are written to two columns of the datastore, which are used as bar positions/heights of the
+    JKQTPBarVerticalGraph base class. These columns are created, when the graph is assigned to a plotter, resized by setBins() and deleted in the destructor.
+    Drawing and autoscaling the graph do not modify the datastore, so updateStatistics() has to be called explicitly (in the thread that owns
+    the plotter and its datastore), before the plot is redrawn.
+
+    \code
+        JKQTPLiveHistogramGraph* hist=new JKQTPLiveHistogramGraph(plot);
+        hist->setDataColumn(colSamples);
+        hist->setBins(-5, 0.25, 40);
+        hist->setWindowSize(10000);
+        plot->addGraph(hist);
+        // ... for every new sample:
+        ds->appendToColumn(colSamples, value);
+        hist->updateStatistics();
+        plot->redrawPlot();
+    \endcode
+
+    \note Only appending rows (and shrinking the column) is detected by updateStatistics(). If existing rows of the column are modified,
+          call resetStatistics() before updateStatistics().
+
+    \see jkqtpstatHistogramCount1D(), jkqtpstatAddHHistogram1D()
+ */
+class JKQTPLOTTER_LIB_EXPORT JKQTPLiveHistogramGraph: public JKQTPBarVerticalGraph {
+        Q_OBJECT
+    public:
+        /** \brief class constructor */
+        JKQTPLiveHistogramGraph(JKQTBasePlotter* parent=nullptr);
+        /** \brief class constructor */
+        JKQTPLiveHistogramGraph(JKQTPlotter* parent);
+        /** \brief class destructor, deletes the output columns from the datastore */
+        virtual ~JKQTPLiveHistogramGraph() override;
+
+        /** \brief sets the parent plotter and moves the output columns to its datastore */
+        virtual void setParent(JKQTBasePlotter* parent) override;
+        /** \copydoc JKQTPGraph::usesColumn() */
+        virtual bool usesColumn(int c) const override;
+
+        /** \copydoc dataColumn */
+        int getDataColumn() const;
+        /** \brief left edge of the first bin */
+        double getBinMin() const;
+        /** \brief width of the bins */
+        double getBinWidth() const;
+        /** \brief number of bins */
+        size_t getBinCount() const;
+        /** \copydoc windowSize */
+        size_t getWindowSize() const;
+        /** \copydoc normalized */
+        bool getNormalized() const;
+        /** \copydoc cummulative */
+        bool getCummulative() const;
+        /** \brief number of valid values in the histogram (i.e. in the current window) */
+        size_t getValueCount() const;
+        /** \brief the (integer) bin counts (of the current window), as of the last update */
+        const std::vector<size_t>& getBinCounts() const;
+
+    public slots:
+        /** \brief brings the histogram up to date with the data column, i.e. bins all rows appended since the last update, and writes the output columns */
+        void updateStatistics();
+        /** \brief forgets the bin counts, so the next update recounts all rows (use this, if existing rows of the data column were modified) */
+        void resetStatistics();
+        /** \copydoc dataColumn */
+        void setDataColumn(int __value);
+        /** \copydoc dataColumn */
+        void setDataColumn(size_t __value);
+        /** \brief sets \a binCount bins of width \a binWidth , where the first bin starts at \a binMin (values outside the bins are counted in the first/last bin) */
+        void setBins(double binMin, double binWidth, size_t binCount);
+        /** \copydoc windowSize */
+        void setWindowSize(size_t __value);
+        /** \copydoc normalized */
+        void setNormalized(bool __value);
+        /** \copydoc cummulative */
+        void setCummulative(bool __value);
+
+    protected:
+        /** \brief column with the data to histogram */
+        int dataColumn;
+        /** \brief left edge of the first bin */
+        double binMin;
+        /** \brief width of the bins */
+        double binWidth;
+        /** \brief number of bins */
+        size_t binCount;
+        /** \brief if >0 only the last \a windowSize rows of the data column are used (rolling histogram), otherwise all rows (default: 0) */
+        size_t windowSize;
+        /** \brief indicates whether the histogram is normalized to the number of values (default: \c false ) */
+        bool normalized;
+        /** \brief if \c true, a cummulative histogram is shown (default: \c false ) */
+        bool cummulative;
+    private:
+        /** \brief integer counts of the bins */
+        std::vector<size_t> m_counts;
+        /** \brief number of valid values in m_counts */
+        size_t m_valueCount;
+        /** \brief first row of the data column, that is contained in m_counts */
+        size_t m_firstRow;
+        /** \brief row behind the last row of the data column, that is contained in m_counts */
+        size_t m_endRow;
+        /** \brief indicates whether m_counts is valid */
+        bool m_countsValid;
+        /** \brief the datastore, which contains the output columns (xColumn and yColumn), created by allocateOutputColumns() */
+        JKQTPDatastore* m_outputDatastore;
+        /** \brief the plotter, whose datastore was m_outputDatastore (used to detect, whether the datastore still exists in the destructor) */
+        QPointer<JKQTBasePlotter> m_outputPlotter;
+        /** \brief creates (or resizes) the output columns in the datastore of the parent plotter */
+        void allocateOutputColumns();
+        /** \brief deletes the output columns from m_outputDatastore */
+        void freeOutputColumns();
+        /** \brief writes the bin positions and (normalized/cummulative) heights from m_counts to the output columns */
+        void writeOutputColumns();
+};
+
+
+
+
+/*! \brief the incremental statistics of JKQTPLiveBoxplotVerticalElement and JKQTPLiveBoxplotHorizontalElement
+    \ingroup jkqtplotter_statgraphs
+    \internal
+
+    Keeps a JKQTPStatQuantileSketch and a JKQTPStatMomentsAccumulator of a data column and writes the boxplot properties
+    to a JKQTPBoxplotElementBase with jkqtpstatUpdateBoxplot().
+ */
+struct JKQTPLOTTER_LIB_EXPORT JKQTPLiveBoxplotStatistics {
+    JKQTPLiveBoxplotStatistics();
+    /** \brief column with the data */
+    int dataColumn;
+    /** \brief the quantiles that define the box and the whiskers */
+    double quantile1Spec, quantile2Spec, minimumQuantile, maximumQuantile;
+    /** \brief quantile sketch of the data column */
+    JKQTPStatQuantileSketch sketch;
+    /** \brief moments of the data column */
+    JKQTPStatMomentsAccumulator moments;
+    /** \brief forgets the statistics */
+    void reset();
+    /** \brief adds the rows of dataColumn in \a ds , that were appended since the last update, and writes the results to \a boxplot */
+    void update(JKQTPBoxplotElementBase* boxplot, const JKQTPDatastore* ds);
+    /** \brief writes the current statistics to \a boxplot (e.g. after the quantiles were changed) */
+    void apply(JKQTPBoxplotElementBase* boxplot) const;
+};
+
+
+
+
+/*! \brief a vertical boxplot of a data column, which is updated incrementally, when rows are appended to the column
+    \ingroup jkqtplotter_statgraphs
+
+    This graph keeps a JKQTPStatQuantileSketch and a JKQTPStatMomentsAccumulator of the data column getDataColumn().
+    Whenever updateStatistics() is called, only the rows that were appended to the column since the last update are added to them
+    and the boxplot properties are updated with jkqtpstatUpdateBoxplot(). So the quartiles and the median are (very accurate) estimates,
+    while mean, minimum and maximum are exact. Drawing and autoscaling the graph do not read the data column, so call updateStatistics()
+    (in the thread that owns the plotter and its datastore), before the plot is redrawn.
+
+    \code
+        JKQTPLiveBoxplotVerticalElement* box=new JKQTPLiveBoxplotVerticalElement(plot);
+        box->setDataColumn(colSamples);
+        box->setPos(1);
+        plot->addGraph(box);
+        // ... for every new sample:
+        ds->appendToColumn(colSamples, value);
+        box->updateStatistics();
+        plot->redrawPlot();
+    \endcode
+
+    \note Only appending rows (and shrinking the column) is detected by updateStatistics(). If existing rows of the column are modified,
+          call resetStatistics() before updateStatistics().
+
+    \see JKQTPStatQuantileSketch, jkqtpstatUpdateBoxplot(), JKQTPLiveBoxplotHorizontalElement
+ */
+class JKQTPLOTTER_LIB_EXPORT JKQTPLiveBoxplotVerticalElement: public JKQTPBoxplotVerticalElement {
+        Q_OBJECT
+    public:
+        /** \brief class constructor */
+        JKQTPLiveBoxplotVerticalElement(JKQTBasePlotter* parent=nullptr);
+        /** \brief class constructor */
+        JKQTPLiveBoxplotVerticalElement(JKQTPlotter* parent);
+
+        /** \brief plots the graph to the plotter object specified as parent (nothing is drawn, before the statistics contain any data) */
+        virtual void draw(JKQTPEnhancedPainter& painter) override;
+        /** \brief returns the y-range of the graph (\c false, before the statistics contain any data) */
+        virtual bool getYMinMax(double& miny, double& maxy, double& smallestGreaterZero) override;
+
+        /** \copydoc JKQTPLiveBoxplotStatistics::dataColumn */
+        int getDataColumn() const;
+        /** \brief the moments (count, average, variance, ...) of the data column, as of the last update */
+        const JKQTPStatMomentsAccumulator& getMoments() const;
+        /** \brief the quantile sketch of the data column, as of the last update */
+        const JKQTPStatQuantileSketch& getQuantileSketch() const;
+
+    public slots:
+        /** \brief brings the statistics up to date with the data column, i.e. adds all rows appended since the last update, and updates the boxplot properties */
+        void updateStatistics();
+        /** \brief forgets the statistics, so the next update reads all rows (use this, if existing rows of the data column were modified) */
+        void resetStatistics();
+        /** \copydoc JKQTPLiveBoxplotStatistics::dataColumn */
+        void setDataColumn(int __value);
+        /** \copydoc JKQTPLiveBoxplotStatistics::dataColumn */
+        void setDataColumn(size_t __value);
+        /** \brief sets the quantiles that define the box (default: 0.25 and 0.75) */
+        void setBoxQuantiles(double quantile1Spec, double quantile2Spec);
+        /** \brief sets the quantiles that define the whiskers (default: 0 and 1, i.e. minimum and maximum) */
+        void setWhiskerQuantiles(double minimumQuantile, double maximumQuantile);
+
+    private:
+        /** \brief the statistics of the data column */
+        JKQTPLiveBoxplotStatistics m_statistics;
+};
+
+
+
+
+/*! \brief a horizontal boxplot of a data column, which is updated incrementally, when rows are appended to the column
+    \ingroup jkqtplotter_statgraphs
+
+    \see JKQTPLiveBoxplotVerticalElement for details
+ */
+class JKQTPLOTTER_LIB_EXPORT JKQTPLiveBoxplotHorizontalElement: public JKQTPBoxplotHorizontalElement {
+        Q_OBJECT
+    public:
+        /** \brief class constructor */
+        JKQTPLiveBoxplotHorizontalElement(JKQTBasePlotter* parent=nullptr);
+        /** \brief class constructor */
+        JKQTPLiveBoxplotHorizontalElement(JKQTPlotter* parent);
+
+        /** \brief plots the graph to the plotter object specified as parent (nothing is drawn, before the statistics contain any data) */
+        virtual void draw(JKQTPEnhancedPainter& painter) override;
+        /** \brief returns the x-range of the graph (\c false, before the statistics contain any data) */
+        virtual bool getXMinMax(double& minx, double& maxx, double& smallestGreaterZero) override;
+
+        /** \copydoc JKQTPLiveBoxplotStatistics::dataColumn */
+        int getDataColumn() const;
+        /** \brief the moments (count, average, variance, ...) of the data column, as of the last update */
+        const JKQTPStatMomentsAccumulator& getMoments() const;
+        /** \brief the quantile sketch of the data column, as of the last update */
+        const JKQTPStatQuantileSketch& getQuantileSketch() const;
+
+    public slots:
+        /** \brief brings the statistics up to date with the data column, i.e. adds all rows appended since the last update, and updates the boxplot properties */
+        void updateStatistics();
+        /** \brief forgets the statistics, so the next update reads all rows (use this, if existing rows of the data column were modified) */
+        void resetStatistics();
+        /** \copydoc JKQTPLiveBoxplotStatistics::dataColumn */
+        void setDataColumn(int __value);
+        /** \copydoc JKQTPLiveBoxplotStatistics::dataColumn */
+        void setDataColumn(size_t __value);
+        /** \brief sets the quantiles that define the box (default: 0.25 and 0.75) */
+        void setBoxQuantiles(double quantile1Spec, double quantile2Spec);
+        /** \brief sets the quantiles that define the whiskers (default: 0 and 1, i.e. minimum and maximum) */
+        void setWhiskerQuantiles(double minimumQuantile, double maximumQuantile);
+
+    private:
+        /** \brief the statistics of the data column */
+        JKQTPLiveBoxplotStatistics m_statistics;
+};
+
+
+
+
+/*! \brief a regression line \f$ f(x) \f$ (model defined by a JKQTPStatRegressionModelType) through the data in two columns, which is updated incrementally, when rows are appended to the columns
+    \ingroup jkqtplotter_statgraphs
+
+    In contrast to jkqtpstatAddRegression() and jkqtpstatAddRobustIRLSRegression(), which fit the model once, this graph keeps the regression
+    state of the columns getXColumn() and getYColumn(). Whenever updateStatistics() is called, only the rows that were appended to the columns since the
+    last update are added:
+      - for a least-squares fit to a JKQTPStatLinearRegressionAccumulator, i.e. an update costs \f$ \mathcal{O}(\mbox{new rows}) \f$
+      - for a robust fit (see setRobust() ) to a JKQTPStatIncrementalRobustIRLSRegression, which warm-starts the IRLS iterations from the previous fit
+    .
+    Drawing the graph does not read the data columns, so call updateStatistics() (in the thread that owns the plotter and its datastore),
+    before the plot is redrawn. This is also necessary after changing the fit parameters (setIRLSParameter(), setIRLSIterations(), ...).
+
+    \code
+        JKQTPLiveRegressionGraph* reg=new JKQTPLiveRegressionGraph(plot);
+        reg->setXColumn(colX);
+        reg->setYColumn(colY);
+        reg->setModelType(JKQTPStatRegressionModelType::Exponential);
+        plot->addGraph(reg);
+        // ... for every new datapoint:
+        ds->appendToColumn(colX, x);
+        ds->appendToColumn(colY, y);
+        reg->updateStatistics();
+        plot->redrawPlot();
+    \endcode
+
+    \note Only appending rows (and shrinking the columns) is detected by updateStatistics(). If existing rows of the columns are modified,
+          call resetStatistics() before updateStatistics().
+
+    \see JKQTPStatLinearRegressionAccumulator, JKQTPStatIncrementalRobustIRLSRegression, jkqtpstatAddRegression(), jkqtpstatAddRobustIRLSRegression()
+ */
+class JKQTPLOTTER_LIB_EXPORT JKQTPLiveRegressionGraph: public JKQTPXFunctionLineGraph {
+        Q_OBJECT
+    public:
+        /** \brief class constructor */
+        JKQTPLiveRegressionGraph(JKQTBasePlotter* parent=nullptr);
+        /** \brief class constructor */
+        JKQTPLiveRegressionGraph(JKQTPlotter* parent);
+
+        /** \brief plots the graph to the plotter object specified as parent (nothing is drawn, if there were too few datapoints at the last update) */
+        virtual void draw(JKQTPEnhancedPainter& painter) override;
+        /** \copydoc JKQTPGraph::usesColumn() */
+        virtual bool usesColumn(int c) const override;
+
+        /** \copydoc xColumn */
+        int getXColumn() const;
+        /** \copydoc yColumn */
+        int getYColumn() const;
+        /** \copydoc modelType */
+        JKQTPStatRegressionModelType getModelType() const;
+        /** \copydoc robust */
+        bool isRobust() const;
+        /** \copydoc irlsP */
+        double getIRLSParameter() const;
+        /** \copydoc irlsIterations */
+        int getIRLSIterations() const;
+        /** \brief offset \f$ a \f$ of the model, as of the last update (NAN if there are too few datapoints) */
+        double getCoeffA() const;
+        /** \brief slope \f$ b \f$ of the model, as of the last update (NAN if there are too few datapoints) */
+        double getCoeffB() const;
+
+    public slots:
+        /** \brief brings the fit up to date with the data columns, i.e. adds all rows appended since the last update and refits the model */
+        void updateStatistics();
+        /** \brief forgets the regression state, so the next update reads all rows (use this, if existing rows of the data columns were modified) */
+        void resetStatistics();
+        /** \copydoc xColumn */
+        void setXColumn(int __value);
+        /** \copydoc xColumn */
+        void setXColumn(size_t __value);
+        /** \copydoc yColumn */
+        void setYColumn(int __value);
+        /** \copydoc yColumn */
+        void setYColumn(size_t __value);
+        /** \copydoc modelType */
+        void setModelType(JKQTPStatRegressionModelType __value);
+        /** \copydoc robust */
+        void setRobust(bool __value);
+        /** \copydoc irlsP */
+        void setIRLSParameter(double __value);
+        /** \copydoc irlsIterations */
+        void setIRLSIterations(int __value);
+
+    protected:
+        /** \brief column with the x-values of the data */
+        int xColumn;
+        /** \brief column with the y-values of the data */
+        int yColumn;
+        /** \brief the model to be fitted (default: JKQTPStatRegressionModelType::Linear ) */
+        JKQTPStatRegressionModelType modelType;
+        /** \brief if \c true, a robust IRLS fit is performed (see jkqtpstatRobustIRLSRegression() ), otherwise a least-squares fit (default: \c false ) */
+        bool robust;
+        /** \brief regularization parameter \f$ p \f$ of the robust IRLS fit (default: 1.1) */
+        double irlsP;
+        /** \brief maximum number of iterations of the robust IRLS fit (default: 100) */
+        int irlsIterations;
+    private:
+        /** \brief least-squares regression state (on the transformed data) */
+        JKQTPStatLinearRegressionAccumulator m_leastSquares;
+        /** \brief robust regression state */
+        JKQTPStatIncrementalRobustIRLSRegression m_irls;
+        /** \brief number of rows of the data columns, that were added to the regression state */
+        size_t m_processedRows;
+        /** \brief indicates whether the model has to be refitted */
+        bool m_fitDirty;
+        /** \brief result of the last fit */
+        double m_coeffA, m_coeffB;
+};
+
+
+#endif // jkqtpgraphslivestatistics_H
@@ -84,25 +84,31 @@ void JKQTPXYLineGraph::draw(JKQTPEnhancedPainter& painter) {
             std::vector<QPolygonF> vec_linesP;
             vec_linesP.push_back(QPolygonF());
             intSortData();
-            for (int iii=imin; iii<imax; iii++) {
-                const int i=qBound(imin, getDataIndex(iii), imax);
-                const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
-                const double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
-                const double x=transformX(xv);
-                const double y=transformY(yv);
-                //qDebug()<<"JKQTPXYLineGraph::draw(): (xv, yv) =    ( "<<xv<<", "<<yv<<" )";
-                if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv)  &&  JKQTPIsOKFloat(x) && JKQTPIsOKFloat(y)) {
-
-                    if (isHighlighted() && getSymbolType()!=JKQTPNoSymbol) {
-                        //JKQTPPlotSymbol(painter, x, y, JKQTPFilledCircle, parent->pt2px(painter, symbolSize*1.5), parent->pt2px(painter, symbolWidth*parent->getLineWidthMultiplier()), penSelection.color(), penSelection.color());
-                    }
-                    if ((!parent->getXAxis()->isLogAxis() || xv>0.0) && (!parent->getYAxis()->isLogAxis() || yv>0.0) ) {
-                        plotStyledSymbol(parent, painter, x, y);
-                        if (drawLine) {
-                            vec_linesP[vec_linesP.size()-1] << QPointF(x,y);
+            // only iterate over the datapoints that may be visible, lines are interrupted between the visible ranges
+            const double marginPx=parent->pt2px(painter, getSymbolSize()/2.0+qMax(getSymbolLineWidth(), getLineWidth())*parent->getLineWidthMultiplier());
+            const auto visibleRanges=getVisibleIndexRanges(imin, imax, drawLine, marginPx);
+            for (const auto& range: visibleRanges) {
+                if (vec_linesP[vec_linesP.size()-1].size()>0) vec_linesP.push_back(QPolygonF());
+                for (int iii=range.first; iii<range.second; iii++) {
+                    const int i=qBound(imin, getDataIndex(iii), imax);
+                    const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
+                    const double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
+                    const double x=transformX(xv);
+                    const double y=transformY(yv);
+                    //qDebug()<<"JKQTPXYLineGraph::draw(): (xv, yv) =    ( "<<xv<<", "<<yv<<" )";
+                    if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv)  &&  JKQTPIsOKFloat(x) && JKQTPIsOKFloat(y)) {
+
+                        if (isHighlighted() && getSymbolType()!=JKQTPNoSymbol) {
+                            //JKQTPPlotSymbol(painter, x, y, JKQTPFilledCircle, parent->pt2px(painter, symbolSize*1.5), parent->pt2px(painter, symbolWidth*parent->getLineWidthMultiplier()), penSelection.color(), penSelection.color());
+                        }
+                        if ((!parent->getXAxis()->isLogAxis() || xv>0.0) && (!parent->getYAxis()->isLogAxis() || yv>0.0) ) {
+                            plotStyledSymbol(parent, painter, x, y);
+                            if (drawLine) {
+                                vec_linesP[vec_linesP.size()-1] << QPointF(x,y);
+                            }
+                        } else {
+                            vec_linesP.push_back(QPolygonF());
                         }
-                    } else {
-                        vec_linesP.push_back(QPolygonF());
                     }
                 }
             }
@@ -128,6 +134,99 @@ void JKQTPXYLineGraph::draw(JKQTPEnhancedPainter& painter) {
     //qDebug()<<"JKQTPXYLineGraph::draw() ... done";
 }
 
+void JKQTPXYLineGraph::initIncrementalDrawState(JKQTPIncrementalDrawState &state) const
+{
+    state=JKQTPIncrementalDrawState();
+    if (parent==nullptr || sortData!=Unsorted) return;
+    const JKQTPDatastore* datastore=parent->getDatastore();
+    int imax=0;
+    int imin=0;
+    if (datastore==nullptr || !getIndexRange(imin, imax)) return;
+    state.drawnStart=imin;
+    state.drawnEnd=imax;
+    state.column1=xColumn;
+    state.column2=yColumn;
+    state.data1=datastore->getColumnPointer(xColumn, 0);
+    state.data2=datastore->getColumnPointer(yColumn, 0);
+    state.rows1=datastore->getRows(xColumn);
+    state.rows2=datastore->getRows(yColumn);
+    if (imax>imin) {
+        state.lastValue1=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(imax-1));
+        state.lastValue2=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(imax-1));
+    }
+    state.valid=true;
+}
+
+bool JKQTPXYLineGraph::drawIncremental(JKQTPEnhancedPainter &painter, JKQTPIncrementalDrawState &state)
+{
+#ifdef JKQTBP_AUTOTIMER
+    JKQTPAutoOutputTimer jkaaot("JKQTPXYLineGraph::drawIncremental");
+#endif
+    if (!state.valid || parent==nullptr || sortData!=Unsorted || state.column1!=xColumn || state.column2!=yColumn) return false;
+    const JKQTPDatastore* datastore=parent->getDatastore();
+    int imax=0;
+    int imin=0;
+    if (datastore==nullptr || !getIndexRange(imin, imax)) return false;
+    if (imin!=state.drawnStart || imax<state.drawnEnd) return false;
+    // the columns have to be the same memory (replacing or reallocating the data forces a complete redraw) and may only have grown
+    const double* data1=datastore->getColumnPointer(xColumn, 0);
+    const double* data2=datastore->getColumnPointer(yColumn, 0);
+    const size_t rows1=datastore->getRows(xColumn);
+    const size_t rows2=datastore->getRows(yColumn);
+    if (data1!=state.data1 || data2!=state.data2 || rows1<state.rows1 || rows2<state.rows2) return false;
+    // the data that has already been drawn has to be unchanged (this is checked for the last drawn datapoint only)
+    const auto sameValue=[](double a, double b) { return a==b || (std::isnan(a) && std::isnan(b)); };
+    if (state.drawnEnd>imin) {
+        if (!sameValue(datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(state.drawnEnd-1)), state.lastValue1)
+            || !sameValue(datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(state.drawnEnd-1)), state.lastValue2)) {
+            return false;
+        }
+    }
+    if (imax==state.drawnEnd) return true;
+
+    {
+        painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
+        const QPen p=getLinePen(painter, parent);
+        const QPen penSelection=getHighlightingLinePen(painter, parent);
+        std::vector<QPolygonF> vec_linesP;
+        vec_linesP.push_back(QPolygonF());
+        // start at the last drawn datapoint, so the line segment to the first new datapoint is drawn
+        for (int i=qMax(imin, state.drawnEnd-1); i<imax; i++) {
+            const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
+            const double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
+            const double x=transformX(xv);
+            const double y=transformY(yv);
+            if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv)  &&  JKQTPIsOKFloat(x) && JKQTPIsOKFloat(y)) {
+                if ((!parent->getXAxis()->isLogAxis() || xv>0.0) && (!parent->getYAxis()->isLogAxis() || yv>0.0) ) {
+                    if (i>=state.drawnEnd) plotStyledSymbol(parent, painter, x, y);
+                    if (drawLine) {
+                        vec_linesP[vec_linesP.size()-1] << QPointF(x,y);
+                    }
+                } else {
+                    vec_linesP.push_back(QPolygonF());
+                }
+            }
+        }
+        for (auto &linesP : vec_linesP) {
+            if (linesP.size()>0) {
+                if (isHighlighted()) {
+                    painter.setPen(penSelection);
+                    painter.drawPolyline(linesP);
+                }
+                painter.setPen(p);
+                painter.drawPolyline(linesP);
+            }
+        }
+    }
+
+    state.drawnEnd=imax;
+    state.rows1=rows1;
+    state.rows2=rows2;
+    state.lastValue1=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(imax-1));
+    state.lastValue2=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(imax-1));
+    return true;
+}
+
 void JKQTPXYLineGraph::drawKeyMarker(JKQTPEnhancedPainter& painter, QRectF& rect) {
     const double minSize=qMin(rect.width(), rect.height());
     const double maxSize=qMax(rect.width(), rect.height());
@@ -266,6 +365,11 @@ bool JKQTPXYLineErrorGraph::usesColumn(int c) const
     return JKQTPXYLineGraph::usesColumn(c)||JKQTPXYGraphErrors::errorUsesColumn(c);
 }
 
+bool JKQTPXYLineErrorGraph::drawIncremental(JKQTPEnhancedPainter &/*painter*/, JKQTPIncrementalDrawState &/*state*/)
+{
+    return false;
+}
+
 void JKQTPXYLineErrorGraph::drawErrorsBefore(JKQTPEnhancedPainter &painter)
 {
     intSortData();
@@ -325,6 +429,11 @@ JKQTPXYParametrizedScatterGraph::JKQTPXYParametrizedScatterGraph(JKQTPlotter *pa
 
 }
 
+bool JKQTPXYParametrizedScatterGraph::drawIncremental(JKQTPEnhancedPainter &/*painter*/, JKQTPIncrementalDrawState &/*state*/)
+{
+    return false;
+}
+
 void JKQTPXYParametrizedScatterGraph::draw(JKQTPEnhancedPainter &painter)
 {
 #ifdef JKQTBP_AUTOTIMER
@@ -348,20 +457,51 @@ void JKQTPXYParametrizedScatterGraph::draw(JKQTPEnhancedPainter &painter)
     int imin=0;
     if (getIndexRange(imin, imax)) {
 
-
-        QVector<QLineF> lines;
+        // consecutive symbols of equal (symbol type, quantized size, color) are collected into one bucket and each bucket is drawn with one call to JKQTPPlotSymbols()
+        // buckets are drawn in the order of the data, so overlapping symbols keep the z-order of the data index
+        // symbol sizes are quantized to 1/symbolSizeQuantization pixels
+        const double symbolSizeQuantization=16.0;
+        const double symbolLineWidthPx=parent->pt2px(painter, getSymbolLineWidth()*parent->getLineWidthMultiplier());
+        // highlighted graphs draw filled circles in the selection color (line and fill) for every point
+        const bool highlightSymbols=isHighlighted() && getSymbolType()!=JKQTPNoSymbol && symbolColumn<0;
+        struct SymbolBucket {
+            quint64 key;
+            JKQTPGraphSymbols symbol;
+            double size;
+            QColor color;
+            QColor fillColor;
+            QVector<QPointF> points;
+        };
+        QVector<SymbolBucket> symbolBuckets;
+        const auto addSymbol=[&symbolBuckets,symbolSizeQuantization,highlightSymbols,this](double x, double y, JKQTPGraphSymbols symbol, double size, QRgb color) {
+            const quint64 qsize=static_cast<quint64>(qBound<qint64>(0, qRound64(size*symbolSizeQuantization), 0xFFFFFF));
+            const quint64 key=(static_cast<quint64>(color)<<32) | (static_cast<quint64>(static_cast<quint8>(symbol))<<24) | qsize;
+            if (symbolBuckets.isEmpty() || symbolBuckets.last().key!=key) {
+                const QColor symbColor=QColor::fromRgba(color);
+                symbolBuckets.push_back(SymbolBucket{key, symbol, static_cast<double>(qsize)/symbolSizeQuantization, symbColor, highlightSymbols?symbColor:JKQTPGetDerivedColor(symbolFillDerivationMode, symbColor), QVector<QPointF>()});
+            }
+            symbolBuckets.last().points.push_back(QPointF(x,y));
+        };
+        // consecutive line segments with the same pen (color, width) are collected into one group and each group is drawn with one call to drawLines()
+        QVector<QPair<QPair<QRgb,double>, QVector<QLineF> > > lineGroups;
+        QVector<QPair<QRgb, QVector<QLineF> > > highlightLineGroups;
         QPolygonF linesP;
-        QVector<QColor> linecols;
-        QVector<QColor> linecolss;
-        QVector<double> linewidths;
+        bool hasLines=false;
         //qDebug()<<"JKQTPXYLineGraph::draw(): "<<3<<" imin="<<imin<<" imax="<<imax;
         {
-            painter.save(); auto __finalpaintinner=JKQTPFinally([&painter]() {painter.restore();});
             double xold=-1;
             double yold=-1;
             bool first=false;
 
             intSortData();
+            const QVector<QRgb> localColors=getLocalColors(imin, imax);
+            const double constSymbSize=(sizeColumn<0)?parent->pt2px(painter, getSymbolSize()):0.0;
+            const double constLineW=(linewidthColumn<0)?parent->pt2px(painter, getLineWidth()):0.0;
+            const JKQTPGraphSymbols constSymbol=getSymbolType();
+            const QRgb highlightColor=penSelection.color().rgba();
+            const QRgb highlightLineColor=getHighlightingLineColor().rgba();
+            const bool xLog=parent->getXAxis()->isLogAxis();
+            const bool yLog=parent->getYAxis()->isLogAxis();
             double specSymbSize=0;
             bool hasSpecSymbSize=false;
             for (int iii=imin; iii<imax; iii++) {
@@ -371,8 +511,8 @@ void JKQTPXYParametrizedScatterGraph::draw(JKQTPEnhancedPainter &painter)
                 double x=transformX(xv);
                 double y=transformY(yv);
                 if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv)  &&  JKQTPIsOKFloat(x) && JKQTPIsOKFloat(y)) {
-                    double symbSize= parent->pt2px(painter, getLocalSymbolSize(i));
-                    double lineW= parent->pt2px(painter, getLocalLineWidth(i));
+                    double symbSize= (sizeColumn<0)?constSymbSize:parent->pt2px(painter, getLocalSymbolSize(i));
+                    const double lineW= (linewidthColumn<0)?constLineW:parent->pt2px(painter, getLocalLineWidth(i));
 
                     if (gridModeForSymbolSize) {
                         if (!hasSpecSymbSize) {
@@ -383,32 +523,29 @@ void JKQTPXYParametrizedScatterGraph::draw(JKQTPEnhancedPainter &painter)
                         }
                         symbSize=specSymbSize;
                     }
-                    QColor symbColor=getLocalColor(i);
-                    QColor symbFillColor=JKQTPGetDerivedColor(symbolFillDerivationMode, symbColor);
+                    const QRgb symbColor=localColors.value(i-imin, getLineColor().rgba());
                     //qDebug()<<i<<symbolSize<<symbColor;
                     if (drawLine) {
                         linesP<<QPointF(x,y);
                     }
                     if (first && drawLine) {
-                        double xl1=xold;
-                        double yl1=yold;
-                        double xl2=x;
-                        double yl2=y;
-
+                        const QLineF l(xold, yold, x, y);
                         if (isHighlighted()) {
-                            if (colorColumn>=0) linecolss<<symbColor.lighter();
-                            else linecolss<<getHighlightingLineColor();
+                            const QRgb hc=(colorColumn>=0)?QColor::fromRgba(symbColor).lighter().rgba():highlightLineColor;
+                            if (highlightLineGroups.isEmpty() || highlightLineGroups.last().first!=hc) highlightLineGroups.push_back(qMakePair(hc, QVector<QLineF>()));
+                            highlightLineGroups.last().second<<l;
                         }
-                        linecols<<symbColor;
-                        lines<<QLineF(xl1, yl1, xl2, yl2);
-                        linewidths<<lineW;
+                        const QPair<QRgb,double> pk(symbColor, lineW);
+                        if (lineGroups.isEmpty() || lineGroups.last().first!=pk) lineGroups.push_back(qMakePair(pk, QVector<QLineF>()));
+                        lineGroups.last().second<<l;
+                        hasLines=true;
                     }
 
-                    if ((!parent->getXAxis()->isLogAxis() || xv>0.0) && (!parent->getYAxis()->isLogAxis() || yv>0.0) ) {
-                        if (isHighlighted() && getSymbolType()!=JKQTPNoSymbol && symbolColumn<0) {
-                            JKQTPPlotSymbol(painter, x, y, JKQTPFilledCircle,symbSize, parent->pt2px(painter, getSymbolLineWidth()*parent->getLineWidthMultiplier()), penSelection.color(), penSelection.color());
+                    if ((!xLog || xv>0.0) && (!yLog || yv>0.0) ) {
+                        if (highlightSymbols) {
+                            addSymbol(x, y, JKQTPFilledCircle, symbSize, highlightColor);
                         } else {
-                            JKQTPPlotSymbol(painter, x, y, getLocalSymbolType(i), symbSize, parent->pt2px(painter, getSymbolLineWidth()*parent->getLineWidthMultiplier()), symbColor, symbFillColor);
+                            addSymbol(x, y, (symbolColumn<0)?constSymbol:getLocalSymbolType(i), symbSize, symbColor);
                         }
                     }
 
@@ -420,17 +557,23 @@ void JKQTPXYParametrizedScatterGraph::draw(JKQTPEnhancedPainter &painter)
             }
         }
 
+        {
+            painter.save(); auto __finalpaintinner=JKQTPFinally([&painter]() {painter.restore();});
+            for (const SymbolBucket& b: symbolBuckets) {
+                JKQTPPlotSymbols(painter, b.points, b.symbol, b.size, symbolLineWidthPx, b.color, b.fillColor);
+            }
+        }
 
 
-        if (lines.size()>0) {
+        if (hasLines) {
             painter.save(); auto __finalpaintinner=JKQTPFinally([&painter]() {painter.restore();});
             if (isHighlighted()) {
                 QPen pp=penSelection;
                 if (colorColumn>=0) {
-                    for (int i=0; i<lines.size(); i++) {
-                        pp.setColor(linecolss.value(i, getHighlightingLineColor()));
+                    for (const auto& g: highlightLineGroups) {
+                        pp.setColor(QColor::fromRgba(g.first));
                         painter.setPen(pp);
-                        painter.drawLine(lines[i]);
+                        painter.drawLines(g.second);
                     }
                 } else {
                     pp.setColor(getHighlightingLineColor());
@@ -440,11 +583,11 @@ void JKQTPXYParametrizedScatterGraph::draw(JKQTPEnhancedPainter &painter)
             }
             QPen pp=p;
             if (colorColumn>=0 || linewidthColumn>=0) {
-                for (int i=0; i<lines.size(); i++) {
-                    pp.setColor(linecols.value(i, getLineColor()));
-                    pp.setWidthF(linewidths.value(i, parent->pt2px(painter, getLineWidth()*parent->getLineWidthMultiplier())));
+                for (const auto& g: lineGroups) {
+                    pp.setColor(QColor::fromRgba(g.first.first));
+                    pp.setWidthF(g.first.second);
                     painter.setPen(pp);
-                    painter.drawLine(lines[i]);
+                    painter.drawLines(g.second);
                 }
             } else {
                 pp.setColor(getHighlightingLineColor());
@@ -458,6 +601,54 @@ void JKQTPXYParametrizedScatterGraph::draw(JKQTPEnhancedPainter &painter)
     drawErrorsAfter(painter);
 }
 
+QVector<QRgb> JKQTPXYParametrizedScatterGraph::getLocalColors(int imin, int imax) const
+{
+    const int N=imax-imin+1;
+    QVector<QRgb> cols;
+    if (N<=0) return cols;
+    cols.resize(N);
+    const JKQTPDatastore* datastore=(parent!=nullptr)?parent->getDatastore():nullptr;
+    if (datastore==nullptr || colorColumn<0) {
+        cols.fill(getLineColor().rgba());
+        return cols;
+    }
+    const int64_t rows=static_cast<int64_t>(datastore->getRows(colorColumn));
+    if (colorColumnContainsRGB) {
+        for (int i=imin; i<=imax; i++) {
+            cols[i-imin]=getLocalColor(i).rgba();
+        }
+    } else {
+        double colMin=0;
+        double colMax=0;
+        if (intColMin==intColMax) {
+            colMin=0;
+            colMax=rows-1;
+        } else {
+            colMin=intColMin;
+            colMax=intColMax;
+        }
+        if (jkqtp_approximatelyEqual(colMin, colMax, JKQTP_DOUBLE_EPSILON)) {
+            // array2image() would autorange on the whole array in this case, so evaluate every point individually, as getLocalColor() does
+            for (int i=imin; i<=imax; i++) {
+                cols[i-imin]=getLocalColor(i).rgba();
+            }
+        } else {
+            QVector<double> colorvals(N, 0.0);
+            for (int i=imin; i<=imax; i++) {
+                if (i>=0 && i<rows) colorvals[i-imin]=datastore->get(colorColumn,i);
+            }
+            QImage img;
+            JKQTPImageTools::array2image(colorvals.constData(), N, 1, img, palette, colMin, colMax);
+            const QRgb* line=reinterpret_cast<const QRgb*>(img.constScanLine(0));
+            for (int i=0; i<N; i++) {
+                // same as QColor(QRgb) in getLocalColor(), which ignores the alpha channel
+                cols[i]=QColor(line[i]).rgba();
+            }
+        }
+    }
+    return cols;
+}
+
 void JKQTPXYParametrizedScatterGraph::drawKeyMarker(JKQTPEnhancedPainter &painter, QRectF &rect)
 {
     const double minSize=qMin(rect.width(), rect.height());
@@ -63,6 +63,17 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPXYLineGraph: public JKQTPXYGraph, public JKQTP
 
         /** \brief plots the graph to the plotter object specified as parent */
         virtual void draw(JKQTPEnhancedPainter& painter) override;
+        /** \copydoc JKQTPPlotElement::initIncrementalDrawState()
+         *
+         *  \note Incremental drawing is only supported for unsorted data (see setDataSortOrder() ).
+         */
+        virtual void initIncrementalDrawState(JKQTPIncrementalDrawState& state) const override;
+        /** \copydoc JKQTPPlotElement::drawIncremental()
+         *
+         *  This draws the datapoints appended to the x- and y-column since \a state and the line segment connecting them to the last
+         *  drawn datapoint. If the data was changed otherwise (fewer rows, different columns, the last drawn datapoint changed), \c false is returned.
+         */
+        virtual bool drawIncremental(JKQTPEnhancedPainter& painter, JKQTPIncrementalDrawState& state) override;
         /** \brief plots a key marker inside the specified rectangle \a rect */
         virtual void drawKeyMarker(JKQTPEnhancedPainter& painter, QRectF& rect) override;
         /** \brief returns the color to be used for the key label */
@@ -130,6 +141,8 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPXYParametrizedScatterGraph: public JKQTPXYLine
 
         /** \brief plots the graph to the plotter object specified as parent */
         virtual void draw(JKQTPEnhancedPainter& painter) override;
+        /** \brief incremental drawing is not supported by this graph, returns \c false */
+        virtual bool drawIncremental(JKQTPEnhancedPainter& painter, JKQTPIncrementalDrawState& state) override;
         /** \brief plots a key marker inside the specified rectangle \a rect */
         virtual void drawKeyMarker(JKQTPEnhancedPainter& painter, QRectF& rect) override;
         /** \brief returns the color to be used for the key label */
@@ -331,6 +344,8 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPXYParametrizedScatterGraph: public JKQTPXYLine
         double getLocalSymbolSize(int i);
         /** \brief retrns the local color for the i-th datapoint */
         QColor getLocalColor(int i) const;
+        /** \brief retrns the local colors for all datapoints \a imin ... \a imax (inclusive), i.e. the same as calling getLocalColor() for every index, but with a single color-palette lookup */
+        QVector<QRgb> getLocalColors(int imin, int imax) const;
         /** \brief retrns the local symbol type for the i-th datapoint */
         JKQTPGraphSymbols getLocalSymbolType(int i);
 
@@ -392,6 +407,8 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPXYLineErrorGraph: public JKQTPXYLineGraph, pub
         virtual bool getYMinMax(double& miny, double& maxy, double& smallestGreaterZero) override;
         /** \copydoc JKQTPGraph::usesColumn() */
         virtual bool usesColumn(int c) const override;
+        /** \brief incremental drawing is not supported by this graph (due to the error indicators), returns \c false */
+        virtual bool drawIncremental(JKQTPEnhancedPainter& painter, JKQTPIncrementalDrawState& state) override;
 
     protected:
         /** \brief this function is used to plot error inidcators before plotting the graphs. */
@@ -132,6 +132,117 @@ inline JKQTPBoxplotVerticalElement* jkqtpstatAddVBoxplot(JKQTBasePlotter* plotte
 
 
 
+/*! \brief updates the values of the boxplot element \a boxplot from the given quantile sketch \a sketch
+    \ingroup jkqtptools_math_statistics_adaptors
+
+    \param boxplot the boxplot element to update
+    \param sketch the quantile sketch, which summarizes the data to represent
+    \param quantile1Spec specifies which quantile to calculate for \a qantile1 (range: 0..1)
+    \param quantile2Spec specifies which quantile to calculate for \a qantile2 (range: 0..1)
+    \param minimumQuantile specifies a quantile for the return value minimum (default is 0 for the real minimum, but you could e.g. use 0.05 for the 5% quantile!)
+    \param maximumQuantile specifies a quantile for the return value maximum (default is 1 for the real maximum, but you could e.g. use 0.95 for the 95% quantile!)
+    \param[out] statOutput optionally returns the internally calculated statistics as a JKQTPStat5NumberStatistics
+
+    This allows to keep a boxplot up to date, while data is streamed into \a sketch : Only the new values have to be added
+    to the sketch, before calling this function (and JKQTBasePlotter::redrawPlot() ).
+
+    Example:
+    \code
+        JKQTPStatQuantileSketch sketch;
+        sketch.addRange(newData.begin(), newData.end());
+        jkqtpstatUpdateBoxplot(boxplot, sketch);
+        plot->redrawPlot();
+    \endcode
+
+    \see JKQTPStatQuantileSketch, jkqtpstatAddVBoxplot(), jkqtpstatAddHBoxplot()
+*/
+inline void jkqtpstatUpdateBoxplot(JKQTPBoxplotElementBase* boxplot, const JKQTPStatQuantileSketch& sketch, double quantile1Spec=0.25, double quantile2Spec=0.75, double minimumQuantile=0, double maximumQuantile=1.0, JKQTPStat5NumberStatistics* statOutput=nullptr) {
+    JKQTPStat5NumberStatistics stat=sketch.fiveNumberStatistics(quantile1Spec, quantile2Spec, minimumQuantile, maximumQuantile);
+    if (statOutput) *statOutput=stat;
+    boxplot->setMin(stat.minimum);
+    boxplot->setMax(stat.maximum);
+    boxplot->setMedian(stat.median);
+    boxplot->setMean(sketch.average());
+    boxplot->setPercentile25(stat.quantile1);
+    boxplot->setPercentile75(stat.quantile2);
+    boxplot->setMedianConfidenceIntervalWidth(stat.IQRSignificanceEstimate());
+}
+
+
+/*! \brief add a JKQTPBoxplotHorizontalElement to the given plotter, where the boxplot values are estimated from the quantile sketch \a sketch
+    \ingroup jkqtptools_math_statistics_adaptors
+
+    \param plotter the plotter to which to add the resulting graph
+    \param sketch the quantile sketch, which summarizes the data to represent
+    \param boxposY y-coordinate of the boxplot
+    \param quantile1Spec specifies which quantile to calculate for \a qantile1 (range: 0..1)
+    \param quantile2Spec specifies which quantile to calculate for \a qantile2 (range: 0..1)
+    \param minimumQuantile specifies a quantile for the return value minimum (default is 0 for the real minimum, but you could e.g. use 0.05 for the 5% quantile!)
+    \param maximumQuantile specifies a quantile for the return value maximum (default is 1 for the real maximum, but you could e.g. use 0.95 for the 95% quantile!)
+    \param[out] statOutput optionally returns the internally calculated statistics as a JKQTPStat5NumberStatistics
+    \return a boxplot element with its values initialized from the given sketch
+
+    In contrast to the iterator-based variant, this function does not need access to (or a copy of) the whole dataset,
+    so it can be used with datasets that are too large to be kept in memory, or that are streamed. The boxplot
+    can later be updated with jkqtpstatUpdateBoxplot().
+
+    \see JKQTPStatQuantileSketch, jkqtpstatUpdateBoxplot()
+*/
+inline JKQTPBoxplotHorizontalElement* jkqtpstatAddHBoxplot(JKQTBasePlotter* plotter, const JKQTPStatQuantileSketch& sketch, double boxposY, double quantile1Spec=0.25, double quantile2Spec=0.75, double minimumQuantile=0, double maximumQuantile=1.0, JKQTPStat5NumberStatistics* statOutput=nullptr) {
+    JKQTPBoxplotHorizontalElement* res=new JKQTPBoxplotHorizontalElement(plotter);
+    jkqtpstatUpdateBoxplot(res, sketch, quantile1Spec, quantile2Spec, minimumQuantile, maximumQuantile, statOutput);
+    res->setDrawMean(true);
+    res->setDrawNotch(true);
+    res->setDrawMedian(true);
+    res->setDrawMinMax(true);
+    res->setDrawBox(true);
+    res->setPos(boxposY);
+    plotter->addGraph(res);
+    return res;
+}
+
+
+/*! \brief add a JKQTPBoxplotVerticalElement to the given plotter, where the boxplot values are estimated from the quantile sketch \a sketch
+    \ingroup jkqtptools_math_statistics_adaptors
+
+    \param plotter the plotter to which to add the resulting graph
+    \param sketch the quantile sketch, which summarizes the data to represent
+    \param boxposX x-coordinate of the boxplot
+    \param quantile1Spec specifies which quantile to calculate for \a qantile1 (range: 0..1)
+    \param quantile2Spec specifies which quantile to calculate for \a qantile2 (range: 0..1)
+    \param minimumQuantile specifies a quantile for the return value minimum (default is 0 for the real minimum, but you could e.g. use 0.05 for the 5% quantile!)
+    \param maximumQuantile specifies a quantile for the return value maximum (default is 1 for the real maximum, but you could e.g. use 0.95 for the 95% quantile!)
+    \param[out] statOutput optionally returns the internally calculated statistics as a JKQTPStat5NumberStatistics
+    \return a boxplot element with its values initialized from the given sketch
+
+    In contrast to the iterator-based variant, this function does not need access to (or a copy of) the whole dataset,
+    so it can be used with datasets that are too large to be kept in memory, or that are streamed. The boxplot
+    can later be updated with jkqtpstatUpdateBoxplot().
+
+    Example:
+    \code
+        JKQTPStatQuantileSketch sketch;
+        sketch.addRange(datastore1->begin(randomdatacol1), datastore1->end(randomdatacol1));
+        jkqtpstatAddVBoxplot(plot1->getPlotter(), sketch, -0.3);
+    \endcode
+
+    \see JKQTPStatQuantileSketch, jkqtpstatUpdateBoxplot()
+*/
+inline JKQTPBoxplotVerticalElement* jkqtpstatAddVBoxplot(JKQTBasePlotter* plotter, const JKQTPStatQuantileSketch& sketch, double boxposX, double quantile1Spec=0.25, double quantile2Spec=0.75, double minimumQuantile=0, double maximumQuantile=1.0, JKQTPStat5NumberStatistics* statOutput=nullptr) {
+    JKQTPBoxplotVerticalElement* res=new JKQTPBoxplotVerticalElement(plotter);
+    jkqtpstatUpdateBoxplot(res, sketch, quantile1Spec, quantile2Spec, minimumQuantile, maximumQuantile, statOutput);
+    res->setDrawMean(true);
+    res->setDrawNotch(true);
+    res->setDrawMedian(true);
+    res->setDrawMinMax(true);
+    res->setDrawBox(true);
+    res->setPos(boxposX);
+    plotter->addGraph(res);
+    return res;
+}
+
+
+
 /*! \brief add a JKQTPBoxplotHorizontalElement and a JKQTPSingleColumnSymbolsGraph for outliers  to the given plotter, where the boxplot values are calculated from the data range \a first ... \a last
     \ingroup jkqtptools_math_statistics_adaptors
 
@@ -453,6 +564,110 @@ inline JKQTPViolinplotVerticalElement* jkqtpstatAddVViolinplotHistogram(JKQTBase
 
 
 
+/*! \brief updates the values and the density estimate of the Violinplot element \a violin from the given quantile sketch \a sketch
+    \ingroup jkqtptools_math_statistics_adaptors
+
+    \param violin the Violinplot element to update
+    \param sketch the quantile sketch, which summarizes the data to represent
+    \param violinDistSamples number of samples of the distribution (between min and max)
+
+    The density estimate (see JKQTPStatQuantileSketch::densityEstimate() ) is written into the columns
+    JKQTPViolinplotElementBase::getViolinPositionColumn() and JKQTPViolinplotElementBase::getViolinFrequencyColumn()
+    of the datastore of the plotter, \a violin belongs to. These columns are resized to \a violinDistSamples rows.
+
+    \see JKQTPStatQuantileSketch, jkqtpstatAddVViolinplotQuantileSketch(), jkqtpstatAddHViolinplotQuantileSketch()
+*/
+inline void jkqtpstatUpdateViolinplot(JKQTPViolinplotElementBase* violin, const JKQTPStatQuantileSketch& sketch, int violinDistSamples=100) {
+    violin->setMin(sketch.minimum());
+    violin->setMax(sketch.maximum());
+    violin->setMedian(sketch.median());
+    violin->setMean(sketch.average());
+    if (violin->getParent() && violin->getViolinPositionColumn()>=0 && violin->getViolinFrequencyColumn()>=0) {
+        JKQTPDatastore* ds=violin->getParent()->getDatastore();
+        const size_t cPos=static_cast<size_t>(violin->getViolinPositionColumn());
+        const size_t cFreq=static_cast<size_t>(violin->getViolinFrequencyColumn());
+        std::vector<double> pos, freq;
+        pos.reserve(static_cast<size_t>(std::max(0, violinDistSamples)));
+        freq.reserve(static_cast<size_t>(std::max(0, violinDistSamples)));
+        sketch.densityEstimate(std::back_inserter(pos), std::back_inserter(freq), violinDistSamples);
+        ds->resizeColumn(cPos, pos.size());
+        ds->resizeColumn(cFreq, freq.size());
+        for (size_t i=0; i<pos.size(); i++) {
+            ds->set(cPos, i, pos[i]);
+            ds->set(cFreq, i, freq[i]);
+        }
+    }
+}
+
+
+/*! \brief add a JKQTPViolinplotHorizontalElement to the given plotter, where the Violinplot values and the density distribution estimate are calculated from the quantile sketch \a sketch
+    \ingroup jkqtptools_math_statistics_adaptors
+
+    \param plotter the plotter to which to add the resulting graph
+    \param sketch the quantile sketch, which summarizes the data to represent
+    \param violinposY y-coordinate of the Violinplot
+    \param distBasename name basing for added columns
+    \param violinDistSamples number of samples of the distribution (between min and max)
+    \return a Violinplot element with its values initialized from the given sketch
+
+    The Violinplot can later be updated with jkqtpstatUpdateViolinplot().
+
+    \see \ref JKQTPlotterViolinplotGraphs, JKQTPViolinplotHorizontalElement, JKQTPStatQuantileSketch, jkqtpstatUpdateViolinplot()
+*/
+inline JKQTPViolinplotHorizontalElement* jkqtpstatAddHViolinplotQuantileSketch(JKQTBasePlotter* plotter, const JKQTPStatQuantileSketch& sketch, double violinposY, const QString& distBasename=QString("violin plot distribution"), int violinDistSamples=100) {
+    size_t cViol1Cat=plotter->getDatastore()->addColumn(distBasename+", category");
+    size_t cViol1Freq=plotter->getDatastore()->addColumn(distBasename+", density");
+    JKQTPViolinplotHorizontalElement* res=new JKQTPViolinplotHorizontalElement(plotter);
+    res->setViolinPositionColumn(cViol1Cat);
+    res->setViolinFrequencyColumn(cViol1Freq);
+    jkqtpstatUpdateViolinplot(res, sketch, violinDistSamples);
+    res->setDrawMean(true);
+    res->setDrawMedian(true);
+    res->setDrawMinMax(true);
+    res->setPos(violinposY);
+    plotter->addGraph(res);
+    return res;
+}
+
+
+/*! \brief add a JKQTPViolinplotVerticalElement to the given plotter, where the Violinplot values and the density distribution estimate are calculated from the quantile sketch \a sketch
+    \ingroup jkqtptools_math_statistics_adaptors
+
+    \param plotter the plotter to which to add the resulting graph
+    \param sketch the quantile sketch, which summarizes the data to represent
+    \param violinposY x-coordinate of the Violinplot
+    \param distBasename name basing for added columns
+    \param violinDistSamples number of samples of the distribution (between min and max)
+    \return a Violinplot element with its values initialized from the given sketch
+
+    The Violinplot can later be updated with jkqtpstatUpdateViolinplot().
+
+    Example:
+    \code
+        JKQTPStatQuantileSketch sketch;
+        sketch.addRange(datastore1->begin(randomdatacol1), datastore1->end(randomdatacol1));
+        jkqtpstatAddVViolinplotQuantileSketch(plot->getPlotter(), sketch, -20);
+    \endcode
+
+    \see \ref JKQTPlotterViolinplotGraphs, JKQTPViolinplotVerticalElement, JKQTPStatQuantileSketch, jkqtpstatUpdateViolinplot()
+*/
+inline JKQTPViolinplotVerticalElement* jkqtpstatAddVViolinplotQuantileSketch(JKQTBasePlotter* plotter, const JKQTPStatQuantileSketch& sketch, double violinposY, const QString& distBasename=QString("violin plot distribution"), int violinDistSamples=100) {
+    size_t cViol1Cat=plotter->getDatastore()->addColumn(distBasename+", category");
+    size_t cViol1Freq=plotter->getDatastore()->addColumn(distBasename+", density");
+    JKQTPViolinplotVerticalElement* res=new JKQTPViolinplotVerticalElement(plotter);
+    res->setViolinPositionColumn(cViol1Cat);
+    res->setViolinFrequencyColumn(cViol1Freq);
+    jkqtpstatUpdateViolinplot(res, sketch, violinDistSamples);
+    res->setDrawMean(true);
+    res->setDrawMedian(true);
+    res->setDrawMinMax(true);
+    res->setPos(violinposY);
+    plotter->addGraph(res);
+    return res;
+}
+
+
+
 
 
 
@@ -2367,17 +2582,19 @@ JKQTPLOTTER_LIB_EXPORT JKQTPXFunctionLineGraph* jkqtpstatAddPolyFit(JKQTPXYGraph
 */
 template <class InputCatIt, class InputValueIt, class TGraph>
 inline TGraph* jkqtpstatAddYErrorGraph(JKQTBasePlotter* plotter, InputCatIt inFirstCat_X, InputCatIt inLastCat_X, InputValueIt inFirstValue_Y, InputValueIt inLastValue_Y, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D, const QString& columnBaseName=QString("grouped data")) {
-    std::map<double, std::vector<double> > groupeddataBar;
-    jkqtpstatGroupData(inFirstCat_X, inLastCat_X, inFirstValue_Y, inLastValue_Y, groupeddataBar, groupDefFunc);
+    JKQTPStatGroupedData groupeddataBar;
+    jkqtpstatGroupDataCSR(inFirstCat_X, inLastCat_X, inFirstValue_Y, inLastValue_Y, groupeddataBar, groupDefFunc);
 
     size_t colGroup=plotter->getDatastore()->addColumn(columnBaseName+", group");
     size_t colAverage=plotter->getDatastore()->addColumn(columnBaseName+", average");
     size_t colStdDev=plotter->getDatastore()->addColumn(columnBaseName+", stddev");
 
-    for (auto it=groupeddataBar.begin(); it!=groupeddataBar.end(); ++it) {
-        plotter->getDatastore()->appendToColumn(colGroup, it->first);
-        plotter->getDatastore()->appendToColumn(colAverage, jkqtpstatAverage(it->second.begin(), it->second.end()));
-        plotter->getDatastore()->appendToColumn(colStdDev, jkqtpstatStdDev(it->second.begin(), it->second.end()));
+    for (size_t g=0; g<groupeddataBar.groupCount(); g++) {
+        JKQTPStatMomentsAccumulator acc;
+        acc.addRange(groupeddataBar.valuesBegin(g), groupeddataBar.valuesEnd(g));
+        plotter->getDatastore()->appendToColumn(colGroup, groupeddataBar.groups[g]);
+        plotter->getDatastore()->appendToColumn(colAverage, acc.average());
+        plotter->getDatastore()->appendToColumn(colStdDev, acc.standardDeviation());
     }
 
     // 2.4. Finally the calculated groups are drawn
@@ -2537,17 +2754,19 @@ inline JKQTPFilledCurveYErrorGraph* jkqtpstatAddYErrorFilledCurveGraph(JKQTBaseP
 */
 template <class InputCatIt, class InputValueIt, class TGraph>
 inline TGraph* jkqtpstatAddXErrorGraph(JKQTBasePlotter* plotter, InputCatIt inFirstCat_Y, InputCatIt inLastCat_Y, InputValueIt inFirstValue_Y, InputValueIt inLastValue_Y, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D, const QString& columnBaseName=QString("grouped data")) {
-    std::map<double, std::vector<double> > groupeddataBar;
-    jkqtpstatGroupData(inFirstCat_Y, inLastCat_Y, inFirstValue_Y, inLastValue_Y, groupeddataBar, groupDefFunc);
+    JKQTPStatGroupedData groupeddataBar;
+    jkqtpstatGroupDataCSR(inFirstCat_Y, inLastCat_Y, inFirstValue_Y, inLastValue_Y, groupeddataBar, groupDefFunc);
 
     size_t colGroup=plotter->getDatastore()->addColumn(columnBaseName+", group");
     size_t colAverage=plotter->getDatastore()->addColumn(columnBaseName+", average");
     size_t colStdDev=plotter->getDatastore()->addColumn(columnBaseName+", stddev");
 
-    for (auto it=groupeddataBar.begin(); it!=groupeddataBar.end(); ++it) {
-        plotter->getDatastore()->appendToColumn(colGroup, it->first);
-        plotter->getDatastore()->appendToColumn(colAverage, jkqtpstatAverage(it->second.begin(), it->second.end()));
-        plotter->getDatastore()->appendToColumn(colStdDev, jkqtpstatStdDev(it->second.begin(), it->second.end()));
+    for (size_t g=0; g<groupeddataBar.groupCount(); g++) {
+        JKQTPStatMomentsAccumulator acc;
+        acc.addRange(groupeddataBar.valuesBegin(g), groupeddataBar.valuesEnd(g));
+        plotter->getDatastore()->appendToColumn(colGroup, groupeddataBar.groups[g]);
+        plotter->getDatastore()->appendToColumn(colAverage, acc.average());
+        plotter->getDatastore()->appendToColumn(colStdDev, acc.standardDeviation());
     }
 
     // 2.4. Finally the calculated groups are drawn
@@ -2708,8 +2927,8 @@ inline JKQTPFilledCurveXErrorGraph* jkqtpstatAddXErrorFilledCurveGraph(JKQTBaseP
 */
 template <class InputCatIt, class InputValueIt, class TGraph>
 inline TGraph* jkqtpstatAddXYErrorGraph(JKQTBasePlotter* plotter, InputCatIt inFirstCat_X, InputCatIt inLastCat_X, InputValueIt inFirstValue_Y, InputValueIt inLastValue_Y, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D, const QString& columnBaseName=QString("grouped data")) {
-    std::map<double, std::pair< std::vector<double>, std::vector<double> > > groupeddataBar;
-    jkqtpstatGroupData(inFirstCat_X, inLastCat_X, inFirstValue_Y, inLastValue_Y, groupeddataBar, groupDefFunc);
+    JKQTPStatGroupedData groupeddataBar;
+    jkqtpstatGroupDataCSR(inFirstCat_X, inLastCat_X, inFirstValue_Y, inLastValue_Y, groupeddataBar, groupDefFunc, true);
 
     size_t colGroup=plotter->getDatastore()->addColumn(columnBaseName+", group");
     size_t colAverageX=plotter->getDatastore()->addColumn(columnBaseName+", category-average");
@@ -2717,12 +2936,15 @@ inline TGraph* jkqtpstatAddXYErrorGraph(JKQTBasePlotter* plotter, InputCatIt inF
     size_t colAverageY=plotter->getDatastore()->addColumn(columnBaseName+", value-average");
     size_t colStdDevY=plotter->getDatastore()->addColumn(columnBaseName+", value-stddev");
 
-    for (auto it=groupeddataBar.begin(); it!=groupeddataBar.end(); ++it) {
-        plotter->getDatastore()->appendToColumn(colGroup, it->first);
-        plotter->getDatastore()->appendToColumn(colAverageX, jkqtpstatAverage(it->second.first.begin(), it->second.first.end()));
-        plotter->getDatastore()->appendToColumn(colStdDevX, jkqtpstatStdDev(it->second.first.begin(), it->second.first.end()));
-        plotter->getDatastore()->appendToColumn(colAverageY, jkqtpstatAverage(it->second.second.begin(), it->second.second.end()));
-        plotter->getDatastore()->appendToColumn(colStdDevY, jkqtpstatStdDev(it->second.second.begin(), it->second.second.end()));
+    for (size_t g=0; g<groupeddataBar.groupCount(); g++) {
+        JKQTPStatMomentsAccumulator accX, accY;
+        accX.addRange(groupeddataBar.categoriesBegin(g), groupeddataBar.categoriesEnd(g));
+        accY.addRange(groupeddataBar.valuesBegin(g), groupeddataBar.valuesEnd(g));
+        plotter->getDatastore()->appendToColumn(colGroup, groupeddataBar.groups[g]);
+        plotter->getDatastore()->appendToColumn(colAverageX, accX.average());
+        plotter->getDatastore()->appendToColumn(colStdDevX, accX.standardDeviation());
+        plotter->getDatastore()->appendToColumn(colAverageY, accY.average());
+        plotter->getDatastore()->appendToColumn(colStdDevY, accY.standardDeviation());
     }
 
     // 2.4. Finally the calculated groups are drawn
@@ -2815,8 +3037,8 @@ inline JKQTPXYParametrizedErrorScatterGraph* jkqtpstatAddXYErrorParametrizedScat
 */
 template <class InputCatIt, class InputValueIt, class TGraph>
 inline TGraph* jkqtpstatAddBoxplots(JKQTBasePlotter* plotter, InputCatIt inFirstCat_Y, InputCatIt inLastCat_Y, InputValueIt inFirstValue_Y, InputValueIt inLastValue_Y, double quantile1Spec=0.25, double quantile2Spec=0.75, double minimumQuantile=0, double maximumQuantile=1.0, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D, const QString& columnBaseName=QString("grouped boxplot data")) {
-    std::map<double, std::vector<double> > groupeddataBar;
-    jkqtpstatGroupData(inFirstCat_Y, inLastCat_Y, inFirstValue_Y, inLastValue_Y, groupeddataBar, groupDefFunc);
+    JKQTPStatGroupedData groupeddataBar;
+    jkqtpstatGroupDataCSR(inFirstCat_Y, inLastCat_Y, inFirstValue_Y, inLastValue_Y, groupeddataBar, groupDefFunc);
 
     size_t colGroup=plotter->getDatastore()->addColumn(columnBaseName+", group");
     size_t colMin=plotter->getDatastore()->addColumn(columnBaseName+", minimum");
@@ -2827,12 +3049,12 @@ inline TGraph* jkqtpstatAddBoxplots(JKQTBasePlotter* plotter, InputCatIt inFirst
     size_t colQ75=plotter->getDatastore()->addColumn(columnBaseName+", quartile75");
     size_t colMax=plotter->getDatastore()->addColumn(columnBaseName+", maximum");
 
-    for (auto it=groupeddataBar.begin(); it!=groupeddataBar.end(); ++it) {
+    for (size_t g=0; g<groupeddataBar.groupCount(); g++) {
 
-        auto stat5=jkqtpstat5NumberStatistics(it->second.begin(), it->second.end(), quantile1Spec,  quantile2Spec,  minimumQuantile,  maximumQuantile);
+        auto stat5=jkqtpstat5NumberStatistics(groupeddataBar.valuesBegin(g), groupeddataBar.valuesEnd(g), quantile1Spec,  quantile2Spec,  minimumQuantile,  maximumQuantile);
 
-        plotter->getDatastore()->appendToColumn(colGroup, it->first);
-        plotter->getDatastore()->appendToColumn(colAverage, jkqtpstatAverage(it->second.begin(), it->second.end()));
+        plotter->getDatastore()->appendToColumn(colGroup, groupeddataBar.groups[g]);
+        plotter->getDatastore()->appendToColumn(colAverage, jkqtpstatAverage(groupeddataBar.valuesBegin(g), groupeddataBar.valuesEnd(g)));
         plotter->getDatastore()->appendToColumn(colMin, stat5.minimum);
         plotter->getDatastore()->appendToColumn(colQ25, stat5.quantile1);
         plotter->getDatastore()->appendToColumn(colMedian, stat5.median);
@@ -2938,8 +3160,8 @@ inline JKQTPBoxplotHorizontalGraph* jkqtpstatVAddBoxplots(JKQTBasePlotter* plott
 */
 template <class InputCatIt, class InputValueIt>
 inline std::pair<JKQTPBoxplotVerticalGraph*, JKQTPXYLineGraph*> jkqtpstatAddVBoxplotsAndOutliers(JKQTBasePlotter* plotter, InputCatIt inFirstCat_X, InputCatIt inLastCat_X, InputValueIt inFirstValue_Y, InputValueIt inLastValue_Y, double quantile1Spec=0.25, double quantile2Spec=0.75, double minimumQuantile=0.03, double maximumQuantile=0.97, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D, const QString& columnBaseName=QString("grouped boxplot data")) {
-    std::map<double, std::vector<double> > groupeddataBar;
-    jkqtpstatGroupData(inFirstCat_X, inLastCat_X, inFirstValue_Y, inLastValue_Y, groupeddataBar, groupDefFunc);
+    JKQTPStatGroupedData groupeddataBar;
+    jkqtpstatGroupDataCSR(inFirstCat_X, inLastCat_X, inFirstValue_Y, inLastValue_Y, groupeddataBar, groupDefFunc);
 
     size_t colGroup=plotter->getDatastore()->addColumn(columnBaseName+", group");
     size_t colMin=plotter->getDatastore()->addColumn(columnBaseName+", minimum");
@@ -2952,19 +3174,19 @@ inline std::pair<JKQTPBoxplotVerticalGraph*, JKQTPXYLineGraph*> jkqtpstatAddVBox
     size_t colOutlierG=plotter->getDatastore()->addColumn(columnBaseName+", outlier-group");
     size_t colOutlierV=plotter->getDatastore()->addColumn(columnBaseName+", outlier-value");
 
-    for (auto it=groupeddataBar.begin(); it!=groupeddataBar.end(); ++it) {
+    for (size_t g=0; g<groupeddataBar.groupCount(); g++) {
 
-        auto stat5=jkqtpstat5NumberStatistics(it->second.begin(), it->second.end(), quantile1Spec,  quantile2Spec,  minimumQuantile,  maximumQuantile);
+        auto stat5=jkqtpstat5NumberStatistics(groupeddataBar.valuesBegin(g), groupeddataBar.valuesEnd(g), quantile1Spec,  quantile2Spec,  minimumQuantile,  maximumQuantile);
 
-        plotter->getDatastore()->appendToColumn(colGroup, it->first);
-        plotter->getDatastore()->appendToColumn(colAverage, jkqtpstatAverage(it->second.begin(), it->second.end()));
+        plotter->getDatastore()->appendToColumn(colGroup, groupeddataBar.groups[g]);
+        plotter->getDatastore()->appendToColumn(colAverage, jkqtpstatAverage(groupeddataBar.valuesBegin(g), groupeddataBar.valuesEnd(g)));
         plotter->getDatastore()->appendToColumn(colMin, stat5.minimum);
         plotter->getDatastore()->appendToColumn(colQ25, stat5.quantile1);
         plotter->getDatastore()->appendToColumn(colMedian, stat5.median);
         plotter->getDatastore()->appendToColumn(colQ75, stat5.quantile2);
         plotter->getDatastore()->appendToColumn(colMax, stat5.maximum);
         plotter->getDatastore()->appendToColumn(colIQRSig, stat5.IQRSignificanceEstimate());
-        std::fill_n(plotter->getDatastore()->backInserter(colOutlierG), stat5.outliers.size(), jkqtp_todouble(it->first));
+        std::fill_n(plotter->getDatastore()->backInserter(colOutlierG), stat5.outliers.size(), groupeddataBar.groups[g]);
         plotter->getDatastore()->appendToColumn(colOutlierV, stat5.outliers.begin(), stat5.outliers.end());
     }
 
@@ -3014,8 +3236,8 @@ inline std::pair<JKQTPBoxplotVerticalGraph*, JKQTPXYLineGraph*> jkqtpstatAddVBox
 */
 template <class InputCatIt, class InputValueIt>
 inline std::pair<JKQTPBoxplotHorizontalGraph*, JKQTPXYLineGraph*> jkqtpstatAddHBoxplotsAndOutliers(JKQTBasePlotter* plotter, InputCatIt inFirstCat_Y, InputCatIt inLastCat_Y, InputValueIt inFirstValue_X, InputValueIt inLastValue_X, double quantile1Spec=0.25, double quantile2Spec=0.75, double minimumQuantile=0.03, double maximumQuantile=0.97, JKQTPStatGroupDefinitionFunctor1D groupDefFunc=&jkqtpstatGroupingIdentity1D, const QString& columnBaseName=QString("grouped boxplot data")) {
-    std::map<double, std::vector<double> > groupeddataBar;
-    jkqtpstatGroupData(inFirstCat_Y, inLastCat_Y, inFirstValue_X, inLastValue_X, groupeddataBar, groupDefFunc);
+    JKQTPStatGroupedData groupeddataBar;
+    jkqtpstatGroupDataCSR(inFirstCat_Y, inLastCat_Y, inFirstValue_X, inLastValue_X, groupeddataBar, groupDefFunc);
 
     size_t colGroup=plotter->getDatastore()->addColumn(columnBaseName+", group");
     size_t colMin=plotter->getDatastore()->addColumn(columnBaseName+", minimum");
@@ -3028,19 +3250,19 @@ inline std::pair<JKQTPBoxplotHorizontalGraph*, JKQTPXYLineGraph*> jkqtpstatAddHB
     size_t colOutlierG=plotter->getDatastore()->addColumn(columnBaseName+", outlier-group");
     size_t colOutlierV=plotter->getDatastore()->addColumn(columnBaseName+", outlier-value");
 
-    for (auto it=groupeddataBar.begin(); it!=groupeddataBar.end(); ++it) {
+    for (size_t g=0; g<groupeddataBar.groupCount(); g++) {
 
-        auto stat5=jkqtpstat5NumberStatistics(it->second.begin(), it->second.end(), quantile1Spec,  quantile2Spec,  minimumQuantile,  maximumQuantile);
+        auto stat5=jkqtpstat5NumberStatistics(groupeddataBar.valuesBegin(g), groupeddataBar.valuesEnd(g), quantile1Spec,  quantile2Spec,  minimumQuantile,  maximumQuantile);
 
-        plotter->getDatastore()->appendToColumn(colGroup, it->first);
-        plotter->getDatastore()->appendToColumn(colAverage, jkqtpstatAverage(it->second.begin(), it->second.end()));
+        plotter->getDatastore()->appendToColumn(colGroup, groupeddataBar.groups[g]);
+        plotter->getDatastore()->appendToColumn(colAverage, jkqtpstatAverage(groupeddataBar.valuesBegin(g), groupeddataBar.valuesEnd(g)));
         plotter->getDatastore()->appendToColumn(colMin, stat5.minimum);
         plotter->getDatastore()->appendToColumn(colQ25, stat5.quantile1);
         plotter->getDatastore()->appendToColumn(colMedian, stat5.median);
         plotter->getDatastore()->appendToColumn(colQ75, stat5.quantile2);
         plotter->getDatastore()->appendToColumn(colMax, stat5.maximum);
         plotter->getDatastore()->appendToColumn(colIQRSig, stat5.IQRSignificanceEstimate());
-        std::fill_n(plotter->getDatastore()->backInserter(colOutlierG), stat5.outliers.size(), jkqtp_todouble(it->first));
+        std::fill_n(plotter->getDatastore()->backInserter(colOutlierG), stat5.outliers.size(), groupeddataBar.groups[g]);
         plotter->getDatastore()->appendToColumn(colOutlierV, stat5.outliers.begin(), stat5.outliers.end());
     }
 
@@ -43,6 +43,15 @@
 #include <QFileDialog>
 #include <QInputDialog>
 #include <QVBoxLayout>
+#include <QThreadPool>
+#include <QThread>
+#include <QRunnable>
+#include <QFontDatabase>
+#include <QPaintEngine>
+#include <QThreadStorage>
+#include <QImageWriter>
+#include <QBuffer>
+#include <functional>
 #ifdef QFWIDLIB_LIBRARY
 #  include "qftools.h"
 #endif
@@ -115,17 +124,34 @@ JKQTBasePlotter::textSizeData JKQTBasePlotter::getTextSizeDetail(const QFont &fm
 JKQTBasePlotter::textSizeData JKQTBasePlotter::getTextSizeDetail(const QString &fontName, double fontSize, const QString &text, QPainter& painter)
 {
     JKQTBasePlotter::textSizeKey  dh(fontName, fontSize, text, painter.device());
-    if (s_TextSizeDataCache.contains(dh)) return s_TextSizeDataCache[dh];
     JKQTBasePlotter::textSizeData d;
+    if (s_TextSizeDataCache.get(dh, d)) return d;
     mathText.setFontRomanOrSpecial(fontName);
     mathText.setFontSize(fontSize);
     mathText.parse(text);
     mathText.getSizeDetail(painter, d.width, d.ascent, d.descent, d.strikeoutPos);
-    s_TextSizeDataCache[dh]=d;
+    s_TextSizeDataCache.put(dh, d);
     //qDebug()<<"+++ textsize hash size: "<<tbrh.size();
     return d;
 }
 
+void JKQTBasePlotter::getTextSizeCacheStatistics(uint64_t &hits, uint64_t &misses, size_t &entries)
+{
+    hits=s_TextSizeDataCache.hits();
+    misses=s_TextSizeDataCache.misses();
+    entries=s_TextSizeDataCache.size();
+}
+
+void JKQTBasePlotter::setTextSizeCacheMaxEntries(size_t maxEntries)
+{
+    s_TextSizeDataCache.setMaxEntries(maxEntries);
+}
+
+void JKQTBasePlotter::clearTextSizeCache()
+{
+    s_TextSizeDataCache.clear();
+}
+
 void JKQTBasePlotter::getTextSizeDetail(const QString &fontName, double fontSize, const QString &text, QPainter &painter, double &width, double &ascent, double &descent, double &strikeoutPos)
 {
     if (!text.isEmpty()) {
@@ -169,6 +195,9 @@ QSizeF JKQTBasePlotter::getTextSizeSize(const QString &fontName, double fontSize
  **************************************************************************************************************************/
 JKQTBasePlotter::JKQTBasePlotter(bool datastore_internal, QObject* parent, JKQTPDatastore* datast):
     QObject(parent), plotterStyle(JKQTPGetSystemDefaultBaseStyle()), m_plotsModel(nullptr), xAxis(nullptr), yAxis(nullptr)
+#if QT_VERSION < QT_VERSION_CHECK(5,14,0)
+    , drawMutex(QMutex::Recursive)
+#endif
 {
     initJKQTBasePlotterResources();
     dataColumnsListWidget=nullptr;
@@ -349,6 +378,7 @@ void JKQTBasePlotter::useExternalDatastore(JKQTPDatastore* newStore){
     }
     datastore=newStore;
     datastoreInternal=false;
+    redrawPlot();
 };
 
 void JKQTBasePlotter::useAsInternalDatastore(JKQTPDatastore* newStore){
@@ -358,7 +388,7 @@ void JKQTBasePlotter::useAsInternalDatastore(JKQTPDatastore* newStore){
     }
     datastore=newStore;
     datastoreInternal=true;
-    if (emitPlotSignals) emit plotUpdated();
+    redrawPlot();
 }
 
 void JKQTBasePlotter::useInternalDatastore(){
@@ -366,7 +396,7 @@ void JKQTBasePlotter::useInternalDatastore(){
         datastore=new JKQTPDatastore();
         datastoreInternal=true;
     }
-    if (emitPlotSignals) emit plotUpdated();
+    redrawPlot();
 }
 
 void JKQTBasePlotter::forceInternalDatastore(){
@@ -376,7 +406,7 @@ void JKQTBasePlotter::forceInternalDatastore(){
     }
     datastore=new JKQTPDatastore();
     datastoreInternal=true;
-    if (emitPlotSignals) emit plotUpdated();
+    redrawPlot();
 }
 
 bool JKQTBasePlotter::isEmittingSignalsEnabled() const {
@@ -394,6 +424,9 @@ void JKQTBasePlotter::initSettings() {
     axisAspectRatio=1;
 
     gridPrinting=false;
+    gridPrintingParallel=false;
+    incrementalDrawing=false;
+    incrementalLayerValid=false;
     gridPrintingList.clear();
     gridPrintingCurrentX=0;
     gridPrintingCurrentY=0;
@@ -565,6 +598,7 @@ void JKQTBasePlotter::setCurrentPlotterStyle(const JKQTBasePlotterStyle &style)
 }
 
 void JKQTBasePlotter::propagateStyle() {
+    incrementalLayerValid=false;
     bool old=emitPlotSignals;
     emitPlotSignals=false;
     xAxis->setCurrentAxisStyle(plotterStyle.xAxisStyle);
@@ -1217,11 +1251,8 @@ void JKQTBasePlotter::drawKey(JKQTPEnhancedPainter& painter) {
 
 
 
-void JKQTBasePlotter::drawPlot(JKQTPEnhancedPainter& painter) {
-#ifdef JKQTBP_AUTOTIMER
-    JKQTPAutoOutputTimer jkaaot("JKQTBasePlotter::paintPlot");
-#endif
-    //qDebug()<<"start JKQTBasePlotter::paintPlot";
+void JKQTBasePlotter::drawPlotBackground(JKQTPEnhancedPainter &painter)
+{
     // draw background
     {
         painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
@@ -1257,7 +1288,10 @@ void JKQTBasePlotter::drawPlot(JKQTPEnhancedPainter& painter) {
     }
 
     drawSystemGrid(painter);
+}
 
+void JKQTBasePlotter::drawPlotLabel(JKQTPEnhancedPainter &painter)
+{
     if (!plotLabel.isEmpty()) {
         mathText.setFontSize(plotterStyle.plotLabelFontSize*fontSizeMultiplier);
         mathText.setFontRomanOrSpecial(plotterStyle.plotLabelFontName);
@@ -1278,12 +1312,32 @@ void JKQTBasePlotter::drawPlot(JKQTPEnhancedPainter& painter) {
 
         }
     }
+}
 
-    painter.setRenderHint(JKQTPEnhancedPainter::Antialiasing, plotterStyle.graphsStyle.useAntiAliasingForGraphs);
-    painter.setRenderHint(JKQTPEnhancedPainter::TextAntialiasing, plotterStyle.useAntiAliasingForText);
-    {
-        painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
-        drawGraphs(painter);
+void JKQTBasePlotter::drawPlot(JKQTPEnhancedPainter& painter) {
+#ifdef JKQTBP_AUTOTIMER
+    JKQTPAutoOutputTimer jkaaot("JKQTBasePlotter::paintPlot");
+#endif
+    //qDebug()<<"start JKQTBasePlotter::paintPlot";
+    // if incremental drawing is active, the background, the grid and the graphs are taken from a cached layer
+    const bool graphLayerDrawn=incrementalDrawing && drawIncrementalGraphLayer(painter);
+    if (!graphLayerDrawn) {
+        drawPlotBackground(painter);
+    } else {
+        painter.setRenderHint(JKQTPEnhancedPainter::NonCosmeticDefaultPen, true);
+        painter.setRenderHint(JKQTPEnhancedPainter::Antialiasing, plotterStyle.useAntiAliasingForSystem);
+        painter.setRenderHint(JKQTPEnhancedPainter::TextAntialiasing, plotterStyle.useAntiAliasingForText);
+    }
+
+    drawPlotLabel(painter);
+
+    if (!graphLayerDrawn) {
+        painter.setRenderHint(JKQTPEnhancedPainter::Antialiasing, plotterStyle.graphsStyle.useAntiAliasingForGraphs);
+        painter.setRenderHint(JKQTPEnhancedPainter::TextAntialiasing, plotterStyle.useAntiAliasingForText);
+        {
+            painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
+            drawGraphs(painter);
+        }
     }
 
     painter.setRenderHint(JKQTPEnhancedPainter::Antialiasing, plotterStyle.useAntiAliasingForSystem);
@@ -1370,6 +1424,7 @@ void JKQTBasePlotter::gridPaint(JKQTPEnhancedPainter& painter, QSizeF pageRect,
 #ifdef JKQTBP_AUTOTIMER
     JKQTPAutoOutputTimer jkaaot("JKQTBasePlotter::gridPaint");
 #endif
+    QMutexLocker locker(&drawMutex);
     calcPlotScaling(painter);
 
     if (!gridPrinting) {
@@ -1417,33 +1472,31 @@ void JKQTBasePlotter::gridPaint(JKQTPEnhancedPainter& painter, QSizeF pageRect,
         painter.scale(scale, scale);
 
         {
-            // plot this plotter
-            painter.save(); auto __finalpaintinner=JKQTPFinally([&painter]() {painter.restore();});
+            // collect this plotter and all the other plotters, together with their positions in the grid
+            QVector<JKQTBasePlotter*> plotters;
+            QVector<QPoint> offsets;
             int t_x=0;
             int t_y=0;
-            //std::cout<<"printing this ...\n";
             for (size_t i=0; i<gridPrintingCurrentX; i++) { t_x+= static_cast<int>(gridPrintingColumns[static_cast<int>(i)]); }
             for (size_t i=0; i<gridPrintingCurrentY; i++) { t_y+= static_cast<int>(gridPrintingRows[static_cast<int>(i)]); }
-            //std::cout<<"printing this @ "<<t_x<<", "<<t_y<<" ...\n";
-            painter.translate(t_x, t_y);
-            drawPlot(painter);
-
-            //std::cout<<"this printed ...\n";
-
-            // plot all the other plotters
+            plotters.append(this);
+            offsets.append(QPoint(t_x, t_y));
             for (int i=0; i< gridPrintingList.size(); i++) {
-                //std::cout<<"printing "<<i<<" ...\n";
-                painter.save(); auto __finalpaintinnerloop=JKQTPFinally([&painter]() {painter.restore();});
                 int gt_x=0;
                 int gt_y=0;
-                //std::cout<<"printing "<<i<<" @g "<<gridPrintingList[i].x<<", "<<gridPrintingList[i].y<<" ...\n";
-                //std::cout<<"colrowlistsizes     "<<gridPrintingColumns.size()<<", "<<gridPrintingRows.size()<<" ...\n";
                 for (size_t j=0; j<gridPrintingList[i].x; j++) {  gt_x+= static_cast<int>(gridPrintingColumns[static_cast<int>(j)]);  }
                 for (size_t j=0; j<gridPrintingList[i].y; j++) {  gt_y+= static_cast<int>(gridPrintingRows[static_cast<int>(j)]); }
-                //std::cout<<"printing "<<i<<" @ "<<t_x<<", "<<t_y<<" ...\n";
-                painter.translate(gt_x, gt_y);
-                gridPrintingList[i].plotter->drawPlot(painter);
+                plotters.append(gridPrintingList[i].plotter);
+                offsets.append(QPoint(t_x+gt_x, t_y+gt_y));
+            }
 
+            // plot all plotters (in parallel, if possible)
+            if (!gridPaintParallel(painter, plotters, offsets)) {
+                for (int i=0; i<plotters.size(); i++) {
+                    painter.save(); auto __finalpaintinnerloop=JKQTPFinally([&painter]() {painter.restore();});
+                    painter.translate(offsets[i]);
+                    plotters[i]->drawPlot(painter);
+                }
             }
 
 
@@ -1462,6 +1515,177 @@ void JKQTBasePlotter::gridPaint(JKQTPEnhancedPainter& painter, QSizeF pageRect,
 
 
 
+namespace {
+    /** \brief a QRunnable that executes a functor, used by JKQTBasePlotter::gridPaintParallel()
+     *  \internal
+     */
+    class JKQTPFunctorRunnable: public QRunnable {
+        public:
+            explicit JKQTPFunctorRunnable(const std::function<void()>& f): m_f(f) {}
+            virtual void run() override { m_f(); }
+        private:
+            std::function<void()> m_f;
+    };
+}
+
+bool JKQTBasePlotter::gridPaintParallel(JKQTPEnhancedPainter &painter, const QVector<JKQTBasePlotter *> &plotters, const QVector<QPoint> &offsets)
+{
+#ifdef JKQTBP_AUTOTIMER
+    JKQTPAutoOutputTimer jkaaot("JKQTBasePlotter::gridPaintParallel");
+#endif
+    if (!gridPrintingParallel || plotters.size()<2 || plotters.size()!=offsets.size()) return false;
+    QPaintDevice* device=painter.device();
+    if (!device || !painter.paintEngine() || painter.paintEngine()->type()!=QPaintEngine::Raster) return false;
+    if (!QFontDatabase::supportsThreadedFontRendering()) return false;
+    // the sub-images can only be composed pixel-exact, if the painter only translates and scales
+    const QTransform trans=painter.combinedTransform();
+    if (trans!=painter.worldTransform() || trans.type()>QTransform::TxScale || trans.m11()<=0.0 || trans.m22()<=0.0) return false;
+    // each plotter may only be drawn by one thread at a time
+    for (int i=0; i<plotters.size(); i++) {
+        if (!plotters[i] || plotters.indexOf(plotters[i])!=i) return false;
+    }
+
+    const double dpr=device->devicePixelRatioF();
+    const int dotsPerMeterX=qRound(static_cast<double>(device->logicalDpiX())/0.0254);
+    const int dotsPerMeterY=qRound(static_cast<double>(device->logicalDpiY())/0.0254);
+    const QFont font=painter.font();
+    const QPainter::RenderHints hints=painter.renderHints();
+
+    QVector<QImage> images(plotters.size());
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(qMax(1, qMin(plotters.size(), QThread::idealThreadCount())));
+        for (int i=0; i<plotters.size(); i++) {
+            JKQTBasePlotter* plt=plotters[i];
+            const QSizeF cellSize(plt->widgetWidth/plt->paintMagnification, plt->widgetHeight/plt->paintMagnification);
+            QImage& img=images[i];
+            img=QImage(qMax(1, static_cast<int>(ceil(cellSize.width()*trans.m11()*dpr))), qMax(1, static_cast<int>(ceil(cellSize.height()*trans.m22()*dpr))), QImage::Format_ARGB32_Premultiplied);
+            // the sub-images need the same resolution as the output, as e.g. JKQTBasePlotter::pt2px() depends on it
+            img.setDotsPerMeterX(dotsPerMeterX);
+            img.setDotsPerMeterY(dotsPerMeterY);
+            img.setDevicePixelRatio(dpr);
+            img.fill(Qt::transparent);
+            pool.start(new JKQTPFunctorRunnable([plt, &img, trans, font, hints]() {
+                JKQTPEnhancedPainter imgPainter(&img);
+                imgPainter.setRenderHints(hints);
+                imgPainter.setFont(font);
+                imgPainter.scale(trans.m11(), trans.m22());
+                plt->drawPlot(imgPainter);
+            }));
+        }
+        pool.waitForDone();
+    }
+
+    // compose the sub-images on the output
+    painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
+    painter.setWorldTransform(QTransform());
+    for (int i=0; i<plotters.size(); i++) {
+        painter.drawImage(QPointF(qRound(trans.dx()+offsets[i].x()*trans.m11()), qRound(trans.dy()+offsets[i].y()*trans.m22())), images[i]);
+    }
+    return true;
+}
+
+namespace {
+    /** \brief render buffers for the headless rendering, see JKQTBasePlotter::grabPixelImage()
+     *  \internal
+     */
+    struct JKQTPHeadlessRenderBuffers {
+        QImage image;
+        QByteArray encoded;
+    };
+    /** \brief one set of render buffers per thread, so several plotters may be rendered concurrently
+     *  \internal
+     */
+    QThreadStorage<JKQTPHeadlessRenderBuffers> headlessRenderBuffers;
+}
+
+void JKQTBasePlotter::drawHeadless(QImage &image, const QSize &size, double dpi)
+{
+#ifdef JKQTBP_AUTOTIMER
+    JKQTPAutoOutputTimer jkaaot("JKQTBasePlotter::drawHeadless");
+#endif
+    QMutexLocker locker(&drawMutex);
+    if (image.size()!=size || image.format()!=QImage::Format_ARGB32_Premultiplied) {
+        image=QImage(size, QImage::Format_ARGB32_Premultiplied);
+    }
+    if (image.isNull()) return;
+    image.setDevicePixelRatio(1.0);
+    image.setDotsPerMeterX(qRound(dpi/0.0254));
+    image.setDotsPerMeterY(qRound(dpi/0.0254));
+    image.fill(Qt::transparent);
+
+    {
+        // switch to the export settings, as in exportpreviewPaintRequested(), but without any GUI interaction
+        const double lw=lineWidthMultiplier;
+        const double fs=fontSizeMultiplier;
+        const double pm=paintMagnification;
+        const QBrush bc=plotterStyle.widgetBackgroundBrush;
+        const bool oldEmitPlotSignals=emitPlotSignals;
+        const int oldWidgetWidth=widgetWidth;
+        const int oldWidgetHeight=widgetHeight;
+        auto __finalsettings=JKQTPFinally([&]() {
+            widgetWidth=oldWidgetWidth;
+            widgetHeight=oldWidgetHeight;
+            emitPlotSignals=oldEmitPlotSignals;
+            lineWidthMultiplier=lw;
+            fontSizeMultiplier=fs;
+            paintMagnification=pm;
+            plotterStyle.widgetBackgroundBrush=bc;
+        });
+        plotterStyle.widgetBackgroundBrush=plotterStyle.exportBackgroundBrush;
+        lineWidthMultiplier=lineWidthPrintMultiplier;
+        fontSizeMultiplier=fontSizePrintMultiplier;
+        paintMagnification=1.0;
+        emitPlotSignals=false;
+        widgetWidth=size.width();
+        widgetHeight=size.height();
+
+        JKQTPEnhancedPainter painter;
+        painter.begin(&image);
+        painter.setRenderHint(JKQTPEnhancedPainter::NonCosmeticDefaultPen, true);
+        painter.setRenderHint(JKQTPEnhancedPainter::Antialiasing);
+        painter.setRenderHint(JKQTPEnhancedPainter::TextAntialiasing);
+        painter.setRenderHint(JKQTPEnhancedPainter::SmoothPixmapTransform);
+        painter.setRenderHint(JKQTPEnhancedPainter::HighQualityAntialiasing);
+        gridPaint(painter, size);
+        painter.end();
+    }
+
+    // the export settings changed the plot scaling (axis ranges in pixels, plot borders, ...), so recalculate it for the
+    // restored widget state, as e.g. x2p()/p2x() are used for mouse interaction. The final output device is not known here,
+    // so the scaling is calculated on a default image (the next redraw on the device recalculates it anyway).
+    QImage scalingImage(1, 1, QImage::Format_ARGB32_Premultiplied);
+    JKQTPEnhancedPainter scalingPainter;
+    scalingPainter.begin(&scalingImage);
+    const bool oldEmitPlotSignals=emitPlotSignals;
+    emitPlotSignals=false;
+    calcPlotScaling(scalingPainter);
+    emitPlotSignals=oldEmitPlotSignals;
+    scalingPainter.end();
+}
+
+QImage JKQTBasePlotter::grabPixelImage(QSize size, double dpi)
+{
+    JKQTPHeadlessRenderBuffers& buffers=headlessRenderBuffers.localData();
+    drawHeadless(buffers.image, size, dpi);
+    return buffers.image;
+}
+
+QByteArray JKQTBasePlotter::grabEncodedImage(QSize size, double dpi, const QByteArray &format, int quality)
+{
+    JKQTPHeadlessRenderBuffers& buffers=headlessRenderBuffers.localData();
+    drawHeadless(buffers.image, size, dpi);
+    if (buffers.image.isNull()) return QByteArray();
+    buffers.encoded.resize(0);
+    QBuffer buffer(&buffers.encoded);
+    if (!buffer.open(QIODevice::WriteOnly)) return QByteArray();
+    QImageWriter writer(&buffer, format);
+    writer.setQuality(quality);
+    if (!writer.write(buffers.image)) return QByteArray();
+    buffer.close();
+    return buffers.encoded;
+}
+
 void JKQTBasePlotter::print(QPrinter* printer, bool displayPreview) {
     loadUserSettings();
     QPrinter* p=printer;
@@ -2085,6 +2309,7 @@ void JKQTBasePlotter::printpreviewPaintRequestedNew(QPaintDevice *paintDevice)
 }
 
 void JKQTBasePlotter::exportpreviewPaintRequested(JKQTPEnhancedPainter &painter, QSize size) {
+    QMutexLocker locker(&drawMutex);
     double lw=lineWidthMultiplier;
     double fs=fontSizeMultiplier;
     QBrush bc=plotterStyle.widgetBackgroundBrush;
@@ -2221,6 +2446,7 @@ void JKQTBasePlotter::draw(JKQTPEnhancedPainter& painter, const QRect& rect) {
 #ifdef JKQTBP_AUTOTIMER
     JKQTPAutoOutputTimer jkaaot(QString("JKQTBasePlotter::draw(rect, %1)"));
 #endif
+    QMutexLocker locker(&drawMutex);
     bool oldEmitPlotSignals=emitPlotSignals;
     emitPlotSignals=false;
 #ifdef JKQTBP_DEBUGTIMING
@@ -2251,6 +2477,7 @@ void JKQTBasePlotter::draw(JKQTPEnhancedPainter& painter, const QPoint& pos) {
 #ifdef JKQTBP_AUTOTIMER
     JKQTPAutoOutputTimer jkaaot(QString("JKQTBasePlotter::draw(pos, %1)"));
 #endif
+    QMutexLocker locker(&drawMutex);
     bool oldEmitPlotSignals=emitPlotSignals;
     emitPlotSignals=false;
 #ifdef JKQTBP_DEBUGTIMING
@@ -2280,6 +2507,7 @@ void JKQTBasePlotter::drawNonGrid(JKQTPEnhancedPainter& painter, const QRect& re
 #ifdef JKQTBP_AUTOTIMER
     JKQTPAutoOutputTimer jkaaot(QString("JKQTBasePlotter::drawNonGrid(rect, %1)"));
 #endif
+    QMutexLocker locker(&drawMutex);
     bool oldEmitPlotSignals=emitPlotSignals;
     emitPlotSignals=false;
 #ifdef JKQTBP_DEBUGTIMING
@@ -2328,6 +2556,7 @@ void JKQTBasePlotter::drawNonGrid(JKQTPEnhancedPainter& painter, const QPoint& p
 #ifdef JKQTBP_AUTOTIMER
     JKQTPAutoOutputTimer jkaaot(QString("JKQTBasePlotter::drawNonGrid(pos)"));
 #endif
+    QMutexLocker locker(&drawMutex);
     bool oldEmitPlotSignals=emitPlotSignals;
     emitPlotSignals=false;
 #ifdef JKQTBP_DEBUGTIMING
@@ -3065,6 +3294,38 @@ bool JKQTBasePlotter::getGridPrinting() const
     return this->gridPrinting;
 }
 
+void JKQTBasePlotter::setGridPrintingParallel(bool __value)
+{
+    this->gridPrintingParallel = __value;
+}
+
+bool JKQTBasePlotter::getGridPrintingParallel() const
+{
+    return this->gridPrintingParallel;
+}
+
+void JKQTBasePlotter::setIncrementalDrawing(bool __value)
+{
+    if (this->incrementalDrawing != __value) {
+        this->incrementalDrawing = __value;
+        incrementalLayerValid=false;
+        if (!__value) {
+            incrementalLayer=QImage();
+            incrementalLayerStates.clear();
+        }
+    }
+}
+
+bool JKQTBasePlotter::isIncrementalDrawing() const
+{
+    return this->incrementalDrawing;
+}
+
+void JKQTBasePlotter::resetIncrementalDrawing()
+{
+    incrementalLayerValid=false;
+}
+
 void JKQTBasePlotter::setGridPrintingCurrentX(size_t __value)
 {
     this->gridPrintingCurrentX = __value;
@@ -4107,6 +4368,133 @@ void JKQTBasePlotter::drawGraphs(JKQTPEnhancedPainter& painter){
     //qDebug()<<"  end JKQTBasePlotter::plotGraphs()";
 }
 
+JKQTBasePlotter::IncrementalLayerKey::IncrementalLayerKey():
+    devicePixelRatio(1), dpiX(0), dpiY(0), widgetWidth(0), widgetHeight(0), paintMagnification(1),
+    xmin(0), xmax(0), ymin(0), ymax(0), xLog(false), yLog(false), xInverted(false), yInverted(false),
+    lineWidthMultiplier(1), fontSizeMultiplier(1)
+{
+
+}
+
+bool JKQTBasePlotter::IncrementalLayerKey::operator==(const IncrementalLayerKey &other) const
+{
+    return transform==other.transform && devicePixelRatio==other.devicePixelRatio && dpiX==other.dpiX && dpiY==other.dpiY
+            && widgetWidth==other.widgetWidth && widgetHeight==other.widgetHeight && paintMagnification==other.paintMagnification
+            && plotRect==other.plotRect && xmin==other.xmin && xmax==other.xmax && ymin==other.ymin && ymax==other.ymax
+            && xLog==other.xLog && yLog==other.yLog && xInverted==other.xInverted && yInverted==other.yInverted
+            && lineWidthMultiplier==other.lineWidthMultiplier && fontSizeMultiplier==other.fontSizeMultiplier
+            && graphs==other.graphs && graphsVisible==other.graphsVisible;
+}
+
+bool JKQTBasePlotter::drawIncrementalGraphLayer(JKQTPEnhancedPainter &painter)
+{
+#ifdef JKQTBP_AUTOTIMER
+    JKQTPAutoOutputTimer jkaaot(QString("JKQTBasePlotter::drawIncrementalGraphLayer"));
+#endif
+    if (!painter.paintEngine() || painter.paintEngine()->type()!=QPaintEngine::Raster || !painter.device()) return false;
+    const QTransform trans=painter.worldTransform();
+    if (painter.combinedTransform()!=trans || trans.type()>QTransform::TxScale || trans.m11()<=0 || trans.m22()<=0) return false;
+
+    QPaintDevice* dev=painter.device();
+    IncrementalLayerKey key;
+    key.transform=trans;
+    key.devicePixelRatio=dev->devicePixelRatioF();
+    key.dpiX=dev->logicalDpiX();
+    key.dpiY=dev->logicalDpiY();
+    key.widgetWidth=widgetWidth;
+    key.widgetHeight=widgetHeight;
+    key.paintMagnification=paintMagnification;
+    key.plotRect=QRectF(internalPlotBorderLeft, internalPlotBorderTop, internalPlotWidth, internalPlotHeight);
+    key.xmin=xAxis->getMin();
+    key.xmax=xAxis->getMax();
+    key.ymin=yAxis->getMin();
+    key.ymax=yAxis->getMax();
+    key.xLog=xAxis->isLogAxis();
+    key.yLog=yAxis->isLogAxis();
+    key.xInverted=xAxis->getInverted();
+    key.yInverted=yAxis->getInverted();
+    key.lineWidthMultiplier=lineWidthMultiplier;
+    key.fontSizeMultiplier=fontSizeMultiplier;
+    key.graphs.reserve(graphs.size());
+    key.graphsVisible.reserve(graphs.size());
+    for (const JKQTPPlotElement* g: graphs) {
+        key.graphs.push_back(g);
+        key.graphsVisible.push_back(g->isVisible());
+    }
+
+    // the layer covers the complete plotter (in device pixels), it is drawn with the same scaling as painter
+    const qreal dpr=key.devicePixelRatio;
+    const QSize layerSize(static_cast<int>(ceil(static_cast<double>(widgetWidth)/paintMagnification*trans.m11()*dpr)), static_cast<int>(ceil(static_cast<double>(widgetHeight)/paintMagnification*trans.m22()*dpr)));
+    if (layerSize.width()<=0 || layerSize.height()<=0) return false;
+
+    auto initLayerPainter=[&](JKQTPEnhancedPainter& lp) {
+        lp.setRenderHints(painter.renderHints());
+        lp.scale(trans.m11(), trans.m22());
+    };
+
+    bool layerDrawn=false;
+    if (incrementalLayerValid && key==incrementalLayerKey && incrementalLayer.size()==layerSize && incrementalLayerStates.size()==graphs.size()) {
+        // only draw the datapoints that were added since the last redraw
+        JKQTPEnhancedPainter lp(&incrementalLayer);
+        if (lp.isActive()) {
+            initLayerPainter(lp);
+            lp.setRenderHint(JKQTPEnhancedPainter::NonCosmeticDefaultPen, true);
+            lp.setRenderHint(JKQTPEnhancedPainter::Antialiasing, plotterStyle.graphsStyle.useAntiAliasingForGraphs);
+            lp.setRenderHint(JKQTPEnhancedPainter::TextAntialiasing, plotterStyle.useAntiAliasingForText);
+            if (useClipping) {
+                QRegion cregion(jkqtp_roundTo<int>(internalPlotBorderLeft), jkqtp_roundTo<int>(internalPlotBorderTop), jkqtp_roundTo<int>(internalPlotWidth), jkqtp_roundTo<int>(internalPlotHeight));
+                lp.setClipping(true);
+                lp.setClipRegion(cregion);
+            }
+            layerDrawn=true;
+            for (int j=0; j<graphs.size(); j++) {
+                JKQTPPlotElement* g=graphs[j];
+                if (g->isVisible() && !g->drawIncremental(lp, incrementalLayerStates[j])) {
+                    layerDrawn=false;
+                    break;
+                }
+            }
+        }
+    }
+    if (!layerDrawn) {
+        // (re)draw the complete layer
+        if (incrementalLayer.size()!=layerSize || incrementalLayer.format()!=QImage::Format_ARGB32_Premultiplied) {
+            incrementalLayer=QImage(layerSize, QImage::Format_ARGB32_Premultiplied);
+        }
+        incrementalLayer.setDevicePixelRatio(dpr);
+        incrementalLayer.setDotsPerMeterX(jkqtp_roundTo<int>(static_cast<double>(key.dpiX)/0.0254));
+        incrementalLayer.setDotsPerMeterY(jkqtp_roundTo<int>(static_cast<double>(key.dpiY)/0.0254));
+        incrementalLayer.fill(Qt::transparent);
+        JKQTPEnhancedPainter lp(&incrementalLayer);
+        if (!lp.isActive()) {
+            incrementalLayerValid=false;
+            return false;
+        }
+        initLayerPainter(lp);
+        drawPlotBackground(lp);
+        lp.setRenderHint(JKQTPEnhancedPainter::Antialiasing, plotterStyle.graphsStyle.useAntiAliasingForGraphs);
+        lp.setRenderHint(JKQTPEnhancedPainter::TextAntialiasing, plotterStyle.useAntiAliasingForText);
+        {
+            lp.save(); auto __finalpaint=JKQTPFinally([&lp]() {lp.restore();});
+            drawGraphs(lp);
+        }
+        incrementalLayerStates.resize(graphs.size());
+        for (int j=0; j<graphs.size(); j++) {
+            graphs[j]->initIncrementalDrawState(incrementalLayerStates[j]);
+        }
+        incrementalLayerKey=key;
+        incrementalLayerValid=true;
+    }
+
+    // compose the layer onto the output in device coordinates, so it is not resampled
+    {
+        painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
+        painter.setWorldTransform(QTransform());
+        painter.drawImage(QPointF(qRound(trans.dx()), qRound(trans.dy())), incrementalLayer);
+    }
+    return true;
+}
+
 
 void JKQTBasePlotter::drawKeyContents(JKQTPEnhancedPainter& painter, double x, double y, double /*width*/, double /*height*/){
 #ifdef JKQTBP_AUTOTIMER
@@ -4137,7 +4525,7 @@ void JKQTBasePlotter::drawKeyContents(JKQTPEnhancedPainter& painter, double x, d
             jkaaot.write(QString("one-col: graph %1: %2").arg(i).arg(g->getTitle()));
 #endif
             if (!g->getTitle().isEmpty() && g->isVisible()) {
-                QSizeF fs=getTextSizeSize(plotterStyle.defaultFontName,plotterStyle.keyStyle.fontSize*fontSizeMultiplier,g->getTitle(),painter);//  mt.getSize(painter);
+                const QSizeF fs=keyLayoutCache.titleSizes.value(i);
                 double itheight=qMax(plotterStyle.keyStyle.itemHeight*kfm.width('X'), fs.height());
                 QRectF markerRect(x, y+1.5*lineWidthMultiplier, plotterStyle.keyStyle.sampleLineLength*kfm.width('X'), itheight-3.0*lineWidthMultiplier);
                 g->drawKeyMarker(painter, markerRect);
@@ -4174,7 +4562,7 @@ void JKQTBasePlotter::drawKeyContents(JKQTPEnhancedPainter& painter, double x, d
             jkaaot.write(QString("one-row: graph %1: %2").arg(i).arg(g->getTitle()));
 #endif
             if (!g->getTitle().isEmpty() && g->isVisible()) {
-                QSizeF fs=getTextSizeSize(plotterStyle.defaultFontName,plotterStyle.keyStyle.fontSize*fontSizeMultiplier,g->getTitle(),painter);//  mt.getSize(painter);
+                const QSizeF fs=keyLayoutCache.titleSizes.value(i);
                 double itheight=qMax(plotterStyle.keyStyle.itemHeight*kfm.width('X'), fs.height());
                 QRectF markerRect(x, y+1.5*lineWidthMultiplier, plotterStyle.keyStyle.sampleLineLength*kfm.width('X'), itheight-3.0*lineWidthMultiplier);
                 g->drawKeyMarker(painter, markerRect);
@@ -4278,12 +4666,76 @@ void JKQTBasePlotter::drawKeyContents(JKQTPEnhancedPainter& painter, double x, d
     painter.setBrush(bold);*/
 
 
+}
+
+JKQTBasePlotter::KeyLayoutCache::KeyLayoutCache():
+    valid(false), dpiX(0), dpiY(0), plotWidth(0), plotHeight(0), fontSize(0), itemWidth(0), itemHeight(0), sampleLineLength(0),
+    xSeparation(0), ySeparation(0), position(JKQTPKeyInsideTopRight), layout(JKQTPKeyLayoutOneColumn), autosize(false),
+    width(0), height(0), textWidth(0), textHeight(0), columns(1), lines(1)
+{
+
 }
 
 void JKQTBasePlotter::getKeyExtent(JKQTPEnhancedPainter& painter, double* width, double* height, double* text_width, double* text_height, int* columns_count, int *lines_count) {
 #ifdef JKQTBP_AUTOTIMER
     JKQTPAutoOutputTimer jkaaot("JKQTBasePlotter::getKeyExtent");
 #endif
+    QFont f=painter.font();
+    f.setFamily(plotterStyle.defaultFontName);
+    f.setPointSizeF(plotterStyle.keyStyle.fontSize*fontSizeMultiplier);
+    const int dpiX=painter.device()?painter.device()->logicalDpiX():0;
+    const int dpiY=painter.device()?painter.device()->logicalDpiY():0;
+    const JKQTPKeyStyle& ks=plotterStyle.keyStyle;
+    bool changed=!keyLayoutCache.valid || keyLayoutCache.titles.size()!=graphs.size() || keyLayoutCache.font!=f
+                 || keyLayoutCache.dpiX!=dpiX || keyLayoutCache.dpiY!=dpiY || keyLayoutCache.plotWidth!=internalPlotWidth || keyLayoutCache.plotHeight!=internalPlotHeight
+                 || keyLayoutCache.fontSize!=ks.fontSize*fontSizeMultiplier || keyLayoutCache.itemWidth!=ks.itemWidth || keyLayoutCache.itemHeight!=ks.itemHeight
+                 || keyLayoutCache.sampleLineLength!=ks.sampleLineLength || keyLayoutCache.xSeparation!=ks.xSeparation || keyLayoutCache.ySeparation!=ks.ySeparation
+                 || keyLayoutCache.position!=ks.position || keyLayoutCache.layout!=ks.layout || keyLayoutCache.autosize!=ks.autosize;
+    for (int i=0; !changed && i<graphs.size(); i++) {
+        changed=(keyLayoutCache.titles[i]!=(graphs[i]->isVisible()?graphs[i]->getTitle():QString()));
+    }
+    if (changed) {
+        keyLayoutCache.valid=false;
+        keyLayoutCache.titles.resize(graphs.size());
+        for (int i=0; i<graphs.size(); i++) {
+            keyLayoutCache.titles[i]=graphs[i]->isVisible()?graphs[i]->getTitle():QString();
+        }
+        keyLayoutCache.titleSizes.fill(QSizeF(), graphs.size());
+        keyLayoutCache.width=0;
+        keyLayoutCache.height=0;
+        keyLayoutCache.textWidth=0;
+        keyLayoutCache.textHeight=0;
+        keyLayoutCache.columns=1;
+        keyLayoutCache.lines=1;
+        calcKeyExtent(painter, &keyLayoutCache.width, &keyLayoutCache.height, &keyLayoutCache.textWidth, &keyLayoutCache.textHeight, &keyLayoutCache.columns, &keyLayoutCache.lines);
+        keyLayoutCache.font=f;
+        keyLayoutCache.dpiX=dpiX;
+        keyLayoutCache.dpiY=dpiY;
+        keyLayoutCache.plotWidth=internalPlotWidth;
+        keyLayoutCache.plotHeight=internalPlotHeight;
+        keyLayoutCache.fontSize=ks.fontSize*fontSizeMultiplier;
+        keyLayoutCache.itemWidth=ks.itemWidth;
+        keyLayoutCache.itemHeight=ks.itemHeight;
+        keyLayoutCache.sampleLineLength=ks.sampleLineLength;
+        keyLayoutCache.xSeparation=ks.xSeparation;
+        keyLayoutCache.ySeparation=ks.ySeparation;
+        keyLayoutCache.position=ks.position;
+        keyLayoutCache.layout=ks.layout;
+        keyLayoutCache.autosize=ks.autosize;
+        keyLayoutCache.valid=true;
+    } else {
+        // calcKeyExtent() leaves the key font set in the painter
+        painter.setFont(f);
+    }
+    if (width) *width=keyLayoutCache.width;
+    if (height) *height=keyLayoutCache.height;
+    if (text_width) *text_width=keyLayoutCache.textWidth;
+    if (text_height) *text_height=keyLayoutCache.textHeight;
+    if (columns_count) *columns_count=keyLayoutCache.columns;
+    if (lines_count) *lines_count=keyLayoutCache.lines;
+}
+
+void JKQTBasePlotter::calcKeyExtent(JKQTPEnhancedPainter& painter, double* width, double* height, double* text_width, double* text_height, int* columns_count, int *lines_count) {
     QFont f=painter.font();
     f.setFamily(plotterStyle.defaultFontName);
     f.setPointSizeF(plotterStyle.keyStyle.fontSize*fontSizeMultiplier);
@@ -4304,6 +4756,7 @@ void JKQTBasePlotter::getKeyExtent(JKQTPEnhancedPainter& painter, double* width,
                 //mt.parse(graphs[i]->getTitle());
                 //QSizeF fs=mt.getSize(painter);
                 QSizeF fs=getTextSizeSize(plotterStyle.defaultFontName, plotterStyle.keyStyle.fontSize*fontSizeMultiplier, graphs[i]->getTitle(), painter);
+                keyLayoutCache.titleSizes[i]=fs;
                 if (fs.width()>w) w=fs.width();
                 if (text_height && fs.height()>*text_height) *text_height=fs.height();
                 h=h+qMax(plotterStyle.keyStyle.itemHeight*kfm.width('X'), fs.height())+plotterStyle.keyStyle.ySeparation*kfm.width('X');
@@ -4335,6 +4788,7 @@ void JKQTBasePlotter::getKeyExtent(JKQTPEnhancedPainter& painter, double* width,
                 //mt.parse(graphs[i]->getTitle());
                 //QSizeF fs=mt.getSize(painter);
                 QSizeF fs=getTextSizeSize(plotterStyle.defaultFontName, plotterStyle.keyStyle.fontSize*fontSizeMultiplier, graphs[i]->getTitle(), painter);
+                keyLayoutCache.titleSizes[i]=fs;
                 if (fs.height()>h) h=fs.height();
                 if (text_width && fs.width()>*text_width) *text_width=fs.width();
                 w=w+fs.width()+(plotterStyle.keyStyle.sampleLineLength+2.0*plotterStyle.keyStyle.xSeparation)*kfm.width('X');
@@ -4371,6 +4825,7 @@ void JKQTBasePlotter::getKeyExtent(JKQTPEnhancedPainter& painter, double* width,
                 //mt.parse(graphs[i]->getTitle());
                 //QSizeF fs=mt.getSize(painter);
                 QSizeF fs=getTextSizeSize(plotterStyle.defaultFontName, plotterStyle.keyStyle.fontSize*fontSizeMultiplier, graphs[i]->getTitle(), painter);
+                keyLayoutCache.titleSizes[i]=fs;
                 if (fs.width()>w) w=fs.width();
                 if ( fs.height()>txtH) txtH=fs.height();
             }
@@ -4954,50 +5409,28 @@ void JKQTBasePlotter::setEmittingSignalsEnabled(bool enabled)
 }
 
 
-QHash<JKQTBasePlotter::textSizeKey, JKQTBasePlotter::textSizeData> JKQTBasePlotter::s_TextSizeDataCache=QHash<JKQTBasePlotter::textSizeKey, JKQTBasePlotter::textSizeData>();
+JKQTPShardedLRUCache<JKQTBasePlotter::textSizeKey, JKQTBasePlotter::textSizeData> JKQTBasePlotter::s_TextSizeDataCache(8192);
 
 JKQTBasePlotter::textSizeKey::textSizeKey(const QFont &f, const QString &text, QPaintDevice *pd):
-    text(), f(), ldpiX(0), ldpiY(0), pdpiX(0), pdpiY(0)
+    textSizeKey(f.family(), f.pointSizeF(), text, pd)
 {
-    this->text=text;
-    this->f=f;
-    if (pd) {
-        ldpiX=pd->logicalDpiX();
-        ldpiY=pd->logicalDpiY();
-        pdpiX=pd->physicalDpiX();
-        pdpiY=pd->physicalDpiY();
-    } else {
-        ldpiX=0;
-        ldpiY=0;
-        pdpiX=0;
-        pdpiY=0;
-    }
 }
 
 JKQTBasePlotter::textSizeKey::textSizeKey(const QString &fontName, double fontSize, const QString &text, QPaintDevice *pd):
-    text(), f(), ldpiX(0), ldpiY(0), pdpiX(0), pdpiY(0)
+    text(text), fontName(fontName), fontSize(fontSize), ldpiX(0), ldpiY(0), pdpiX(0), pdpiY(0), hash(0)
 {
-    QFont f;
-    f.setFamily(fontName);
-    f.setPointSizeF(fontSize);
-    this->text=text;
-    this->f=f;
     if (pd) {
         ldpiX=pd->logicalDpiX();
         ldpiY=pd->logicalDpiY();
         pdpiX=pd->physicalDpiX();
         pdpiY=pd->physicalDpiY();
-    } else {
-        ldpiX=0;
-        ldpiY=0;
-        pdpiX=0;
-        pdpiY=0;
     }
+    hash=qHash(text)^(qHash(fontName)+0x9e3779b9u)^(qHash(fontSize)*31u)^(static_cast<uint>(ldpiX)<<16)^static_cast<uint>(ldpiY);
 }
 
 bool JKQTBasePlotter::textSizeKey::operator==(const JKQTBasePlotter::textSizeKey &other) const
 {
-    return ldpiX==other.ldpiX &&  ldpiY==other.ldpiY && text==other.text && f==other.f;
+    return hash==other.hash && ldpiX==other.ldpiX &&  ldpiY==other.ldpiY && fontSize==other.fontSize && text==other.text && fontName==other.fontName;
 }
 
 
@@ -23,6 +23,7 @@
 #include "jkqtmathtext/jkqtmathtext.h"
 #include "jkqtplotter/jkqtpbaseelements.h"
 #include "jkqtcommon/jkqtpenhancedpainter.h"
+#include "jkqtcommon/jkqtpcachingtools.h"
 #include "jkqtplotter/gui/jkqtpenhancedspinboxes.h"
 
 #include <QObject>
@@ -40,6 +41,12 @@
 #include <QPointer>
 #include <QListWidget>
 #include <QComboBox>
+#include <QMutex>
+#if QT_VERSION >= QT_VERSION_CHECK(5,14,0)
+#  include <QRecursiveMutex>
+#endif
+#include <QImage>
+#include <QTransform>
 
 #include <vector>
 #include <cmath>
@@ -215,6 +222,46 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPPaintDeviceAdapter {
  *   - copyPixelImage()
  * .
  *
+ * \subsection jkqtplotter_base_headless Headless Rendering
+ * For server-side/batch generation of plots, the following functions render the plot (including
+ * \ref JKQTBASEPLOTTER_SYNCMULTIPLOT_GRIDPRINT "grid printing") without any dialogs, user settings or
+ * other interaction with the GUI (they also work with \c QT_QPA_PLATFORM=offscreen , but a QGuiApplication has to exist):
+ *   - grabPixelImage() renders the plot into a QImage with a given size (in pixels) and resolution (in DPI)
+ *   - grabEncodedImage() renders the plot and returns the encoded image file (e.g. PNG) as a QByteArray
+ * .
+ * The headless rendering temporarily changes the widget size, the line width/font size multipliers and the plot scaling of the plotter
+ * (and of its \ref JKQTBASEPLOTTER_SYNCMULTIPLOT_GRIDPRINT "grid printing" sub-plotters). This is not synchronized with the other functions of the plotter
+ * (e.g. zooming or the mouse, resize and paint events of a JKQTPlotter widget), so a plotter that is displayed or modified in the GUI thread must not be
+ * rendered from a worker thread. Instead use a separate plotter instance (with separate sub-plotters) in each worker thread. Several such plotters
+ * may be rendered concurrently in different threads. The render buffers are kept per thread and reused between calls, e.g.
+ * \code
+ *     // in a worker thread, with a plotter that is only used by this thread:
+ *     const QByteArray png=plotter->grabEncodedImage(QSize(800,600), 150, "PNG");
+ * \endcode
+ *
+ * \subsection jkqtplotter_base_incremental Incremental Drawing of Live Data
+ * For live data that is only appended to the datastore (e.g. a data logger), redrawing all graphs on every update is wasteful.
+ * If setIncrementalDrawing() is activated, the plotter keeps the background, the grid and the graphs in a cached layer
+ * and on every redraw only the datapoints, that were appended since the last redraw, are drawn onto this layer. Then the axes, the key and
+ * the plot label are drawn on top. Only graphs that implement JKQTPPlotElement::drawIncremental() (e.g. JKQTPXYLineGraph with unsorted data)
+ * are drawn incrementally, if any visible graph does not support this, the complete layer is redrawn.
+ *
+ * The layer is also redrawn completely, whenever the axis ranges, the widget size, the graphs in the plot or their visibility change,
+ * the datastore is exchanged, the data columns of a graph are replaced or reallocated, after JKQTBasePlotter::redrawPlot() or JKQTPlotter::redrawPlot()
+ * and after resetIncrementalDrawing(). Only JKQTPlotter::redrawPlotIncremental() keeps the layer and draws the appended datapoints.
+ * Changing the style of a graph or any data that was already drawn does not invalidate the layer automatically, so call
+ * resetIncrementalDrawing() (or JKQTPlotter::redrawPlot() ) in these cases.
+ * \code
+ *     plot.getPlotter()->setIncrementalDrawing(true);
+ *     // ... for every new sample:
+ *     ds->appendToColumn(columnX, x);
+ *     ds->appendToColumn(columnY, y);
+ *     plot.redrawPlotIncremental(); // only draws the new line segments, as long as the axis ranges do not change
+ * \endcode
+ *
+ * Incremental drawing is only applied to pixel-image outputs (QPaintEngine::Raster), i.e. the widget and pixel-image export,
+ * all other outputs are always drawn completely.
+ *
  * \subsection jkqtplotter_base_dataexport Exporting Graph Data
  * This class implement a set of function to save the data of the graphs:
  *   - saveData() saves the data of the plot
@@ -313,6 +360,8 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPPaintDeviceAdapter {
  *   - setGridPrintingCurrentX() / setGridPrintingCurrentY() / setGridPrintingCurrentPos()
  *     sets the location of the calling plot inside the grid. <i>By default each plot assumes to be at (0,0).</i>
  *   - clearGridPrintingPlotters() clear all additional plotters for grid printing mode
+ *   - setGridPrintingParallel() when printing/exporting to a pixel image, all plotters of the grid are drawn in parallel
+ *     (each into its own image) and the results are composed afterwards. This is deactivated by default (see gridPrintingParallel for the graphs that may be drawn in parallel).
  * .
  *
  * \see See \ref JKQTPlotterMultiPlotLayout for an extensive example of the functionality.
@@ -642,8 +691,48 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
          */
         void drawNonGrid(JKQTPEnhancedPainter& painter, const QPoint& pos=QPoint(0,0));
 
-        /** \brief emit plotUpdated() */
-        void redrawPlot() { if (emitPlotSignals) emit plotUpdated(); }
+        /*! \brief renders the plot (including grid prints) headless into a QImage of \a size pixels with a resolution of \a dpi
+            \param size size of the output image in pixels
+            \param dpi resolution of the output image, font sizes and line widths (given in pt) are converted to pixels using this value
+
+            This function does not display any dialogs and does not read or write user settings, so it can be used from worker threads,
+            also with \c QT_QPA_PLATFORM=offscreen , but only for plotters that are not used by any other thread at the same time
+            (in particular not for the plotter of a JKQTPlotter widget, see \ref jkqtplotter_base_headless ).
+
+            \note The image buffer is kept per thread and reused by subsequent calls. The returned QImage is an implicitly shared
+                  copy of this buffer, i.e. it does not copy the pixel data. As long as the caller holds the returned image, the
+                  next call in the same thread has to allocate a new buffer (the held image is never overwritten) and modifying the returned
+                  image detaches (copies) it. Release the returned image before the next call, to profit from the buffer reuse.
+
+            \note In grid printing mode, the registered sub-plotters are drawn (and their settings are temporarily changed) too, so they must not be used by another thread at the same time.
+
+            \see \ref jkqtplotter_base_headless, grabEncodedImage()
+         */
+        QImage grabPixelImage(QSize size, double dpi=96.0);
+
+        /*! \brief renders the plot (including grid prints) headless, as grabPixelImage(), and returns the image, encoded as \a format
+            \param size size of the output image in pixels
+            \param dpi resolution of the output image
+            \param format the image format to use (any format supported by QImageWriter, e.g. \c "PNG" or \c "JPEG")
+            \param quality quality for lossy formats (\c 0..100 ), \c -1 uses the default of the format
+            \return the encoded image or an empty QByteArray, if the image could not be encoded
+
+            \see \ref jkqtplotter_base_headless, grabPixelImage()
+         */
+        QByteArray grabEncodedImage(QSize size, double dpi=96.0, const QByteArray& format=QByteArray("PNG"), int quality=-1);
+
+        /** \brief emit plotUpdated() (this also invalidates the cached graph layer of the \ref jkqtplotter_base_incremental "incremental drawing") */
+        void redrawPlot() { incrementalLayerValid=false; if (emitPlotSignals) emit plotUpdated(); }
+
+        /** \copydoc incrementalDrawing */
+        void setIncrementalDrawing(bool __value);
+        /** \copydoc incrementalDrawing */
+        bool isIncrementalDrawing() const;
+        /** \brief invalidates the cached graph layer of the \ref jkqtplotter_base_incremental "incremental drawing", i.e. the next redraw draws all graphs completely
+         *
+         *  Call this after changing the style of a graph or data that has already been drawn.
+         */
+        void resetIncrementalDrawing();
 
         /** \brief controls, whether the signals plotUpdated() are emitted */
         void setEmittingPlotSignalsEnabled(bool __value);
@@ -761,6 +850,10 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
         void setGridPrinting(bool __value);
         /** \copydoc gridPrinting */ 
         bool getGridPrinting() const;
+        /** \copydoc gridPrintingParallel */
+        void setGridPrintingParallel(bool __value);
+        /** \copydoc gridPrintingParallel */
+        bool getGridPrintingParallel() const;
         /** \copydoc gridPrintingCurrentX */ 
         void setGridPrintingCurrentX(size_t __value);
         /** \copydoc gridPrintingCurrentX */ 
@@ -1045,8 +1138,11 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
             explicit textSizeKey(const QFont& f, const QString& text, QPaintDevice *pd);
             explicit textSizeKey(const QString& fontName, double fontSize, const QString& text, QPaintDevice *pd);
             QString text;
-            QFont f;
+            QString fontName;
+            double fontSize;
             int ldpiX, ldpiY, pdpiX, pdpiY;
+            /** \brief hash of the key, calculated once in the constructor (see qHash() ) */
+            uint hash;
 
             bool operator==(const textSizeKey& other) const;
         };
@@ -1062,6 +1158,12 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
          * \internal
          */
         void getTextSizeDetail(const QString& fontName, double fontSize, const QString& text,  QPainter &painter, double& width, double& ascent, double& descent, double& strikeoutPos);
+        /** \brief returns the number of hits and misses and the current number of entries of the (global) cache of getTextSizeDetail() */
+        static void getTextSizeCacheStatistics(uint64_t& hits, uint64_t& misses, size_t& entries);
+        /** \brief sets the maximum number of entries in the (global) cache of getTextSizeDetail() (default: 8192) */
+        static void setTextSizeCacheMaxEntries(size_t maxEntries);
+        /** \brief removes all entries from the (global) cache of getTextSizeDetail() */
+        static void clearTextSizeCache();
         /** \brief calculates a text-size details for the given string \a text if it would be drawn on \a painter with font \a fm
          * \internal
          */
@@ -1575,8 +1677,11 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
          */
         void enableDebugShowRegionBoxes(bool enabled=true);
     protected:
-        /** \brief this is a cache for JKQTBasePlotter::textSizeData calculated with JKQTBasePlotter::getTextSizeDetail() */
-        static QHash<JKQTBasePlotter::textSizeKey, JKQTBasePlotter::textSizeData> s_TextSizeDataCache;
+        /** \brief this is a cache for JKQTBasePlotter::textSizeData calculated with JKQTBasePlotter::getTextSizeDetail()
+         *
+         *  The cache is bounded (least recently used entries are evicted) and thread-safe, as plotters may be drawn in parallel (see gridPrintingParallel).
+         */
+        static JKQTPShardedLRUCache<JKQTBasePlotter::textSizeKey, JKQTBasePlotter::textSizeData> s_TextSizeDataCache;
 
 
 
@@ -1589,6 +1694,18 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
          *  \param painter JKQTPEnhancedPainter to draw on
          */
         void drawPlot(JKQTPEnhancedPainter& painter);
+        /** \brief draws the widget background, the plot background (incl. frame) and the grid */
+        void drawPlotBackground(JKQTPEnhancedPainter& painter);
+        /** \brief draws the plot label above the plot */
+        void drawPlotLabel(JKQTPEnhancedPainter& painter);
+        /** \brief draws the background, the grid and the graphs from the cached graph layer of the \ref jkqtplotter_base_incremental "incremental drawing"
+         *
+         *  If the layer is still valid, only the datapoints added since the last call are drawn onto it (see JKQTPPlotElement::drawIncremental() ),
+         *  otherwise the layer is redrawn completely.
+         *
+         *  \return \c false if \a painter does not draw onto a pixel image with a transformation that only translates and scales (nothing is drawn then)
+         */
+        bool drawIncrementalGraphLayer(JKQTPEnhancedPainter& painter);
         /** \brief simply calls paintPlot() if grid printing mode is deactivated and prints the graph grid otherwise
          *         \a pageRect is used to determine the size of the page to draw on. If this does not coincide with
          *         the widget extents this function calculates a scaling factor so the graphs fit onto the page. This
@@ -1600,6 +1717,25 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
          *  \param scaleIfTooSmall scale image if it is smaller than pageRect
          */
         void gridPaint(JKQTPEnhancedPainter& painter, QSizeF pageRect, bool scaleIfTooLarge=true, bool scaleIfTooSmall=true);
+        /** \brief draws the given \a plotters in parallel, each into its own QImage, and composes them onto \a painter at the given \a offsets
+         *
+         *  This is only possible, if gridPrintingParallel is set, \a painter draws on a pixel image (QPaintEngine::Raster) with a transformation
+         *  that only translates and scales and the platform supports threaded font rendering.
+         *
+         *  \param painter JKQTPEnhancedPainter to draw on
+         *  \param plotters the plotters to draw (each plotter may only occur once)
+         *  \param offsets position of each plotter (in the coordinate system of \a painter )
+         *  \return \c true if the plotters were drawn, \c false if parallel drawing is not possible (nothing was drawn then)
+         *
+         *  \see gridPrintingParallel
+         */
+        bool gridPaintParallel(JKQTPEnhancedPainter& painter, const QVector<JKQTBasePlotter*>& plotters, const QVector<QPoint>& offsets);
+        /** \brief renders the plot (incl. grid prints) with the export settings into \a image of \a size pixels at \a dpi,
+         *         the buffer \a image is only reallocated, if its size or format does not fit
+         *
+         *  \see grabPixelImage(), grabEncodedImage()
+         */
+        void drawHeadless(QImage& image, const QSize& size, double dpi);
 
         /** \brief This method goes through all registered plotters and calculates the width of every column and
          *      height of every row as the max over the row/column. The reults are stored in the private datamembers
@@ -1642,6 +1778,35 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
          * The implementation in here returns zero size!
          */
         void getKeyExtent(JKQTPEnhancedPainter& painter, double *width, double *height, double *text_width=nullptr, double *text_height=nullptr, int *columns_count=nullptr, int* lines_count=nullptr);
+        /** \brief measures the key for getKeyExtent() (all pointers have to be valid) and stores the size of every graph title in keyLayoutCache */
+        void calcKeyExtent(JKQTPEnhancedPainter& painter, double *width, double *height, double *text_width, double *text_height, int *columns_count, int* lines_count);
+        /** \brief the layout of the key, as measured by the last call of getKeyExtent(), and the parameters it depends on \internal
+         *
+         *  getKeyExtent() is called several times per redraw (calcPlotScaling(), drawKey(), drawKeyContents() ), the key is only measured again,
+         *  if the title or visibility of a graph, the key style, the fonts, the plot size or the resolution changed.
+         */
+        struct KeyLayoutCache {
+            KeyLayoutCache();
+            /** \brief \c false, if the key was not measured yet */
+            bool valid;
+            /** \brief titles of the graphs, an empty string for invisible graphs (which are not part of the key) */
+            QVector<QString> titles;
+            /** \brief the key font (as set to the painter by getKeyExtent() ) */
+            QFont font;
+            int dpiX, dpiY;
+            int plotWidth, plotHeight;
+            double fontSize, itemWidth, itemHeight, sampleLineLength, xSeparation, ySeparation;
+            JKQTPKeyPosition position;
+            JKQTPKeyLayout layout;
+            bool autosize;
+            /** \brief results of calcKeyExtent() */
+            double width, height, textWidth, textHeight;
+            int columns, lines;
+            /** \brief size of the title of every graph in the key font, empty for graphs that are not part of the key */
+            QVector<QSizeF> titleSizes;
+        };
+        /** \brief the layout of the key \see getKeyExtent() */
+        KeyLayoutCache keyLayoutCache;
         /** \brief show the print preview window for a given print \a p */
         bool printpreviewNew(QPaintDevice* paintDevice, bool setAbsolutePaperSize=false, double printsizeX_inMM=-1.0, double printsizeY_inMM=-1.0, bool displayPreview=true);
 
@@ -1802,6 +1967,26 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
          * \see \ref JKQTBASEPLOTTER_SYNCMULTIPLOT_GRIDPRINT
          */
         bool gridPrinting;
+        /** \brief indicates whether the plotters in \ref JKQTBASEPLOTTER_SYNCMULTIPLOT_GRIDPRINT "grid printing" mode may be drawn in parallel (default: \c false )
+         *
+         * If activated and the output is a pixel image (i.e. a QPaintEngine::Raster), every plotter of the grid is drawn into its own QImage
+         * by a thread of a QThreadPool and the images are composed onto the output afterwards. For all other outputs (printers, SVG, PDF, ...)
+         * the plotters are drawn one after the other, as before.
+         *
+         * The draw() functions of all graphs of the grid's plotters then run in these threads, so only activate this, if all graphs are safe to draw in parallel:
+         *   - graphs that only read their datastore columns and their own properties while drawing may be used, i.e. the line/scatter graphs (JKQTPXYLineGraph, ...),
+         *     filled curves, impulses, barcharts, boxplots, violin plots, error indicators, images (JKQTPImage, JKQTPColumnMathImage, ...), geometric elements and
+         *     annotations, as well as the live statistics graphs (JKQTPLiveHistogramGraph, JKQTPLiveBoxplotVerticalElement, JKQTPLiveRegressionGraph, ...),
+         *     as they are only updated by an explicit call of their updateStatistics() slot. The datastore (also a shared one) must not be modified, while the grid is drawn.
+         *   - function graphs (JKQTPXFunctionLineGraph, JKQTPYFunctionLineGraph, JKQTPXYFunctionLineGraph, the parsed function graphs, ...) call their
+         *     (user-supplied) functions from the drawing threads. They may only be used, if these functions are reentrant and do not share state with
+         *     functions of graphs in other plotters of the grid.
+         *   - user-defined graphs may only be used, if their draw() does not modify state that is shared with other plotters.
+         *   .
+         *
+         * \see \ref JKQTBASEPLOTTER_SYNCMULTIPLOT_GRIDPRINT, gridPaintParallel()
+         */
+        bool gridPrintingParallel;
         /** \brief x position of the current graph in \ref JKQTBASEPLOTTER_SYNCMULTIPLOT_GRIDPRINT "grid printing"
          *
          * \see \ref JKQTBASEPLOTTER_SYNCMULTIPLOT_GRIDPRINT
@@ -1820,6 +2005,57 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
         QList<size_t> gridPrintingColumns;
         /** \brief size of all plots in \ref JKQTBASEPLOTTER_SYNCMULTIPLOT_GRIDPRINT "grid printing" mode, filled by gridPrintingCalc() */
         QSizeF gridPrintingSize;
+        /** \brief serializes the drawing functions of this plotter with each other (draw(), drawNonGrid(), gridPaint() and the headless rendering, see grabPixelImage() ),
+         *         as drawing temporarily changes the state of the plotter (widget size, multipliers, ...) and updates its caches
+         *
+         *  This mutex is recursive, as the drawing functions call each other. It is not taken by the other functions that change the
+         *  same state (zooming, calcPlotScaling() from the event handlers of JKQTPlotter, ...) and not for the grid printing sub-plotters,
+         *  so it does not make a plotter thread-safe (see \ref jkqtplotter_base_headless ).
+         */
+#if QT_VERSION >= QT_VERSION_CHECK(5,14,0)
+        QRecursiveMutex drawMutex;
+#else
+        QMutex drawMutex;
+#endif
+
+        /** \brief indicates whether graphs are drawn \ref jkqtplotter_base_incremental "incrementally" from a cached graph layer, i.e. whether only appended datapoints are drawn on a redraw (default: \c false )
+         *
+         * \see \ref jkqtplotter_base_incremental
+         */
+        bool incrementalDrawing;
+        /** \brief describes the state of the plotter, for which incrementalLayer was drawn. If any of these properties changes, the layer is redrawn completely. */
+        struct IncrementalLayerKey {
+            IncrementalLayerKey();
+            QTransform transform;
+            qreal devicePixelRatio;
+            int dpiX;
+            int dpiY;
+            int widgetWidth;
+            int widgetHeight;
+            double paintMagnification;
+            QRectF plotRect;
+            double xmin;
+            double xmax;
+            double ymin;
+            double ymax;
+            bool xLog;
+            bool yLog;
+            bool xInverted;
+            bool yInverted;
+            double lineWidthMultiplier;
+            double fontSizeMultiplier;
+            QVector<const JKQTPPlotElement*> graphs;
+            QVector<bool> graphsVisible;
+            bool operator==(const IncrementalLayerKey& other) const;
+        };
+        /** \brief indicates whether incrementalLayer may be reused */
+        bool incrementalLayerValid;
+        /** \brief the state of the plotter, when incrementalLayer was drawn */
+        IncrementalLayerKey incrementalLayerKey;
+        /** \brief cached layer with the background, the grid and the graphs for \ref jkqtplotter_base_incremental "incremental drawing" */
+        QImage incrementalLayer;
+        /** \brief per-graph states of the \ref jkqtplotter_base_incremental "incremental drawing", one entry per element of graphs */
+        QVector<JKQTPIncrementalDrawState> incrementalLayerStates;
 
         /** \brief this is an internal property that is used by the export/print system to control the "magnification". Usually this is 1.0
          *         but if set !=1.0, it is used to scale the widgetWidth and widgetHeight before painting! */
@@ -2131,7 +2367,7 @@ class JKQTPLOTTER_LIB_EXPORT JKQTBasePlotter: public QObject {
  *   \ingroup jkqtpplottersupprt
  */
 inline uint qHash(const JKQTBasePlotter::textSizeKey& data) {
-    return qHash(data.f.family())+qHash(data.text);
+    return data.hash;
 }
 
 #endif // JKQTPBASEPLOTTER_H
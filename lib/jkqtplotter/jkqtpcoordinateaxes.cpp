@@ -30,6 +30,23 @@
 //#undef SHOW_JKQTPLOTTER_DEBUG
 //#define SHOW_JKQTPLOTTER_DEBUG
 
+namespace {
+    /** \brief formats \a data with \a past_comma digits in the system locale (without group separators) and removes trailing zeros after the decimal point */
+    QString jkqtpFloatToDefaultTickLabel(double data, int past_comma) {
+        QLocale loc=QLocale::system();
+        loc.setNumberOptions(QLocale::OmitGroupSeparator);
+        QString res=loc.toString(data, 'f', past_comma);
+        const QChar decimalPoint=loc.decimalPoint();
+        if (res.contains(decimalPoint)) {
+            int len=res.size();
+            while (len>0 && res[len-1]=='0') len--;
+            if (len>0 && res[len-1]==decimalPoint) len--;
+            res.truncate(len);
+        }
+        return res;
+    }
+}
+
 JKQTPCoordinateAxis::JKQTPCoordinateAxis(JKQTBasePlotter* _parent):
     QObject(_parent),
     paramsChanged(true),
@@ -56,7 +73,10 @@ JKQTPCoordinateAxis::JKQTPCoordinateAxis(JKQTBasePlotter* _parent):
     tickSpacingLog(10),
     axisLabel(),
     axisPrefix(),
-    scaleSign(1)
+    scaleSign(1),
+    x2pOffset(0),
+    x2pFactor(0),
+    x2pLogMin(0)
 {
 
 }
@@ -65,6 +85,34 @@ JKQTPCoordinateAxis::~JKQTPCoordinateAxis() {
 
 }
 
+JKQTPCoordinateAxis::TickCalculationParams::TickCalculationParams():
+    valid(false), axismin(0), axismax(0), logAxisBase(0), userTickSpacing(0), userLogTickSpacing(0),
+    logAxis(false), autoAxisSpacing(false), autoLabelDigits(false), tickMode(JKQTPLTMLinOrPower),
+    labelType(JKQTPCALTdefault), minTicks(0), labelDigits(0), resultTickStart(0), resultTickSpacing(0), resultTickSpacingLog(0), resultLabelDigits(0)
+{
+
+}
+
+bool JKQTPCoordinateAxis::TickCalculationParams::operator==(const TickCalculationParams &other) const
+{
+    return valid==other.valid && axismin==other.axismin && axismax==other.axismax && logAxisBase==other.logAxisBase
+            && userTickSpacing==other.userTickSpacing && userLogTickSpacing==other.userLogTickSpacing && logAxis==other.logAxis
+            && autoAxisSpacing==other.autoAxisSpacing && autoLabelDigits==other.autoLabelDigits && tickMode==other.tickMode
+            && labelType==other.labelType && minTicks==other.minTicks && labelDigits==other.labelDigits;
+}
+
+JKQTPCoordinateAxis::TickLabelCacheParams::TickLabelCacheParams():
+    valid(false), labelType(JKQTPCALTdefault), labelDigits(0), belowIsZero(0)
+{
+
+}
+
+bool JKQTPCoordinateAxis::TickLabelCacheParams::operator==(const TickLabelCacheParams &other) const
+{
+    return valid==other.valid && labelType==other.labelType && labelDigits==other.labelDigits && belowIsZero==other.belowIsZero
+            && tickDateFormat==other.tickDateFormat && tickTimeFormat==other.tickTimeFormat && tickDateTimeFormat==other.tickDateTimeFormat;
+}
+
 void JKQTPCoordinateAxis::setParent(JKQTBasePlotter* parent) {
     this->parent=parent;
     QObject::setParent(parent);
@@ -364,73 +412,68 @@ double JKQTPCoordinateAxis::calcLogTickSpacing() {
 QString JKQTPCoordinateAxis::floattolabel(double data) const {
     int past_comma=axisStyle.labelDigits;
     const bool remove_trail0=true;
-    QLocale loc=QLocale::system();
-    loc.setNumberOptions(QLocale::OmitGroupSeparator);
 
     double belowIsZero=1e-300;
     if (!getLogAxis()) {
         belowIsZero=fabs(getMax()-getMin())*1e-6;
     }
 
+    TickLabelCacheParams params;
+    params.valid=true;
+    params.labelType=axisStyle.labelType;
+    params.labelDigits=past_comma;
+    params.belowIsZero=belowIsZero;
+    params.tickDateFormat=axisStyle.tickDateFormat;
+    params.tickTimeFormat=axisStyle.tickTimeFormat;
+    params.tickDateTimeFormat=axisStyle.tickDateTimeFormat;
+    if (params==tickLabelCacheParams) {
+        auto it=tickLabelCache.constFind(data);
+        if (it!=tickLabelCache.constEnd()) return it.value();
+    } else {
+        tickLabelCache.clear();
+        tickLabelCacheParams=params;
+    }
+
+    QString res;
     switch(axisStyle.labelType) {
         case JKQTPCALTdefault: {
-                QString res=loc.toString(data, 'f', past_comma);
-                if (remove_trail0 && res.contains(QLocale::system().decimalPoint())) {
-                    while (res.size()>0 && res[res.size()-1]=='0') {
-                        res=res.left(res.size()-1);
-                    }
-                    if (res.size()>0 && res[res.size()-1]==loc.decimalPoint()) res=res.left(res.size()-1);
-                }
-                return res;
+                res=jkqtpFloatToDefaultTickLabel(data, past_comma);
             }; break;
         case JKQTPCALTexponent: {
-                return QString(jkqtp_floattolatexstr(data, past_comma, remove_trail0, belowIsZero, pow(10, -past_comma), pow(10, past_comma+1)).c_str());
+                res=QString::fromStdString(jkqtp_floattolatexstr(data, past_comma, remove_trail0, belowIsZero, pow(10, -past_comma), pow(10, past_comma+1)));
             }; break;
         case JKQTPCALTexponentCharacter: {
-                return QString(jkqtp_floattounitstr(data, past_comma, remove_trail0).c_str());
+                res=QString::fromStdString(jkqtp_floattounitstr(data, past_comma, remove_trail0));
             }; break;
         case JKQTPCALTdate: {
                 QDateTime dt;
                 dt.setMSecsSinceEpoch(uint64_t(data));
-                return dt.toString(axisStyle.tickDateFormat);
+                res=dt.toString(axisStyle.tickDateFormat);
             }; break;
         case JKQTPCALTtime: {
                 QDateTime dt;
                 dt.setMSecsSinceEpoch(uint64_t(data));
-                return dt.toString(axisStyle.tickTimeFormat);
+                res=dt.toString(axisStyle.tickTimeFormat);
             }; break;
         case JKQTPCALTdatetime: {
                 QDateTime dt;
                 dt.setMSecsSinceEpoch(uint64_t(data));
-                return dt.toString(axisStyle.tickDateTimeFormat);
+                res=dt.toString(axisStyle.tickDateTimeFormat);
             }; break;
         default:
-            return QString();
             break;
     }
 
-    /*
-    axisStyle.tickTimeFormat
-    axisStyle.tickDateFormat
-    axisStyle.tickDateTimeFormat
-     **/
-
-    return QString();
+    // panning an axis creates new tick positions for the same parameters, so the cache is bounded
+    if (tickLabelCache.size()>=1024) tickLabelCache.clear();
+    tickLabelCache.insert(data, res);
+    return res;
 }
 
 QString JKQTPCoordinateAxis::floattolabel(double data, int past_comma) const {
     bool remove_trail0=true;
-    QLocale loc=QLocale::system();
-    loc.setNumberOptions(QLocale::OmitGroupSeparator);
     if (axisStyle.labelType==JKQTPCALTdefault) {
-        QString res=loc.toString(data, 'f', past_comma);//QString::number(data, 'f', past_comma);
-        if (remove_trail0 && res.contains(QLocale::system().decimalPoint())) {
-            while (res.size()>0 && res[res.size()-1]=='0') {
-                res=res.left(res.size()-1);
-            }
-            if (res.size()>0 && res[res.size()-1]==loc.decimalPoint()) res=res.left(res.size()-1);
-        }
-        return res;
+        return jkqtpFloatToDefaultTickLabel(data, past_comma);
     } else if (axisStyle.labelType==JKQTPCALTexponent) return QString(jkqtp_floattolatexstr(data, past_comma, remove_trail0, 1e-300, pow(10, -past_comma), pow(10, past_comma+1)).c_str());
     else if (axisStyle.labelType==JKQTPCALTexponentCharacter) return QString(jkqtp_floattounitstr(data, past_comma, remove_trail0).c_str());
     return "";
@@ -522,11 +565,37 @@ void JKQTPCoordinateAxis::calcPlotScaling(bool force) {
         }
 
     }
+    updateTransformation();
 #ifdef SHOW_JKQTPLOTTER_DEBUG
     //qDebug()<<getParent()->objectName()<<":  offset     = "<<offset;
     //qDebug()<<getParent()->objectName()<<":  scale      = "<<scale;
     //qDebug()<<getParent()->objectName()<<":  scaleSign  = "<<scaleSign;
 #endif
+    // the tick positions and label digits only depend on the range and the tick settings,
+    // so they are only recalculated if these changed (e.g. not for a resize of the plot)
+    TickCalculationParams tickParams;
+    tickParams.valid=true;
+    tickParams.axismin=axismin;
+    tickParams.axismax=axismax;
+    tickParams.logAxisBase=logAxisBase;
+    tickParams.userTickSpacing=userTickSpacing;
+    tickParams.userLogTickSpacing=userLogTickSpacing;
+    tickParams.logAxis=logAxis;
+    tickParams.autoAxisSpacing=autoAxisSpacing;
+    tickParams.autoLabelDigits=axisStyle.autoLabelDigits;
+    tickParams.tickMode=axisStyle.tickMode;
+    tickParams.labelType=axisStyle.labelType;
+    tickParams.minTicks=axisStyle.minTicks;
+    tickParams.labelDigits=axisStyle.autoLabelDigits?0:axisStyle.labelDigits;
+    if (tickParams==tickCalculationParams) {
+        tickStart=tickCalculationParams.resultTickStart;
+        tickSpacing=tickCalculationParams.resultTickSpacing;
+        tickSpacingLog=tickCalculationParams.resultTickSpacingLog;
+        axisStyle.labelDigits=tickCalculationParams.resultLabelDigits;
+        paramsChanged=false;
+        return;
+    }
+
     // now we try to find a suitable tick and grid line spacing so that
     // between maxTicks and axisStyle.minTicks ticks fit into twidth
     // if autoXAxisSpacing/autoYAxisSpacing is false then the spacing properties
@@ -568,6 +637,11 @@ void JKQTPCoordinateAxis::calcPlotScaling(bool force) {
 
 
     axisStyle.labelDigits=calcLinearUnitDigits();
+    tickParams.resultTickStart=tickStart;
+    tickParams.resultTickSpacing=tickSpacing;
+    tickParams.resultTickSpacingLog=tickSpacingLog;
+    tickParams.resultLabelDigits=axisStyle.labelDigits;
+    tickCalculationParams=tickParams;
 #ifdef SHOW_JKQTPLOTTER_DEBUG
     //qDebug()<<"    tickStart="<<tickStart<<"\n";
     //qDebug()<<"    tickSpacing="<<tickSpacing<<"\n";
@@ -577,6 +651,35 @@ void JKQTPCoordinateAxis::calcPlotScaling(bool force) {
 
 }
 
+void JKQTPCoordinateAxis::updateTransformation()
+{
+    x2pOffset=offset;
+    x2pFactor=scaleSign*scale;
+    if (logAxis) x2pFactor/=log(logAxisBase);
+    if (inverted) {
+        // mirror at the center of the plot: 2*plotOffset+plotWidth-r
+        x2pOffset=2.0*getParentPlotOffset()+getParentPlotWidth()-x2pOffset;
+        x2pFactor=-x2pFactor;
+    }
+    x2pLogMin=x2pOffset+x2pFactor*log(axismin);
+}
+
+void JKQTPCoordinateAxis::x2p(const double *x, double *p, size_t n) const
+{
+    const double a=x2pOffset;
+    const double b=x2pFactor;
+    if (logAxis) {
+        const double pmin=x2pLogMin;
+        for (size_t i=0; i<n; i++) {
+            p[i]=(x[i]<=0)?pmin:(a+b*log(x[i]));
+        }
+    } else {
+        for (size_t i=0; i<n; i++) {
+            p[i]=a+b*x[i];
+        }
+    }
+}
+
 bool JKQTPCoordinateAxis::isLogAxis() const {
     return logAxis;// || (axisStyle.tickMode==JKQTPLTMPower);
 }
@@ -836,6 +939,7 @@ void JKQTPCoordinateAxis::setShowZeroAxis(bool __value) {
 
 void JKQTPCoordinateAxis::setInverted(bool __value) {
     this->inverted = __value;
+    updateTransformation();
     this->paramsChanged=true;
     redrawPlot();
 }
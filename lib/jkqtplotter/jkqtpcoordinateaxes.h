@@ -27,6 +27,7 @@
 #include <QString>
 #include <QPainter>
 #include <QPair>
+#include <QHash>
 #include <QSettings>
 #include "jkqtplotter/jkqtptools.h"
 #include "jkqtmathtext/jkqtmathtext.h"
@@ -103,6 +104,9 @@ class JKQTBasePlotter;
 
     The object implements the above coordinate transformations in the (inline) method x2p(). The inverse transformations
     are implemented in p2x(). They can be used to show the system coordinates of the current mouse position.
+    All constants of these transformations (including \f$ 1/\log(\mbox{logXAxisBase}) \f$ and the mirroring of inverted axes)
+    are combined into one offset and one factor by calcPlotScaling(), so x2p() is a single multiply-add (plus one \c log() for
+    logarithmic axes). The overload x2p(const double*, double*, size_t) transforms whole arrays of coordinates at once.
 
 
     \section jkqtplotter_coordinateaxes_inverted Inverted Coordinate Axes
@@ -173,31 +177,26 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPCoordinateAxis: public QObject {
 
         /** \brief return x-pixel coordinate from time coordinate */
         inline double x2p(double x) const {
-            double r=0;
             if (logAxis) {
-                if (x<=0) r= offset+scaleSign*log(axismin)/log(logAxisBase)*scale;
-                else r= offset+scaleSign*log(x)/log(logAxisBase)*scale;
-            } else {
-                r= offset+scaleSign*x*scale;
-            }
-            if (inverted) {
-                return 2.0*getParentPlotOffset()+getParentPlotWidth()-r;//getParentPlotOffset()+getParentPlotWidth()-(r-getParentPlotOffset());
-            } else {
-                return r;
+                if (x<=0) return x2pLogMin;
+                return x2pOffset+x2pFactor*log(x);
             }
+            return x2pOffset+x2pFactor*x;
         }
 
+        /** \brief transforms the \a n coordinates in \a x into pixel coordinates and stores them in \a p (same results as x2p(double) for every element)
+         *
+         *  The loops contain no calls and (for linear axes) no branches, so they can be vectorized by the compiler.
+         */
+        void x2p(const double* x, double* p, size_t n) const;
+
         /** \brief return time coordinate coordinate from x-pixel */
         inline double p2x(double x) const {
-            double xx=x;
-            if (inverted) {
-                xx=2.0*getParentPlotOffset()+getParentPlotWidth()-x;
-            }
-            xx=xx-offset;
+            const double t=(x-x2pOffset)/x2pFactor;
             if (logAxis) {
-                return exp(log(logAxisBase)*(xx)/(scaleSign*scale));
+                return exp(t);
             } else {
-                return xx/(scaleSign*scale);
+                return t;
             }
         }
 
@@ -588,7 +587,7 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPCoordinateAxis: public QObject {
         const JKQTMathText* getParentMathText() const;
 
 
-        /** \brief convert a float to a tick label string */
+        /** \brief convert a float to a tick label string, the results are cached in tickLabelCache */
         QString floattolabel(double data) const;
 
         /** \brief convert a float to a tick label string with a given precision */
@@ -715,12 +714,68 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPCoordinateAxis: public QObject {
          */
         int calcLinearUnitDigits();
 
+        /** \brief parameters, from which calcPlotScaling() determines tickStart, tickSpacing, tickSpacingLog and the label digits
+         *
+         * These are only recalculated, if one of the parameters changed since the last call, otherwise the stored results are reused.
+         */
+        struct TickCalculationParams {
+            TickCalculationParams();
+            /** \brief \c false, if no tick calculation happened yet */
+            bool valid;
+            double axismin, axismax, logAxisBase, userTickSpacing, userLogTickSpacing;
+            bool logAxis, autoAxisSpacing, autoLabelDigits;
+            JKQTPLabelTickMode tickMode;
+            JKQTPCALabelType labelType;
+            unsigned int minTicks;
+            int labelDigits;
+            /** \brief results of the calculation for these parameters (not compared by operator==() ) */
+            double resultTickStart, resultTickSpacing, resultTickSpacingLog;
+            /** \brief resulting JKQTPCoordinateAxisStyle::labelDigits (not compared by operator==() ) */
+            int resultLabelDigits;
+            bool operator==(const TickCalculationParams& other) const;
+        };
+        /** \brief parameters and results of the last tick calculation in calcPlotScaling() */
+        TickCalculationParams tickCalculationParams;
+
+        /** \brief parameters, which determine the output of floattolabel(double), tickLabelCache is valid for these parameters */
+        struct TickLabelCacheParams {
+            TickLabelCacheParams();
+            /** \brief \c false, if tickLabelCache was not filled yet */
+            bool valid;
+            JKQTPCALabelType labelType;
+            int labelDigits;
+            double belowIsZero;
+            QString tickDateFormat, tickTimeFormat, tickDateTimeFormat;
+            bool operator==(const TickLabelCacheParams& other) const;
+        };
+        /** \brief parameters, for which tickLabelCache was filled */
+        mutable TickLabelCacheParams tickLabelCacheParams;
+        /** \brief cache of the labels returned by floattolabel(double) for the current tickLabelCacheParams, so redrawing an unchanged axis does not format any numbers */
+        mutable QHash<double, QString> tickLabelCache;
+
 
 
         /** \brief axis prefix for storage of parameters */
         QString axisPrefix;
         /** \brief this is used by x2p() and p2x() to determine the sign */
         double scaleSign;
+        /** \brief <b>calculated property:</b> x2p() returns <code>x2pOffset+x2pFactor*x</code> (linear axes) or <code>x2pOffset+x2pFactor*log(x)</code> (logarithmic axes)
+         *
+         * \see updateTransformation()
+         */
+        double x2pOffset;
+        /** \brief <b>calculated property:</b> factor of the transformation in x2p(), includes scaleSign, the inversion and \f$ 1/\log(\mbox{logAxisBase}) \f$
+         *
+         * \see updateTransformation()
+         */
+        double x2pFactor;
+        /** \brief <b>calculated property:</b> result of x2p() for values <=0 on logarithmic axes (i.e. the position of axismin)
+         *
+         * \see updateTransformation()
+         */
+        double x2pLogMin;
+        /** \brief calculates x2pOffset, x2pFactor and x2pLogMin from offset, scale, scaleSign, inverted and logAxisBase */
+        void updateTransformation();
 
         /** \brief calculates the next label from the given parameters.
          *
@@ -149,6 +149,16 @@ void JKQTPPlotElement::drawOutside(JKQTPEnhancedPainter& /*painter*/, QRect /*le
 
 }
 
+void JKQTPPlotElement::initIncrementalDrawState(JKQTPIncrementalDrawState &state) const
+{
+    state=JKQTPIncrementalDrawState();
+}
+
+bool JKQTPPlotElement::drawIncremental(JKQTPEnhancedPainter &/*painter*/, JKQTPIncrementalDrawState &/*state*/)
+{
+    return false;
+}
+
 
 QString JKQTPPlotElement::formatHitTestDefaultLabel(double x, double y, int index, JKQTPDatastore* datastore) const {
     const JKQTPXGraphErrorData* errgx=dynamic_cast<const JKQTPXGraphErrorData*>(this);
@@ -233,22 +243,34 @@ double JKQTPPlotElement::transformY(double y) const {
 QVector<double> JKQTPPlotElement::transformX(const QVector<double>& x) const {
     QVector<double> res;
     res.resize(x.size());
-    for (int i=0; i<x.size(); i++) {
-        res[i]=parent->getXAxis()->x2p(x[i]);
-    }
+    parent->getXAxis()->x2p(x.constData(), res.data(), static_cast<size_t>(x.size()));
     return res;
 }
 
 QVector<double> JKQTPPlotElement::transformY(const QVector<double>& y) const {
     QVector<double> res;
     res.resize(y.size());
-    for (int i=0; i<y.size(); i++) {
-        res[i]=parent->getYAxis()->x2p(y[i]);
-    }
+    parent->getYAxis()->x2p(y.constData(), res.data(), static_cast<size_t>(y.size()));
     return res;
 }
 
 
+void JKQTPPlotElement::getVisibleDataWindow(double &xmin, double &xmax, double &ymin, double &ymax, double marginPx) const
+{
+    const double px1=transformX(parent->getXAxis()->getMin());
+    const double px2=transformX(parent->getXAxis()->getMax());
+    const double x1=backtransformX(qMin(px1, px2)-marginPx);
+    const double x2=backtransformX(qMax(px1, px2)+marginPx);
+    xmin=qMin(x1, x2);
+    xmax=qMax(x1, x2);
+    const double py1=transformY(parent->getYAxis()->getMin());
+    const double py2=transformY(parent->getYAxis()->getMax());
+    const double y1=backtransformY(qMin(py1, py2)-marginPx);
+    const double y2=backtransformY(qMax(py1, py2)+marginPx);
+    ymin=qMin(y1, y2);
+    ymax=qMax(y1, y2);
+}
+
 double JKQTPPlotElement::backtransformX(double x) const {
     return parent->getXAxis()->p2x(x);
 }
@@ -620,26 +642,23 @@ void JKQTPXYGraph::intSortData()
 
     QVector<double> datas;
 
-    if (sortData==JKQTPXYLineGraph::SortedX) {
-
-        for (int i=0; i<imax; i++) {
-            double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
-            sortedIndices<<i;
-            datas<<xv;
-        }
-
-        jkqtpQuicksortDual(datas.data(), sortedIndices.data(), datas.size());
-
-
-    } else if (sortData==JKQTPXYLineGraph::SortedY) {
-
+    if (sortData==JKQTPXYLineGraph::SortedX || sortData==JKQTPXYLineGraph::SortedY) {
+        const size_t column=static_cast<size_t>((sortData==JKQTPXYLineGraph::SortedX)?xColumn:yColumn);
+        // NaN values have no order, so they are moved behind all other values and only the other values are sorted
+        // (getVisibleIndexRanges() relies on this order for its binary search)
+        QVector<int> nanIndices;
         for (int i=0; i<imax; i++) {
-            double xv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
-            sortedIndices<<i;
-            datas<<xv;
+            double xv=datastore->get(column,static_cast<size_t>(i));
+            if (std::isnan(xv)) {
+                nanIndices<<i;
+            } else {
+                sortedIndices<<i;
+                datas<<xv;
+            }
         }
 
         jkqtpQuicksortDual(datas.data(), sortedIndices.data(), datas.size());
+        sortedIndices<<nanIndices;
     }
 }
 
@@ -666,6 +685,129 @@ bool JKQTPXYGraph::getIndexRange(int& imin, int& imax) const
 
 
 
+const int JKQTPXYGraph::VISIBILITY_BLOCK_SIZE=256;
+
+JKQTPXYGraph::VisibilityBlockBox::VisibilityBlockBox():
+    hasX(false), hasY(false), xmin(0), xmax(0), ymin(0), ymax(0)
+{
+
+}
+
+void JKQTPXYGraph::VisibilityBlockBox::add(double x, double y)
+{
+    if (JKQTPIsOKFloat(x)) {
+        if (!hasX || x<xmin) xmin=x;
+        if (!hasX || x>xmax) xmax=x;
+        hasX=true;
+    }
+    if (JKQTPIsOKFloat(y)) {
+        if (!hasY || y<ymin) ymin=y;
+        if (!hasY || y>ymax) ymax=y;
+        hasY=true;
+    }
+}
+
+QVector<QPair<int, int> > JKQTPXYGraph::getVisibleIndexRanges(int imin, int imax, bool connectedPoints, double marginPx, bool cullX, bool cullY, bool includeNeighbours) const
+{
+    QVector<QPair<int,int> > ranges;
+    if (imax<=imin) return ranges;
+    if (parent==nullptr || (!cullX && !cullY) || xColumn<0 || yColumn<0) {
+        ranges<<qMakePair(imin, imax);
+        return ranges;
+    }
+    const JKQTPDatastore* datastore=parent->getDatastore();
+    double xmin=0, xmax=0, ymin=0, ymax=0;
+    getVisibleDataWindow(xmin, xmax, ymin, ymax, marginPx);
+    if (!JKQTPIsOKFloat(xmin) || !JKQTPIsOKFloat(xmax)) cullX=false;
+    if (!JKQTPIsOKFloat(ymin) || !JKQTPIsOKFloat(ymax)) cullY=false;
+    if (!cullX && !cullY) {
+        ranges<<qMakePair(imin, imax);
+        return ranges;
+    }
+    const auto valueAt=[&](int column, int iii) -> double {
+        return datastore->get(static_cast<size_t>(column),static_cast<size_t>(qBound(imin, getDataIndex(iii), imax)));
+    };
+
+    if ((sortData==SortedX && cullX) || (sortData==SortedY && cullY)) {
+        // sorted data: binary search for the visible range along the sorted axis
+        // (intSortData() moves NaN values behind all other values, so they are treated as larger than any value)
+        const int column=(sortData==SortedX)?xColumn:yColumn;
+        const double lower=(sortData==SortedX)?xmin:ymin;
+        const double upper=(sortData==SortedX)?xmax:ymax;
+        int a=imin;
+        int b=imax;
+        while (a<b) {
+            const int m=a+(b-a)/2;
+            const double v=valueAt(column, m);
+            if (!std::isnan(v) && v<lower) a=m+1;
+            else b=m;
+        }
+        int first=a;
+        b=imax;
+        while (a<b) {
+            const int m=a+(b-a)/2;
+            const double v=valueAt(column, m);
+            if (!std::isnan(v) && v<=upper) a=m+1;
+            else b=m;
+        }
+        int last=a;
+        if (connectedPoints || includeNeighbours) {
+            // in sorted data the neighbours along the sorted axis are also the neighbouring indices
+            first=qMax(imin, first-1);
+            last=qMin(imax, last+1);
+        }
+        if (last>first) ranges<<qMakePair(first, last);
+        return ranges;
+    }
+
+    if (includeNeighbours) {
+        // unsorted data: extend the window up to the closest datapoint outside of it
+        double xbelow=xmin, xabove=xmax, ybelow=ymin, yabove=ymax;
+        bool hasXBelow=false, hasXAbove=false, hasYBelow=false, hasYAbove=false;
+        for (int iii=imin; iii<imax; iii++) {
+            if (cullX) {
+                const double xv=valueAt(xColumn, iii);
+                if (JKQTPIsOKFloat(xv)) {
+                    if (xv<xmin && (!hasXBelow || xv>xbelow)) { xbelow=xv; hasXBelow=true; }
+                    if (xv>xmax && (!hasXAbove || xv<xabove)) { xabove=xv; hasXAbove=true; }
+                }
+            }
+            if (cullY) {
+                const double yv=valueAt(yColumn, iii);
+                if (JKQTPIsOKFloat(yv)) {
+                    if (yv<ymin && (!hasYBelow || yv>ybelow)) { ybelow=yv; hasYBelow=true; }
+                    if (yv>ymax && (!hasYAbove || yv<yabove)) { yabove=yv; hasYAbove=true; }
+                }
+            }
+        }
+        xmin=xbelow; xmax=xabove;
+        ymin=ybelow; ymax=yabove;
+    }
+
+    // unsorted data: skip blocks of datapoints, whose bounding box lies outside the visible window.
+    // If points are connected, each block also contains the first point of the next block,
+    // so its bounding box also contains the line segment connecting the two blocks
+    for (int start=imin; start<imax; start+=VISIBILITY_BLOCK_SIZE) {
+        const int end=qMin(start+VISIBILITY_BLOCK_SIZE, imax);
+        const int endExt=connectedPoints?qMin(end+1, imax):end;
+        VisibilityBlockBox box;
+        for (int iii=start; iii<endExt; iii++) {
+            box.add(cullX?valueAt(xColumn, iii):0.0, cullY?valueAt(yColumn, iii):0.0);
+        }
+        const bool visible=(!cullX || (box.hasX && box.xmax>=xmin && box.xmin<=xmax)) && (!cullY || (box.hasY && box.ymax>=ymin && box.ymin<=ymax));
+        if (visible) {
+            if (ranges.size()>0 && start<=ranges.last().second) {
+                ranges.last().second=qMax(ranges.last().second, endExt);
+            } else {
+                ranges<<qMakePair(start, endExt);
+            }
+        }
+    }
+    return ranges;
+}
+
+
+
 JKQTPGeometricPlotElement::JKQTPGeometricPlotElement(DrawMode drawMode, JKQTBasePlotter *parent):
     JKQTPPlotElement(parent), m_drawMode(drawMode)
 {
@@ -137,6 +137,24 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPPlotElement: public QObject {
          */
         virtual void drawOutside(JKQTPEnhancedPainter& painter, QRect leftSpace, QRect rightSpace, QRect topSpace, QRect bottomSpace);
 
+        /*! \brief fills \a state so it describes the graph as it was drawn by the last call to draw() (for incremental drawing)
+
+            The default implementation marks \a state as invalid, i.e. the graph does not support incremental drawing.
+
+            \see drawIncremental(), JKQTBasePlotter::setIncrementalDrawing()
+         */
+        virtual void initIncrementalDrawState(JKQTPIncrementalDrawState& state) const;
+
+        /*! \brief draws only the parts of the graph that were added after \a state (e.g. datapoints appended to the data columns)
+                   on top of the graph as drawn before and updates \a state
+
+            \return \c false if incremental drawing is not possible (e.g. the data was modified and not only appended), the
+                    graph has to be redrawn completely with draw() then. The default implementation always returns \c false .
+
+            \see initIncrementalDrawState(), JKQTBasePlotter::setIncrementalDrawing()
+         */
+        virtual bool drawIncremental(JKQTPEnhancedPainter& painter, JKQTPIncrementalDrawState& state);
+
         /** \brief modes of operation for the function hitTest() */
         enum HitTestMode {
             HitTestXY,      /*!< \brief find closest point in x- and y-direction simulatneously (i.e. measure direct distance) */
@@ -258,6 +276,13 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPPlotElement: public QObject {
         /** \brief transform all y-coordinates in a vector \a x */
         QVector<double> transformY(const QVector<double>& x) const;
 
+        /** \brief returns the range of x- and y-values (plot coordinates) that is visible in the plot area, extended by \a marginPx pixels on every side
+         *
+         *  Graphs can use this to skip datapoints that lie outside the plot area before transforming and painting them.
+         *  \a marginPx should cover everything that is drawn around a datapoint (e.g. half the symbol size).
+         */
+        void getVisibleDataWindow(double& xmin, double& xmax, double& ymin, double& ymax, double marginPx=0) const;
+
 
     protected:
 
@@ -657,6 +682,52 @@ protected:
      *  \return \c true on success and \c false if the information is not available
      */
     virtual bool getIndexRange(int &imin, int &imax) const;
+
+    /** \brief number of consecutive datapoints that getVisibleIndexRanges() combines into one bounding block, when the data is not sorted */
+    static const int VISIBILITY_BLOCK_SIZE;
+
+    /** \brief determines the runs of datapoints in the range [\a imin , \a imax ) that may be visible in the plot area.
+     *
+     *  The returned ranges are half-open intervals <code>[first, last)</code> of indices into the SORTED datapoints, i.e. they have to be
+     *  converted with getDataIndex() (so call intSortData() first). Iterating over the returned ranges instead of
+     *  <code>[imin, imax)</code> lets the drawing cost scale with the number of visible points, instead of with the size of the dataset.
+     *
+     *  - If the data is sorted along the culled axis (sortData \c ==SortedX or \c ==SortedY), the visible range is found by a binary search
+     *    (intSortData() sorts NaN values behind all other values, so they do not break the search).
+     *  - Otherwise the datapoints are grouped into blocks of VISIBILITY_BLOCK_SIZE points and blocks, whose bounding box
+     *    does not intersect the (extended) plot area, are skipped. The bounding boxes are calculated anew on every call, as the datastore
+     *    does not track modifications of the column contents.
+     *  .
+     *
+     *  \param imin first datapoint (index into the sorted datapoints)
+     *  \param imax one behind the last datapoint (index into the sorted datapoints)
+     *  \param connectedPoints if \c true, consecutive points are connected by lines, so every returned range also contains the points
+     *                         directly before and after the visible points. In that case line segments that cross the border of the plot area are kept intact.
+     *                         If a range ends, the connecting line has to be interrupted.
+     *  \param marginPx the visible area is extended by this number of pixels on all sides (e.g. to take the symbol size into account)
+     *  \param cullX take the x-coordinate (xColumn) into account for culling
+     *  \param cullY take the y-coordinate (yColumn) into account for culling
+     *  \param includeNeighbours extends the visible range along each culled axis up to the next datapoint outside it (needed e.g. by barcharts, whose width depends on the neighboring datapoints).
+     *                           For sorted data this simply widens the result of the binary search by one index on each side, for unsorted data
+     *                           the closest datapoints outside the window have to be searched in all datapoints.
+     */
+    QVector<QPair<int,int> > getVisibleIndexRanges(int imin, int imax, bool connectedPoints, double marginPx=0, bool cullX=true, bool cullY=true, bool includeNeighbours=false) const;
+    friend class JKQTPGraphErrorStyleMixin;
+private:
+    /** \internal
+     *  \brief bounding box of one block of VISIBILITY_BLOCK_SIZE datapoints, used by getVisibleIndexRanges() for unsorted data
+     *         (x- and y-range are tracked separately, as invalid values may occur in only one of them) */
+    struct VisibilityBlockBox {
+        VisibilityBlockBox();
+        /** \brief extends the box by the datapoint \a x , \a y (invalid coordinates are ignored) */
+        void add(double x, double y);
+        bool hasX;
+        bool hasY;
+        double xmin;
+        double xmax;
+        double ymin;
+        double ymax;
+    };
 };
 
 
@@ -301,232 +301,265 @@ void JKQTPGraphErrorStyleMixin::intPlotXYErrorIndicators(JKQTPEnhancedPainter& p
     QList<QColor> errFC, errC;
     bool defaultErrorColor=true;
 
+    // error indicators of single datapoints, whose error box lies completely outside the plot area, are skipped
+    // (not for error styles that connect the datapoints with lines or polygons)
+    const auto isConnectedErrorStyle=[](JKQTPErrorPlotstyle style) {
+        return style==JKQTPErrorLines || style==JKQTPErrorPolygons || style==JKQTPErrorBarsLines || style==JKQTPErrorBarsPolygons || style==JKQTPErrorSimpleBarsLines || style==JKQTPErrorSimpleBarsPolygons;
+    };
+    const bool cullErrors=!isConnectedErrorStyle(xErrorStyle) && !isConnectedErrorStyle(yErrorStyle);
+    double visXMin=0, visXMax=0, visYMin=0, visYMax=0;
+    if (cullErrors) {
+        parentGraph->getVisibleDataWindow(visXMin, visXMax, visYMin, visYMax, ebs_px/2.0+p.widthF());
+    }
 
 
-    for (size_t iii=imin; iii<imax; iii++) {
-        int i=static_cast<int>(iii);
-        if (dataorder) i=dataorder->value(static_cast<int>(iii), static_cast<int>(iii));
-        const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
-        const double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
-
-        double deltax=1;
-        double deltapx=0;
-        double deltamx=0;
-        if (imin==imax) { // only one x-value
-            deltamx=0.5;
-            deltapx=0.5;
-        } else if (static_cast<int>(i)==static_cast<int>(imax)-1&& static_cast<int>(i)-1>=0) { // the right-most x-value
-            deltapx=deltamx=fabs(xv-datastore->get(xColumn,static_cast<size_t>(i-1)))/2.0;
-        } else if (i==static_cast<int>(imin) && i+1<static_cast<int>(imax)) { // the left-most x-value
-            deltamx=deltapx=fabs(datastore->get(xColumn,static_cast<size_t>(i+1))-xv)/2.0;
-        } else {
-            if (static_cast<int>(i)-1>=0) deltamx=fabs(xv-datastore->get(xColumn,static_cast<size_t>(i-1)))/2.0;
-            if (i+1<static_cast<int>(imax)) deltapx=fabs(datastore->get(xColumn,static_cast<size_t>(i+1))-xv)/2.0;
-        }
-        deltax=deltapx+deltamx;
-
-        double deltay=1;
-        double deltapy=0;
-        double deltamy=0;
-        if (imin==imax) { // only one y-value
-            deltamy=0.5;
-            deltapy=0.5;
-        } else if (i==static_cast<int>(imax)-1&& static_cast<int>(i)-1>=0) { // the right-most y-value
-            deltapy=deltamy=fabs(yv-datastore->get(yColumn,static_cast<size_t>(i-1)))/2.0;
-        } else if (i==static_cast<int>(imin) && i+1<static_cast<int>(imax)) { // the left-most y-value
-            deltamy=deltapy=fabs(datastore->get(yColumn,static_cast<size_t>(i+1))-yv)/2.0;
-        } else {
-            if (static_cast<int>(i)-1>=0) deltamy=fabs(yv-datastore->get(yColumn,static_cast<size_t>(i-1)))/2.0;
-            if (i+1<static_cast<int>(imax)) deltapy=fabs(datastore->get(yColumn,static_cast<size_t>(i+1))-yv)/2.0;
-        }
-        deltay=deltapy+deltamy;
-
-        bool plotlowerbarx=false;
-        bool plotupperbarx=false;
-        bool plotlowerbary=false;
-        bool plotupperbary=false;
-
-        double xe=0;   if (xErrorStyle!=JKQTPNoError && xErrorColumn>=0) { xe=datastore->get(xErrorColumn,static_cast<size_t>(i)); plotupperbarx=true; }
-        double ye=0;   if (yErrorStyle!=JKQTPNoError && yErrorColumn>=0) { ye=datastore->get(yErrorColumn,static_cast<size_t>(i)); plotupperbary=true; }
-        double xl=0;   if (xErrorSymmetric) { xl=xe; plotlowerbarx=plotupperbarx||(xl>0); }
-                       else if (xErrorStyle!=JKQTPNoError && xErrorColumnLower>=0) { xl=datastore->get(xErrorColumnLower,static_cast<size_t>(i)); plotlowerbarx=true; }
-        double yl=0;   if (yErrorSymmetric) { yl=ye; plotlowerbary=plotupperbary||(yl>0); }
-                       else if (yErrorStyle!=JKQTPNoError && yErrorColumnLower>=0) { yl=datastore->get(yErrorColumnLower,static_cast<size_t>(i)); plotlowerbary=true; }
-        if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv) && JKQTPIsOKFloat(xe) && JKQTPIsOKFloat(ye) && JKQTPIsOKFloat(xl) && JKQTPIsOKFloat(yl)) {
-            double x=parentGraph->transformX(xv+xrelshift*deltax); bool xok=JKQTPIsOKFloat(x);
-            double y=parentGraph->transformY(yv+yrelshift*deltay); bool yok=JKQTPIsOKFloat(y);
-            QColor terrCol=getErrorLineColor();
-            QColor terrFillCol=getErrorFillColor();
-            defaultErrorColor = defaultErrorColor && !this->intPlotXYErrorIndicatorsGetColor(painter, parent, parentGraph, xColumn, yColumn, xErrorColumn, yErrorColumn, xErrorStyle, yErrorStyle, i, terrCol, terrFillCol);
-
-            // x-errorpolygons
-            if (/*pastFirst &&*/ (xErrorStyle==JKQTPErrorPolygons || xErrorStyle==JKQTPErrorBarsPolygons || xErrorStyle==JKQTPErrorSimpleBarsPolygons)) {
-                double xl2m=parentGraph->transformX(xv+xrelshift*deltax-xl);
-                double xl2p=parentGraph->transformX(xv+xrelshift*deltax+xe);
-                double yl2=y;
-
-                polyXTopPoints<<QPointF(xl2p, yl2);
-                polyXBottomPoints<<QPointF(xl2m, yl2);
-                errFC<<terrFillCol;
-                errC<<terrCol;
+    // if the error indicators do not extend along an axis, whole runs of datapoints outside the plot area can be skipped
+    // along that axis (using the binary search/block culling of JKQTPXYGraph::getVisibleIndexRanges())
+    QVector<QPair<int,int> > visibleRanges;
+    visibleRanges<<qMakePair(static_cast<int>(imin), static_cast<int>(imax));
+    const JKQTPXYGraph* xyGraph=dynamic_cast<const JKQTPXYGraph*>(parentGraph);
+    if (cullErrors && xyGraph && xyGraph->xColumn==xColumn && xyGraph->yColumn==yColumn && ((dataorder==nullptr && xyGraph->sortData==JKQTPXYGraph::Unsorted) || dataorder==&(xyGraph->sortedIndices))) {
+        const bool cullX=!visX && xrelshift==0.0;
+        const bool cullY=!visY && yrelshift==0.0;
+        if (cullX || cullY) visibleRanges=xyGraph->getVisibleIndexRanges(static_cast<int>(imin), static_cast<int>(imax), false, ebs_px/2.0+p.widthF(), cullX, cullY);
+    }
+
+    for (const auto& range: visibleRanges) {
+        for (size_t iii=static_cast<size_t>(range.first); iii<static_cast<size_t>(range.second); iii++) {
+            int i=static_cast<int>(iii);
+            if (dataorder) i=dataorder->value(static_cast<int>(iii), static_cast<int>(iii));
+            const double xv=datastore->get(static_cast<size_t>(xColumn),static_cast<size_t>(i));
+            const double yv=datastore->get(static_cast<size_t>(yColumn),static_cast<size_t>(i));
+
+            double deltax=1;
+            double deltapx=0;
+            double deltamx=0;
+            if (imin==imax) { // only one x-value
+                deltamx=0.5;
+                deltapx=0.5;
+            } else if (static_cast<int>(i)==static_cast<int>(imax)-1&& static_cast<int>(i)-1>=0) { // the right-most x-value
+                deltapx=deltamx=fabs(xv-datastore->get(xColumn,static_cast<size_t>(i-1)))/2.0;
+            } else if (i==static_cast<int>(imin) && i+1<static_cast<int>(imax)) { // the left-most x-value
+                deltamx=deltapx=fabs(datastore->get(xColumn,static_cast<size_t>(i+1))-xv)/2.0;
+            } else {
+                if (static_cast<int>(i)-1>=0) deltamx=fabs(xv-datastore->get(xColumn,static_cast<size_t>(i-1)))/2.0;
+                if (i+1<static_cast<int>(imax)) deltapx=fabs(datastore->get(xColumn,static_cast<size_t>(i+1))-xv)/2.0;
+            }
+            deltax=deltapx+deltamx;
+
+            double deltay=1;
+            double deltapy=0;
+            double deltamy=0;
+            if (imin==imax) { // only one y-value
+                deltamy=0.5;
+                deltapy=0.5;
+            } else if (i==static_cast<int>(imax)-1&& static_cast<int>(i)-1>=0) { // the right-most y-value
+                deltapy=deltamy=fabs(yv-datastore->get(yColumn,static_cast<size_t>(i-1)))/2.0;
+            } else if (i==static_cast<int>(imin) && i+1<static_cast<int>(imax)) { // the left-most y-value
+                deltamy=deltapy=fabs(datastore->get(yColumn,static_cast<size_t>(i+1))-yv)/2.0;
+            } else {
+                if (static_cast<int>(i)-1>=0) deltamy=fabs(yv-datastore->get(yColumn,static_cast<size_t>(i-1)))/2.0;
+                if (i+1<static_cast<int>(imax)) deltapy=fabs(datastore->get(yColumn,static_cast<size_t>(i+1))-yv)/2.0;
             }
+            deltay=deltapy+deltamy;
+
+            bool plotlowerbarx=false;
+            bool plotupperbarx=false;
+            bool plotlowerbary=false;
+            bool plotupperbary=false;
+
+            double xe=0;   if (xErrorStyle!=JKQTPNoError && xErrorColumn>=0) { xe=datastore->get(xErrorColumn,static_cast<size_t>(i)); plotupperbarx=true; }
+            double ye=0;   if (yErrorStyle!=JKQTPNoError && yErrorColumn>=0) { ye=datastore->get(yErrorColumn,static_cast<size_t>(i)); plotupperbary=true; }
+            double xl=0;   if (xErrorSymmetric) { xl=xe; plotlowerbarx=plotupperbarx||(xl>0); }
+                           else if (xErrorStyle!=JKQTPNoError && xErrorColumnLower>=0) { xl=datastore->get(xErrorColumnLower,static_cast<size_t>(i)); plotlowerbarx=true; }
+            double yl=0;   if (yErrorSymmetric) { yl=ye; plotlowerbary=plotupperbary||(yl>0); }
+                           else if (yErrorStyle!=JKQTPNoError && yErrorColumnLower>=0) { yl=datastore->get(yErrorColumnLower,static_cast<size_t>(i)); plotlowerbary=true; }
+            if (JKQTPIsOKFloat(xv) && JKQTPIsOKFloat(yv) && JKQTPIsOKFloat(xe) && JKQTPIsOKFloat(ye) && JKQTPIsOKFloat(xl) && JKQTPIsOKFloat(yl)) {
+                double x=parentGraph->transformX(xv+xrelshift*deltax); bool xok=JKQTPIsOKFloat(x);
+                double y=parentGraph->transformY(yv+yrelshift*deltay); bool yok=JKQTPIsOKFloat(y);
+                QColor terrCol=getErrorLineColor();
+                QColor terrFillCol=getErrorFillColor();
+                defaultErrorColor = defaultErrorColor && !this->intPlotXYErrorIndicatorsGetColor(painter, parent, parentGraph, xColumn, yColumn, xErrorColumn, yErrorColumn, xErrorStyle, yErrorStyle, i, terrCol, terrFillCol);
+                if (cullErrors) {
+                    // skip error indicators, whose error box lies completely outside the plot area (after the color was evaluated, so defaultErrorColor does not depend on the visible area)
+                    const double xc=xv+xrelshift*deltax;
+                    const double yc=yv+yrelshift*deltay;
+                    const double exmin=qMin(xc, qMin(xc-xl, xc+xe));
+                    const double exmax=qMax(xc, qMax(xc-xl, xc+xe));
+                    const double eymin=qMin(yc, qMin(yc-yl, yc+ye));
+                    const double eymax=qMax(yc, qMax(yc-yl, yc+ye));
+                    if (exmax<visXMin || exmin>visXMax || eymax<visYMin || eymin>visYMax) continue;
+                }
 
-            // y-errorpolygons
-            if (/*pastFirst &&*/ (yErrorStyle==JKQTPErrorPolygons || yErrorStyle==JKQTPErrorBarsPolygons || yErrorStyle==JKQTPErrorSimpleBarsPolygons)) {
+                // x-errorpolygons
+                if (/*pastFirst &&*/ (xErrorStyle==JKQTPErrorPolygons || xErrorStyle==JKQTPErrorBarsPolygons || xErrorStyle==JKQTPErrorSimpleBarsPolygons)) {
+                    double xl2m=parentGraph->transformX(xv+xrelshift*deltax-xl);
+                    double xl2p=parentGraph->transformX(xv+xrelshift*deltax+xe);
+                    double yl2=y;
 
-                double yl2m=parentGraph->transformY(yv+yrelshift*deltay-yl);
-                double yl2p=parentGraph->transformY(yv+yrelshift*deltay+ye);
-                double xl2=x;
+                    polyXTopPoints<<QPointF(xl2p, yl2);
+                    polyXBottomPoints<<QPointF(xl2m, yl2);
+                    errFC<<terrFillCol;
+                    errC<<terrCol;
+                }
 
-                polyYTopPoints<<QPointF(xl2, yl2p);
-                polyYBottomPoints<<QPointF(xl2, yl2m);
-                errFC<<terrFillCol;
-                errC<<terrCol;
-            }
+                // y-errorpolygons
+                if (/*pastFirst &&*/ (yErrorStyle==JKQTPErrorPolygons || yErrorStyle==JKQTPErrorBarsPolygons || yErrorStyle==JKQTPErrorSimpleBarsPolygons)) {
 
+                    double yl2m=parentGraph->transformY(yv+yrelshift*deltay-yl);
+                    double yl2p=parentGraph->transformY(yv+yrelshift*deltay+ye);
+                    double xl2=x;
 
-            //x-errorbars
-            if ((xErrorColumn>=0 || xErrorColumnLower>=0) && (xErrorStyle==JKQTPErrorBars || xErrorStyle==JKQTPErrorBarsLines|| xErrorStyle==JKQTPErrorBarsPolygons
-                || xErrorStyle==JKQTPErrorSimpleBars || xErrorStyle==JKQTPErrorSimpleBarsLines|| xErrorStyle==JKQTPErrorSimpleBarsPolygons)) {
-                    double x0=parentGraph->transformX(xv+xrelshift*deltax-xl); bool x0ok=JKQTPIsOKFloat(x0);
-                    double x1=parentGraph->transformX(xv+xrelshift*deltax+xe); bool x1ok=JKQTPIsOKFloat(x1);
-                    painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
-                    QPen pp=p;
-                    if (!defaultErrorColor) pp.setColor(terrCol);
-                    painter.setPen(pp);
-                    if (x0ok&&x1ok&&xok&&yok) {
-                        painter.drawLine(QLineF(x0, y, x1, y));
-                        if (xErrorStyle==JKQTPErrorBars || xErrorStyle==JKQTPErrorBarsLines|| xErrorStyle==JKQTPErrorBarsPolygons) {
-                            if (plotlowerbarx) painter.drawLine(QLineF(x0,y-ebs_px/2.0,x0,y+ebs_px/2.0));
-                            if (plotupperbarx) painter.drawLine(QLineF(x1,y-ebs_px/2.0,x1,y+ebs_px/2.0));
-                        }
-                    } else if (x0ok&&!x1ok&&xok&&yok) {
-                        painter.drawLine(QLineF(x0, y, x, y));
-                        if (xErrorStyle==JKQTPErrorBars || xErrorStyle==JKQTPErrorBarsLines|| xErrorStyle==JKQTPErrorBarsPolygons) {
-                            if (plotlowerbarx) painter.drawLine(QLineF(x0,y-ebs_px/2.0,x0,y+ebs_px/2.0));
+                    polyYTopPoints<<QPointF(xl2, yl2p);
+                    polyYBottomPoints<<QPointF(xl2, yl2m);
+                    errFC<<terrFillCol;
+                    errC<<terrCol;
+                }
+
+
+                //x-errorbars
+                if ((xErrorColumn>=0 || xErrorColumnLower>=0) && (xErrorStyle==JKQTPErrorBars || xErrorStyle==JKQTPErrorBarsLines|| xErrorStyle==JKQTPErrorBarsPolygons
+                    || xErrorStyle==JKQTPErrorSimpleBars || xErrorStyle==JKQTPErrorSimpleBarsLines|| xErrorStyle==JKQTPErrorSimpleBarsPolygons)) {
+                        double x0=parentGraph->transformX(xv+xrelshift*deltax-xl); bool x0ok=JKQTPIsOKFloat(x0);
+                        double x1=parentGraph->transformX(xv+xrelshift*deltax+xe); bool x1ok=JKQTPIsOKFloat(x1);
+                        painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
+                        QPen pp=p;
+                        if (!defaultErrorColor) pp.setColor(terrCol);
+                        painter.setPen(pp);
+                        if (x0ok&&x1ok&&xok&&yok) {
+                            painter.drawLine(QLineF(x0, y, x1, y));
+                            if (xErrorStyle==JKQTPErrorBars || xErrorStyle==JKQTPErrorBarsLines|| xErrorStyle==JKQTPErrorBarsPolygons) {
+                                if (plotlowerbarx) painter.drawLine(QLineF(x0,y-ebs_px/2.0,x0,y+ebs_px/2.0));
+                                if (plotupperbarx) painter.drawLine(QLineF(x1,y-ebs_px/2.0,x1,y+ebs_px/2.0));
+                            }
+                        } else if (x0ok&&!x1ok&&xok&&yok) {
+                            painter.drawLine(QLineF(x0, y, x, y));
+                            if (xErrorStyle==JKQTPErrorBars || xErrorStyle==JKQTPErrorBarsLines|| xErrorStyle==JKQTPErrorBarsPolygons) {
+                                if (plotlowerbarx) painter.drawLine(QLineF(x0,y-ebs_px/2.0,x0,y+ebs_px/2.0));
+                            }
+                            if (x0<x) painter.drawLine(QLineF(x,y,parentGraph->transformX(parent->getXMax()),y));
+                            else painter.drawLine(QLineF(x,y,parentGraph->transformX(parent->getXMin()),y));
+                        } else if (!x0ok&&x1ok&&xok&&yok) {
+                            painter.drawLine(QLineF(x1, y, x, y));
+                            if (xErrorStyle==JKQTPErrorBars || xErrorStyle==JKQTPErrorBarsLines|| xErrorStyle==JKQTPErrorBarsPolygons) {
+                                if (plotupperbarx) painter.drawLine(QLineF(x1,y-ebs_px/2.0,x1,y+ebs_px/2.0));
+                            }
+                            if (x1<x) painter.drawLine(QLineF(x,y,parentGraph->transformX(parent->getXMin()),y));
+                            else painter.drawLine(QLineF(x,y,parentGraph->transformX(parent->getXMax()),y));
                         }
-                        if (x0<x) painter.drawLine(QLineF(x,y,parentGraph->transformX(parent->getXMax()),y));
-                        else painter.drawLine(QLineF(x,y,parentGraph->transformX(parent->getXMin()),y));
-                    } else if (!x0ok&&x1ok&&xok&&yok) {
-                        painter.drawLine(QLineF(x1, y, x, y));
-                        if (xErrorStyle==JKQTPErrorBars || xErrorStyle==JKQTPErrorBarsLines|| xErrorStyle==JKQTPErrorBarsPolygons) {
-                            if (plotupperbarx) painter.drawLine(QLineF(x1,y-ebs_px/2.0,x1,y+ebs_px/2.0));
+
+                    }
+                    // y-errorbars
+                    if ((yErrorColumn>=0 || yErrorColumnLower>=0) && (yErrorStyle==JKQTPErrorBars || yErrorStyle==JKQTPErrorBarsLines || yErrorStyle==JKQTPErrorBarsPolygons
+                        || yErrorStyle==JKQTPErrorSimpleBars || yErrorStyle==JKQTPErrorSimpleBarsLines || yErrorStyle==JKQTPErrorSimpleBarsPolygons)) {
+                        double y0=parentGraph->transformY(yv+yrelshift*deltay-yl); bool y0ok=JKQTPIsOKFloat(y0);
+                        double y1=parentGraph->transformY(yv+yrelshift*deltay+ye); bool y1ok=JKQTPIsOKFloat(y1);
+                        painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
+                        QPen pp=p;
+                        if (!defaultErrorColor) pp.setColor(terrCol);
+                        painter.setPen(pp);
+                        if (y0ok&&y1ok&&xok&&yok) {
+                            painter.drawLine(QLineF(x, y0, x, y1));
+                            if (yErrorStyle==JKQTPErrorBars || yErrorStyle==JKQTPErrorBarsLines || yErrorStyle==JKQTPErrorBarsPolygons) {
+                                if (plotlowerbary) painter.drawLine(QLineF(x-ebs_px/2.0,y0,x+ebs_px/2.0,y0));
+                                if (plotupperbary) painter.drawLine(QLineF(x-ebs_px/2.0,y1,x+ebs_px/2.0,y1));
+                            }
+                        } else if (y0ok&&!y1ok&&xok&&yok) {   // upper errorbar OK, lower errorbar NAN
+                            painter.drawLine(QLineF(x, y0, x, y));
+                            if (yErrorStyle==JKQTPErrorBars || yErrorStyle==JKQTPErrorBarsLines || yErrorStyle==JKQTPErrorBarsPolygons) {
+                                if (plotlowerbary) painter.drawLine(QLineF(x-ebs_px/2.0,y0,x+ebs_px/2.0,y0));
+                            }
+                            if (y0<y) painter.drawLine(QLineF(x,y,x,parentGraph->transformY(parent->getYMin())));
+                            else painter.drawLine(QLineF(x,y,x,parentGraph->transformY(parent->getYMax()))); // inverted axis!
+                        } else if (!y0ok&&y1ok&&xok&&yok) {
+                            painter.drawLine(QLineF(x, y1, x, y));
+                            if (yErrorStyle==JKQTPErrorBars || yErrorStyle==JKQTPErrorBarsLines || yErrorStyle==JKQTPErrorBarsPolygons) {
+                                if (plotupperbary) painter.drawLine(QLineF(x-ebs_px/2.0,y1,x+ebs_px/2.0,y1));
+                            }
+                            if (y1<y) painter.drawLine(QLineF(x,y,x,parentGraph->transformY(parent->getYMax())));
+                            else painter.drawLine(QLineF(x,y,x,parentGraph->transformY(parent->getYMin())));
                         }
-                        if (x1<x) painter.drawLine(QLineF(x,y,parentGraph->transformX(parent->getXMin()),y));
-                        else painter.drawLine(QLineF(x,y,parentGraph->transformX(parent->getXMax()),y));
+
+
                     }
 
-                }
-                // y-errorbars
-                if ((yErrorColumn>=0 || yErrorColumnLower>=0) && (yErrorStyle==JKQTPErrorBars || yErrorStyle==JKQTPErrorBarsLines || yErrorStyle==JKQTPErrorBarsPolygons
-                    || yErrorStyle==JKQTPErrorSimpleBars || yErrorStyle==JKQTPErrorSimpleBarsLines || yErrorStyle==JKQTPErrorSimpleBarsPolygons)) {
-                    double y0=parentGraph->transformY(yv+yrelshift*deltay-yl); bool y0ok=JKQTPIsOKFloat(y0);
-                    double y1=parentGraph->transformY(yv+yrelshift*deltay+ye); bool y1ok=JKQTPIsOKFloat(y1);
+                    // error boxes
+                    if (yErrorStyle==JKQTPErrorBoxes || xErrorStyle==JKQTPErrorBoxes || yErrorStyle==JKQTPErrorEllipses || xErrorStyle==JKQTPErrorEllipses ) {
+                        double y0=parentGraph->transformY(yv+yrelshift*deltay-yl); bool y0ok=JKQTPIsOKFloat(y0);
+                        double y1=parentGraph->transformY(yv+yrelshift*deltay+ye); bool y1ok=JKQTPIsOKFloat(y1);
+                        double x0=parentGraph->transformX(xv+xrelshift*deltax-xl); bool x0ok=JKQTPIsOKFloat(x0);
+                        double x1=parentGraph->transformX(xv+xrelshift*deltax+xe); bool x1ok=JKQTPIsOKFloat(x1);
+                        painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
+                        QPen pp=p;
+                        if (!defaultErrorColor) pp.setColor(terrCol);
+                        painter.setPen(pp);
+                        QBrush bb=b;
+                        if (!defaultErrorColor) bb.setColor(terrFillCol);
+                        painter.setBrush(bb);
+
+                        QRectF errRect=QRectF(QPointF(x0,y0), QPointF(x1,y1));
+                        if ((y0ok&&y1ok)||(x0ok&&x1ok)) {
+                            if (yErrorStyle==JKQTPErrorEllipses || xErrorStyle==JKQTPErrorEllipses) painter.drawEllipse(errRect);
+                            else painter.drawRect(errRect);
+                        }
+
+
+                    }            //}
+
+                // x-errorlines
+                if (pastFirst && (xErrorStyle==JKQTPErrorLines || xErrorStyle==JKQTPErrorBarsLines || xErrorStyle==JKQTPErrorSimpleBarsLines)) {
+                    double xl1m=xmold;
+                    double xl1p=xpold;
+                    double yl1=yold;
+                    double xl2m=parentGraph->transformX(xv+xrelshift*deltax-xl);
+                    double xl2p=parentGraph->transformX(xv+xrelshift*deltax+xe);
+                    double yl2=y;
                     painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
                     QPen pp=p;
                     if (!defaultErrorColor) pp.setColor(terrCol);
                     painter.setPen(pp);
-                    if (y0ok&&y1ok&&xok&&yok) {
-                        painter.drawLine(QLineF(x, y0, x, y1));
-                        if (yErrorStyle==JKQTPErrorBars || yErrorStyle==JKQTPErrorBarsLines || yErrorStyle==JKQTPErrorBarsPolygons) {
-                            if (plotlowerbary) painter.drawLine(QLineF(x-ebs_px/2.0,y0,x+ebs_px/2.0,y0));
-                            if (plotupperbary) painter.drawLine(QLineF(x-ebs_px/2.0,y1,x+ebs_px/2.0,y1));
-                        }
-                    } else if (y0ok&&!y1ok&&xok&&yok) {   // upper errorbar OK, lower errorbar NAN
-                        painter.drawLine(QLineF(x, y0, x, y));
-                        if (yErrorStyle==JKQTPErrorBars || yErrorStyle==JKQTPErrorBarsLines || yErrorStyle==JKQTPErrorBarsPolygons) {
-                            if (plotlowerbary) painter.drawLine(QLineF(x-ebs_px/2.0,y0,x+ebs_px/2.0,y0));
-                        }
-                        if (y0<y) painter.drawLine(QLineF(x,y,x,parentGraph->transformY(parent->getYMin())));
-                        else painter.drawLine(QLineF(x,y,x,parentGraph->transformY(parent->getYMax()))); // inverted axis!
-                    } else if (!y0ok&&y1ok&&xok&&yok) {
-                        painter.drawLine(QLineF(x, y1, x, y));
-                        if (yErrorStyle==JKQTPErrorBars || yErrorStyle==JKQTPErrorBarsLines || yErrorStyle==JKQTPErrorBarsPolygons) {
-                            if (plotupperbary) painter.drawLine(QLineF(x-ebs_px/2.0,y1,x+ebs_px/2.0,y1));
-                        }
-                        if (y1<y) painter.drawLine(QLineF(x,y,x,parentGraph->transformY(parent->getYMax())));
-                        else painter.drawLine(QLineF(x,y,x,parentGraph->transformY(parent->getYMin())));
+                    if (JKQTPIsOKFloat(xl1m)&&JKQTPIsOKFloat(yl1)&&JKQTPIsOKFloat(xl2m)&&JKQTPIsOKFloat(yl2)) {
+                        painter.drawLine(QLineF(xl1m, yl1, xl2m, yl2));
+                    }
+                    if (JKQTPIsOKFloat(xl1p)&&JKQTPIsOKFloat(yl1)&&JKQTPIsOKFloat(xl2p)&&JKQTPIsOKFloat(yl2)) {
+                        painter.drawLine(QLineF(xl1p, yl1, xl2p, yl2));
                     }
-
 
                 }
 
-                // error boxes
-                if (yErrorStyle==JKQTPErrorBoxes || xErrorStyle==JKQTPErrorBoxes || yErrorStyle==JKQTPErrorEllipses || xErrorStyle==JKQTPErrorEllipses ) {
-                    double y0=parentGraph->transformY(yv+yrelshift*deltay-yl); bool y0ok=JKQTPIsOKFloat(y0);
-                    double y1=parentGraph->transformY(yv+yrelshift*deltay+ye); bool y1ok=JKQTPIsOKFloat(y1);
-                    double x0=parentGraph->transformX(xv+xrelshift*deltax-xl); bool x0ok=JKQTPIsOKFloat(x0);
-                    double x1=parentGraph->transformX(xv+xrelshift*deltax+xe); bool x1ok=JKQTPIsOKFloat(x1);
+
+                // y-errorlines
+                if (pastFirst && (yErrorStyle==JKQTPErrorLines || yErrorStyle==JKQTPErrorBarsLines || yErrorStyle==JKQTPErrorSimpleBarsLines)) {
+                    double yl1m=ymold;
+                    double yl1p=ypold;
+                    double xl1=xold;
+                    double yl2m=parentGraph->transformY(yv+yrelshift*deltay-yl);
+                    double yl2p=parentGraph->transformY(yv+yrelshift*deltay+ye);
+                    double xl2=x;
                     painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
                     QPen pp=p;
                     if (!defaultErrorColor) pp.setColor(terrCol);
                     painter.setPen(pp);
-                    QBrush bb=b;
-                    if (!defaultErrorColor) bb.setColor(terrFillCol);
-                    painter.setBrush(bb);
-
-                    QRectF errRect=QRectF(QPointF(x0,y0), QPointF(x1,y1));
-                    if ((y0ok&&y1ok)||(x0ok&&x1ok)) {
-                        if (yErrorStyle==JKQTPErrorEllipses || xErrorStyle==JKQTPErrorEllipses) painter.drawEllipse(errRect);
-                        else painter.drawRect(errRect);
+                    if (JKQTPIsOKFloat(xl1)&&JKQTPIsOKFloat(yl1m)&&JKQTPIsOKFloat(xl2)&&JKQTPIsOKFloat(yl2m)) {
+                        painter.drawLine(QLineF(xl1, yl1m, xl2, yl2m));
+                    }
+                    if (JKQTPIsOKFloat(xl1)&&JKQTPIsOKFloat(yl1p)&&JKQTPIsOKFloat(xl2)&&JKQTPIsOKFloat(yl2p)) {
+                        painter.drawLine(QLineF(xl1, yl1p, xl2, yl2p));
                     }
 
-
-                }            //}
-
-            // x-errorlines
-            if (pastFirst && (xErrorStyle==JKQTPErrorLines || xErrorStyle==JKQTPErrorBarsLines || xErrorStyle==JKQTPErrorSimpleBarsLines)) {
-                double xl1m=xmold;
-                double xl1p=xpold;
-                double yl1=yold;
-                double xl2m=parentGraph->transformX(xv+xrelshift*deltax-xl);
-                double xl2p=parentGraph->transformX(xv+xrelshift*deltax+xe);
-                double yl2=y;
-                painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
-                QPen pp=p;
-                if (!defaultErrorColor) pp.setColor(terrCol);
-                painter.setPen(pp);
-                if (JKQTPIsOKFloat(xl1m)&&JKQTPIsOKFloat(yl1)&&JKQTPIsOKFloat(xl2m)&&JKQTPIsOKFloat(yl2)) {
-                    painter.drawLine(QLineF(xl1m, yl1, xl2m, yl2));
-                }
-                if (JKQTPIsOKFloat(xl1p)&&JKQTPIsOKFloat(yl1)&&JKQTPIsOKFloat(xl2p)&&JKQTPIsOKFloat(yl2)) {
-                    painter.drawLine(QLineF(xl1p, yl1, xl2p, yl2));
                 }
 
-            }
-
 
-            // y-errorlines
-            if (pastFirst && (yErrorStyle==JKQTPErrorLines || yErrorStyle==JKQTPErrorBarsLines || yErrorStyle==JKQTPErrorSimpleBarsLines)) {
-                double yl1m=ymold;
-                double yl1p=ypold;
-                double xl1=xold;
-                double yl2m=parentGraph->transformY(yv+yrelshift*deltay-yl);
-                double yl2p=parentGraph->transformY(yv+yrelshift*deltay+ye);
-                double xl2=x;
-                painter.save(); auto __finalpaint=JKQTPFinally([&painter]() {painter.restore();});
-                QPen pp=p;
-                if (!defaultErrorColor) pp.setColor(terrCol);
-                painter.setPen(pp);
-                if (JKQTPIsOKFloat(xl1)&&JKQTPIsOKFloat(yl1m)&&JKQTPIsOKFloat(xl2)&&JKQTPIsOKFloat(yl2m)) {
-                    painter.drawLine(QLineF(xl1, yl1m, xl2, yl2m));
-                }
-                if (JKQTPIsOKFloat(xl1)&&JKQTPIsOKFloat(yl1p)&&JKQTPIsOKFloat(xl2)&&JKQTPIsOKFloat(yl2p)) {
-                    painter.drawLine(QLineF(xl1, yl1p, xl2, yl2p));
-                }
 
+                pastFirst=true;
+                xold=x;
+                xmold=parentGraph->transformX(xv+xrelshift*deltax-xl);
+                xpold=parentGraph->transformX(xv+xrelshift*deltax+xe);
+                yold=y;
+                ymold=parentGraph->transformY(yv+yrelshift*deltay-yl);
+                ypold=parentGraph->transformY(yv+yrelshift*deltay+ye);
             }
-
-
-
-            pastFirst=true;
-            xold=x;
-            xmold=parentGraph->transformX(xv+xrelshift*deltax-xl);
-            xpold=parentGraph->transformX(xv+xrelshift*deltax+xe);
-            yold=y;
-            ymold=parentGraph->transformY(yv+yrelshift*deltay-yl);
-            ypold=parentGraph->transformY(yv+yrelshift*deltay+ye);
-        }
+    }
     }
     // x-errorpolygons
     if ((polyXTopPoints.size()>0 || polyXBottomPoints.size()>0) && (xErrorStyle==JKQTPErrorPolygons || xErrorStyle==JKQTPErrorBarsPolygons || xErrorStyle==JKQTPErrorSimpleBarsPolygons)) {
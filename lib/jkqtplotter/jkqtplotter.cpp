@@ -1155,8 +1155,13 @@ void JKQTPlotter::synchronizeXYAxis(double newxmin, double newxmax, double newym
 
 
 void JKQTPlotter::redrawPlot() {
+    plotter->resetIncrementalDrawing();
+    redrawPlotIncremental();
+}
+
+void JKQTPlotter::redrawPlotIncremental() {
 #ifdef JKQTBP_AUTOTIMER
-    JKQTPAutoOutputTimer jkaaot(QString("JKQTPlotter::redrawPlot()"));
+    JKQTPAutoOutputTimer jkaaot(QString("JKQTPlotter::redrawPlotIncremental()"));
 #endif
     if (!doDrawing) return;
     disconnect(plotter, SIGNAL(plotUpdated()), this, SLOT(redrawPlot()));
@@ -1034,8 +1034,14 @@ class JKQTPLOTTER_LIB_EXPORT JKQTPlotter: public QWidget {
         /** \brief zooms out of the graph (the same as turning the mouse wheel) by the given factor */
         inline void zoomOut(double factor=2.0) { plotter->zoomOut(factor); }
 
-        /** \brief update the plot and the overlays */
+        /** \brief update the plot and the overlays (this also invalidates the cached graph layer of the \ref jkqtplotter_base_incremental "incremental drawing") */
         void redrawPlot();
+        /** \brief update the plot and the overlays, but keep the cached graph layer of the \ref jkqtplotter_base_incremental "incremental drawing",
+         *         i.e. only the datapoints that were appended since the last redraw are drawn (if incremental drawing is activated)
+         *
+         *  \see JKQTBasePlotter::setIncrementalDrawing()
+         */
+        void redrawPlotIncremental();
 
         /** \brief allows to activate/deactivate toolbar buttons that can activate certain mouse drag actions
          *
@@ -543,3 +543,9 @@ JKQTPUserActionMarkerType String2JKQTPUserActionMarkerType(const QString &act)
     if (m=="circle+crosshair" || m=="circle+cross") return jkqtpuamtCircleAndCrossHair;
     return jkqtpuamtCircle;
 }
+
+JKQTPIncrementalDrawState::JKQTPIncrementalDrawState():
+    valid(false), drawnStart(0), drawnEnd(0), column1(-1), column2(-1), data1(nullptr), data2(nullptr), rows1(0), rows2(0), lastValue1(JKQTP_NAN), lastValue2(JKQTP_NAN)
+{
+
+}
@@ -477,6 +477,32 @@ struct JKQTPLOTTER_LIB_EXPORT JKQTPGridPrintingItem {
 };
 
 
+/** \brief describes which part of a graph has already been drawn in an incremental (append-only) drawing
+ * \ingroup jkqtpplottersupprt
+ *
+ * This is filled by JKQTPPlotElement::initIncrementalDrawState() and updated by JKQTPPlotElement::drawIncremental().
+ *
+ * \see JKQTBasePlotter::setIncrementalDrawing()
+ */
+struct JKQTPLOTTER_LIB_EXPORT JKQTPIncrementalDrawState {
+    JKQTPIncrementalDrawState();
+    /** \brief indicates whether the state is valid, i.e. whether drawIncremental() may continue from this state */
+    bool valid;
+    /** \brief first datapoint index, that has been drawn */
+    int drawnStart;
+    /** \brief datapoint index after the last datapoint, that has been drawn */
+    int drawnEnd;
+    /** \brief the data columns that were drawn */
+    int column1, column2;
+    /** \brief data pointers of the columns column1 and column2, when they were drawn (if they change, e.g. because the column data was replaced or reallocated, everything is redrawn) */
+    const double* data1, *data2;
+    /** \brief number of rows in the columns column1 and column2, when they were drawn (used to detect that data was removed) */
+    size_t rows1, rows2;
+    /** \brief the values of the last drawn datapoint, used to detect whether the drawn data was replaced */
+    double lastValue1, lastValue2;
+};
+
+
 
 /** \brief plot styles for the error information
  * \ingroup jkqtplotter_basegraphserrors